@@ -191,6 +191,14 @@ sk_sp<SkData> ParseBase64(const std::string& input) {
   return data;
 }
 
+fml::UniqueFD PersistentCache::OpenImpellerCacheDirectory() const {
+  if (is_read_only_ || !IsValid()) {
+    return {};
+  }
+  return fml::CreateDirectory(*cache_directory_, {kImpellerSubdirName},
+                              fml::FilePermission::kReadWrite);
+}
+
 size_t PersistentCache::PrecompileKnownSkSLs(GrDirectContext* context) const {
   // clang-tidy has trouble reasoning about some of the complicated array and
   // pointer-arithmetic code in rapidjson.
@@ -111,6 +111,15 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   ///
   size_t PrecompileKnownSkSLs(GrDirectContext* context) const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Open the directory, inside the cache directory, that Impeller
+  ///             persists the pipeline cache of its Vulkan backend in.
+  ///
+  /// @return     The directory, which is invalid if the cache is read only or
+  ///             has no directory.
+  ///
+  fml::UniqueFD OpenImpellerCacheDirectory() const;
+
   // Return mappings for all skp's accessible through the AssetManager
   std::vector<std::unique_ptr<fml::Mapping>> GetSkpsFromAssetManager() const;
 
@@ -128,6 +137,7 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   static void MarkStrategySet() { strategy_set_ = true; }
 
   static constexpr char kSkSLSubdirName[] = "sksl";
+  static constexpr char kImpellerSubdirName[] = "impeller";
   static constexpr char kAssetFileName[] = "io.flutter.shaders.json";
 
  private:
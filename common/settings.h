@@ -87,6 +87,19 @@ using MappingsCallback = std::function<Mappings(void)>;
 
 using FrameRasterizedCallback = std::function<void(const FrameTiming&)>;
 
+// How layer trees queued between the UI and raster threads are handed to the
+// rasterizer.
+enum class FramePipelinePolicy {
+  // Every layer tree is rasterized in the order it was produced.
+  kFifo,
+  // Only the most recently produced layer tree is rasterized; older queued
+  // layer trees are dropped.
+  kLatestWins,
+  // Like |kFifo|, but the number of layer trees in flight grows while the
+  // rasterizer misses frames, so that the UI thread can run further ahead.
+  kAdaptiveDepth,
+};
+
 class DartIsolate;
 
 struct Settings {
@@ -136,6 +149,10 @@ struct Settings {
   std::optional<std::vector<std::string>> trace_skia_allowlist;
   bool trace_startup = false;
   bool trace_systrace = false;
+  // The number of trace events kept per thread in the ring buffers enabled
+  // with --trace-to-ring-buffer, or 0 if trace events are not recorded into
+  // ring buffers.
+  size_t trace_ring_buffer_size = 0;
   bool enable_timeline_event_handler = true;
   bool dump_skp_on_shader_compilation = false;
   bool cache_sksl = false;
@@ -262,6 +279,10 @@ struct Settings {
   // calls in this callback will cause applications to jank.
   LogMessageCallback log_message_callback;
   bool enable_software_rendering = false;
+  FramePipelinePolicy frame_pipeline_policy = FramePipelinePolicy::kFifo;
+  // Paint sibling layer subtrees that do not depend on each other into
+  // separate display lists on the concurrent worker pool of the VM.
+  bool enable_concurrent_layer_painting = false;
   bool skia_deterministic_rendering_on_cpu = false;
   bool verbose_logging = false;
   std::string log_tag = "flutter";
@@ -301,6 +322,14 @@ struct Settings {
   // Max bytes threshold of resource cache, or 0 for unlimited.
   size_t resource_cache_max_bytes_threshold = 0;
 
+  // Max bytes used by the images of the raster cache, or 0 for unlimited.
+  size_t raster_cache_max_bytes = 0;
+
+  // Max number of display lists rasterized into the raster cache at the same
+  // time on the concurrent worker pool of the VM, or 0 to rasterize them on
+  // the raster thread in the frame where they become eligible for caching.
+  size_t raster_cache_max_async_jobs = 0;
+
   /// The minimum number of samples to require in multipsampled anti-aliasing.
   ///
   /// Setting this value to 0 or 1 disables MSAA.
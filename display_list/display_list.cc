@@ -2,12 +2,15 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+#include <string_view>
 #include <type_traits>
 
 #include "flutter/display_list/display_list.h"
 #include "flutter/display_list/display_list_canvas_dispatcher.h"
 #include "flutter/display_list/display_list_ops.h"
 #include "flutter/display_list/display_list_utils.h"
+#include "flutter/fml/hash_combine.h"
 #include "flutter/fml/trace_event.h"
 
 namespace flutter {
@@ -24,7 +27,9 @@ DisplayList::DisplayList()
       unique_id_(0),
       bounds_({0, 0, 0, 0}),
       bounds_cull_({0, 0, 0, 0}),
-      can_apply_group_opacity_(true) {}
+      can_apply_group_opacity_(true),
+      has_gpu_images_(false),
+      has_stable_content_hash_(true) {}
 
 DisplayList::DisplayList(uint8_t* ptr,
                          size_t byte_count,
@@ -32,7 +37,9 @@ DisplayList::DisplayList(uint8_t* ptr,
                          size_t nested_byte_count,
                          unsigned int nested_op_count,
                          const SkRect& cull_rect,
-                         bool can_apply_group_opacity)
+                         bool can_apply_group_opacity,
+                         bool has_gpu_images,
+                         bool has_stable_content_hash)
     : storage_(ptr),
       byte_count_(byte_count),
       op_count_(op_count),
@@ -40,16 +47,42 @@ DisplayList::DisplayList(uint8_t* ptr,
       nested_op_count_(nested_op_count),
       bounds_({0, 0, -1, -1}),
       bounds_cull_(cull_rect),
-      can_apply_group_opacity_(can_apply_group_opacity) {
+      can_apply_group_opacity_(can_apply_group_opacity),
+      has_gpu_images_(has_gpu_images),
+      has_stable_content_hash_(has_stable_content_hash) {
   static std::atomic<uint32_t> next_id{1};
   do {
     unique_id_ = next_id.fetch_add(+1, std::memory_order_relaxed);
   } while (unique_id_ == 0);
 }
 
+DisplayList::DisplayList(std::shared_ptr<const fml::Mapping> mapping,
+                         uint8_t* ops,
+                         size_t byte_count,
+                         unsigned int op_count,
+                         const SkRect& cull_rect,
+                         bool can_apply_group_opacity)
+    : DisplayList(nullptr,
+                  byte_count,
+                  op_count,
+                  0,
+                  0,
+                  cull_rect,
+                  can_apply_group_opacity,
+                  false,
+                  true) {
+  FML_DCHECK(mapping);
+  mapping_ = std::move(mapping);
+  mapped_ops_ = ops;
+}
+
 DisplayList::~DisplayList() {
-  uint8_t* ptr = storage_.get();
-  DisposeOps(ptr, ptr + byte_count_);
+  // Mapped records are trivially destructible and are released along
+  // with the mapping itself.
+  if (!mapping_) {
+    uint8_t* ptr = storage_.get();
+    DisposeOps(ptr, ptr + byte_count_);
+  }
 }
 
 void DisplayList::ComputeBounds() {
@@ -65,13 +98,43 @@ void DisplayList::ComputeBounds() {
 void DisplayList::ComputeRTree() {
   RTreeBoundsAccumulator accumulator;
   DisplayListBoundsCalculator calculator(accumulator, &bounds_cull_);
-  Dispatch(calculator);
+  uint8_t* start = ops();
+  uint8_t* ptr = start;
+  uint8_t* end = start + byte_count_;
+  while (ptr < end) {
+    auto op = reinterpret_cast<const DLOp*>(ptr);
+    accumulator.set_op_offset(ptr - start);
+    ptr += op->size;
+    FML_DCHECK(ptr <= end);
+    if (!DispatchOneOp(calculator, op)) {
+      break;
+    }
+  }
   if (calculator.is_unbounded()) {
     FML_LOG(INFO) << "returning partial rtree for unbounded DisplayList";
   }
+  rtree_is_unbounded_ = calculator.is_unbounded();
+  rtree_op_offsets_ = accumulator.op_offsets();
   rtree_ = accumulator.rtree();
 }
 
+bool DisplayList::DispatchOneOp(Dispatcher& dispatcher, const DLOp* op) {
+  switch (op->type) {
+#define DL_OP_DISPATCH(name)                                \
+  case DisplayListOpType::k##name:                          \
+    static_cast<const name##Op*>(op)->dispatch(dispatcher); \
+    return true;
+
+    FOR_EACH_DISPLAY_LIST_OP(DL_OP_DISPATCH)
+
+#undef DL_OP_DISPATCH
+
+    default:
+      FML_DCHECK(false);
+      return false;
+  }
+}
+
 void DisplayList::Dispatch(Dispatcher& dispatcher,
                            uint8_t* ptr,
                            uint8_t* end) const {
@@ -79,19 +142,59 @@ void DisplayList::Dispatch(Dispatcher& dispatcher,
     auto op = reinterpret_cast<const DLOp*>(ptr);
     ptr += op->size;
     FML_DCHECK(ptr <= end);
-    switch (op->type) {
-#define DL_OP_DISPATCH(name)                                \
-  case DisplayListOpType::k##name:                          \
-    static_cast<const name##Op*>(op)->dispatch(dispatcher); \
-    break;
+    if (!DispatchOneOp(dispatcher, op)) {
+      return;
+    }
+  }
+}
 
-      FOR_EACH_DISPLAY_LIST_OP(DL_OP_DISPATCH)
+void DisplayList::Dispatch(Dispatcher& dispatcher, const SkRect& cull_rect) {
+  if (cull_rect.isEmpty()) {
+    return;
+  }
+  if (cull_rect.contains(bounds())) {
+    Dispatch(dispatcher);
+    return;
+  }
+  sk_sp<const DlRTree> tree = rtree();
+  if (rtree_is_unbounded_) {
+    // Some records could not be bounded so the rtree cannot be trusted
+    // to contain all of the records that might render inside the cull.
+    Dispatch(dispatcher);
+    return;
+  }
 
-#undef DL_OP_DISPATCH
+  std::vector<int> rect_indices;
+  tree->search(cull_rect, &rect_indices);
+  std::vector<size_t> visible_offsets;
+  visible_offsets.reserve(rect_indices.size());
+  for (int index : rect_indices) {
+    visible_offsets.push_back(rtree_op_offsets_[index]);
+  }
+  std::sort(visible_offsets.begin(), visible_offsets.end());
 
-      default:
-        FML_DCHECK(false);
-        return;
+  uint8_t* start = ops();
+  uint8_t* ptr = start;
+  uint8_t* end = start + byte_count_;
+  auto next_visible = visible_offsets.begin();
+  while (ptr < end) {
+    auto op = reinterpret_cast<const DLOp*>(ptr);
+    size_t offset = ptr - start;
+    ptr += op->size;
+    FML_DCHECK(ptr <= end);
+    // Rendering records all follow the attribute, save/restore, transform
+    // and clip records in the op type enum.
+    if (op->type >= DisplayListOpType::kDrawPaint) {
+      while (next_visible != visible_offsets.end() &&
+             *next_visible < offset) {
+        ++next_visible;
+      }
+      if (next_visible == visible_offsets.end() || *next_visible != offset) {
+        continue;
+      }
+    }
+    if (!DispatchOneOp(dispatcher, op)) {
+      return;
     }
   }
 }
@@ -207,12 +310,17 @@ bool DisplayList::Equals(const DisplayList* other) const {
   if (byte_count_ != other->byte_count_ || op_count_ != other->op_count_) {
     return false;
   }
-  uint8_t* ptr = storage_.get();
-  uint8_t* o_ptr = other->storage_.get();
+  uint8_t* ptr = ops();
+  uint8_t* o_ptr = other->ops();
   if (ptr == o_ptr) {
     return true;
   }
   return CompareOps(ptr, ptr + byte_count_, o_ptr, o_ptr + other->byte_count_);
 }
 
+size_t DisplayList::ComputeContentHash() const {
+  std::string_view bytes(reinterpret_cast<const char*>(ops()), byte_count_);
+  return fml::HashCombine(std::hash<std::string_view>{}(bytes), op_count_);
+}
+
 }  // namespace flutter
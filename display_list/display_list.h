@@ -7,11 +7,13 @@
 
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "flutter/display_list/display_list_rtree.h"
 #include "flutter/display_list/display_list_sampling_options.h"
 #include "flutter/display_list/types.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/mapping.h"
 
 // The Flutter DisplayList mechanism encapsulates a persistent sequence of
 // rendering operations.
@@ -60,6 +62,9 @@
 
 namespace flutter {
 
+// The rendering ops, starting with DrawPaint, must be listed after all
+// of the attribute, save/restore, transform and clip ops so that culled
+// dispatch can tell them apart by value.
 #define FOR_EACH_DISPLAY_LIST_OP(V) \
   V(SetAntiAlias)                   \
   V(SetDither)                      \
@@ -164,6 +169,7 @@ enum class DisplayListOpType { FOR_EACH_DISPLAY_LIST_OP(DL_OP_TO_ENUM_VALUE) };
 
 class Dispatcher;
 class DisplayListBuilder;
+struct DLOp;
 
 class SaveLayerOptions {
  public:
@@ -225,10 +231,21 @@ class DisplayList : public SkRefCnt {
   ~DisplayList();
 
   void Dispatch(Dispatcher& ctx) const {
-    uint8_t* ptr = storage_.get();
+    uint8_t* ptr = ops();
     Dispatch(ctx, ptr, ptr + byte_count_);
   }
 
+  // Dispatches only the rendering records whose bounds intersect
+  // |cull_rect|, as determined by the |rtree()| of the DisplayList.
+  // All attribute, save/restore, transform and clip records are still
+  // dispatched so that the state seen by the rendering records that
+  // are dispatched is unchanged.
+  //
+  // The rtree is computed on first use, so this is only profitable for
+  // DisplayLists that are dispatched repeatedly with a cull rect that
+  // covers a small portion of their bounds.
+  void Dispatch(Dispatcher& ctx, const SkRect& cull_rect);
+
   void RenderTo(DisplayListBuilder* builder,
                 SkScalar opacity = SK_Scalar1) const;
 
@@ -272,6 +289,31 @@ class DisplayList : public SkRefCnt {
 
   bool can_apply_group_opacity() { return can_apply_group_opacity_; }
 
+  // Whether this DisplayList, or a DisplayList nested in it, draws images
+  // that live on the GPU or that belong to the context of the raster thread
+  // (such as the images of |Picture.toImage|). Such a DisplayList can only
+  // be rendered on the raster thread into a surface of that context.
+  bool has_gpu_images() const { return has_gpu_images_; }
+
+  // Whether the records of this DisplayList hold nothing but values and
+  // nested DisplayLists whose hash is stable. The |content_hash| of other
+  // DisplayLists depends on the addresses of the paths, images, text blobs
+  // or other objects that they reference, which are new objects every time
+  // they are recorded.
+  bool has_stable_content_hash() const { return has_stable_content_hash_; }
+
+  // A hash of the bytes of the records of this DisplayList, computed on
+  // first use. DisplayLists that compare |Equals| have the same hash as
+  // long as their records reference the same objects (images, nested
+  // DisplayLists, filters, ...), so the hash is a cheap filter for finding
+  // candidates to compare, see |DisplayListReuseCache|.
+  size_t content_hash() {
+    if (!content_hash_) {
+      content_hash_ = ComputeContentHash();
+    }
+    return content_hash_.value();
+  }
+
   static void DisposeOps(uint8_t* ptr, uint8_t* end);
 
  private:
@@ -281,12 +323,28 @@ class DisplayList : public SkRefCnt {
               size_t nested_byte_count,
               unsigned int nested_op_count,
               const SkRect& cull_rect,
+              bool can_apply_group_opacity,
+              bool has_gpu_images,
+              bool has_stable_content_hash);
+
+  // Creates a DisplayList whose records live inside of |mapping| rather
+  // than in memory owned by the DisplayList. Only used for records that
+  // are trivially destructible, see DisplayListSerialization.
+  DisplayList(std::shared_ptr<const fml::Mapping> mapping,
+              uint8_t* ops,
+              size_t byte_count,
+              unsigned int op_count,
+              const SkRect& cull_rect,
               bool can_apply_group_opacity);
 
+  uint8_t* ops() const { return mapping_ ? mapped_ops_ : storage_.get(); }
+
   struct SkFreeDeleter {
     void operator()(uint8_t* p) { sk_free(p); }
   };
   std::unique_ptr<uint8_t, SkFreeDeleter> storage_;
+  std::shared_ptr<const fml::Mapping> mapping_;
+  uint8_t* mapped_ops_ = nullptr;
   size_t byte_count_;
   unsigned int op_count_;
 
@@ -296,17 +354,29 @@ class DisplayList : public SkRefCnt {
   uint32_t unique_id_;
   SkRect bounds_;
   sk_sp<const DlRTree> rtree_;
+  // The offset of the record that produced each rect in |rtree_|.
+  std::vector<size_t> rtree_op_offsets_;
+  bool rtree_is_unbounded_ = false;
 
   // Only used for drawPaint() and drawColor()
   SkRect bounds_cull_;
 
   bool can_apply_group_opacity_;
+  bool has_gpu_images_;
+  bool has_stable_content_hash_;
+
+  std::optional<size_t> content_hash_;
 
   void ComputeBounds();
+  size_t ComputeContentHash() const;
   void ComputeRTree();
   void Dispatch(Dispatcher& ctx, uint8_t* ptr, uint8_t* end) const;
 
+  // Returns false if the op type is not recognized.
+  static bool DispatchOneOp(Dispatcher& ctx, const DLOp* op);
+
   friend class DisplayListBuilder;
+  friend class DisplayListSerialization;
 };
 
 }  // namespace flutter
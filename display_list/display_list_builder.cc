@@ -4,6 +4,8 @@
 
 #include "flutter/display_list/display_list_builder.h"
 
+#include <type_traits>
+
 #include "flutter/display_list/display_list.h"
 #include "flutter/display_list/display_list_blend_mode.h"
 #include "flutter/display_list/display_list_color_source.h"
@@ -11,8 +13,6 @@
 
 namespace flutter {
 
-#define DL_BUILDER_PAGE 4096
-
 // CopyV(dst, src,n, src,n, ...) copies any number of typed srcs into dst.
 static void CopyV(void* dst) {}
 
@@ -29,22 +29,18 @@ template <typename T, typename... Args>
 void* DisplayListBuilder::Push(size_t pod, int op_inc, Args&&... args) {
   size_t size = SkAlignPtr(sizeof(T) + pod);
   FML_DCHECK(size < (1 << 24));
-  if (used_ + size > allocated_) {
-    static_assert(SkIsPow2(DL_BUILDER_PAGE),
-                  "This math needs updating for non-pow2.");
-    // Next greater multiple of DL_BUILDER_PAGE.
-    allocated_ = (used_ + size + DL_BUILDER_PAGE) & ~(DL_BUILDER_PAGE - 1);
-    storage_.realloc(allocated_);
-    FML_DCHECK(storage_.get());
-    memset(storage_.get() + used_, 0, allocated_ - used_);
-  }
-  FML_DCHECK(used_ + size <= allocated_);
-  auto op = reinterpret_cast<T*>(storage_.get() + used_);
-  used_ += size;
+  auto op = reinterpret_cast<T*>(storage_.Allocate(size));
   new (op) T{std::forward<Args>(args)...};
   op->type = T::kType;
   op->size = size;
   op_count_ += op_inc;
+  // Records that hold references to objects other than DisplayLists, such
+  // as paths, images or text blobs, can't be destroyed trivially. Nested
+  // DisplayLists are accounted for in |drawDisplayList|.
+  if constexpr (!std::is_trivially_destructible_v<T> &&
+                T::kType != DisplayListOpType::kDrawDisplayList) {
+    has_stable_content_hash_ = false;
+  }
   return op + 1;
 }
 
@@ -52,17 +48,20 @@ sk_sp<DisplayList> DisplayListBuilder::Build() {
   while (layer_stack_.size() > 1) {
     restore();
   }
-  size_t bytes = used_;
+  size_t bytes = storage_.bytes_used();
   int count = op_count_;
   size_t nested_bytes = nested_bytes_;
   int nested_count = nested_op_count_;
-  used_ = allocated_ = op_count_ = 0;
+  op_count_ = 0;
   nested_bytes_ = nested_op_count_ = 0;
-  storage_.realloc(bytes);
   bool compatible = layer_stack_.back().is_group_opacity_compatible();
-  return sk_sp<DisplayList>(new DisplayList(storage_.release(), bytes, count,
-                                            nested_bytes, nested_count,
-                                            cull_rect_, compatible));
+  bool has_gpu_images = has_gpu_images_;
+  bool has_stable_content_hash = has_stable_content_hash_;
+  has_gpu_images_ = false;
+  has_stable_content_hash_ = true;
+  return sk_sp<DisplayList>(new DisplayList(
+      storage_.Compact(), bytes, count, nested_bytes, nested_count, cull_rect_,
+      compatible, has_gpu_images, has_stable_content_hash));
 }
 
 DisplayListBuilder::DisplayListBuilder(const SkRect& cull_rect)
@@ -72,10 +71,8 @@ DisplayListBuilder::DisplayListBuilder(const SkRect& cull_rect)
 }
 
 DisplayListBuilder::~DisplayListBuilder() {
-  uint8_t* ptr = storage_.get();
-  if (ptr) {
-    DisplayList::DisposeOps(ptr, ptr + used_);
-  }
+  storage_.ForEachRange(
+      [](uint8_t* ptr, uint8_t* end) { DisplayList::DisposeOps(ptr, end); });
 }
 
 void DisplayListBuilder::onSetAntiAlias(bool aa) {
@@ -137,6 +134,13 @@ void DisplayListBuilder::onSetBlender(sk_sp<SkBlender> blender) {
     UpdateCurrentOpacityCompatibility();
   }
 }
+void DisplayListBuilder::CheckForGpuImage(const DlImage* image) {
+  if (image && (image->isTextureBacked() ||
+                image->owning_context() == DlImage::OwningContext::kRaster)) {
+    has_gpu_images_ = true;
+  }
+}
+
 void DisplayListBuilder::onSetColorSource(const DlColorSource* source) {
   if (source == nullptr) {
     current_.setColorSource(nullptr);
@@ -154,6 +158,7 @@ void DisplayListBuilder::onSetColorSource(const DlColorSource* source) {
         const DlImageColorSource* image_source = source->asImage();
         FML_DCHECK(image_source);
         Push<SetImageColorSourceOp>(0, 0, image_source);
+        CheckForGpuImage(image_source->image().get());
         break;
       }
       case DlColorSourceType::kLinearGradient: {
@@ -189,6 +194,11 @@ void DisplayListBuilder::onSetColorSource(const DlColorSource* source) {
         const DlRuntimeEffectColorSource* effect = source->asRuntimeEffect();
         FML_DCHECK(effect);
         Push<SetRuntimeEffectColorSourceOp>(0, 0, effect);
+        for (const auto& sampler : effect->samplers()) {
+          if (sampler && sampler->asImage()) {
+            CheckForGpuImage(sampler->asImage()->image().get());
+          }
+        }
         break;
       }
       case DlColorSourceType::kUnknown:
@@ -458,8 +468,8 @@ void DisplayListBuilder::restore() {
         // in the DisplayList are only allowed *during* the build phase.
         // Once built, the DisplayList records must remain read only to
         // ensure consistency of rendering and |Equals()| behavior.
-        SaveLayerOp* op = reinterpret_cast<SaveLayerOp*>(
-            storage_.get() + layer_info.save_layer_offset);
+        SaveLayerOp* op =
+            reinterpret_cast<SaveLayerOp*>(layer_info.save_layer_op);
         op->options = op->options.with_can_distribute_opacity();
       }
     } else {
@@ -483,7 +493,6 @@ void DisplayListBuilder::saveLayer(const SkRect* bounds,
                                    const SaveLayerOptions in_options,
                                    const DlImageFilter* backdrop) {
   SaveLayerOptions options = in_options.without_optimizations();
-  size_t save_layer_offset = used_;
   if (backdrop) {
     bounds  //
         ? Push<SaveLayerBackdropBoundsOp>(0, 1, *bounds, options, backdrop)
@@ -493,8 +502,11 @@ void DisplayListBuilder::saveLayer(const SkRect* bounds,
         ? Push<SaveLayerBoundsOp>(0, 1, *bounds, options)
         : Push<SaveLayerOp>(0, 1, options);
   }
+  // Storage pages are never relocated during the build phase so the
+  // record can be located directly when the matching restore() is seen.
+  uint8_t* save_layer_op = storage_.last_allocation();
   CheckLayerOpacityCompatibility(options.renders_with_attributes());
-  layer_stack_.emplace_back(current_layer_, save_layer_offset, true);
+  layer_stack_.emplace_back(current_layer_, save_layer_op, true);
   current_layer_ = &layer_stack_.back();
   if (options.renders_with_attributes()) {
     // |current_opacity_compatibility_| does not take an ImageFilter into
@@ -910,6 +922,7 @@ void DisplayListBuilder::drawImage(const sk_sp<DlImage> image,
       ? Push<DrawImageWithAttrOp>(0, 1, image, point, sampling)
       : Push<DrawImageOp>(0, 1, image, point, sampling);
   CheckLayerOpacityCompatibility(render_with_attributes);
+  CheckForGpuImage(image.get());
 }
 void DisplayListBuilder::drawImage(const sk_sp<DlImage>& image,
                                    const SkPoint point,
@@ -932,6 +945,7 @@ void DisplayListBuilder::drawImageRect(const sk_sp<DlImage> image,
   Push<DrawImageRectOp>(0, 1, image, src, dst, sampling, render_with_attributes,
                         constraint);
   CheckLayerOpacityCompatibility(render_with_attributes);
+  CheckForGpuImage(image.get());
 }
 void DisplayListBuilder::drawImageRect(const sk_sp<DlImage>& image,
                                        const SkRect& src,
@@ -956,6 +970,7 @@ void DisplayListBuilder::drawImageNine(const sk_sp<DlImage> image,
       ? Push<DrawImageNineWithAttrOp>(0, 1, image, center, dst, filter)
       : Push<DrawImageNineOp>(0, 1, image, center, dst, filter);
   CheckLayerOpacityCompatibility(render_with_attributes);
+  CheckForGpuImage(image.get());
 }
 void DisplayListBuilder::drawImageNine(const sk_sp<DlImage>& image,
                                        const SkIRect& center,
@@ -991,6 +1006,7 @@ void DisplayListBuilder::drawImageLattice(const sk_sp<DlImage> image,
   CopyV(pod, lattice.fXDivs, x_div_count, lattice.fYDivs, y_div_count,
         lattice.fColors, cell_count, lattice.fRectTypes, cell_count);
   CheckLayerOpacityCompatibility(render_with_attributes);
+  CheckForGpuImage(image.get());
 }
 void DisplayListBuilder::drawAtlas(const sk_sp<DlImage> atlas,
                                    const SkRSXform xform[],
@@ -1029,6 +1045,7 @@ void DisplayListBuilder::drawAtlas(const sk_sp<DlImage> atlas,
   // on it to distribute the opacity without overlap without checking all
   // of the transforms and texture rectangles.
   UpdateLayerOpacityCompatibility(false);
+  CheckForGpuImage(atlas.get());
 }
 void DisplayListBuilder::drawAtlas(const sk_sp<DlImage>& atlas,
                                    const SkRSXform xform[],
@@ -1079,6 +1096,9 @@ void DisplayListBuilder::drawDisplayList(
   nested_op_count_ += display_list->op_count(true) - 1;
   nested_bytes_ += display_list->bytes(true);
   UpdateLayerOpacityCompatibility(display_list->can_apply_group_opacity());
+  has_gpu_images_ = has_gpu_images_ || display_list->has_gpu_images();
+  has_stable_content_hash_ =
+      has_stable_content_hash_ && display_list->has_stable_content_hash();
 }
 void DisplayListBuilder::drawTextBlob(const sk_sp<SkTextBlob> blob,
                                       SkScalar x,
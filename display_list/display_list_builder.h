@@ -14,6 +14,7 @@
 #include "flutter/display_list/display_list_paint.h"
 #include "flutter/display_list/display_list_path_effect.h"
 #include "flutter/display_list/display_list_sampling_options.h"
+#include "flutter/display_list/display_list_storage.h"
 #include "flutter/display_list/types.h"
 #include "flutter/fml/macros.h"
 
@@ -357,15 +358,19 @@ class DisplayListBuilder final : public virtual Dispatcher,
  private:
   void checkForDeferredSave();
 
-  SkAutoTMalloc<uint8_t> storage_;
-  size_t used_ = 0;
-  size_t allocated_ = 0;
+  DlStorage storage_;
   int op_count_ = 0;
 
   // bytes and ops from |drawPicture| and |drawDisplayList|
   size_t nested_bytes_ = 0;
   int nested_op_count_ = 0;
 
+  // See |DisplayList::has_gpu_images|.
+  bool has_gpu_images_ = false;
+  // See |DisplayList::has_stable_content_hash|.
+  bool has_stable_content_hash_ = true;
+  void CheckForGpuImage(const DlImage* image);
+
   SkRect cull_rect_;
 
   template <typename T, typename... Args>
@@ -384,9 +389,9 @@ class DisplayListBuilder final : public virtual Dispatcher,
   struct LayerInfo {
     LayerInfo(const SkM44& matrix,
               const SkRect& clip_bounds,
-              size_t save_layer_offset = 0,
+              uint8_t* save_layer_op = nullptr,
               bool has_layer = false)
-        : save_layer_offset(save_layer_offset),
+        : save_layer_op(save_layer_op),
           has_layer(has_layer),
           cannot_inherit_opacity(false),
           has_compatible_op(false),
@@ -394,20 +399,20 @@ class DisplayListBuilder final : public virtual Dispatcher,
           clip_bounds(clip_bounds) {}
 
     LayerInfo(const LayerInfo* current_layer,
-              size_t save_layer_offset = 0,
+              uint8_t* save_layer_op = nullptr,
               bool has_layer = false)
         : LayerInfo(current_layer->matrix,
                     current_layer->clip_bounds,
-                    save_layer_offset,
+                    save_layer_op,
                     has_layer) {}
 
-    // The offset into the memory buffer where the saveLayer DLOp record
+    // The address in the recording storage where the saveLayer DLOp record
     // for this saveLayer() call is placed. This may be needed if the
     // eventual restore() call has discovered important information about
     // the records inside the saveLayer that may impact how the saveLayer
     // is handled (e.g., |cannot_inherit_opacity| == false).
-    // This offset is only valid if |has_layer| is true.
-    size_t save_layer_offset;
+    // This address is only valid if |has_layer| is true.
+    uint8_t* save_layer_op;
 
     bool has_deferred_save_op_ = false;
 
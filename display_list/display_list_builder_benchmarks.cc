@@ -3,7 +3,11 @@
 // found in the LICENSE file.
 
 #include "flutter/benchmarking/benchmarking.h"
+#include "flutter/display_list/display_list_serialization.h"
 #include "flutter/display_list/display_list_test_utils.h"
+#include "flutter/display_list/display_list_utils.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
 
 namespace flutter {
 namespace {
@@ -46,8 +50,102 @@ static void Complete(DisplayListBuilder& builder,
   }
 }
 
+// A Dispatcher that only counts the rendering calls it receives so that
+// dispatch overhead can be measured without any rasterization.
+class CountingDispatcher : public virtual Dispatcher,
+                           public IgnoreAttributeDispatchHelper,
+                           public IgnoreClipDispatchHelper,
+                           public IgnoreTransformDispatchHelper,
+                           public IgnoreDrawDispatchHelper {
+ public:
+  void drawRect(const SkRect& rect) override { draw_count_++; }
+  void drawRRect(const SkRRect& rrect) override { draw_count_++; }
+
+  int draw_count() const { return draw_count_; }
+
+ private:
+  int draw_count_ = 0;
+};
+
+// Builds a DisplayList that resembles a long scrolling list, a column of
+// |item_count| items each made of a translated card and a few contents.
+static sk_sp<DisplayList> BuildScrollingList(int item_count) {
+  DisplayListBuilder builder;
+  for (int i = 0; i < item_count; i++) {
+    builder.save();
+    builder.translate(0, i * 100);
+    builder.drawRRect(SkRRect::MakeRectXY({0, 0, 400, 90}, 8, 8));
+    builder.drawRect({10, 10, 80, 80});
+    builder.drawRect({90, 20, 390, 40});
+    builder.drawRect({90, 50, 300, 70});
+    builder.restore();
+  }
+  return builder.Build();
+}
+
 }  // namespace
 
+// Dispatches a long list where only about 5% of the items are inside the
+// viewport, either linearly (culled == false) or through the rtree.
+static void BM_DisplayListDispatchScrollingList(benchmark::State& state,
+                                                bool culled) {
+  const int item_count = 2000;
+  auto display_list = BuildScrollingList(item_count);
+  // 100 of the 2000 items are visible.
+  SkRect viewport = SkRect::MakeXYWH(0, 50000, 400, 100 * 100 - 1);
+  display_list->rtree();
+  while (state.KeepRunning()) {
+    CountingDispatcher dispatcher;
+    if (culled) {
+      display_list->Dispatch(dispatcher, viewport);
+    } else {
+      display_list->Dispatch(dispatcher);
+    }
+    benchmark::DoNotOptimize(dispatcher.draw_count());
+  }
+}
+
+// Records a large number of simple ops to measure the cost of growing the
+// builder's recording storage independently of the cost of the ops.
+static void BM_DisplayListBuilderManyOps(benchmark::State& state) {
+  const int op_count = state.range(0);
+  size_t bytes = 0;
+  while (state.KeepRunning()) {
+    DisplayListBuilder builder;
+    for (int i = 0; i < op_count; i++) {
+      builder.drawRect(SkRect::MakeXYWH(i % 1000, i / 1000, 10, 10));
+    }
+    auto display_list = builder.Build();
+    bytes = display_list->bytes(false);
+  }
+  state.SetItemsProcessed(state.iterations() * op_count);
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+// Maps a serialized DisplayList from disk and computes its bounds, which
+// dispatches every record once, to measure replay of captured frames.
+static void BM_DisplayListLoadFromFile(benchmark::State& state) {
+  const int op_count = state.range(0);
+  DisplayListBuilder builder;
+  for (int i = 0; i < op_count; i++) {
+    builder.drawRect(SkRect::MakeXYWH(i % 1000, i / 1000, 10, 10));
+  }
+  auto serialized = DisplayListSerialization::Serialize(*builder.Build());
+  FML_CHECK(serialized);
+
+  fml::ScopedTemporaryDirectory temp_dir;
+  FML_CHECK(fml::WriteAtomically(temp_dir.fd(), "frame.dl", *serialized));
+
+  while (state.KeepRunning()) {
+    std::shared_ptr<const fml::Mapping> mapping =
+        fml::FileMapping::CreateReadOnly(temp_dir.fd(), "frame.dl");
+    auto display_list = DisplayListSerialization::Deserialize(mapping);
+    display_list->bounds();
+  }
+  state.SetItemsProcessed(state.iterations() * op_count);
+  state.SetBytesProcessed(state.iterations() * serialized->GetSize());
+}
+
 static void BM_DisplayListBuilderDefault(benchmark::State& state,
                                          DisplayListBuilderBenchmarkType type) {
   while (state.KeepRunning()) {
@@ -130,6 +228,21 @@ static void BM_DisplayListBuilderWithSaveLayerAndImageFilter(
   }
 }
 
+BENCHMARK_CAPTURE(BM_DisplayListDispatchScrollingList, Linear, false)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DisplayListDispatchScrollingList, Culled, true)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_DisplayListBuilderManyOps)
+    ->RangeMultiplier(10)
+    ->Range(10000, 100000)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_DisplayListLoadFromFile)
+    ->RangeMultiplier(10)
+    ->Range(10000, 100000)
+    ->Unit(benchmark::kMicrosecond);
+
 BENCHMARK_CAPTURE(BM_DisplayListBuilderDefault,
                   kDefault,
                   DisplayListBuilderBenchmarkType::kDefault)
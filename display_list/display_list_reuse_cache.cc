@@ -0,0 +1,68 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/display_list_reuse_cache.h"
+
+#include <iterator>
+
+namespace flutter {
+
+DisplayListReuseCache::DisplayListReuseCache(size_t max_bytes,
+                                             size_t min_bytes)
+    : max_bytes_(max_bytes), min_bytes_(min_bytes) {}
+
+DisplayListReuseCache::~DisplayListReuseCache() = default;
+
+sk_sp<DisplayList> DisplayListReuseCache::Reuse(
+    sk_sp<DisplayList> display_list) {
+  if (!display_list || !display_list->has_stable_content_hash() ||
+      display_list->bytes(false) - sizeof(DisplayList) < min_bytes_) {
+    return display_list;
+  }
+  size_t bytes = display_list->bytes(true);
+  if (bytes > max_bytes_) {
+    return display_list;
+  }
+
+  size_t hash = display_list->content_hash();
+  auto range = index_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    const sk_sp<DisplayList>& cached = it->second->display_list;
+    if (cached->Equals(display_list) &&
+        cached->bounds() == display_list->bounds()) {
+      entries_.splice(entries_.begin(), entries_, it->second);
+      hit_count_++;
+      return cached;
+    }
+  }
+
+  entries_.push_front({display_list, hash, bytes});
+  index_.emplace(hash, entries_.begin());
+  bytes_ += bytes;
+  while (bytes_ > max_bytes_) {
+    EvictLeastRecentlyUsed();
+  }
+  return display_list;
+}
+
+void DisplayListReuseCache::Clear() {
+  index_.clear();
+  entries_.clear();
+  bytes_ = 0;
+}
+
+void DisplayListReuseCache::EvictLeastRecentlyUsed() {
+  auto last = std::prev(entries_.end());
+  auto range = index_.equal_range(last->hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second == last) {
+      index_.erase(it);
+      break;
+    }
+  }
+  bytes_ -= last->bytes;
+  entries_.erase(last);
+}
+
+}  // namespace flutter
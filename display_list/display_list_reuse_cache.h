@@ -0,0 +1,91 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_DISPLAY_LIST_REUSE_CACHE_H_
+#define FLUTTER_DISPLAY_LIST_DISPLAY_LIST_REUSE_CACHE_H_
+
+#include <list>
+#include <unordered_map>
+
+#include "flutter/display_list/display_list.h"
+#include "flutter/fml/macros.h"
+
+namespace flutter {
+
+// A cache of recently built DisplayLists, indexed by their content hash, that
+// hands out a previously built DisplayList in place of a newly built one
+// that compares |Equals| to it.
+//
+// Content that does not change from frame to frame is typically recorded
+// again every frame. Substituting the previous DisplayList means that the
+// DrawDisplayListOp of any DisplayList that draws it, and the layer that
+// holds it, reference the same immutable object as in the previous frame.
+// That object keeps its |unique_id|, so its raster cache entries remain
+// valid, and the DiffContext can compare it by identity rather than by
+// comparing the records of both DisplayLists.
+//
+// Since records that reference other objects are hashed by the address of
+// those objects, only DisplayLists with a |has_stable_content_hash| are
+// cached. Paths, images, text blobs and the like are new objects every time
+// they are recorded, so DisplayLists that hold them would never be found.
+// Nested DisplayLists must go through the same cache for the DisplayLists
+// that draw them to be found, which happens naturally when DisplayLists are
+// built bottom-up.
+//
+// The cache retains DisplayLists of up to |max_bytes| in total, counting
+// the DisplayLists they draw, in least recently used order. It is not
+// thread-safe.
+class DisplayListReuseCache {
+ public:
+  static constexpr size_t kDefaultMaxBytes = 2 * 1024 * 1024;
+
+  // DisplayLists with fewer bytes of records than this are not worth the
+  // cost of hashing and comparing them, nor of keeping them alive.
+  static constexpr size_t kDefaultMinBytes = 512;
+
+  explicit DisplayListReuseCache(size_t max_bytes = kDefaultMaxBytes,
+                                 size_t min_bytes = kDefaultMinBytes);
+
+  ~DisplayListReuseCache();
+
+  // Returns a cached DisplayList equal to |display_list| if there is one,
+  // otherwise caches and returns |display_list|.
+  sk_sp<DisplayList> Reuse(sk_sp<DisplayList> display_list);
+
+  // Releases all cached DisplayLists, for example when the system is low
+  // on memory.
+  void Clear();
+
+  size_t size() const { return entries_.size(); }
+
+  // The bytes of the cached DisplayLists, see |DisplayList::bytes|.
+  size_t bytes() const { return bytes_; }
+
+  // The number of DisplayLists that were substituted by a cached one.
+  size_t hit_count() const { return hit_count_; }
+
+ private:
+  struct Entry {
+    sk_sp<DisplayList> display_list;
+    size_t hash;
+    size_t bytes;
+  };
+  using EntryList = std::list<Entry>;
+
+  const size_t max_bytes_;
+  const size_t min_bytes_;
+  // Most recently used first.
+  EntryList entries_;
+  std::unordered_multimap<size_t, EntryList::iterator> index_;
+  size_t bytes_ = 0;
+  size_t hit_count_ = 0;
+
+  void EvictLeastRecentlyUsed();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DisplayListReuseCache);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_DISPLAY_LIST_REUSE_CACHE_H_
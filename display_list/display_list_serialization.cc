@@ -0,0 +1,304 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/display_list_serialization.h"
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "flutter/display_list/display_list_ops.h"
+#include "third_party/skia/include/private/SkMalloc.h"
+
+namespace flutter {
+
+// The records that hold nothing but plain data and can be dispatched
+// from any address in any process. The attribute records don't count
+// towards the op count of a DisplayList, the rendering records do.
+#define FOR_EACH_POSITION_INDEPENDENT_ATTRIBUTE_OP(V) \
+  V(SetAntiAlias)                                     \
+  V(SetDither)                                        \
+  V(SetInvertColors)                                  \
+  V(SetStrokeCap)                                     \
+  V(SetStrokeJoin)                                    \
+  V(SetStyle)                                         \
+  V(SetStrokeWidth)                                   \
+  V(SetStrokeMiter)                                   \
+  V(SetColor)                                         \
+  V(SetBlendMode)                                     \
+  V(ClearBlender)                                     \
+  V(ClearPathEffect)                                  \
+  V(ClearColorFilter)                                 \
+  V(ClearColorSource)                                 \
+  V(ClearImageFilter)                                 \
+  V(ClearMaskFilter)                                  \
+  V(TransformReset)
+
+#define FOR_EACH_POSITION_INDEPENDENT_RENDERING_OP(V) \
+  V(Save)                                             \
+  V(SaveLayer)                                        \
+  V(SaveLayerBounds)                                  \
+  V(Restore)                                          \
+  V(Translate)                                        \
+  V(Scale)                                            \
+  V(Rotate)                                           \
+  V(Skew)                                             \
+  V(Transform2DAffine)                                \
+  V(TransformFullPerspective)                         \
+  V(ClipIntersectRect)                                \
+  V(ClipIntersectRRect)                               \
+  V(ClipDifferenceRect)                               \
+  V(ClipDifferenceRRect)                              \
+  V(DrawPaint)                                        \
+  V(DrawColor)                                        \
+  V(DrawLine)                                         \
+  V(DrawRect)                                         \
+  V(DrawOval)                                         \
+  V(DrawCircle)                                       \
+  V(DrawRRect)                                        \
+  V(DrawDRRect)                                       \
+  V(DrawArc)                                          \
+  V(DrawPoints)                                       \
+  V(DrawLines)                                        \
+  V(DrawPolygon)                                      \
+  V(DrawVertices)
+
+#define FOR_EACH_POSITION_INDEPENDENT_OP(V)     \
+  FOR_EACH_POSITION_INDEPENDENT_ATTRIBUTE_OP(V) \
+  FOR_EACH_POSITION_INDEPENDENT_RENDERING_OP(V)
+
+#define DL_ASSERT_TRIVIAL(name)                                     \
+  static_assert(std::is_trivially_destructible_v<name##Op> &&       \
+                    !std::is_polymorphic_v<name##Op>,               \
+                #name "Op cannot be stored in a serialized list");
+FOR_EACH_POSITION_INDEPENDENT_OP(DL_ASSERT_TRIVIAL)
+#undef DL_ASSERT_TRIVIAL
+
+namespace {
+
+constexpr uint32_t kMagic = 0x4c444c46;  // "FLDL" in little endian
+constexpr uint16_t kByteOrderMark = 0x0102;
+constexpr uint32_t kCanApplyGroupOpacityFlag = 1 << 0;
+
+struct DisplayListFileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t header_size;
+  uint16_t pointer_size;
+  uint16_t byte_order_mark;
+  uint64_t byte_count;
+  uint32_t op_count;
+  uint32_t flags;
+  SkRect cull_rect;
+};
+static_assert(sizeof(DisplayListFileHeader) % alignof(std::max_align_t) == 0,
+              "Records must start on an aligned boundary after the header");
+
+bool IsRenderingOp(DisplayListOpType type) {
+  switch (type) {
+#define DL_OP_IS_RENDERING(name)   \
+  case DisplayListOpType::k##name: \
+    return true;
+
+    FOR_EACH_POSITION_INDEPENDENT_RENDERING_OP(DL_OP_IS_RENDERING)
+
+#undef DL_OP_IS_RENDERING
+
+    default:
+      return false;
+  }
+}
+
+bool IsPositionIndependent(DisplayListOpType type) {
+  switch (type) {
+#define DL_OP_IS_POSITION_INDEPENDENT(name) \
+  case DisplayListOpType::k##name:          \
+    return true;
+
+    FOR_EACH_POSITION_INDEPENDENT_OP(DL_OP_IS_POSITION_INDEPENDENT)
+
+#undef DL_OP_IS_POSITION_INDEPENDENT
+
+    default:
+      return false;
+  }
+}
+
+// Returns the minimum number of bytes a record of the indicated type
+// must occupy, including any trailing data it refers to, or 0 if the
+// record cannot be read from a serialized list.
+size_t MinimumRecordSize(const DLOp* op) {
+  size_t size;
+  switch (op->type) {
+#define DL_OP_MINIMUM_SIZE(name)   \
+  case DisplayListOpType::k##name: \
+    size = sizeof(name##Op);       \
+    break;
+
+    FOR_EACH_POSITION_INDEPENDENT_OP(DL_OP_MINIMUM_SIZE)
+
+#undef DL_OP_MINIMUM_SIZE
+
+    default:
+      return 0;
+  }
+  switch (op->type) {
+    case DisplayListOpType::kDrawPoints:
+    case DisplayListOpType::kDrawLines:
+    case DisplayListOpType::kDrawPolygon:
+      // All three point ops share the same layout.
+      return size +
+             static_cast<const DrawPointsOp*>(op)->count * sizeof(SkPoint);
+    case DisplayListOpType::kDrawVertices:
+      return size + sizeof(DlVertices);
+    default:
+      return size;
+  }
+}
+
+// Returns true if the records between |ptr| and |end| can be dispatched
+// and hold |op_count| rendering ops.
+bool ValidateRecords(const uint8_t* ptr,
+                     const uint8_t* end,
+                     uint32_t op_count) {
+  uint32_t rendering_op_count = 0;
+  while (ptr < end) {
+    if (static_cast<size_t>(end - ptr) < sizeof(DLOp)) {
+      return false;
+    }
+    auto op = reinterpret_cast<const DLOp*>(ptr);
+    if (op->size == 0 || (op->size & (sizeof(void*) - 1)) != 0 ||
+        op->size > static_cast<size_t>(end - ptr)) {
+      return false;
+    }
+    if (!IsPositionIndependent(op->type)) {
+      return false;
+    }
+    size_t minimum_size = MinimumRecordSize(op);
+    if (minimum_size == 0 || op->size < minimum_size) {
+      return false;
+    }
+    if (op->type == DisplayListOpType::kDrawVertices) {
+      // The counts and offsets of the vertices are read from the data too.
+      auto vertices = reinterpret_cast<const DlVertices*>(
+          static_cast<const DrawVerticesOp*>(op) + 1);
+      if (!vertices->IsValid(op->size - sizeof(DrawVerticesOp))) {
+        return false;
+      }
+    }
+    if (IsRenderingOp(op->type)) {
+      rendering_op_count++;
+    }
+    ptr += op->size;
+  }
+  return ptr == end && rendering_op_count == op_count;
+}
+
+}  // namespace
+
+#undef FOR_EACH_POSITION_INDEPENDENT_OP
+#undef FOR_EACH_POSITION_INDEPENDENT_RENDERING_OP
+#undef FOR_EACH_POSITION_INDEPENDENT_ATTRIBUTE_OP
+
+bool DisplayListSerialization::CanSerialize(const DisplayList& display_list) {
+  const uint8_t* ptr = display_list.ops();
+  const uint8_t* end = ptr + display_list.byte_count_;
+  while (ptr < end) {
+    auto op = reinterpret_cast<const DLOp*>(ptr);
+    if (!IsPositionIndependent(op->type)) {
+      return false;
+    }
+    ptr += op->size;
+  }
+  return true;
+}
+
+std::unique_ptr<fml::Mapping> DisplayListSerialization::Serialize(
+    const DisplayList& display_list) {
+  if (!CanSerialize(display_list)) {
+    return nullptr;
+  }
+
+  DisplayListFileHeader header = {};
+  header.magic = kMagic;
+  header.version = kVersion;
+  header.header_size = sizeof(DisplayListFileHeader);
+  header.pointer_size = sizeof(void*);
+  header.byte_order_mark = kByteOrderMark;
+  header.byte_count = display_list.byte_count_;
+  header.op_count = display_list.op_count_;
+  header.flags =
+      display_list.can_apply_group_opacity_ ? kCanApplyGroupOpacityFlag : 0;
+  header.cull_rect = display_list.bounds_cull_;
+
+  std::vector<uint8_t> data(sizeof(header) + display_list.byte_count_);
+  memcpy(data.data(), &header, sizeof(header));
+  if (display_list.byte_count_ > 0) {
+    memcpy(data.data() + sizeof(header), display_list.ops(),
+           display_list.byte_count_);
+  }
+  return std::make_unique<fml::DataMapping>(std::move(data));
+}
+
+sk_sp<DisplayList> DisplayListSerialization::Deserialize(
+    std::shared_ptr<const fml::Mapping> mapping) {
+  if (!mapping || mapping->GetMapping() == nullptr ||
+      mapping->GetSize() < sizeof(DisplayListFileHeader)) {
+    return nullptr;
+  }
+
+  DisplayListFileHeader header;
+  memcpy(&header, mapping->GetMapping(), sizeof(header));
+  if (header.magic != kMagic || header.version != kVersion ||
+      header.header_size != sizeof(DisplayListFileHeader) ||
+      header.pointer_size != sizeof(void*) ||
+      header.byte_order_mark != kByteOrderMark) {
+    FML_LOG(ERROR) << "Serialized DisplayList was written by an incompatible "
+                      "version or platform.";
+    return nullptr;
+  }
+  if (header.byte_count != mapping->GetSize() - sizeof(header)) {
+    FML_LOG(ERROR) << "Serialized DisplayList is truncated or corrupt.";
+    return nullptr;
+  }
+
+  const uint8_t* records = mapping->GetMapping() + sizeof(header);
+  const size_t byte_count = header.byte_count;
+  const bool can_apply_group_opacity =
+      (header.flags & kCanApplyGroupOpacityFlag) != 0;
+
+  uintptr_t alignment_mask = alignof(std::max_align_t) - 1;
+  if ((reinterpret_cast<uintptr_t>(records) & alignment_mask) != 0) {
+    // Records must be aligned to be dispatched in place, fall back to
+    // owning a copy of them.
+    uint8_t* storage = nullptr;
+    if (byte_count > 0) {
+      storage = static_cast<uint8_t*>(sk_malloc_throw(byte_count));
+      memcpy(storage, records, byte_count);
+    }
+    if (!ValidateRecords(storage, storage + byte_count, header.op_count)) {
+      sk_free(storage);
+      FML_LOG(ERROR) << "Serialized DisplayList contains invalid records.";
+      return nullptr;
+    }
+    return sk_sp<DisplayList>(new DisplayList(storage, byte_count,
+                                              header.op_count, 0, 0,
+                                              header.cull_rect,
+                                              can_apply_group_opacity, false,
+                                              true));
+  }
+
+  if (!ValidateRecords(records, records + byte_count, header.op_count)) {
+    FML_LOG(ERROR) << "Serialized DisplayList contains invalid records.";
+    return nullptr;
+  }
+  // The records are never written to once a DisplayList is built, the
+  // non-const pointer only matches the internal dispatch signature.
+  return sk_sp<DisplayList>(new DisplayList(
+      std::move(mapping), const_cast<uint8_t*>(records), byte_count,
+      header.op_count, header.cull_rect, can_apply_group_opacity));
+}
+
+}  // namespace flutter
@@ -0,0 +1,64 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_DISPLAY_LIST_SERIALIZATION_H_
+#define FLUTTER_DISPLAY_LIST_DISPLAY_LIST_SERIALIZATION_H_
+
+#include <memory>
+
+#include "flutter/display_list/display_list.h"
+#include "flutter/fml/mapping.h"
+
+namespace flutter {
+
+// Converts DisplayLists that hold nothing but plain data to and from a
+// versioned binary format that can be written to disk and later dispatched
+// directly out of a file mapping.
+//
+// The format is a fixed-size header followed by the raw records of the
+// DisplayList exactly as they are laid out in memory. Loading a
+// DisplayList therefore only validates the records before dispatching
+// them in place; no per-op decoding or copying takes place.
+//
+// Because the records are used in place, only records that are position
+// independent can be stored, i.e. records that hold no pointers, reference
+// counts or vtables. This is not a general format for capturing the frames
+// of an application: there are no side tables for referenced objects, so
+// any record that draws or sets a path, image, text blob, SkVertices,
+// color source, filter, effect or nested picture or DisplayList makes
+// |Serialize| fail. Most application frames hold such
+// records, capture those as SkPictures instead. The format also records the
+// pointer size and byte order of the writer and is only loaded on a
+// matching platform.
+class DisplayListSerialization {
+ public:
+  // The current version of the format. Files with any other version are
+  // rejected by |Deserialize|.
+  static constexpr uint32_t kVersion = 1;
+
+  // Returns true if every record in |display_list| holds only plain data
+  // and can be stored in the binary format.
+  static bool CanSerialize(const DisplayList& display_list);
+
+  // Returns the serialized form of |display_list|, or nullptr if it
+  // contains records that cannot be stored (see |CanSerialize|).
+  static std::unique_ptr<fml::Mapping> Serialize(
+      const DisplayList& display_list);
+
+  // Returns a DisplayList that dispatches the records held by |mapping|,
+  // or nullptr if the mapping does not hold a valid DisplayList for this
+  // platform. The returned DisplayList keeps |mapping| alive.
+  //
+  // If the records in |mapping| are not suitably aligned for in-place
+  // dispatch they are copied once into memory owned by the DisplayList.
+  static sk_sp<DisplayList> Deserialize(
+      std::shared_ptr<const fml::Mapping> mapping);
+
+ private:
+  FML_DISALLOW_IMPLICIT_CONSTRUCTORS(DisplayListSerialization);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_DISPLAY_LIST_SERIALIZATION_H_
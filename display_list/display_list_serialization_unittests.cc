@@ -0,0 +1,395 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "flutter/display_list/display_list.h"
+#include "flutter/display_list/display_list_builder.h"
+#include "flutter/display_list/display_list_ops.h"
+#include "flutter/display_list/display_list_serialization.h"
+#include "flutter/display_list/display_list_test_utils.h"
+#include "flutter/display_list/display_list_vertices.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static sk_sp<DisplayList> MakePodOnlyDisplayList() {
+  DisplayListBuilder builder(SkRect::MakeLTRB(0, 0, 200, 200));
+  builder.setAntiAlias(true);
+  builder.setColor(DlColor::kRed());
+  builder.save();
+  builder.translate(10, 10);
+  builder.clipRect({0, 0, 100, 100}, SkClipOp::kIntersect, true);
+  builder.drawRect({10, 10, 50, 50});
+  builder.drawRRect(SkRRect::MakeRectXY({20, 20, 80, 80}, 5, 5));
+  builder.restore();
+  builder.saveLayer(nullptr, false);
+  builder.drawCircle({100, 100}, 20);
+  builder.restore();
+  SkPoint points[] = {{0, 0}, {10, 10}, {20, 0}};
+  builder.drawPoints(SkCanvas::kPolygon_PointMode, 3, points);
+  auto vertices = DlVertices::Make(DlVertexMode::kTriangles, 3, points,
+                                   nullptr, nullptr);
+  builder.drawVertices(vertices, DlBlendMode::kSrcOver);
+  return builder.Build();
+}
+
+TEST(DisplayListSerialization, RoundTripIsEqual) {
+  auto display_list = MakePodOnlyDisplayList();
+  ASSERT_TRUE(DisplayListSerialization::CanSerialize(*display_list));
+
+  std::shared_ptr<const fml::Mapping> mapping =
+      DisplayListSerialization::Serialize(*display_list);
+  ASSERT_NE(mapping, nullptr);
+
+  auto loaded = DisplayListSerialization::Deserialize(mapping);
+  ASSERT_NE(loaded, nullptr);
+  EXPECT_EQ(loaded->op_count(), display_list->op_count());
+  EXPECT_EQ(loaded->bytes(false), display_list->bytes(false));
+  EXPECT_EQ(loaded->bounds(), display_list->bounds());
+  EXPECT_EQ(loaded->can_apply_group_opacity(),
+            display_list->can_apply_group_opacity());
+  EXPECT_TRUE(loaded->Equals(*display_list));
+  EXPECT_TRUE(display_list->Equals(*loaded));
+}
+
+TEST(DisplayListSerialization, EmptyDisplayListRoundTrips) {
+  auto display_list = DisplayListBuilder().Build();
+  std::shared_ptr<const fml::Mapping> mapping =
+      DisplayListSerialization::Serialize(*display_list);
+  ASSERT_NE(mapping, nullptr);
+
+  auto loaded = DisplayListSerialization::Deserialize(mapping);
+  ASSERT_NE(loaded, nullptr);
+  EXPECT_EQ(loaded->op_count(), 0u);
+  EXPECT_TRUE(loaded->Equals(*display_list));
+}
+
+TEST(DisplayListSerialization, RecordsAreDispatchedInPlace) {
+  auto display_list = MakePodOnlyDisplayList();
+  std::shared_ptr<const fml::Mapping> mapping =
+      DisplayListSerialization::Serialize(*display_list);
+  ASSERT_NE(mapping, nullptr);
+
+  auto loaded = DisplayListSerialization::Deserialize(mapping);
+  ASSERT_NE(loaded, nullptr);
+  // The DisplayList shares the mapping rather than copying it.
+  EXPECT_GT(mapping.use_count(), 1);
+  loaded.reset();
+  EXPECT_EQ(mapping.use_count(), 1);
+}
+
+TEST(DisplayListSerialization, MisalignedMappingIsCopied) {
+  auto display_list = MakePodOnlyDisplayList();
+  auto mapping = DisplayListSerialization::Serialize(*display_list);
+  ASSERT_NE(mapping, nullptr);
+
+  std::vector<uint8_t> buffer(mapping->GetSize() + 1);
+  memcpy(buffer.data() + 1, mapping->GetMapping(), mapping->GetSize());
+  auto misaligned = std::make_shared<fml::NonOwnedMapping>(
+      buffer.data() + 1, mapping->GetSize());
+
+  auto loaded = DisplayListSerialization::Deserialize(misaligned);
+  ASSERT_NE(loaded, nullptr);
+  EXPECT_TRUE(loaded->Equals(*display_list));
+  EXPECT_EQ(misaligned.use_count(), 1);
+}
+
+TEST(DisplayListSerialization, ListsWithReferencedObjectsAreNotSerialized) {
+  {
+    DisplayListBuilder builder;
+    builder.drawPath(kTestPath1);
+    auto display_list = builder.Build();
+    EXPECT_FALSE(DisplayListSerialization::CanSerialize(*display_list));
+    EXPECT_EQ(DisplayListSerialization::Serialize(*display_list), nullptr);
+  }
+  {
+    DisplayListBuilder builder;
+    builder.drawImage(TestImage1, {10, 10}, DlImageSampling::kLinear, false);
+    auto display_list = builder.Build();
+    EXPECT_FALSE(DisplayListSerialization::CanSerialize(*display_list));
+    EXPECT_EQ(DisplayListSerialization::Serialize(*display_list), nullptr);
+  }
+}
+
+// The ops that application frames record, split into the ones the format
+// stores and the ones that reference objects it has no side tables for.
+TEST(DisplayListSerialization, SupportedOpsOfAFrame) {
+  struct OpCase {
+    const char* name;
+    std::function<void(DisplayListBuilder&)> record;
+  };
+  SkPoint points[] = {{0, 0}, {10, 10}, {20, 0}};
+  const std::vector<OpCase> supported = {
+      {"save/restore",
+       [](DisplayListBuilder& b) {
+         b.save();
+         b.drawRect(kTestBounds);
+         b.restore();
+       }},
+      {"saveLayer",
+       [](DisplayListBuilder& b) {
+         b.saveLayer(&kTestBounds, true);
+         b.drawRect(kTestBounds);
+         b.restore();
+       }},
+      {"transforms",
+       [](DisplayListBuilder& b) {
+         b.translate(10, 10);
+         b.scale(2, 2);
+         b.rotate(45);
+         b.skew(0.5, 0.5);
+         b.transform(kTestMatrix1);
+         b.transformReset();
+       }},
+      {"clipRect",
+       [](DisplayListBuilder& b) {
+         b.clipRect(kTestBounds, SkClipOp::kIntersect, true);
+       }},
+      {"clipRRect",
+       [](DisplayListBuilder& b) {
+         b.clipRRect(kTestRRect, SkClipOp::kDifference, true);
+       }},
+      {"attributes",
+       [](DisplayListBuilder& b) {
+         b.setAntiAlias(true);
+         b.setColor(DlColor::kBlue());
+         b.setStyle(DlDrawStyle::kStroke);
+         b.setStrokeWidth(3);
+         b.setBlendMode(DlBlendMode::kMultiply);
+         b.drawRect(kTestBounds);
+       }},
+      {"drawColor",
+       [](DisplayListBuilder& b) {
+         b.drawColor(DlColor::kRed(), DlBlendMode::kSrcOver);
+       }},
+      {"drawLine", [](DisplayListBuilder& b) { b.drawLine({0, 0}, {5, 5}); }},
+      {"drawRect", [](DisplayListBuilder& b) { b.drawRect(kTestBounds); }},
+      {"drawOval", [](DisplayListBuilder& b) { b.drawOval(kTestBounds); }},
+      {"drawCircle",
+       [](DisplayListBuilder& b) { b.drawCircle({10, 10}, 5); }},
+      {"drawRRect", [](DisplayListBuilder& b) { b.drawRRect(kTestRRect); }},
+      {"drawDRRect",
+       [](DisplayListBuilder& b) {
+         b.drawDRRect(kTestRRect, kTestInnerRRect);
+       }},
+      {"drawArc",
+       [](DisplayListBuilder& b) { b.drawArc(kTestBounds, 0, 90, true); }},
+      {"drawPoints",
+       [&points](DisplayListBuilder& b) {
+         b.drawPoints(SkCanvas::kPolygon_PointMode, 3, points);
+       }},
+      {"drawVertices",
+       [](DisplayListBuilder& b) {
+         b.drawVertices(TestVertices1, DlBlendMode::kSrcOver);
+       }},
+  };
+  const std::vector<OpCase> unsupported = {
+      {"clipPath",
+       [](DisplayListBuilder& b) {
+         b.clipPath(kTestPath1, SkClipOp::kIntersect, true);
+       }},
+      {"drawPath", [](DisplayListBuilder& b) { b.drawPath(kTestPath1); }},
+      {"drawShadow",
+       [](DisplayListBuilder& b) {
+         b.drawShadow(kTestPath1, DlColor::kBlack(), 3, false, 1);
+       }},
+      {"drawImage",
+       [](DisplayListBuilder& b) {
+         b.drawImage(TestImage1, {10, 10}, kLinearSampling, false);
+       }},
+      {"drawTextBlob",
+       [](DisplayListBuilder& b) { b.drawTextBlob(TestBlob1, 10, 10); }},
+      {"drawDisplayList",
+       [](DisplayListBuilder& b) { b.drawDisplayList(TestDisplayList1); }},
+      {"setColorSource",
+       [](DisplayListBuilder& b) {
+         b.setColorSource(&kTestSource1);
+         b.drawRect(kTestBounds);
+       }},
+      {"setColorFilter",
+       [](DisplayListBuilder& b) {
+         b.setColorFilter(&kTestMatrixColorFilter1);
+         b.drawRect(kTestBounds);
+       }},
+      {"setImageFilter",
+       [](DisplayListBuilder& b) {
+         b.setImageFilter(&kTestBlurImageFilter1);
+         b.drawRect(kTestBounds);
+       }},
+      {"setMaskFilter",
+       [](DisplayListBuilder& b) {
+         b.setMaskFilter(&kTestMaskFilter1);
+         b.drawRect(kTestBounds);
+       }},
+  };
+
+  for (const OpCase& op : supported) {
+    DisplayListBuilder builder;
+    op.record(builder);
+    auto display_list = builder.Build();
+    EXPECT_TRUE(DisplayListSerialization::CanSerialize(*display_list))
+        << op.name;
+    auto mapping = DisplayListSerialization::Serialize(*display_list);
+    ASSERT_NE(mapping, nullptr) << op.name;
+    auto loaded = DisplayListSerialization::Deserialize(std::move(mapping));
+    ASSERT_NE(loaded, nullptr) << op.name;
+    EXPECT_TRUE(loaded->Equals(*display_list)) << op.name;
+  }
+  for (const OpCase& op : unsupported) {
+    DisplayListBuilder builder;
+    op.record(builder);
+    auto display_list = builder.Build();
+    EXPECT_FALSE(DisplayListSerialization::CanSerialize(*display_list))
+        << op.name;
+    EXPECT_EQ(DisplayListSerialization::Serialize(*display_list), nullptr)
+        << op.name;
+  }
+}
+
+TEST(DisplayListSerialization, CorruptDataIsRejected) {
+  auto display_list = MakePodOnlyDisplayList();
+  auto mapping = DisplayListSerialization::Serialize(*display_list);
+  ASSERT_NE(mapping, nullptr);
+  std::vector<uint8_t> good(mapping->GetMapping(),
+                            mapping->GetMapping() + mapping->GetSize());
+
+  auto load = [](std::vector<uint8_t> data) {
+    return DisplayListSerialization::Deserialize(
+        std::make_shared<fml::DataMapping>(std::move(data)));
+  };
+
+  ASSERT_NE(load(good), nullptr);
+  EXPECT_EQ(load({}), nullptr);
+
+  // Truncated records.
+  std::vector<uint8_t> truncated(good.begin(), good.end() - 8);
+  EXPECT_EQ(load(truncated), nullptr);
+
+  // Bad magic.
+  std::vector<uint8_t> bad_magic = good;
+  bad_magic[0] ^= 0xff;
+  EXPECT_EQ(load(bad_magic), nullptr);
+
+  // Bad version.
+  std::vector<uint8_t> bad_version = good;
+  bad_version[4] ^= 0xff;
+  EXPECT_EQ(load(bad_version), nullptr);
+
+  // The first record (setAntiAlias) gets an invalid size.
+  std::vector<uint8_t> bad_record = good;
+  size_t record_bytes = display_list->bytes(false) - sizeof(DisplayList);
+  size_t header_size = good.size() - record_bytes;
+  bad_record[header_size + 1] = 0xff;
+  bad_record[header_size + 2] = 0xff;
+  bad_record[header_size + 3] = 0xff;
+  EXPECT_EQ(load(bad_record), nullptr);
+}
+
+TEST(DisplayListSerialization, CorruptVerticesAreRejected) {
+  SkPoint points[] = {{0, 0}, {10, 0}, {10, 10}, {0, 10}};
+  SkPoint texture_coordinates[] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+  DlColor colors[] = {DlColor::kRed(), DlColor::kGreen(), DlColor::kBlue(),
+                      DlColor::kWhite()};
+  uint16_t indices[] = {0, 1, 2, 0, 2, 3};
+  DisplayListBuilder builder;
+  builder.drawVertices(
+      DlVertices::Make(DlVertexMode::kTriangles, 4, points,
+                       texture_coordinates, colors, 6, indices),
+      DlBlendMode::kSrcOver);
+  auto display_list = builder.Build();
+  auto mapping = DisplayListSerialization::Serialize(*display_list);
+  ASSERT_NE(mapping, nullptr);
+  const std::vector<uint8_t> good(mapping->GetMapping(),
+                                  mapping->GetMapping() + mapping->GetSize());
+
+  // The list holds a single DrawVertices record, the DlVertices follow it.
+  const size_t record_bytes = display_list->bytes(false) - sizeof(DisplayList);
+  const size_t vertices_offset =
+      good.size() - record_bytes + sizeof(DrawVerticesOp);
+  const size_t vertices_end = good.size();
+
+  auto load = [](const std::vector<uint8_t>& data) {
+    return DisplayListSerialization::Deserialize(
+        std::make_shared<fml::DataMapping>(data));
+  };
+  ASSERT_NE(load(good), nullptr);
+
+  // The vertex count follows the mode.
+  constexpr size_t kVertexCountOffset = 4;
+  int32_t vertex_count;
+  memcpy(&vertex_count, good.data() + vertices_offset + kVertexCountOffset,
+         sizeof(vertex_count));
+  ASSERT_EQ(vertex_count, 4);
+  for (int32_t bad_count : {-1, 5, INT32_MAX, INT32_MIN}) {
+    std::vector<uint8_t> data = good;
+    memcpy(data.data() + vertices_offset + kVertexCountOffset, &bad_count,
+           sizeof(bad_count));
+    EXPECT_EQ(load(data), nullptr) << "vertex count " << bad_count;
+  }
+
+  // An index past the last vertex.
+  {
+    auto original =
+        reinterpret_cast<const DlVertices*>(good.data() + vertices_offset);
+    const size_t indices_offset =
+        reinterpret_cast<const uint8_t*>(original->indices()) - good.data();
+    std::vector<uint8_t> data = good;
+    uint16_t bad_index = 4;
+    memcpy(data.data() + indices_offset, &bad_index, sizeof(bad_index));
+    EXPECT_EQ(load(data), nullptr);
+  }
+
+  // Every word of the vertices replaced by values that are out of range as
+  // counts or offsets. Whatever is still accepted must be dispatched within
+  // the record.
+  for (size_t offset = vertices_offset; offset + 4 <= vertices_end;
+       offset += 4) {
+    for (uint32_t value : {0x00000000u, 0x00000001u, 0x00000003u, 0x0000ffffu,
+                           0x7fffffffu, 0x80000000u, 0xfffffffcu,
+                           0xffffffffu}) {
+      std::vector<uint8_t> data = good;
+      memcpy(data.data() + offset, &value, sizeof(value));
+      auto loaded = load(data);
+      if (!loaded) {
+        continue;
+      }
+      DisplayListBuilder copy;
+      loaded->RenderTo(&copy);
+      auto vertices = reinterpret_cast<const DlVertices*>(
+          data.data() + vertices_offset);
+      EXPECT_TRUE(vertices->IsValid(vertices_end - vertices_offset))
+          << "word at " << offset << " set to " << value;
+    }
+  }
+}
+
+TEST(DisplayListSerialization, OpCountOfHeaderIsChecked) {
+  auto display_list = MakePodOnlyDisplayList();
+  auto mapping = DisplayListSerialization::Serialize(*display_list);
+  ASSERT_NE(mapping, nullptr);
+  std::vector<uint8_t> data(mapping->GetMapping(),
+                            mapping->GetMapping() + mapping->GetSize());
+
+  // The op count follows the magic, version, header size, pointer size,
+  // byte order mark and byte count of the header.
+  constexpr size_t kOpCountOffset = 24;
+  uint32_t op_count;
+  memcpy(&op_count, data.data() + kOpCountOffset, sizeof(op_count));
+  ASSERT_EQ(op_count, display_list->op_count());
+
+  for (uint32_t bad_count : {0u, op_count - 1, op_count + 1, 0xffffffffu}) {
+    memcpy(data.data() + kOpCountOffset, &bad_count, sizeof(bad_count));
+    EXPECT_EQ(DisplayListSerialization::Deserialize(
+                  std::make_shared<fml::DataMapping>(data)),
+              nullptr);
+  }
+}
+
+}  // namespace testing
+}  // namespace flutter
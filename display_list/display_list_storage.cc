@@ -0,0 +1,108 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/display_list_storage.h"
+
+#include <cstring>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/thread_local.h"
+#include "third_party/skia/include/private/SkMalloc.h"
+
+namespace flutter {
+
+namespace {
+
+// A per-thread cache of regular sized pages. Builders are normally used
+// on a single thread (the UI thread) frame after frame, so keeping the
+// pool thread local avoids any synchronization on the recording path.
+class DlStoragePagePool {
+ public:
+  std::unique_ptr<uint8_t[]> Take() {
+    if (pages_.empty()) {
+      return std::make_unique<uint8_t[]>(DlStorage::kPageSize);
+    }
+    std::unique_ptr<uint8_t[]> page = std::move(pages_.back());
+    pages_.pop_back();
+    return page;
+  }
+
+  void Give(std::unique_ptr<uint8_t[]> page) {
+    if (pages_.size() < DlStorage::kMaxPooledPagesPerThread) {
+      pages_.push_back(std::move(page));
+    }
+  }
+
+ private:
+  std::vector<std::unique_ptr<uint8_t[]>> pages_;
+};
+
+FML_THREAD_LOCAL fml::ThreadLocalUniquePtr<DlStoragePagePool> tls_page_pool;
+
+DlStoragePagePool& GetPagePool() {
+  DlStoragePagePool* pool = tls_page_pool.get();
+  if (pool == nullptr) {
+    pool = new DlStoragePagePool();
+    tls_page_pool.reset(pool);
+  }
+  return *pool;
+}
+
+}  // namespace
+
+DlStorage::~DlStorage() {
+  Reset();
+}
+
+uint8_t* DlStorage::Allocate(size_t size) {
+  FML_DCHECK((size & (sizeof(void*) - 1)) == 0);
+  if (pages_.empty() || pages_.back().used + size > pages_.back().capacity) {
+    if (size > kPageSize) {
+      pages_.push_back({std::make_unique<uint8_t[]>(size), size, 0});
+    } else {
+      pages_.push_back({GetPagePool().Take(), kPageSize, 0});
+    }
+  }
+  Page& page = pages_.back();
+  uint8_t* ptr = page.memory.get() + page.used;
+  // Pooled pages contain the bytes of previous recordings and the
+  // padding inside of records must be deterministic for the bulk
+  // memcmp performed by |DisplayList::Equals|.
+  memset(ptr, 0, size);
+  page.used += size;
+  bytes_used_ += size;
+  last_allocation_ = ptr;
+  return ptr;
+}
+
+uint8_t* DlStorage::Compact() {
+  uint8_t* result = nullptr;
+  if (bytes_used_ > 0) {
+    result = static_cast<uint8_t*>(sk_malloc_throw(bytes_used_));
+    uint8_t* dst = result;
+    for (const Page& page : pages_) {
+      memcpy(dst, page.memory.get(), page.used);
+      dst += page.used;
+    }
+    FML_DCHECK(dst == result + bytes_used_);
+  }
+  Reset();
+  return result;
+}
+
+void DlStorage::Reset() {
+  if (!pages_.empty()) {
+    DlStoragePagePool& pool = GetPagePool();
+    for (Page& page : pages_) {
+      if (page.capacity == kPageSize) {
+        pool.Give(std::move(page.memory));
+      }
+    }
+    pages_.clear();
+  }
+  bytes_used_ = 0;
+  last_allocation_ = nullptr;
+}
+
+}  // namespace flutter
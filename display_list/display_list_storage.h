@@ -0,0 +1,93 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_DISPLAY_LIST_STORAGE_H_
+#define FLUTTER_DISPLAY_LIST_DISPLAY_LIST_STORAGE_H_
+
+#include <memory>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+
+namespace flutter {
+
+// The recording storage used by DisplayListBuilder while ops are being
+// accumulated.
+//
+// Memory is handed out from a chain of fixed-size pages that are never
+// relocated, so recording a large DisplayList does not pay for repeated
+// realloc+memcpy of everything recorded so far, and pointers to previously
+// recorded ops remain valid for the whole build phase. Pages are obtained
+// from, and returned to, a small per-thread pool so that a builder that
+// records a frame's worth of ops every frame does not hit the allocator
+// once it has warmed up.
+//
+// When recording is complete, |Compact| gathers the recorded bytes into a
+// single contiguous block (the layout that DisplayList dispatches from)
+// with exactly one copy per byte, and returns the pages to the pool.
+//
+// DlStorage only manages memory; the ops recorded into it must be
+// disposed of by its owner (see |DisplayList::DisposeOps|) before the
+// storage is reset or destroyed.
+class DlStorage {
+ public:
+  // The size of a regular page. Allocations larger than a page are given
+  // their own dedicated page which is not recycled through the pool.
+  static constexpr size_t kPageSize = 16 * 1024;
+
+  // The maximum number of regular pages retained by the pool of any one
+  // thread.
+  static constexpr size_t kMaxPooledPagesPerThread = 64;
+
+  DlStorage() = default;
+
+  ~DlStorage();
+
+  // Returns a pointer to |size| bytes of zero-filled memory. |size| must
+  // be a multiple of the pointer size so that the contiguous layout
+  // produced by |Compact| keeps all records aligned.
+  uint8_t* Allocate(size_t size);
+
+  // The total number of bytes handed out since the last reset.
+  size_t bytes_used() const { return bytes_used_; }
+
+  // The pointer most recently returned from |Allocate|, or nullptr.
+  uint8_t* last_allocation() const { return last_allocation_; }
+
+  // Invokes |visitor(start, end)| for the recorded range of every page
+  // in allocation order.
+  template <typename Visitor>
+  void ForEachRange(Visitor&& visitor) const {
+    for (const Page& page : pages_) {
+      uint8_t* start = page.memory.get();
+      visitor(start, start + page.used);
+    }
+  }
+
+  // Copies every recorded byte into one contiguous block allocated with
+  // sk_malloc, returns that block (or nullptr if nothing was recorded),
+  // and resets the storage. The caller takes ownership of the recorded
+  // ops, which move with the bytes.
+  uint8_t* Compact();
+
+  // Returns all pages to the pool without disposing of their contents.
+  void Reset();
+
+ private:
+  struct Page {
+    std::unique_ptr<uint8_t[]> memory;
+    size_t capacity;
+    size_t used;
+  };
+
+  std::vector<Page> pages_;
+  size_t bytes_used_ = 0;
+  uint8_t* last_allocation_ = nullptr;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DlStorage);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_DISPLAY_LIST_STORAGE_H_
@@ -13,7 +13,9 @@
 #include "flutter/display_list/display_list_builder.h"
 #include "flutter/display_list/display_list_canvas_recorder.h"
 #include "flutter/display_list/display_list_paint.h"
+#include "flutter/display_list/display_list_reuse_cache.h"
 #include "flutter/display_list/display_list_rtree.h"
+#include "flutter/display_list/display_list_storage.h"
 #include "flutter/display_list/display_list_test_utils.h"
 #include "flutter/display_list/display_list_utils.h"
 #include "flutter/fml/logging.h"
@@ -164,6 +166,47 @@ TEST(DisplayList, SingleOpDisplayListsCompareToEachOther) {
   }
 }
 
+TEST(DisplayList, MultiPageDisplayListsRecapturedAreEqual) {
+  auto record = [](int count) {
+    DisplayListBuilder builder;
+    for (int i = 0; i < count; i++) {
+      builder.setColor(DlColor(0xff000000 | i));
+      builder.drawRect(SkRect::MakeXYWH(i % 100, i / 100, 10, 10));
+    }
+    return builder.Build();
+  };
+  // Enough ops to span many storage pages.
+  int count = static_cast<int>(DlStorage::kPageSize);
+  auto dl1 = record(count);
+  auto dl2 = record(count);
+  EXPECT_EQ(dl1->op_count(), static_cast<unsigned int>(count));
+  EXPECT_GT(dl1->bytes(false), DlStorage::kPageSize * 4);
+  EXPECT_EQ(dl1->bytes(false), dl2->bytes(false));
+  EXPECT_TRUE(dl1->Equals(*dl2));
+  EXPECT_EQ(dl1->bounds(), SkRect::MakeLTRB(0, 0, 109, (count - 1) / 100 + 10));
+}
+
+TEST(DisplayList, RecycledStoragePagesDoNotAffectEquality) {
+  DisplayListBuilder builder1;
+  // Dirty a storage page with non-zero data and return it to the pool.
+  for (int i = 0; i < 100; i++) {
+    builder1.drawCircle({1e6, 1e6}, 1e6);
+  }
+  builder1.Build();
+
+  DisplayListBuilder builder2;
+  builder2.setAntiAlias(true);
+  builder2.drawRect({10, 10, 20, 20});
+  auto dl1 = builder2.Build();
+
+  DisplayListBuilder builder3;
+  builder3.setAntiAlias(true);
+  builder3.drawRect({10, 10, 20, 20});
+  auto dl2 = builder3.Build();
+
+  EXPECT_TRUE(dl1->Equals(*dl2));
+}
+
 TEST(DisplayList, FullRotationsAreNop) {
   DisplayListBuilder builder;
   builder.rotate(0);
@@ -834,6 +877,28 @@ TEST(DisplayList, SaveLayerNoAttributesSupportsOpacityOptimization) {
   EXPECT_EQ(expector.save_layer_count(), 1);
 }
 
+TEST(DisplayList, SaveLayerAcrossStoragePagesSupportsOpacityOptimization) {
+  SaveLayerOptions expected =
+      SaveLayerOptions::kNoAttributes.with_can_distribute_opacity();
+  SaveLayerOptionsExpector expector(expected);
+
+  DisplayListBuilder builder;
+  // Fill most of the first storage page so that the saveLayer record and
+  // its matching restore land on different pages.
+  for (size_t i = 0; i < DlStorage::kPageSize / 32; i++) {
+    builder.translate(1, 1);
+  }
+  builder.saveLayer(nullptr, false);
+  builder.drawRect({10, 10, 20, 20});
+  for (size_t i = 0; i < DlStorage::kPageSize / 32; i++) {
+    builder.translate(1, 1);
+  }
+  builder.restore();
+
+  builder.Build()->Dispatch(expector);
+  EXPECT_EQ(expector.save_layer_count(), 1);
+}
+
 TEST(DisplayList, SaveLayerTwoOverlappingOpsPreventsOpacityOptimization) {
   SaveLayerOptions expected = SaveLayerOptions::kWithAttributes;
   SaveLayerOptionsExpector expector(expected);
@@ -2251,5 +2316,207 @@ TEST(DisplayList, RTreeOfClippedSaveLayerFilterScene) {
   test_rtree(rtree, {19, 19, 51, 51}, rects, {0, 1});
 }
 
+class DrawRectRecorder : public virtual Dispatcher,
+                         public IgnoreAttributeDispatchHelper,
+                         public IgnoreClipDispatchHelper,
+                         public IgnoreTransformDispatchHelper,
+                         public IgnoreDrawDispatchHelper {
+ public:
+  void save() override { save_count_++; }
+  void restore() override { restore_count_++; }
+  void translate(SkScalar tx, SkScalar ty) override { translate_count_++; }
+  void drawRect(const SkRect& rect) override { rects_.push_back(rect); }
+
+  const std::vector<SkRect>& rects() const { return rects_; }
+  int save_count() const { return save_count_; }
+  int restore_count() const { return restore_count_; }
+  int translate_count() const { return translate_count_; }
+
+ private:
+  std::vector<SkRect> rects_;
+  int save_count_ = 0;
+  int restore_count_ = 0;
+  int translate_count_ = 0;
+};
+
+TEST(DisplayList, CulledDispatchSkipsRenderingOpsOutsideCullRect) {
+  DisplayListBuilder builder;
+  for (int i = 0; i < 100; i++) {
+    builder.drawRect(SkRect::MakeXYWH(0, i * 20, 100, 10));
+  }
+  auto display_list = builder.Build();
+
+  DrawRectRecorder recorder;
+  display_list->Dispatch(recorder, SkRect::MakeLTRB(0, 205, 100, 245));
+  std::vector<SkRect> expected = {
+      SkRect::MakeXYWH(0, 200, 100, 10),
+      SkRect::MakeXYWH(0, 220, 100, 10),
+      SkRect::MakeXYWH(0, 240, 100, 10),
+  };
+  EXPECT_EQ(recorder.rects(), expected);
+}
+
+TEST(DisplayList, CulledDispatchKeepsStateOps) {
+  DisplayListBuilder builder;
+  for (int i = 0; i < 10; i++) {
+    builder.save();
+    builder.translate(0, i * 20);
+    builder.drawRect(SkRect::MakeWH(100, 10));
+    builder.restore();
+  }
+  auto display_list = builder.Build();
+
+  DrawRectRecorder recorder;
+  display_list->Dispatch(recorder, SkRect::MakeLTRB(0, 45, 100, 55));
+  // Only the third rect (translated to 40..50) intersects the cull rect,
+  // but every save, translate and restore is still dispatched.
+  std::vector<SkRect> expected = {SkRect::MakeWH(100, 10)};
+  EXPECT_EQ(recorder.rects(), expected);
+  EXPECT_EQ(recorder.save_count(), 10);
+  EXPECT_EQ(recorder.translate_count(), 10);
+  EXPECT_EQ(recorder.restore_count(), 10);
+}
+
+TEST(DisplayList, CulledDispatchWithCoveringCullRectDispatchesEverything) {
+  DisplayListBuilder builder;
+  for (int i = 0; i < 10; i++) {
+    builder.drawRect(SkRect::MakeXYWH(i * 20, 0, 10, 10));
+  }
+  auto display_list = builder.Build();
+
+  DrawRectRecorder recorder;
+  display_list->Dispatch(recorder, SkRect::MakeLTRB(-10, -10, 500, 500));
+  EXPECT_EQ(recorder.rects().size(), 10u);
+
+  DrawRectRecorder empty_recorder;
+  display_list->Dispatch(empty_recorder, SkRect::MakeEmpty());
+  EXPECT_EQ(empty_recorder.rects().size(), 0u);
+}
+
+TEST(DisplayList, CulledDispatchAccountsForSaveLayerFilters) {
+  DisplayListBuilder builder;
+  auto filter = DlBlurImageFilter(10.0, 10.0, DlTileMode::kDecal);
+  DlPaint filter_paint = DlPaint().setImageFilter(&filter);
+  builder.saveLayer(nullptr, &filter_paint);
+  builder.drawRect({100, 100, 110, 110});
+  builder.restore();
+  builder.drawRect({300, 300, 310, 310});
+  auto display_list = builder.Build();
+
+  // The blur spreads the first rect beyond its own bounds and into the
+  // cull rect, so it must still be dispatched.
+  DrawRectRecorder recorder;
+  display_list->Dispatch(recorder, SkRect::MakeLTRB(112, 112, 120, 120));
+  std::vector<SkRect> expected = {{100, 100, 110, 110}};
+  EXPECT_EQ(recorder.rects(), expected);
+}
+
+static sk_sp<DisplayList> BuildRectGrid(int count, SkColor color) {
+  DisplayListBuilder builder;
+  builder.setColor(color);
+  for (int i = 0; i < count; i++) {
+    builder.drawRect(SkRect::MakeXYWH((i % 10) * 10, (i / 10) * 10, 8, 8));
+  }
+  return builder.Build();
+}
+
+TEST(DisplayList, EqualDisplayListsHaveEqualContentHash) {
+  auto dl1 = BuildRectGrid(50, SK_ColorRED);
+  auto dl2 = BuildRectGrid(50, SK_ColorRED);
+  auto dl3 = BuildRectGrid(50, SK_ColorBLUE);
+  ASSERT_NE(dl1.get(), dl2.get());
+  EXPECT_EQ(dl1->content_hash(), dl2->content_hash());
+  EXPECT_NE(dl1->content_hash(), dl3->content_hash());
+}
+
+TEST(DisplayListReuseCache, ReusesEqualDisplayList) {
+  DisplayListReuseCache cache;
+  auto first = BuildRectGrid(50, SK_ColorRED);
+  ASSERT_EQ(cache.Reuse(first), first);
+
+  auto second = BuildRectGrid(50, SK_ColorRED);
+  auto reused = cache.Reuse(second);
+  EXPECT_EQ(reused, first);
+  EXPECT_EQ(reused->unique_id(), first->unique_id());
+  EXPECT_EQ(cache.hit_count(), 1u);
+
+  auto different = BuildRectGrid(50, SK_ColorBLUE);
+  EXPECT_EQ(cache.Reuse(different), different);
+  EXPECT_EQ(cache.size(), 2u);
+}
+
+TEST(DisplayListReuseCache, ReusesDisplayListsDrawingReusedDisplayLists) {
+  DisplayListReuseCache cache(DisplayListReuseCache::kDefaultMaxBytes,
+                              /*min_bytes=*/0);
+  auto build_outer = [&cache]() {
+    DisplayListBuilder builder;
+    builder.drawDisplayList(cache.Reuse(BuildRectGrid(50, SK_ColorRED)));
+    builder.drawRect(SkRect::MakeWH(5, 5));
+    return cache.Reuse(builder.Build());
+  };
+  auto first = build_outer();
+  auto second = build_outer();
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(cache.hit_count(), 2u);
+}
+
+TEST(DisplayListReuseCache, SmallDisplayListsAreNotCached) {
+  DisplayListReuseCache cache;
+  auto small = BuildRectGrid(1, SK_ColorRED);
+  EXPECT_EQ(cache.Reuse(small), small);
+  EXPECT_NE(cache.Reuse(BuildRectGrid(1, SK_ColorRED)), small);
+  EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST(DisplayListReuseCache, DisplayListsWithReferencesAreNotCached) {
+  DisplayListReuseCache cache(DisplayListReuseCache::kDefaultMaxBytes,
+                              /*min_bytes=*/0);
+  auto build_path_grid = []() {
+    DisplayListBuilder builder;
+    for (int i = 0; i < 50; i++) {
+      SkPath path;
+      path.addRect(SkRect::MakeXYWH((i % 10) * 10, (i / 10) * 10, 8, 8));
+      builder.drawPath(path);
+    }
+    return builder.Build();
+  };
+  auto paths = build_path_grid();
+  EXPECT_FALSE(paths->has_stable_content_hash());
+  EXPECT_EQ(cache.Reuse(paths), paths);
+  EXPECT_EQ(cache.size(), 0u);
+
+  // A DisplayList drawing one that is not cached can't be found either.
+  DisplayListBuilder builder;
+  builder.drawDisplayList(paths);
+  EXPECT_FALSE(builder.Build()->has_stable_content_hash());
+  EXPECT_TRUE(BuildRectGrid(50, SK_ColorRED)->has_stable_content_hash());
+}
+
+TEST(DisplayListReuseCache, ClearReleasesDisplayLists) {
+  DisplayListReuseCache cache;
+  auto first = cache.Reuse(BuildRectGrid(50, SK_ColorRED));
+  EXPECT_EQ(cache.bytes(), first->bytes());
+  cache.Clear();
+  EXPECT_EQ(cache.size(), 0u);
+  EXPECT_EQ(cache.bytes(), 0u);
+  EXPECT_NE(cache.Reuse(BuildRectGrid(50, SK_ColorRED)), first);
+}
+
+TEST(DisplayListReuseCache, EvictsLeastRecentlyUsed) {
+  // Room for two of the grids, which all have the same size.
+  DisplayListReuseCache cache(
+      /*max_bytes=*/BuildRectGrid(50, SK_ColorRED)->bytes() * 2,
+      /*min_bytes=*/0);
+  auto red = cache.Reuse(BuildRectGrid(50, SK_ColorRED));
+  auto green = cache.Reuse(BuildRectGrid(50, SK_ColorGREEN));
+  // Touch red so that green is the least recently used.
+  EXPECT_EQ(cache.Reuse(BuildRectGrid(50, SK_ColorRED)), red);
+  cache.Reuse(BuildRectGrid(50, SK_ColorBLUE));
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_EQ(cache.bytes(), red->bytes() * 2);
+  EXPECT_EQ(cache.Reuse(BuildRectGrid(50, SK_ColorRED)), red);
+  EXPECT_NE(cache.Reuse(BuildRectGrid(50, SK_ColorGREEN)), green);
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -328,6 +328,7 @@ SkRect RectBoundsAccumulator::AccumulationRect::bounds() const {
 void RTreeBoundsAccumulator::accumulate(const SkRect& r) {
   if (r.fLeft < r.fRight && r.fTop < r.fBottom) {
     rects_.push_back(r);
+    op_offsets_.push_back(op_offset_);
   }
 }
 bool RTreeBoundsAccumulator::is_empty() const {
@@ -363,10 +364,12 @@ bool RTreeBoundsAccumulator::restore(
       success = false;
     }
     if (clip == nullptr || original.intersect(*clip)) {
+      op_offsets_[previous_size] = op_offsets_[i];
       rects_[previous_size++] = original;
     }
   }
   rects_.resize(previous_size);
+  op_offsets_.resize(previous_size);
   return success;
 }
 sk_sp<DlRTree> RTreeBoundsAccumulator::rtree() const {
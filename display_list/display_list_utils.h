@@ -466,13 +466,24 @@ class RTreeBoundsAccumulator final : public virtual BoundsAccumulator {
 
   sk_sp<DlRTree> rtree() const;
 
+  // Sets the byte offset of the DisplayList record that is responsible
+  // for any rects accumulated from now on so that each rect in the
+  // resulting rtree can be traced back to the record that drew it.
+  void set_op_offset(size_t op_offset) { op_offset_ = op_offset; }
+
+  // The record offset for each rect in the rtree, indexed by the values
+  // returned from |DlRTree::search|.
+  const std::vector<size_t>& op_offsets() const { return op_offsets_; }
+
   BoundsAccumulatorType type() const override {
     return BoundsAccumulatorType::kRTree;
   }
 
  private:
   std::vector<SkRect> rects_;
+  std::vector<size_t> op_offsets_;
   std::vector<size_t> saved_offsets_;
+  size_t op_offset_ = 0;
 };
 
 // This class implements all rendering methods and computes a liberal
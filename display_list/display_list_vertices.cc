@@ -85,6 +85,55 @@ size_t DlVertices::size() const {
                       index_count_);
 }
 
+bool DlVertices::IsValid(size_t byte_count) const {
+  if (byte_count < sizeof(DlVertices)) {
+    return false;
+  }
+  switch (mode_) {
+    case DlVertexMode::kTriangles:
+    case DlVertexMode::kTriangleStrip:
+    case DlVertexMode::kTriangleFan:
+      break;
+    default:
+      return false;
+  }
+  if (vertex_count_ < 0 || index_count_ < 0) {
+    return false;
+  }
+
+  // An array that is present must hold |count| elements between the end of
+  // the object and |byte_count|, at an offset aligned for its elements.
+  auto array_fits = [byte_count](size_t offset, size_t element_size,
+                                 size_t alignment, int count) {
+    if (offset == 0) {
+      return true;
+    }
+    return offset >= sizeof(DlVertices) && offset <= byte_count &&
+           offset % alignment == 0 &&
+           static_cast<size_t>(count) <= (byte_count - offset) / element_size;
+  };
+  if ((vertex_count_ > 0) != (vertices_offset_ > 0) ||
+      (index_count_ > 0) != (indices_offset_ > 0) ||
+      !array_fits(vertices_offset_, sizeof(SkPoint), alignof(SkPoint),
+                  vertex_count_) ||
+      !array_fits(texture_coordinates_offset_, sizeof(SkPoint),
+                  alignof(SkPoint), vertex_count_) ||
+      !array_fits(colors_offset_, sizeof(DlColor), alignof(DlColor),
+                  vertex_count_) ||
+      !array_fits(indices_offset_, sizeof(uint16_t), alignof(uint16_t),
+                  index_count_)) {
+    return false;
+  }
+
+  const uint16_t* vertex_indices = indices();
+  for (int i = 0; i < index_count_; i++) {
+    if (vertex_indices[i] >= vertex_count_) {
+      return false;
+    }
+  }
+  return size() <= byte_count;
+}
+
 static SkRect compute_bounds(const SkPoint* points, int count) {
   RectBoundsAccumulator accumulator;
   for (int i = 0; i < count; i++) {
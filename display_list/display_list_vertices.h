@@ -195,6 +195,13 @@ class DlVertices {
   /// Returns the size of the object including all of the inlined data.
   size_t size() const;
 
+  /// Returns true if the mode, the counts and the offsets of the inlined
+  /// arrays are consistent, the arrays lie within the first |byte_count|
+  /// bytes of the object and the indices refer to existing vertices.
+  /// Used to check vertices that were read from untrusted data before
+  /// they are dispatched.
+  bool IsValid(size_t byte_count) const;
+
   /// Returns the bounds of the vertices.
   SkRect bounds() const { return bounds_; }
 
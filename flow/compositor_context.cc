@@ -8,6 +8,7 @@
 #include <utility>
 #include "flutter/flow/layers/layer_tree.h"
 #include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkPath.h"
 
 namespace flutter {
 
@@ -41,7 +42,7 @@ std::optional<SkRect> FrameDamage::ComputeClipRect(
 
     damage_ =
         context.ComputeDamage(additional_damage_, horizontal_clip_alignment_,
-                              vertical_clip_alignment_);
+                              vertical_clip_alignment_, merge_policy_);
     return SkRect::Make(damage_->buffer_damage);
   } else {
     return std::nullopt;
@@ -153,6 +154,15 @@ RasterStatus CompositorContext::ScopedFrame::Raster(
   if (canvas()) {
     if (clip_rect) {
       canvas()->clipRect(*clip_rect);
+      std::vector<SkIRect> damage_rects = frame_damage->GetBufferDamageRects();
+      if (damage_rects.size() > 1) {
+        // Only paint the damaged rects, not the space between them.
+        SkPath damage_path;
+        for (const auto& rect : damage_rects) {
+          damage_path.addRect(SkRect::Make(rect));
+        }
+        canvas()->clipPath(damage_path);
+      }
     }
 
     if (needs_save_layer) {
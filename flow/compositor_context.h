@@ -14,6 +14,7 @@
 #include "flutter/flow/instrumentation.h"
 #include "flutter/flow/layer_snapshot_store.h"
 #include "flutter/flow/raster_cache.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/raster_thread_merger.h"
 #include "third_party/skia/include/core/SkCanvas.h"
@@ -67,7 +68,7 @@ class FrameDamage {
   // Adds additional damage (accumulated for double / triple buffering).
   // This is area that will be repainted alongside any changed part.
   void AddAdditionalDamage(const SkIRect& damage) {
-    additional_damage_.join(damage);
+    additional_damage_.push_back(damage);
   }
 
   // Specifies clip rect alignment.
@@ -76,6 +77,13 @@ class FrameDamage {
     vertical_clip_alignment_ = vertical;
   }
 
+  // Specifies how damaged areas are merged into the rects returned by
+  // GetFrameDamageRects and GetBufferDamageRects. By default damage is a
+  // single rect.
+  void SetMergePolicy(const DamageMergePolicy& merge_policy) {
+    merge_policy_ = merge_policy;
+  }
+
   // Calculates clip rect for current rasterization. This is diff of layer tree
   // and previous layer tree + any additional provided damage.
   // If previous layer tree is not specified, clip rect will be nullopt,
@@ -94,9 +102,20 @@ class FrameDamage {
     return damage_ ? std::make_optional(damage_->buffer_damage) : std::nullopt;
   }
 
+  // See Damage::frame_damage_rects.
+  std::vector<SkIRect> GetFrameDamageRects() const {
+    return damage_ ? damage_->frame_damage_rects : std::vector<SkIRect>();
+  }
+
+  // See Damage::buffer_damage_rects.
+  std::vector<SkIRect> GetBufferDamageRects() const {
+    return damage_ ? damage_->buffer_damage_rects : std::vector<SkIRect>();
+  }
+
  private:
-  SkIRect additional_damage_ = SkIRect::MakeEmpty();
+  std::vector<SkIRect> additional_damage_;
   std::optional<Damage> damage_;
+  DamageMergePolicy merge_policy_;
   const LayerTree* prev_layer_tree_ = nullptr;
   int vertical_clip_alignment_ = 1;
   int horizontal_clip_alignment_ = 1;
@@ -191,12 +210,33 @@ class CompositorContext {
 
   LayerSnapshotStore& snapshot_store() { return layer_snapshot_store_; }
 
+  // Sets the task runner used to paint independent layer subtrees
+  // concurrently, and the number of workers it runs tasks on. Subtrees are
+  // painted on the raster thread only if no task runner is set.
+  void SetConcurrentPaintTaskRunner(
+      std::shared_ptr<fml::ConcurrentTaskRunner> task_runner,
+      size_t worker_count) {
+    concurrent_paint_task_runner_ = std::move(task_runner);
+    concurrent_paint_worker_count_ = worker_count;
+  }
+
+  const std::shared_ptr<fml::ConcurrentTaskRunner>&
+  concurrent_paint_task_runner() const {
+    return concurrent_paint_task_runner_;
+  }
+
+  size_t concurrent_paint_worker_count() const {
+    return concurrent_paint_worker_count_;
+  }
+
  private:
   RasterCache raster_cache_;
   std::shared_ptr<TextureRegistry> texture_registry_;
   Stopwatch raster_time_;
   Stopwatch ui_time_;
   LayerSnapshotStore layer_snapshot_store_;
+  std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_paint_task_runner_;
+  size_t concurrent_paint_worker_count_ = 0;
 
   /// Only used by default constructor of `CompositorContext`.
   FixedRefreshRateUpdater fixed_refresh_rate_updater_;
@@ -3,6 +3,10 @@
 // found in the LICENSE file.
 
 #include "flutter/flow/diff_context.h"
+
+#include <algorithm>
+#include <limits>
+
 #include "flutter/flow/layers/layer.h"
 
 namespace flutter {
@@ -94,37 +98,157 @@ void DiffContext::AlignRect(SkIRect& rect,
   rect = SkIRect::MakeLTRB(left, top, right, bottom);
 }
 
-Damage DiffContext::ComputeDamage(const SkIRect& accumulated_buffer_damage,
-                                  int horizontal_clip_alignment,
-                                  int vertical_clip_alignment) const {
-  SkRect buffer_damage = SkRect::Make(accumulated_buffer_damage);
-  buffer_damage.join(damage_);
-  SkRect frame_damage(damage_);
+namespace {
 
-  for (const auto& r : readbacks_) {
-    SkRect rect = SkRect::Make(r.rect);
-    if (rect.intersects(frame_damage)) {
-      frame_damage.join(rect);
+// Merging damage rects is quadratic in the number of rects. Beyond this number
+// of rects, only overlapping rects are combined before giving up and using
+// the bounds of the damage.
+constexpr size_t kMaxRectsForPairwiseMerge = 64;
+
+int64_t Area(const SkIRect& rect) {
+  return static_cast<int64_t>(rect.width()) * rect.height();
+}
+
+SkIRect ComputeBounds(const std::vector<SkIRect>& rects) {
+  SkIRect bounds = SkIRect::MakeEmpty();
+  for (const auto& rect : rects) {
+    bounds.join(rect);
+  }
+  return bounds;
+}
+
+}  // namespace
+
+void DiffContext::MergeDamageRects(
+    std::vector<SkIRect>& rects,
+    const DamageMergePolicy& merge_policy) const {
+  SkIRect frame_clip = SkIRect::MakeSize(frame_size_);
+  size_t count = 0;
+  for (auto rect : rects) {
+    if (rect.intersect(frame_clip)) {
+      rects[count++] = rect;
     }
-    if (rect.intersects(buffer_damage)) {
-      buffer_damage.join(rect);
+  }
+  rects.resize(count);
+
+  if (rects.size() > kMaxRectsForPairwiseMerge && merge_policy.max_rects > 1) {
+    // Fold each rect into the first rect it overlaps with. Damage often
+    // consists of many overlapping rects of nested layers.
+    std::vector<SkIRect> folded;
+    for (const auto& rect : rects) {
+      auto overlapping =
+          std::find_if(folded.begin(), folded.end(), [&](const SkIRect& r) {
+            return SkIRect::Intersects(r, rect);
+          });
+      if (overlapping == folded.end()) {
+        folded.push_back(rect);
+      } else {
+        overlapping->join(rect);
+      }
     }
+    rects.swap(folded);
   }
 
-  Damage res;
-  buffer_damage.roundOut(&res.buffer_damage);
-  frame_damage.roundOut(&res.frame_damage);
+  if (rects.size() > 1 && (merge_policy.max_rects <= 1 ||
+                           rects.size() > kMaxRectsForPairwiseMerge)) {
+    rects = {ComputeBounds(rects)};
+    return;
+  }
 
-  SkIRect frame_clip = SkIRect::MakeSize(frame_size_);
-  res.buffer_damage.intersect(frame_clip);
-  res.frame_damage.intersect(frame_clip);
+  for (;;) {
+    size_t merge_first = 0;
+    size_t merge_second = 0;
+    int64_t merge_cost = std::numeric_limits<int64_t>::max();
+    bool must_merge = false;
+    for (size_t i = 0; i < rects.size() && !must_merge; ++i) {
+      for (size_t j = i + 1; j < rects.size(); ++j) {
+        SkIRect bounds = rects[i];
+        bounds.join(rects[j]);
+        SkIRect overlap;
+        bool overlaps = overlap.intersect(rects[i], rects[j]);
+        int64_t covered = Area(rects[i]) + Area(rects[j]) -
+                          (overlaps ? Area(overlap) : 0);
+        int64_t cost = Area(bounds) - covered;
+        if (overlaps || cost <= covered * merge_policy.max_merge_overhead) {
+          merge_first = i;
+          merge_second = j;
+          must_merge = true;
+          break;
+        }
+        if (cost < merge_cost) {
+          merge_first = i;
+          merge_second = j;
+          merge_cost = cost;
+        }
+      }
+    }
+    if (!must_merge && rects.size() <= merge_policy.max_rects) {
+      break;
+    }
+    rects[merge_first].join(rects[merge_second]);
+    rects.erase(rects.begin() + merge_second);
+  }
+}
+
+std::vector<SkIRect> DiffContext::FinalizeDamage(
+    std::vector<SkIRect> rects,
+    int horizontal_clip_alignment,
+    int vertical_clip_alignment,
+    const DamageMergePolicy& merge_policy) const {
+  MergeDamageRects(rects, merge_policy);
+
+  for (const auto& r : readbacks_) {
+    bool intersects =
+        std::any_of(rects.begin(), rects.end(), [&](const SkIRect& rect) {
+          return SkIRect::Intersects(rect, r.rect);
+        });
+    if (intersects) {
+      rects.push_back(r.rect);
+      MergeDamageRects(rects, merge_policy);
+    }
+  }
 
   if (horizontal_clip_alignment > 1 || vertical_clip_alignment > 1) {
-    AlignRect(res.buffer_damage, horizontal_clip_alignment,
-              vertical_clip_alignment);
-    AlignRect(res.frame_damage, horizontal_clip_alignment,
-              vertical_clip_alignment);
+    for (auto& rect : rects) {
+      AlignRect(rect, horizontal_clip_alignment, vertical_clip_alignment);
+    }
+    // Aligned rects may overlap.
+    MergeDamageRects(rects, merge_policy);
+  }
+  return rects;
+}
+
+Damage DiffContext::ComputeDamage(const SkIRect& accumulated_buffer_damage,
+                                  int horizontal_clip_alignment,
+                                  int vertical_clip_alignment) const {
+  return ComputeDamage(std::vector<SkIRect>{accumulated_buffer_damage},
+                       horizontal_clip_alignment, vertical_clip_alignment,
+                       DamageMergePolicy());
+}
+
+Damage DiffContext::ComputeDamage(
+    const std::vector<SkIRect>& accumulated_buffer_damage,
+    int horizontal_clip_alignment,
+    int vertical_clip_alignment,
+    const DamageMergePolicy& merge_policy) const {
+  std::vector<SkIRect> frame_damage;
+  frame_damage.reserve(damage_.size());
+  for (const auto& rect : damage_) {
+    frame_damage.push_back(rect.roundOut());
   }
+  std::vector<SkIRect> buffer_damage(frame_damage);
+  buffer_damage.insert(buffer_damage.end(), accumulated_buffer_damage.begin(),
+                       accumulated_buffer_damage.end());
+
+  Damage res;
+  res.frame_damage_rects =
+      FinalizeDamage(std::move(frame_damage), horizontal_clip_alignment,
+                     vertical_clip_alignment, merge_policy);
+  res.buffer_damage_rects =
+      FinalizeDamage(std::move(buffer_damage), horizontal_clip_alignment,
+                     vertical_clip_alignment, merge_policy);
+  res.frame_damage = ComputeBounds(res.frame_damage_rects);
+  res.buffer_damage = ComputeBounds(res.buffer_damage_rects);
   return res;
 }
 
@@ -215,13 +339,11 @@ PaintRegion DiffContext::CurrentSubtreeRegion() const {
 
 void DiffContext::AddDamage(const PaintRegion& damage) {
   FML_DCHECK(damage.is_valid());
-  for (const auto& r : damage) {
-    damage_.join(r);
-  }
+  damage_.insert(damage_.end(), damage.begin(), damage.end());
 }
 
 void DiffContext::AddDamage(const SkRect& rect) {
-  damage_.join(rect);
+  damage_.push_back(rect);
 }
 
 void DiffContext::SetLayerPaintRegion(const Layer* layer,
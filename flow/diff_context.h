@@ -34,6 +34,32 @@ struct Damage {
   // upfront may be useful for tile based GPUs.
   // Corresponds to "buffer damage" from EGL_KHR_partial_update.
   SkIRect buffer_damage;
+
+  // frame_damage as a list of disjoint rects, the bounds of which are
+  // frame_damage. The number of rects is limited by
+  // DamageMergePolicy::max_rects. Empty if there is no frame damage.
+  std::vector<SkIRect> frame_damage_rects;
+
+  // buffer_damage as a list of disjoint rects, the bounds of which are
+  // buffer_damage. The number of rects is limited by
+  // DamageMergePolicy::max_rects. Empty if there is no buffer damage.
+  std::vector<SkIRect> buffer_damage_rects;
+};
+
+// Controls how DiffContext::ComputeDamage combines damaged areas into the
+// rects of Damage::frame_damage_rects and Damage::buffer_damage_rects.
+struct DamageMergePolicy {
+  // The maximum number of rects that damage can be split into. Rects are
+  // merged, cheapest first, until no more than this many remain. A value of 1
+  // always produces the single bounding rect of the damage.
+  size_t max_rects = 1;
+
+  // Two rects are merged even if max_rects has not been reached when their
+  // bounding rect covers no more than this fraction of extra area compared to
+  // the area covered by the two rects. Each rect has a fixed cost for the
+  // compositor, so there is no point in keeping rects that are close to each
+  // other apart.
+  double max_merge_overhead = 0.25;
 };
 
 // Layer Unique Id to PaintRegion
@@ -141,6 +167,16 @@ class DiffContext {
                        int horizontal_clip_alignment = 0,
                        int vertical_clip_alignment = 0) const;
 
+  // Computes final damage split into disjoint rects according to
+  // merge_policy.
+  //
+  // additional_damage are the rects of previously accumulated frame_damage
+  // for current framebuffer.
+  Damage ComputeDamage(const std::vector<SkIRect>& additional_damage,
+                       int horizontal_clip_alignment,
+                       int vertical_clip_alignment,
+                       const DamageMergePolicy& merge_policy) const;
+
   double frame_device_pixel_ratio() const { return frame_device_pixel_ratio_; };
 
   // Adds the region to current damage. Used for removed layers, where instead
@@ -234,7 +270,8 @@ class DiffContext {
   // Rect must be in device coordinates.
   SkRect ApplyFilterBoundsAdjustment(SkRect rect) const;
 
-  SkRect damage_ = SkRect::MakeEmpty();
+  // Damaged areas in screen coordinates, in the order they were added.
+  std::vector<SkRect> damage_;
 
   PaintRegionMap& this_frame_paint_region_map_;
   const PaintRegionMap& last_frame_paint_region_map_;
@@ -246,6 +283,19 @@ class DiffContext {
                  int horizontal_alignment,
                  int vertical_clip_alignment) const;
 
+  // Clips rects to the frame, drops empty rects and merges the remaining
+  // ones until they are disjoint and there are no more than
+  // merge_policy.max_rects of them.
+  void MergeDamageRects(std::vector<SkIRect>& rects,
+                        const DamageMergePolicy& merge_policy) const;
+
+  // Extends damage by the readback regions it intersects, aligns it and
+  // merges it according to merge_policy.
+  std::vector<SkIRect> FinalizeDamage(std::vector<SkIRect> rects,
+                                      int horizontal_clip_alignment,
+                                      int vertical_clip_alignment,
+                                      const DamageMergePolicy& merge_policy) const;
+
   struct Readback {
     // Index of rects_ entry that this readback belongs to. Used to
     // determine if subtree has any readback
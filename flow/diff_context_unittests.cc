@@ -32,5 +32,113 @@ TEST_F(DiffContextTest, ClipAlignment) {
   EXPECT_EQ(damage.buffer_damage, SkIRect::MakeLTRB(16, 16, 64, 64));
 }
 
+TEST_F(DiffContextTest, SingleDamageRectByDefault) {
+  MockLayerTree t1;
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(10, 10, 50, 50), 1)));
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(900, 900, 950, 950), 1)));
+  auto damage = DiffLayerTree(t1, MockLayerTree());
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(10, 10, 950, 950));
+  EXPECT_EQ(damage.frame_damage_rects,
+            std::vector<SkIRect>{SkIRect::MakeLTRB(10, 10, 950, 950)});
+  EXPECT_EQ(damage.buffer_damage_rects,
+            std::vector<SkIRect>{SkIRect::MakeLTRB(10, 10, 950, 950)});
+}
+
+TEST_F(DiffContextTest, DistantDamageIsKeptApart) {
+  MockLayerTree t1;
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(10, 10, 50, 50), 1)));
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(900, 900, 950, 950), 1)));
+  DamageMergePolicy policy;
+  policy.max_rects = 4;
+  auto damage = DiffLayerTree(t1, MockLayerTree(), SkIRect::MakeEmpty(), 0, 0,
+                              true, policy);
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(10, 10, 950, 950));
+  std::vector<SkIRect> expected = {SkIRect::MakeLTRB(10, 10, 50, 50),
+                                   SkIRect::MakeLTRB(900, 900, 950, 950)};
+  EXPECT_EQ(damage.frame_damage_rects, expected);
+  EXPECT_EQ(damage.buffer_damage_rects, expected);
+}
+
+TEST_F(DiffContextTest, OverlappingAndAdjacentDamageIsMerged) {
+  MockLayerTree t1;
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(10, 10, 50, 50), 1)));
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(40, 40, 80, 80), 1)));
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(500, 10, 550, 50), 1)));
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(550, 10, 600, 50), 1)));
+  DamageMergePolicy policy;
+  policy.max_rects = 4;
+  auto damage = DiffLayerTree(t1, MockLayerTree(), SkIRect::MakeEmpty(), 0, 0,
+                              true, policy);
+  std::vector<SkIRect> expected = {SkIRect::MakeLTRB(10, 10, 80, 80),
+                                   SkIRect::MakeLTRB(500, 10, 600, 50)};
+  EXPECT_EQ(damage.frame_damage_rects, expected);
+}
+
+TEST_F(DiffContextTest, DamageRectCountIsLimited) {
+  MockLayerTree t1;
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(10, 10, 20, 20), 1)));
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(100, 10, 110, 20), 1)));
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(900, 900, 910, 910), 1)));
+  DamageMergePolicy policy;
+  policy.max_rects = 2;
+  auto damage = DiffLayerTree(t1, MockLayerTree(), SkIRect::MakeEmpty(), 0, 0,
+                              true, policy);
+  // The two rects closest to each other are merged.
+  std::vector<SkIRect> expected = {SkIRect::MakeLTRB(10, 10, 110, 20),
+                                   SkIRect::MakeLTRB(900, 900, 910, 910)};
+  EXPECT_EQ(damage.frame_damage_rects, expected);
+}
+
+TEST_F(DiffContextTest, AdditionalDamageIsOnlyInBufferDamage) {
+  MockLayerTree t1;
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(10, 10, 50, 50), 1)));
+  DamageMergePolicy policy;
+  policy.max_rects = 4;
+  auto damage =
+      DiffLayerTree(t1, MockLayerTree(), SkIRect::MakeLTRB(900, 900, 950, 950),
+                    0, 0, true, policy);
+  EXPECT_EQ(damage.frame_damage_rects,
+            std::vector<SkIRect>{SkIRect::MakeLTRB(10, 10, 50, 50)});
+  std::vector<SkIRect> expected = {SkIRect::MakeLTRB(10, 10, 50, 50),
+                                   SkIRect::MakeLTRB(900, 900, 950, 950)};
+  EXPECT_EQ(damage.buffer_damage_rects, expected);
+  EXPECT_EQ(damage.buffer_damage, SkIRect::MakeLTRB(10, 10, 950, 950));
+}
+
+TEST_F(DiffContextTest, AlignedDamageRectsAreDisjoint) {
+  MockLayerTree t1;
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(10, 10, 20, 20), 1)));
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(40, 40, 50, 50), 1)));
+  DamageMergePolicy policy;
+  policy.max_rects = 4;
+  policy.max_merge_overhead = 0;
+  auto damage = DiffLayerTree(t1, MockLayerTree(), SkIRect::MakeEmpty(), 64,
+                              64, true, policy);
+  EXPECT_EQ(damage.frame_damage_rects,
+            std::vector<SkIRect>{SkIRect::MakeLTRB(0, 0, 64, 64)});
+}
+
+TEST_F(DiffContextTest, NoDamageProducesNoRects) {
+  MockLayerTree t1;
+  auto damage = DiffLayerTree(t1, MockLayerTree());
+  EXPECT_TRUE(damage.frame_damage.isEmpty());
+  EXPECT_TRUE(damage.frame_damage_rects.empty());
+  EXPECT_TRUE(damage.buffer_damage_rects.empty());
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -4,8 +4,12 @@
 
 #include "flutter/flow/layers/container_layer.h"
 
+#include <atomic>
 #include <optional>
 
+#include "flutter/display_list/display_list_canvas_recorder.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+
 namespace flutter {
 
 ContainerLayer::ContainerLayer() : child_paint_bounds_(SkRect::MakeEmpty()) {}
@@ -135,6 +139,7 @@ void ContainerLayer::PrerollChildren(PrerollContext* context,
 
   bool child_has_platform_view = false;
   bool child_has_texture_layer = false;
+  bool child_needs_readback = false;
   bool all_renderable_state_flags = LayerStateStack::kCallerCanApplyAnything;
 
   for (auto& layer : layers_) {
@@ -148,8 +153,20 @@ void ContainerLayer::PrerollChildren(PrerollContext* context,
     // opt-in to applying state attributes during its |Preroll|
     context->renderable_state_flags = 0;
 
+    // Track readback per child so that each child can be checked for
+    // independence from the content painted before it.
+    bool prev_surface_needs_readback = context->surface_needs_readback;
+    context->surface_needs_readback = false;
+
     layer->Preroll(context);
 
+    layer->set_can_paint_concurrently(!context->has_platform_view &&
+                                      !context->has_texture_layer &&
+                                      !context->surface_needs_readback);
+    child_needs_readback =
+        child_needs_readback || context->surface_needs_readback;
+    context->surface_needs_readback = prev_surface_needs_readback;
+
     all_renderable_state_flags &= context->renderable_state_flags;
     if (safe_intersection_test(child_paint_bounds, layer->paint_bounds())) {
       // This will allow inheritance by a linear sequence of non-overlapping
@@ -167,6 +184,8 @@ void ContainerLayer::PrerollChildren(PrerollContext* context,
 
   context->has_platform_view = child_has_platform_view;
   context->has_texture_layer = child_has_texture_layer;
+  context->surface_needs_readback =
+      context->surface_needs_readback || child_needs_readback;
   context->renderable_state_flags = all_renderable_state_flags;
   set_subtree_has_platform_view(child_has_platform_view);
   set_children_renderable_state_flags(all_renderable_state_flags);
@@ -185,6 +204,10 @@ void ContainerLayer::PaintChildren(PaintContext& context) const {
   auto restore = context.state_stack.applyState(
       child_paint_bounds(), children_renderable_state_flags());
 
+  if (context.concurrent_task_runner && PaintChildrenConcurrently(context)) {
+    return;
+  }
+
   // Intentionally not tracing here as there should be no self-time
   // and the trace event on this common function has a small overhead.
   for (auto& layer : layers_) {
@@ -194,4 +217,142 @@ void ContainerLayer::PaintChildren(PaintContext& context) const {
   }
 }
 
+bool ContainerLayer::PaintChildrenConcurrently(PaintContext& context) const {
+  // Outstanding state attributes would have to be applied to each recorded
+  // child individually, which is not equivalent to applying them to the
+  // group of children. Leaf layer tracing snapshots each leaf on the raster
+  // thread, so it is not supported on the workers either.
+  const LayerStateStack& state_stack = context.state_stack;
+  if (context.enable_leaf_layer_tracing ||
+      state_stack.outstanding_opacity() < SK_Scalar1 ||
+      state_stack.outstanding_color_filter() ||
+      state_stack.outstanding_image_filter()) {
+    return false;
+  }
+
+  std::vector<size_t> indices;
+  for (size_t i = 0; i < layers_.size(); i++) {
+    if (layers_[i]->can_paint_concurrently() &&
+        layers_[i]->needs_painting(context)) {
+      indices.push_back(i);
+    }
+  }
+  if (indices.size() < 2) {
+    return false;
+  }
+
+  TRACE_EVENT0("flutter", "ContainerLayer::PaintChildrenConcurrently");
+
+  // The children are recorded in device space, clipped to the current device
+  // cull rect, so that the recordings can be drawn back with an identity
+  // transform regardless of the state of the canvas they are drawn into.
+  struct RecordState {
+    RecordState(const PaintContext& context, size_t count)
+        : matrix(context.state_stack.transform_4x4()),
+          device_cull_rect(context.state_stack.device_cull_rect()),
+          checkerboard_func(context.state_stack.checkerboard_func()),
+          record_to_canvas(context.builder == nullptr),
+          results(count),
+          latch(count) {}
+
+    const SkM44 matrix;
+    const SkRect device_cull_rect;
+    const CheckerboardFunc checkerboard_func;
+    const bool record_to_canvas;
+    std::vector<const Layer*> layers;
+    std::vector<sk_sp<DisplayList>> results;
+    std::atomic_size_t next_index{0};
+    fml::CountDownLatch latch;
+  };
+
+  auto state = std::make_shared<RecordState>(context, indices.size());
+  for (size_t index : indices) {
+    state->layers.push_back(layers_[index].get());
+  }
+
+  auto record = [&context](RecordState& state, size_t index) {
+    LayerStateStack child_state_stack;
+    child_state_stack.set_checkerboard_func(state.checkerboard_func);
+
+    std::optional<DisplayListCanvasRecorder> recorder;
+    std::optional<DisplayListBuilder> builder;
+    if (state.record_to_canvas) {
+      recorder.emplace(state.device_cull_rect);
+      child_state_stack.set_delegate(static_cast<SkCanvas*>(&*recorder));
+    } else {
+      builder.emplace(state.device_cull_rect);
+      child_state_stack.set_delegate(&*builder);
+    }
+
+    PaintContext child_context = {
+        // clang-format off
+        .state_stack                   = child_state_stack,
+        .canvas                        = recorder ? &*recorder : nullptr,
+        .builder                       = builder ? &*builder : nullptr,
+        .gr_context                    = nullptr,
+        .dst_color_space               = context.dst_color_space,
+        .view_embedder                 = nullptr,
+        .raster_time                   = context.raster_time,
+        .ui_time                       = context.ui_time,
+        .texture_registry              = context.texture_registry,
+        .raster_cache                  = context.raster_cache,
+        .frame_device_pixel_ratio      = context.frame_device_pixel_ratio,
+        .layer_snapshot_store          = nullptr,
+        .enable_leaf_layer_tracing     = false,
+        .aiks_context                  = context.aiks_context,
+        // clang-format on
+    };
+
+    {
+      auto mutator = child_state_stack.save();
+      mutator.clipRect(state.device_cull_rect, false);
+      mutator.transform(state.matrix);
+      const Layer* layer = state.layers[index];
+      if (layer->needs_painting(child_context)) {
+        layer->Paint(child_context);
+      }
+    }
+
+    state.results[index] = recorder ? recorder->Build() : builder->Build();
+  };
+
+  // Workers and the calling thread claim children until none are left. The
+  // |context| referenced by |record| outlives the tasks because this method
+  // waits on the latch before returning.
+  auto drain = [state, record]() {
+    size_t index;
+    while ((index = state->next_index.fetch_add(1)) < state->layers.size()) {
+      record(*state, index);
+      state->latch.CountDown();
+    }
+  };
+  size_t task_count =
+      std::min(indices.size() - 1, context.concurrent_worker_count);
+  for (size_t i = 0; i < task_count; i++) {
+    context.concurrent_task_runner->PostTask(drain);
+  }
+  drain();
+  state->latch.Wait();
+
+  size_t next = 0;
+  for (size_t i = 0; i < layers_.size(); i++) {
+    if (next < indices.size() && indices[next] == i) {
+      const sk_sp<DisplayList>& display_list = state->results[next++];
+      if (context.builder) {
+        context.builder->save();
+        context.builder->transformReset();
+        context.builder->drawDisplayList(display_list);
+        context.builder->restore();
+      } else {
+        SkAutoCanvasRestore save(context.canvas, true);
+        context.canvas->resetMatrix();
+        display_list->RenderTo(context.canvas);
+      }
+    } else if (layers_[i]->needs_painting(context)) {
+      layers_[i]->Paint(context);
+    }
+  }
+  return true;
+}
+
 }  // namespace flutter
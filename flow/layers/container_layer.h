@@ -48,6 +48,13 @@ class ContainerLayer : public Layer {
   void PrerollChildren(PrerollContext* context, SkRect* child_paint_bounds);
 
  private:
+  // Records the children that |can_paint_concurrently| into separate display
+  // lists on the concurrent task runner of the |context| and draws them, in
+  // order with the remaining children, to the canvas or builder of the
+  // |context|. Returns false, without painting anything, if it is not worth
+  // painting the children concurrently.
+  bool PaintChildrenConcurrently(PaintContext& context) const;
+
   std::vector<std::shared_ptr<Layer>> layers_;
   SkRect child_paint_bounds_;
   int children_renderable_state_flags_ = 0;
@@ -9,11 +9,13 @@
 #include "flutter/flow/testing/diff_context_test.h"
 #include "flutter/flow/testing/layer_test.h"
 #include "flutter/flow/testing/mock_layer.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/testing/mock_canvas.h"
 #include "gtest/gtest.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkMatrix.h"
+#include "include/core/SkSurface.h"
 
 namespace flutter {
 namespace testing {
@@ -160,6 +162,110 @@ TEST_F(ContainerLayerTest, Multiple) {
                                                child_path2, child_paint2}}}));
 }
 
+TEST_F(ContainerLayerTest, ConcurrentPaintEligibility) {
+  SkPath child_path;
+  child_path.addRect(5.0f, 6.0f, 20.5f, 21.5f);
+
+  auto plain_layer = MockLayer::Make(child_path);
+  auto readback_layer = MockLayer::Make(child_path);
+  readback_layer->set_fake_reads_surface(true);
+  auto platform_view_layer = MockLayer::Make(child_path);
+  platform_view_layer->set_fake_has_platform_view(true);
+  auto texture_layer = MockLayer::Make(child_path);
+  texture_layer->set_fake_has_texture_layer(true);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(plain_layer);
+  layer->Add(readback_layer);
+  layer->Add(platform_view_layer);
+  layer->Add(texture_layer);
+
+  layer->Preroll(preroll_context());
+  EXPECT_TRUE(plain_layer->can_paint_concurrently());
+  EXPECT_FALSE(readback_layer->can_paint_concurrently());
+  EXPECT_FALSE(platform_view_layer->can_paint_concurrently());
+  EXPECT_FALSE(texture_layer->can_paint_concurrently());
+  EXPECT_TRUE(preroll_context()->surface_needs_readback);
+}
+
+TEST_F(ContainerLayerTest, ConcurrentPaintMatchesSerialPaint) {
+  // Overlapping children of different colors, so that drawing the recorded
+  // children back out of order changes the pixels. The child that reads back
+  // from the surface is painted in place between the recorded ones.
+  auto layer = std::make_shared<ContainerLayer>();
+  for (int i = 0; i < 8; i++) {
+    SkPath child_path;
+    child_path.addRect(10.0f * i, 5.0f * i, 10.0f * i + 40.0f,
+                       5.0f * i + 40.0f);
+    SkPaint child_paint;
+    child_paint.setColor(SkColorSetARGB(0xff, 0x20 * i, 0xff - 0x20 * i, 0x80));
+    auto child = std::make_shared<MockLayer>(child_path, child_paint);
+    child->set_fake_reads_surface(i == 4);
+    layer->Add(child);
+  }
+  SkMatrix transform = SkMatrix::Translate(7.5f, 3.5f);
+  transform.preScale(1.5f, 1.25f);
+
+  preroll_context()->state_stack.set_preroll_delegate(kGiantRect, transform);
+  layer->Preroll(preroll_context());
+
+  auto paint = [this, &layer, &transform](
+                   fml::ConcurrentTaskRunner* task_runner,
+                   size_t worker_count) {
+    DisplayListCanvasRecorder recorder(kGiantRect);
+    LayerStateStack state_stack;
+    state_stack.set_delegate(static_cast<SkCanvas*>(&recorder));
+    PaintContext context{
+        // clang-format off
+        .state_stack                   = state_stack,
+        .canvas                        = &recorder,
+        .gr_context                    = nullptr,
+        .view_embedder                 = nullptr,
+        .raster_time                   = paint_context().raster_time,
+        .ui_time                       = paint_context().ui_time,
+        .texture_registry              = paint_context().texture_registry,
+        .raster_cache                  = nullptr,
+        .frame_device_pixel_ratio      = 1.0f,
+        .concurrent_task_runner        = task_runner,
+        .concurrent_worker_count       = worker_count,
+        // clang-format on
+    };
+    {
+      auto mutator = state_stack.save();
+      mutator.transform(transform);
+      layer->Paint(context);
+    }
+    state_stack.clear_delegate();
+    return recorder.Build();
+  };
+
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  sk_sp<DisplayList> serial = paint(nullptr, 0);
+  sk_sp<DisplayList> concurrent =
+      paint(loop->GetTaskRunner().get(), loop->GetWorkerCount());
+
+  // The recorded children are drawn back as nested display lists.
+  EXPECT_FALSE(concurrent->Equals(serial));
+
+  auto rasterize = [](const sk_sp<DisplayList>& display_list) {
+    sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(200, 100);
+    surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+    display_list->RenderTo(surface->getCanvas());
+    return surface;
+  };
+  sk_sp<SkSurface> serial_surface = rasterize(serial);
+  sk_sp<SkSurface> concurrent_surface = rasterize(concurrent);
+  SkPixmap serial_pixels;
+  SkPixmap concurrent_pixels;
+  ASSERT_TRUE(serial_surface->peekPixels(&serial_pixels));
+  ASSERT_TRUE(concurrent_surface->peekPixels(&concurrent_pixels));
+  for (int y = 0; y < serial_pixels.height(); y++) {
+    for (int x = 0; x < serial_pixels.width(); x++) {
+      ASSERT_EQ(concurrent_pixels.getColor(x, y), serial_pixels.getColor(x, y))
+          << "at " << x << ", " << y;
+    }
+  }
+}
+
 TEST_F(ContainerLayerTest, MultipleWithEmpty) {
   SkPath child_path1;
   child_path1.addRect(5.0f, 6.0f, 20.5f, 21.5f);
@@ -21,7 +21,9 @@ static bool IsDisplayListWorthRasterizing(
     DisplayList* display_list,
     bool will_change,
     bool is_complex,
-    DisplayListComplexityCalculator* complexity_calculator) {
+    DisplayListComplexityCalculator* complexity_calculator,
+    unsigned int* complexity_score) {
+  *complexity_score = 0;
   if (will_change) {
     // If the display list is going to change in the future, there is no point
     // in doing to extra work to rasterize.
@@ -41,8 +43,8 @@ static bool IsDisplayListWorthRasterizing(
     return true;
   }
 
-  unsigned int complexity_score = complexity_calculator->Compute(display_list);
-  return complexity_calculator->ShouldBeCached(complexity_score);
+  *complexity_score = complexity_calculator->Compute(display_list);
+  return complexity_calculator->ShouldBeCached(*complexity_score);
 }
 
 DisplayListRasterCacheItem::DisplayListRasterCacheItem(
@@ -76,7 +78,8 @@ void DisplayListRasterCacheItem::PrerollSetup(PrerollContext* context,
                           : DisplayListComplexityCalculator::GetForSoftware();
 
   if (!IsDisplayListWorthRasterizing(display_list_, will_change_, is_complex_,
-                                     complexity_calculator)) {
+                                     complexity_calculator,
+                                     &complexity_score_)) {
     // We only deal with display lists that are worthy of rasterization.
     return;
   }
@@ -159,12 +162,18 @@ bool DisplayListRasterCacheItem::TryToPrepareRasterCache(
       .matrix             = transformation_matrix_,
       .logical_rect       = bounds,
       .flow_type          = flow_type,
+      .rasterize_cost     = complexity_score_,
       // clang-format on
   };
+  // Display lists are immutable, so they can be rasterized on another
+  // thread as long as the closure holds a reference to them. Images that
+  // live on the GPU can only be drawn on the raster thread, into a surface
+  // of its context.
   return context.raster_cache->UpdateCacheEntry(
       GetId().value(), r_context,
-      [display_list = display_list_](SkCanvas* canvas) {
+      [display_list = sk_ref_sp(display_list_)](SkCanvas* canvas) {
         display_list->RenderTo(canvas);
-      });
+      },
+      /*can_rasterize_async=*/!display_list_->has_gpu_images());
 }
 }  // namespace flutter
@@ -59,6 +59,10 @@ class DisplayListRasterCacheItem : public RasterCacheItem {
   SkPoint offset_;
   bool is_complex_;
   bool will_change_;
+  // The complexity score computed during |PrerollSetup|, used by the raster
+  // cache as the cost of rasterizing this display list again. 0 if the score
+  // was not computed because the display list was hinted to be complex.
+  unsigned int complexity_score_ = 0;
 };
 
 }  // namespace flutter
@@ -20,6 +20,7 @@
 #include "flutter/flow/raster_cache.h"
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/compiler_specific.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/trace_event.h"
@@ -120,6 +121,12 @@ struct PaintContext {
   LayerSnapshotStore* layer_snapshot_store = nullptr;
   bool enable_leaf_layer_tracing = false;
   impeller::AiksContext* aiks_context;
+
+  // Task runner used to record independent child subtrees into separate
+  // display lists concurrently. Children are painted in sequence on the
+  // calling thread when this is null.
+  fml::ConcurrentTaskRunner* concurrent_task_runner = nullptr;
+  size_t concurrent_worker_count = 0;
 };
 
 // Represents a single composited layer. Created on the UI thread but then
@@ -203,6 +210,16 @@ class Layer {
     subtree_has_platform_view_ = value;
   }
 
+  // Whether the subtree rooted at this layer can be recorded on a worker
+  // thread into its own display list, independently of its siblings. This is
+  // determined by the parent during Preroll() and is false for subtrees that
+  // contain platform views or texture layers, or that read back from the
+  // surface they are painted into.
+  bool can_paint_concurrently() const { return can_paint_concurrently_; }
+  void set_can_paint_concurrently(bool value) {
+    can_paint_concurrently_ = value;
+  }
+
   // Returns the paint bounds in the layer's local coordinate system
   // as determined during Preroll().  The bounds should include any
   // transform, clip or distortions performed by the layer itself,
@@ -268,6 +285,7 @@ class Layer {
   uint64_t unique_id_;
   uint64_t original_layer_id_;
   bool subtree_has_platform_view_;
+  bool can_paint_concurrently_ = false;
 
   static uint64_t NextUniqueID();
 
@@ -149,11 +149,16 @@ void LayerTree::Paint(CompositorContext::ScopedFrame& frame,
       .layer_snapshot_store          = snapshot_store,
       .enable_leaf_layer_tracing     = enable_leaf_layer_tracing_,
       .aiks_context                  = frame.aiks_context(),
+      .concurrent_task_runner        =
+          frame.context().concurrent_paint_task_runner().get(),
+      .concurrent_worker_count       =
+          frame.context().concurrent_paint_worker_count(),
       // clang-format on
   };
 
   if (cache) {
     cache->EvictUnusedCacheEntries();
+    cache->CollectAsyncRasterizeResults(frame.gr_context());
     TryToRasterCache(raster_cache_items_, &context, ignore_raster_cache);
   }
 
@@ -4,7 +4,10 @@
 
 #include "flutter/flow/raster_cache.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
+#include <limits>
 #include <vector>
 
 #include "flutter/common/constants.h"
@@ -13,6 +16,7 @@
 #include "flutter/flow/paint_utils.h"
 #include "flutter/flow/raster_cache_util.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/metrics.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkColorSpace.h"
@@ -42,18 +46,37 @@ void RasterCacheResult::draw(SkCanvas& canvas, const SkPaint* paint) const {
                    paint);
 }
 
+static size_t EstimateImageBytes(const RasterCache::Context& context) {
+  auto matrix = RasterCacheUtil::GetIntegralTransCTM(context.matrix);
+  SkRect dest_rect =
+      RasterCacheUtil::GetRoundedOutDeviceBounds(context.logical_rect, matrix);
+  return SkImageInfo::MakeN32Premul(dest_rect.width(), dest_rect.height())
+      .computeMinByteSize();
+}
+
 RasterCache::RasterCache(size_t access_threshold,
                          size_t display_list_cache_limit_per_frame)
     : access_threshold_(access_threshold),
       display_list_cache_limit_per_frame_(display_list_cache_limit_per_frame),
       checkerboard_images_(false) {}
 
-/// @note Procedure doesn't copy all closures.
-std::unique_ptr<RasterCacheResult> RasterCache::Rasterize(
+namespace {
+
+fml::metrics::Gauge& GetCachedBytesGauge() {
+  return FML_METRICS_GAUGE("flutter.RasterCache.Bytes");
+}
+
+}  // namespace
+
+RasterCache::~RasterCache() {
+  GetCachedBytesGauge().Add(-static_cast<int64_t>(reported_cached_bytes_));
+}
+
+static sk_sp<SkImage> RasterizeImage(
     const RasterCache::Context& context,
     const std::function<void(SkCanvas*)>& draw_function,
-    const std::function<void(SkCanvas*, const SkRect& rect)>& draw_checkerboard)
-    const {
+    const std::function<void(SkCanvas*, const SkRect& rect)>*
+        draw_checkerboard) {
   auto matrix = RasterCacheUtil::GetIntegralTransCTM(context.matrix);
   SkRect dest_rect =
       RasterCacheUtil::GetRoundedOutDeviceBounds(context.logical_rect, matrix);
@@ -77,24 +100,69 @@ std::unique_ptr<RasterCacheResult> RasterCache::Rasterize(
   canvas->concat(matrix);
   draw_function(canvas);
 
-  if (checkerboard_images_) {
-    draw_checkerboard(canvas, context.logical_rect);
+  if (draw_checkerboard) {
+    (*draw_checkerboard)(canvas, context.logical_rect);
   }
 
-  return std::make_unique<RasterCacheResult>(
-      surface->makeImageSnapshot(), context.logical_rect, context.flow_type);
+  return surface->makeImageSnapshot();
+}
+
+/// @note Procedure doesn't copy all closures.
+std::unique_ptr<RasterCacheResult> RasterCache::Rasterize(
+    const RasterCache::Context& context,
+    const std::function<void(SkCanvas*)>& draw_function,
+    const std::function<void(SkCanvas*, const SkRect& rect)>& draw_checkerboard)
+    const {
+  sk_sp<SkImage> image =
+      RasterizeImage(context, draw_function,
+                     checkerboard_images_ ? &draw_checkerboard : nullptr);
+  if (!image) {
+    return nullptr;
+  }
+  return std::make_unique<RasterCacheResult>(image, context.logical_rect,
+                                             context.flow_type);
 }
 
 bool RasterCache::UpdateCacheEntry(
     const RasterCacheKeyID& id,
     const Context& raster_cache_context,
-    const std::function<void(SkCanvas*)>& render_function) const {
+    const std::function<void(SkCanvas*)>& render_function,
+    bool can_rasterize_async) const {
   RasterCacheKey key = RasterCacheKey(id, raster_cache_context.matrix);
   Entry& entry = cache_[key];
+  entry.rasterize_cost = raster_cache_context.rasterize_cost;
   if (!entry.image) {
+    if (entry.async_job_id != 0) {
+      // The image is still being rasterized, so the item is drawn directly
+      // in this frame.
+      return false;
+    }
+    bool rasterize_async = can_rasterize_async && async_task_runner_;
+    if (rasterize_async && in_flight_jobs_ >= max_in_flight_jobs_) {
+      // The entry waits for a later frame, so nothing is evicted for it.
+      return false;
+    }
+    size_t bytes = EstimateImageBytes(raster_cache_context);
+    if (max_bytes_ > 0) {
+      double score =
+          RetentionScore(entry.accesses_since_visible, entry.last_visible_frame,
+                         entry.rasterize_cost, bytes);
+      if (!MakeRoomFor(bytes, score)) {
+        return false;
+      }
+    }
+    if (rasterize_async) {
+      StartAsyncRasterize(key, entry, raster_cache_context, render_function,
+                          bytes);
+      if (id.type() == RasterCacheKeyType::kDisplayList) {
+        display_list_cached_this_frame_++;
+      }
+      return false;
+    }
     void (*func)(SkCanvas*, const SkRect& rect) = DrawCheckerboard;
     entry.image = Rasterize(raster_cache_context, render_function, func);
     if (entry.image != nullptr) {
+      cached_bytes_ += entry.image->image_bytes();
       switch (id.type()) {
         case RasterCacheKeyType::kDisplayList: {
           display_list_cached_this_frame_++;
@@ -109,6 +177,114 @@ bool RasterCache::UpdateCacheEntry(
   return entry.image != nullptr;
 }
 
+void RasterCache::StartAsyncRasterize(
+    const RasterCacheKey& key,
+    Entry& entry,
+    const Context& raster_cache_context,
+    const std::function<void(SkCanvas*)>& render_function,
+    size_t reserved_bytes) const {
+  FML_DCHECK(in_flight_jobs_ < max_in_flight_jobs_);
+  uint64_t job_id = next_async_job_id_++;
+  entry.async_job_id = job_id;
+  entry.async_reserved_bytes = reserved_bytes;
+  cached_bytes_ += reserved_bytes;
+  in_flight_jobs_++;
+
+  async_task_runner_->PostTask(
+      [results = async_results_, key, job_id,
+       matrix = raster_cache_context.matrix,
+       logical_rect = raster_cache_context.logical_rect,
+       color_space = sk_ref_sp(raster_cache_context.dst_color_space),
+       flow_type = raster_cache_context.flow_type, render_function,
+       checkerboard = checkerboard_images_]() {
+        TRACE_EVENT0("flutter", "RasterCache::RasterizeAsync");
+        // The GPU context is only usable on the raster thread, so the image
+        // is rasterized in CPU memory and uploaded when it is collected.
+        RasterCache::Context context = {
+            // clang-format off
+            .gr_context         = nullptr,
+            .dst_color_space    = color_space.get(),
+            .matrix             = matrix,
+            .logical_rect       = logical_rect,
+            .flow_type          = flow_type,
+            // clang-format on
+        };
+        std::function<void(SkCanvas*, const SkRect&)> draw_checkerboard =
+            DrawCheckerboard;
+        sk_sp<SkImage> image = RasterizeImage(
+            context, render_function,
+            checkerboard ? &draw_checkerboard : nullptr);
+
+        std::scoped_lock lock(results->mutex);
+        results->results.push_back(
+            {key, job_id, std::move(image), logical_rect, flow_type});
+      });
+}
+
+void RasterCache::ReleaseAsyncReservation(Entry& entry) const {
+  FML_DCHECK(cached_bytes_ >= entry.async_reserved_bytes);
+  cached_bytes_ -= entry.async_reserved_bytes;
+  entry.async_reserved_bytes = 0;
+  entry.async_job_id = 0;
+}
+
+void RasterCache::SetAsyncRasterizeTaskRunner(
+    std::shared_ptr<fml::BasicTaskRunner> task_runner,
+    size_t max_in_flight_jobs) {
+  if (max_in_flight_jobs == 0) {
+    task_runner = nullptr;
+  }
+  async_task_runner_ = std::move(task_runner);
+  max_in_flight_jobs_ = max_in_flight_jobs;
+}
+
+void RasterCache::CollectAsyncRasterizeResults(GrDirectContext* gr_context) {
+  std::vector<AsyncRasterizeResult> results;
+  {
+    std::scoped_lock lock(async_results_->mutex);
+    results.swap(async_results_->results);
+  }
+
+  for (AsyncRasterizeResult& result : results) {
+    FML_DCHECK(in_flight_jobs_ > 0);
+    in_flight_jobs_--;
+
+    auto it = cache_.find(result.key);
+    if (it == cache_.end() || it->second.async_job_id != result.job_id) {
+      // The entry was evicted while its image was being rasterized.
+      continue;
+    }
+    Entry& entry = it->second;
+    // The image takes the place of the estimate that was reserved for it,
+    // which may differ from its actual size.
+    ReleaseAsyncReservation(entry);
+    if (!result.image) {
+      continue;
+    }
+
+    if (max_bytes_ > 0) {
+      size_t bytes = result.image->imageInfo().computeMinByteSize();
+      double score =
+          RetentionScore(entry.accesses_since_visible, entry.last_visible_frame,
+                         entry.rasterize_cost, bytes);
+      if (!MakeRoomFor(bytes, score)) {
+        continue;
+      }
+    }
+
+    sk_sp<SkImage> image = result.image;
+    if (gr_context) {
+      TRACE_EVENT0("flutter", "RasterCache::UploadAsyncImage");
+      if (sk_sp<SkImage> texture_image = image->makeTextureImage(gr_context)) {
+        image = std::move(texture_image);
+      }
+    }
+    entry.image = std::make_unique<RasterCacheResult>(
+        std::move(image), result.logical_rect, result.flow_type);
+    cached_bytes_ += entry.image->image_bytes();
+  }
+}
+
 int RasterCache::MarkSeen(const RasterCacheKeyID& id,
                           const SkMatrix& matrix,
                           bool visible) const {
@@ -116,6 +292,9 @@ int RasterCache::MarkSeen(const RasterCacheKeyID& id,
   Entry& entry = cache_[key];
   entry.encountered_this_frame = true;
   entry.visible_this_frame = visible;
+  if (visible) {
+    entry.last_visible_frame = frame_count_;
+  }
   if (visible || entry.accesses_since_visible > 0) {
     entry.accesses_since_visible++;
   }
@@ -144,8 +323,11 @@ bool RasterCache::HasEntry(const RasterCacheKeyID& id,
 bool RasterCache::Draw(const RasterCacheKeyID& id,
                        SkCanvas& canvas,
                        const SkPaint* paint) const {
-  auto it = cache_.find(RasterCacheKey(id, canvas.getTotalMatrix()));
+  RasterCacheKey key = RasterCacheKey(id, canvas.getTotalMatrix());
+  DrawCounters& counters = GetDrawCountersForKind(key.kind());
+  auto it = cache_.find(key);
   if (it == cache_.end()) {
+    counters.miss_count.fetch_add(1, std::memory_order_relaxed);
     return false;
   }
 
@@ -153,19 +335,117 @@ bool RasterCache::Draw(const RasterCacheKeyID& id,
 
   if (entry.image) {
     entry.image->draw(canvas, paint);
+    counters.hit_count.fetch_add(1, std::memory_order_relaxed);
     return true;
   }
 
+  counters.miss_count.fetch_add(1, std::memory_order_relaxed);
   return false;
 }
 
 void RasterCache::BeginFrame() {
+  frame_count_++;
   display_list_cached_this_frame_ = 0;
   picture_metrics_ = {};
   layer_metrics_ = {};
+  for (DrawCounters* counters :
+       {&layer_draw_counters_, &picture_draw_counters_}) {
+    counters->hit_count.store(0, std::memory_order_relaxed);
+    counters->miss_count.store(0, std::memory_order_relaxed);
+  }
+}
+
+void RasterCache::SetMaxBytes(size_t max_bytes) {
+  max_bytes_ = max_bytes;
+}
+
+double RasterCache::RetentionScore(size_t accesses,
+                                   size_t last_visible_frame,
+                                   unsigned int rasterize_cost,
+                                   size_t bytes) const {
+  // Frequently used entries that are expensive to rasterize again are kept
+  // the longest, as long as they have been visible recently. The cost is
+  // compressed logarithmically since complexity scores span several orders
+  // of magnitude, and the score is per byte so that one large entry does not
+  // crowd out many small ones.
+  double age = static_cast<double>(frame_count_ - last_visible_frame);
+  double cost_weight = 1.0 + std::log2(1.0 + rasterize_cost);
+  return (accesses + 1) * cost_weight /
+         ((1.0 + age) * std::max<size_t>(bytes, 1));
+}
+
+bool RasterCache::MakeRoomFor(size_t bytes, double score) const {
+  if (bytes > max_bytes_) {
+    return false;
+  }
+  if (cached_bytes_ + bytes <= max_bytes_) {
+    return true;
+  }
+
+  struct Candidate {
+    double score;
+    size_t bytes;
+    RasterCacheKey::Map<Entry>::iterator it;
+  };
+  std::vector<Candidate> candidates;
+  size_t reclaimable_bytes = 0;
+  for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+    const Entry& entry = it->second;
+    if (!entry.image || entry.visible_this_frame) {
+      continue;
+    }
+    size_t entry_bytes = entry.image->image_bytes();
+    double entry_score =
+        RetentionScore(entry.accesses_since_visible, entry.last_visible_frame,
+                       entry.rasterize_cost, entry_bytes);
+    if (entry_score < score) {
+      candidates.push_back({entry_score, entry_bytes, it});
+      reclaimable_bytes += entry_bytes;
+    }
+  }
+  if (cached_bytes_ - reclaimable_bytes + bytes > max_bytes_) {
+    // Evicting every eligible entry would still not make enough room, so
+    // keep them rather than dropping images that will be drawn again soon.
+    return false;
+  }
+
+  std::sort(candidates.begin(), candidates.end(),
+            [](const Candidate& a, const Candidate& b) {
+              return a.score < b.score;
+            });
+  for (const Candidate& candidate : candidates) {
+    if (cached_bytes_ + bytes <= max_bytes_) {
+      break;
+    }
+    GetMetricsForKind(candidate.it->first.kind()).budget_eviction_count++;
+    EvictEntryImage(candidate.it->first, candidate.it->second);
+  }
+  return true;
+}
+
+void RasterCache::EvictEntryImage(const RasterCacheKey& key,
+                                  Entry& entry) const {
+  if (!entry.image) {
+    return;
+  }
+  size_t bytes = entry.image->image_bytes();
+  RasterCacheMetrics& metrics = GetMetricsForKind(key.kind());
+  metrics.eviction_count++;
+  metrics.eviction_bytes += bytes;
+  FML_DCHECK(cached_bytes_ >= bytes);
+  cached_bytes_ -= bytes;
+  entry.image.reset();
 }
 
 void RasterCache::UpdateMetrics() {
+  for (RasterCacheKeyKind kind : {RasterCacheKeyKind::kLayerMetrics,
+                                  RasterCacheKeyKind::kDisplayListMetrics}) {
+    RasterCacheMetrics& metrics = GetMetricsForKind(kind);
+    DrawCounters& counters = GetDrawCountersForKind(kind);
+    metrics.hit_count = counters.hit_count.load(std::memory_order_relaxed);
+    metrics.miss_count = counters.miss_count.load(std::memory_order_relaxed);
+  }
+
   for (auto it = cache_.begin(); it != cache_.end(); ++it) {
     Entry& entry = it->second;
     FML_DCHECK(entry.encountered_this_frame);
@@ -189,22 +469,29 @@ void RasterCache::EvictUnusedCacheEntries() {
   }
 
   for (auto it : dead) {
-    if (it->second.image) {
-      RasterCacheMetrics& metrics = GetMetricsForKind(it->first.kind());
-      metrics.eviction_count++;
-      metrics.eviction_bytes += it->second.image->image_bytes();
-    }
+    ReleaseAsyncReservation(it->second);
+    EvictEntryImage(it->first, it->second);
     cache_.erase(it);
   }
 }
 
+void RasterCache::ReportCachedBytes() {
+  GetCachedBytesGauge().Add(static_cast<int64_t>(cached_bytes_) -
+                            static_cast<int64_t>(reported_cached_bytes_));
+  reported_cached_bytes_ = cached_bytes_;
+}
+
 void RasterCache::EndFrame() {
   UpdateMetrics();
+  ReportCachedBytes();
   TraceStatsToTimeline();
 }
 
 void RasterCache::Clear() {
+  // Results of asynchronous rasterization that are still in flight will not
+  // find their entries when they are collected and are dropped.
   cache_.clear();
+  cached_bytes_ = 0;
   picture_metrics_ = {};
   layer_metrics_ = {};
 }
@@ -250,6 +537,11 @@ void RasterCache::TraceStatsToTimeline() const {
   FML_TRACE_COUNTER(
       "flutter",                                                           //
       "RasterCache", reinterpret_cast<int64_t>(this),                      //
+      "LayerHits", layer_metrics_.hit_count,                               //
+      "LayerMisses", layer_metrics_.miss_count,                            //
+      "PictureHits", picture_metrics_.hit_count,                           //
+      "PictureMisses", picture_metrics_.miss_count,                        //
+      "InFlightRasterizeJobs", in_flight_jobs_,                            //
       "LayerCount", layer_metrics_.total_count(),                          //
       "LayerMBytes", layer_metrics_.total_bytes() / kMegaByteSizeInBytes,  //
       "PictureCount", picture_metrics_.total_count(),                      //
@@ -280,7 +572,8 @@ size_t RasterCache::EstimatePictureCacheByteSize() const {
   return picture_cache_bytes;
 }
 
-RasterCacheMetrics& RasterCache::GetMetricsForKind(RasterCacheKeyKind kind) {
+RasterCacheMetrics& RasterCache::GetMetricsForKind(
+    RasterCacheKeyKind kind) const {
   switch (kind) {
     case RasterCacheKeyKind::kDisplayListMetrics:
       return picture_metrics_;
@@ -289,4 +582,14 @@ RasterCacheMetrics& RasterCache::GetMetricsForKind(RasterCacheKeyKind kind) {
   }
 }
 
+RasterCache::DrawCounters& RasterCache::GetDrawCountersForKind(
+    RasterCacheKeyKind kind) const {
+  switch (kind) {
+    case RasterCacheKeyKind::kDisplayListMetrics:
+      return picture_draw_counters_;
+    case RasterCacheKeyKind::kLayerMetrics:
+      return layer_draw_counters_;
+  }
+}
+
 }  // namespace flutter
@@ -5,8 +5,11 @@
 #ifndef FLUTTER_FLOW_RASTER_CACHE_H_
 #define FLUTTER_FLOW_RASTER_CACHE_H_
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include "flutter/display_list/display_list.h"
 #include "flutter/display_list/display_list_complexity.h"
@@ -14,6 +17,7 @@
 #include "flutter/flow/raster_cache_util.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
+#include "flutter/fml/task_runner.h"
 #include "flutter/fml/trace_event.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkMatrix.h"
@@ -67,6 +71,24 @@ struct RasterCacheMetrics {
    */
   size_t eviction_bytes = 0;
 
+  /**
+   * The number of cache entries with images evicted in this frame to keep
+   * the cache within its byte budget. These are included in |eviction_count|.
+   */
+  size_t budget_eviction_count = 0;
+
+  /**
+   * The number of times a cached image was drawn in this frame.
+   */
+  size_t hit_count = 0;
+
+  /**
+   * The number of times an item expected to be drawn from the cache in this
+   * frame had no cached image, for example because it was not rasterized
+   * to stay within the byte budget.
+   */
+  size_t miss_count = 0;
+
   /**
    * The number of cache entries with images used in this frame.
    */
@@ -120,6 +142,10 @@ class RasterCache {
     const SkMatrix& matrix;
     const SkRect& logical_rect;
     const char* flow_type;
+    // An estimate of the cost of rasterizing the entry again if it is
+    // evicted, such as a |DisplayListComplexityCalculator| score, or 0 if
+    // it is unknown.
+    unsigned int rasterize_cost = 0;
   };
 
   std::unique_ptr<RasterCacheResult> Rasterize(
@@ -133,7 +159,7 @@ class RasterCache {
       size_t picture_and_display_list_cache_limit_per_frame =
           RasterCacheUtil::kDefaultPictureAndDispLayListCacheLimitPerFrame);
 
-  virtual ~RasterCache() = default;
+  virtual ~RasterCache();
 
   // Draws this item if it should be rendered from the cache and returns
   // true iff it was successfully drawn. Typically this should only fail
@@ -156,6 +182,22 @@ class RasterCache {
 
   void SetCheckboardCacheImages(bool checkerboard);
 
+  /**
+   * @brief Limit the memory used by the images of the cache entries to the
+   * given number of bytes, or 0 for unlimited.
+   *
+   * When the budget would be exceeded, entries that are not visible in the
+   * current frame are evicted in the order of their retention score, which
+   * weighs the access frequency, the number of frames since the entry was
+   * last visible, the rasterization cost and the image size. If the new
+   * entry scores lower than the entries that would have to be evicted to
+   * make room for it, it is not rasterized, so that entries which are drawn
+   * every frame are never evicted to make room for others.
+   */
+  void SetMaxBytes(size_t max_bytes);
+
+  size_t max_bytes() const { return max_bytes_; }
+
   const RasterCacheMetrics& picture_metrics() const { return picture_metrics_; }
   const RasterCacheMetrics& layer_metrics() const { return layer_metrics_; }
 
@@ -195,6 +237,43 @@ class RasterCache {
    */
   size_t EstimateLayerCacheByteSize() const;
 
+  /**
+   * @brief Return how much memory is used by the images of all of the cache
+   * entries in bytes, as counted against the budget set by |SetMaxBytes|.
+   */
+  size_t GetCachedBytes() const { return cached_bytes_; }
+
+  /**
+   * @brief Rasterize the entries that allow it on |task_runner| instead of
+   * synchronously in the frame where they become eligible for caching.
+   *
+   * Until the image of such an entry has been rasterized and collected by
+   * |CollectAsyncRasterizeResults|, |UpdateCacheEntry| returns false and the
+   * item is drawn directly. The images are rasterized into CPU memory and
+   * uploaded to the GPU when they are collected, since the GPU context may
+   * only be used on the raster thread. At most |max_in_flight_jobs| entries
+   * are rasterized at the same time; further entries wait for a later frame.
+   *
+   * Passing a null |task_runner| or 0 |max_in_flight_jobs| restores
+   * synchronous rasterization.
+   */
+  void SetAsyncRasterizeTaskRunner(
+      std::shared_ptr<fml::BasicTaskRunner> task_runner,
+      size_t max_in_flight_jobs);
+
+  /**
+   * @brief Move the images rasterized asynchronously since the last call
+   * into their cache entries, uploading them to |gr_context| if it is not
+   * null. Images of entries that were evicted in the meantime are dropped.
+   */
+  void CollectAsyncRasterizeResults(GrDirectContext* gr_context);
+
+  /**
+   * @brief Return the number of entries that are being rasterized
+   * asynchronously or whose images have not been collected yet.
+   */
+  size_t GetInFlightRasterizeJobCount() const { return in_flight_jobs_; }
+
   /**
    * @brief Return the number of frames that a picture must be prepared
    * before it will be cached. If the number is 0, then no picture will
@@ -231,29 +310,110 @@ class RasterCache {
    */
   int GetAccessCount(const RasterCacheKeyID& id, const SkMatrix& matrix) const;
 
-  bool UpdateCacheEntry(
-      const RasterCacheKeyID& id,
-      const Context& raster_cache_context,
-      const std::function<void(SkCanvas*)>& render_function) const;
+  /**
+   * @brief Rasterize the entry for |id| if it does not have an image yet.
+   * If |can_rasterize_async| is true and an asynchronous task runner is set,
+   * |render_function| may be called on another thread, so it must only
+   * capture state that is immutable and outlives the call.
+   * @return true if the entry has an image that can be drawn in this frame.
+   */
+  bool UpdateCacheEntry(const RasterCacheKeyID& id,
+                        const Context& raster_cache_context,
+                        const std::function<void(SkCanvas*)>& render_function,
+                        bool can_rasterize_async = false) const;
 
  private:
   struct Entry {
     bool encountered_this_frame = false;
     bool visible_this_frame = false;
     size_t accesses_since_visible = 0;
+    size_t last_visible_frame = 0;
+    unsigned int rasterize_cost = 0;
+    // Non-zero while an image is being rasterized asynchronously, to match
+    // the result to the entry it was started for.
+    uint64_t async_job_id = 0;
+    // The estimated bytes of the image that is being rasterized
+    // asynchronously, counted in |cached_bytes_| until the image is
+    // collected so that the jobs in flight cannot exceed the budget.
+    size_t async_reserved_bytes = 0;
     std::unique_ptr<RasterCacheResult> image;
   };
 
+  struct AsyncRasterizeResult {
+    RasterCacheKey key;
+    uint64_t job_id;
+    sk_sp<SkImage> image;
+    SkRect logical_rect;
+    const char* flow_type;
+  };
+
+  // Shared with the asynchronous rasterization tasks, which may outlive
+  // the cache.
+  struct AsyncRasterizeResults {
+    std::mutex mutex;
+    std::vector<AsyncRasterizeResult> results;
+  };
+
+  // Must only be called while fewer than |max_in_flight_jobs_| jobs are in
+  // flight.
+  void StartAsyncRasterize(
+      const RasterCacheKey& key,
+      Entry& entry,
+      const Context& raster_cache_context,
+      const std::function<void(SkCanvas*)>& render_function,
+      size_t reserved_bytes) const;
+
+  // Returns the bytes reserved for the image of |entry| that is being
+  // rasterized asynchronously to the budget.
+  void ReleaseAsyncReservation(Entry& entry) const;
+
+  // Counters updated by |Draw|, which may be called from several threads
+  // when layer subtrees are painted concurrently.
+  struct DrawCounters {
+    std::atomic_size_t hit_count{0};
+    std::atomic_size_t miss_count{0};
+  };
+
   void UpdateMetrics();
 
-  RasterCacheMetrics& GetMetricsForKind(RasterCacheKeyKind kind);
+  // Adds the change in |cached_bytes_| since the last call to the bytes of
+  // all raster caches in the process, which are reported without tracing.
+  void ReportCachedBytes();
+
+  RasterCacheMetrics& GetMetricsForKind(RasterCacheKeyKind kind) const;
+
+  DrawCounters& GetDrawCountersForKind(RasterCacheKeyKind kind) const;
+
+  double RetentionScore(size_t accesses,
+                        size_t last_visible_frame,
+                        unsigned int rasterize_cost,
+                        size_t bytes) const;
+
+  // Evicts the images of entries that are not visible in this frame and
+  // score lower than |score| until |bytes| more bytes fit in the budget.
+  // Returns false, leaving the cache unchanged, if that is not possible.
+  bool MakeRoomFor(size_t bytes, double score) const;
+
+  void EvictEntryImage(const RasterCacheKey& key, Entry& entry) const;
 
   const size_t access_threshold_;
   const size_t display_list_cache_limit_per_frame_;
   mutable size_t display_list_cached_this_frame_ = 0;
-  RasterCacheMetrics layer_metrics_;
-  RasterCacheMetrics picture_metrics_;
+  mutable RasterCacheMetrics layer_metrics_;
+  mutable RasterCacheMetrics picture_metrics_;
+  mutable DrawCounters layer_draw_counters_;
+  mutable DrawCounters picture_draw_counters_;
   mutable RasterCacheKey::Map<Entry> cache_;
+  mutable size_t cached_bytes_ = 0;
+  size_t reported_cached_bytes_ = 0;
+  size_t max_bytes_ = 0;
+  size_t frame_count_ = 0;
+  std::shared_ptr<fml::BasicTaskRunner> async_task_runner_;
+  size_t max_in_flight_jobs_ = 0;
+  mutable size_t in_flight_jobs_ = 0;
+  mutable uint64_t next_async_job_id_ = 1;
+  std::shared_ptr<AsyncRasterizeResults> async_results_ =
+      std::make_shared<AsyncRasterizeResults>();
   bool checkerboard_images_;
 
   void TraceStatsToTimeline() const;
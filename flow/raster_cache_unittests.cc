@@ -432,6 +432,465 @@ TEST(RasterCache, EvitUnusedCacheEntries) {
   cache.EndFrame();
 }
 
+TEST(RasterCache, ByteBudgetDoesNotEvictVisibleEntries) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  // Room for exactly one rasterized sample display list.
+  cache.SetMaxBytes(25600u);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list_1 = GetSampleDisplayList();
+  auto display_list_2 = GetSampleDisplayList();
+
+  SkCanvas dummy_canvas(1000, 1000);
+  SkPaint paint;
+
+  LayerStateStack preroll_state_stack;
+  preroll_state_stack.set_preroll_delegate(kGiantRect, matrix);
+  LayerStateStack paint_state_stack;
+  paint_state_stack.set_delegate(&dummy_canvas);
+
+  FixedRefreshRateStopwatch raster_time;
+  FixedRefreshRateStopwatch ui_time;
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder(
+      preroll_state_stack, &cache, &raster_time, &ui_time);
+  PaintContextHolder paint_context_holder = GetSamplePaintContextHolder(
+      paint_state_stack, &cache, &raster_time, &ui_time);
+  auto& preroll_context = preroll_context_holder.preroll_context;
+  auto& paint_context = paint_context_holder.paint_context;
+
+  DisplayListRasterCacheItem display_list_item_1(display_list_1.get(),
+                                                 SkPoint(), true, false);
+  DisplayListRasterCacheItem display_list_item_2(display_list_2.get(),
+                                                 SkPoint(), true, false);
+
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item_1, preroll_context, matrix);
+  RasterCacheItemPreroll(display_list_item_2, preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  cache.EndFrame();
+
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item_1, preroll_context, matrix);
+  RasterCacheItemPreroll(display_list_item_2, preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  ASSERT_TRUE(
+      RasterCacheItemTryToRasterCache(display_list_item_1, paint_context));
+  // Both entries are visible, so the second one is not rasterized rather
+  // than evicting the first one.
+  ASSERT_FALSE(
+      RasterCacheItemTryToRasterCache(display_list_item_2, paint_context));
+  ASSERT_EQ(cache.GetCachedBytes(), 25600u);
+  ASSERT_TRUE(display_list_item_1.Draw(paint_context, &dummy_canvas, &paint));
+  ASSERT_FALSE(display_list_item_2.Draw(paint_context, &dummy_canvas, &paint));
+  cache.EndFrame();
+
+  ASSERT_EQ(cache.picture_metrics().total_count(), 1u);
+  ASSERT_EQ(cache.picture_metrics().total_bytes(), 25600u);
+  ASSERT_EQ(cache.picture_metrics().hit_count, 1u);
+  ASSERT_EQ(cache.picture_metrics().miss_count, 1u);
+  ASSERT_EQ(cache.picture_metrics().eviction_count, 0u);
+}
+
+TEST(RasterCache, ByteBudgetEvictsEntriesThatAreNotVisible) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  // Room for exactly one rasterized sample display list.
+  cache.SetMaxBytes(25600u);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list_1 = GetSampleDisplayList();
+  auto display_list_2 = GetSampleDisplayList();
+
+  SkCanvas dummy_canvas(1000, 1000);
+  SkPaint paint;
+
+  LayerStateStack preroll_state_stack;
+  preroll_state_stack.set_preroll_delegate(kGiantRect, matrix);
+  LayerStateStack offscreen_state_stack;
+  offscreen_state_stack.set_preroll_delegate(
+      SkRect::MakeLTRB(200, 200, 300, 300), matrix);
+  LayerStateStack paint_state_stack;
+  paint_state_stack.set_delegate(&dummy_canvas);
+
+  FixedRefreshRateStopwatch raster_time;
+  FixedRefreshRateStopwatch ui_time;
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder(
+      preroll_state_stack, &cache, &raster_time, &ui_time);
+  PrerollContextHolder offscreen_context_holder = GetSamplePrerollContextHolder(
+      offscreen_state_stack, &cache, &raster_time, &ui_time);
+  PaintContextHolder paint_context_holder = GetSamplePaintContextHolder(
+      paint_state_stack, &cache, &raster_time, &ui_time);
+  auto& preroll_context = preroll_context_holder.preroll_context;
+  auto& offscreen_context = offscreen_context_holder.preroll_context;
+  auto& paint_context = paint_context_holder.paint_context;
+
+  DisplayListRasterCacheItem display_list_item_1(display_list_1.get(),
+                                                 SkPoint(), true, false);
+  DisplayListRasterCacheItem display_list_item_2(display_list_2.get(),
+                                                 SkPoint(), true, false);
+
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item_1, preroll_context, matrix);
+  RasterCacheItemPreroll(display_list_item_2, preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  cache.EndFrame();
+
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item_1, preroll_context, matrix);
+  RasterCacheItemPreroll(display_list_item_2, offscreen_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  ASSERT_TRUE(
+      RasterCacheItemTryToRasterCache(display_list_item_1, paint_context));
+  ASSERT_EQ(cache.GetCachedBytes(), 25600u);
+  cache.EndFrame();
+
+  // The first entry scrolls out of view while the second one comes into
+  // view, so the first one makes room for the second one.
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item_1, offscreen_context, matrix);
+  RasterCacheItemPreroll(display_list_item_2, preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  ASSERT_TRUE(
+      RasterCacheItemTryToRasterCache(display_list_item_2, paint_context));
+  ASSERT_EQ(cache.GetCachedBytes(), 25600u);
+  ASSERT_TRUE(display_list_item_2.Draw(paint_context, &dummy_canvas, &paint));
+  cache.EndFrame();
+
+  ASSERT_EQ(cache.picture_metrics().total_count(), 1u);
+  ASSERT_EQ(cache.picture_metrics().hit_count, 1u);
+  ASSERT_EQ(cache.picture_metrics().eviction_count, 1u);
+  ASSERT_EQ(cache.picture_metrics().budget_eviction_count, 1u);
+  ASSERT_EQ(cache.picture_metrics().eviction_bytes, 25600u);
+  // The evicted entry keeps its access history.
+  ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 2u);
+}
+
+namespace {
+class DeferredTaskRunner : public fml::BasicTaskRunner {
+ public:
+  void PostTask(const fml::closure& task) override { tasks_.push_back(task); }
+
+  void RunTasks() {
+    for (const auto& task : tasks_) {
+      task();
+    }
+    tasks_.clear();
+  }
+
+  size_t task_count() const { return tasks_.size(); }
+
+ private:
+  std::vector<fml::closure> tasks_;
+};
+}  // namespace
+
+TEST(RasterCache, AsyncRasterizeSwapsImageInOnLaterFrame) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  auto task_runner = std::make_shared<DeferredTaskRunner>();
+  cache.SetAsyncRasterizeTaskRunner(task_runner, 1);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list_1 = GetSampleDisplayList();
+  auto display_list_2 = GetSampleDisplayList();
+
+  SkCanvas dummy_canvas(1000, 1000);
+  SkPaint paint;
+
+  LayerStateStack preroll_state_stack;
+  preroll_state_stack.set_preroll_delegate(kGiantRect, matrix);
+  LayerStateStack paint_state_stack;
+  paint_state_stack.set_delegate(&dummy_canvas);
+
+  FixedRefreshRateStopwatch raster_time;
+  FixedRefreshRateStopwatch ui_time;
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder(
+      preroll_state_stack, &cache, &raster_time, &ui_time);
+  PaintContextHolder paint_context_holder = GetSamplePaintContextHolder(
+      paint_state_stack, &cache, &raster_time, &ui_time);
+  auto& preroll_context = preroll_context_holder.preroll_context;
+  auto& paint_context = paint_context_holder.paint_context;
+
+  DisplayListRasterCacheItem display_list_item_1(display_list_1.get(),
+                                                 SkPoint(), true, false);
+  DisplayListRasterCacheItem display_list_item_2(display_list_2.get(),
+                                                 SkPoint(), true, false);
+
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item_1, preroll_context, matrix);
+  RasterCacheItemPreroll(display_list_item_2, preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  cache.EndFrame();
+
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item_1, preroll_context, matrix);
+  RasterCacheItemPreroll(display_list_item_2, preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  cache.CollectAsyncRasterizeResults(nullptr);
+  // The first item starts rasterizing, the second one has to wait since
+  // only one job may be in flight.
+  ASSERT_FALSE(
+      RasterCacheItemTryToRasterCache(display_list_item_1, paint_context));
+  ASSERT_FALSE(
+      RasterCacheItemTryToRasterCache(display_list_item_2, paint_context));
+  ASSERT_EQ(task_runner->task_count(), 1u);
+  ASSERT_EQ(cache.GetInFlightRasterizeJobCount(), 1u);
+  // The bytes of the image in flight are reserved in the budget.
+  ASSERT_EQ(cache.GetCachedBytes(), 25600u);
+  ASSERT_FALSE(display_list_item_1.Draw(paint_context, &dummy_canvas, &paint));
+  cache.EndFrame();
+  ASSERT_EQ(cache.picture_metrics().total_count(), 0u);
+
+  task_runner->RunTasks();
+
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item_1, preroll_context, matrix);
+  RasterCacheItemPreroll(display_list_item_2, preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  cache.CollectAsyncRasterizeResults(nullptr);
+  ASSERT_EQ(cache.GetInFlightRasterizeJobCount(), 0u);
+  ASSERT_TRUE(
+      RasterCacheItemTryToRasterCache(display_list_item_1, paint_context));
+  ASSERT_FALSE(
+      RasterCacheItemTryToRasterCache(display_list_item_2, paint_context));
+  ASSERT_EQ(task_runner->task_count(), 1u);
+  ASSERT_TRUE(display_list_item_1.Draw(paint_context, &dummy_canvas, &paint));
+  cache.EndFrame();
+  ASSERT_EQ(cache.picture_metrics().total_count(), 1u);
+  ASSERT_EQ(cache.picture_metrics().total_bytes(), 25600u);
+  // The reservation of the second item, which started rasterizing in this
+  // frame, adds to the bytes of the first image.
+  ASSERT_EQ(cache.GetCachedBytes(), 51200u);
+}
+
+TEST(RasterCache, AsyncRasterizeResultOfEvictedEntryIsDropped) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  auto task_runner = std::make_shared<DeferredTaskRunner>();
+  cache.SetAsyncRasterizeTaskRunner(task_runner, 4);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list = GetSampleDisplayList();
+
+  SkCanvas dummy_canvas(1000, 1000);
+
+  LayerStateStack preroll_state_stack;
+  preroll_state_stack.set_preroll_delegate(kGiantRect, matrix);
+  LayerStateStack paint_state_stack;
+  paint_state_stack.set_delegate(&dummy_canvas);
+
+  FixedRefreshRateStopwatch raster_time;
+  FixedRefreshRateStopwatch ui_time;
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder(
+      preroll_state_stack, &cache, &raster_time, &ui_time);
+  PaintContextHolder paint_context_holder = GetSamplePaintContextHolder(
+      paint_state_stack, &cache, &raster_time, &ui_time);
+  auto& preroll_context = preroll_context_holder.preroll_context;
+  auto& paint_context = paint_context_holder.paint_context;
+
+  DisplayListRasterCacheItem display_list_item(display_list.get(), SkPoint(),
+                                               true, false);
+
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item, preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  cache.EndFrame();
+
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item, preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  ASSERT_FALSE(
+      RasterCacheItemTryToRasterCache(display_list_item, paint_context));
+  cache.EndFrame();
+  ASSERT_EQ(cache.GetCachedBytes(), 25600u);
+
+  // The display list is not part of the next frame, so its entry is gone
+  // by the time the image is collected.
+  task_runner->RunTasks();
+  cache.BeginFrame();
+  cache.EvictUnusedCacheEntries();
+  cache.CollectAsyncRasterizeResults(nullptr);
+  cache.EndFrame();
+
+  ASSERT_EQ(cache.GetInFlightRasterizeJobCount(), 0u);
+  ASSERT_EQ(cache.GetCachedEntriesCount(), 0u);
+  ASSERT_EQ(cache.GetCachedBytes(), 0u);
+}
+
+TEST(RasterCache, AsyncRasterizeAtJobLimitDoesNotEvictEntries) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  // Room for exactly two rasterized sample display lists.
+  cache.SetMaxBytes(51200u);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list_1 = GetSampleDisplayList();
+  auto display_list_2 = GetSampleDisplayList();
+  auto display_list_3 = GetSampleDisplayList();
+
+  SkCanvas dummy_canvas(1000, 1000);
+
+  LayerStateStack preroll_state_stack;
+  preroll_state_stack.set_preroll_delegate(kGiantRect, matrix);
+  LayerStateStack offscreen_state_stack;
+  offscreen_state_stack.set_preroll_delegate(
+      SkRect::MakeLTRB(200, 200, 300, 300), matrix);
+  LayerStateStack paint_state_stack;
+  paint_state_stack.set_delegate(&dummy_canvas);
+
+  FixedRefreshRateStopwatch raster_time;
+  FixedRefreshRateStopwatch ui_time;
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder(
+      preroll_state_stack, &cache, &raster_time, &ui_time);
+  PrerollContextHolder offscreen_context_holder = GetSamplePrerollContextHolder(
+      offscreen_state_stack, &cache, &raster_time, &ui_time);
+  PaintContextHolder paint_context_holder = GetSamplePaintContextHolder(
+      paint_state_stack, &cache, &raster_time, &ui_time);
+  auto& preroll_context = preroll_context_holder.preroll_context;
+  auto& offscreen_context = offscreen_context_holder.preroll_context;
+  auto& paint_context = paint_context_holder.paint_context;
+
+  DisplayListRasterCacheItem display_list_item_1(display_list_1.get(),
+                                                 SkPoint(), true, false);
+  DisplayListRasterCacheItem display_list_item_2(display_list_2.get(),
+                                                 SkPoint(), true, false);
+  DisplayListRasterCacheItem display_list_item_3(display_list_3.get(),
+                                                 SkPoint(), true, false);
+
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item_1, preroll_context, matrix);
+  RasterCacheItemPreroll(display_list_item_2, preroll_context, matrix);
+  RasterCacheItemPreroll(display_list_item_3, preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  cache.EndFrame();
+
+  // The first entry is rasterized synchronously.
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item_1, preroll_context, matrix);
+  RasterCacheItemPreroll(display_list_item_2, preroll_context, matrix);
+  RasterCacheItemPreroll(display_list_item_3, preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  ASSERT_TRUE(
+      RasterCacheItemTryToRasterCache(display_list_item_1, paint_context));
+  cache.EndFrame();
+  ASSERT_EQ(cache.GetCachedBytes(), 25600u);
+
+  auto task_runner = std::make_shared<DeferredTaskRunner>();
+  cache.SetAsyncRasterizeTaskRunner(task_runner, 1);
+
+  // The first entry scrolls out of view. The second entry fits next to it
+  // and starts rasterizing, the third one has to wait for the job to
+  // finish and must not evict the first entry in the meantime.
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item_1, offscreen_context, matrix);
+  RasterCacheItemPreroll(display_list_item_2, preroll_context, matrix);
+  RasterCacheItemPreroll(display_list_item_3, preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  cache.CollectAsyncRasterizeResults(nullptr);
+  ASSERT_FALSE(
+      RasterCacheItemTryToRasterCache(display_list_item_2, paint_context));
+  ASSERT_FALSE(
+      RasterCacheItemTryToRasterCache(display_list_item_3, paint_context));
+  ASSERT_EQ(task_runner->task_count(), 1u);
+  ASSERT_EQ(cache.GetInFlightRasterizeJobCount(), 1u);
+  cache.EndFrame();
+
+  ASSERT_EQ(cache.picture_metrics().total_count(), 1u);
+  ASSERT_EQ(cache.picture_metrics().eviction_count, 0u);
+  ASSERT_EQ(cache.picture_metrics().budget_eviction_count, 0u);
+  ASSERT_EQ(cache.GetCachedBytes(), 51200u);
+}
+
+namespace {
+// An image that belongs to the context of the raster thread, like the
+// images of |Picture.toImage|.
+class RasterContextImage : public DlImage {
+ public:
+  explicit RasterContextImage(sk_sp<SkImage> image)
+      : image_(std::move(image)) {}
+
+  sk_sp<SkImage> skia_image() const override { return image_; }
+  std::shared_ptr<impeller::Texture> impeller_texture() const override {
+    return nullptr;
+  }
+  bool isOpaque() const override { return image_->isOpaque(); }
+  bool isTextureBacked() const override { return false; }
+  SkISize dimensions() const override { return image_->dimensions(); }
+  size_t GetApproximateByteSize() const override {
+    return sizeof(*this) + image_->imageInfo().computeMinByteSize();
+  }
+  OwningContext owning_context() const override {
+    return OwningContext::kRaster;
+  }
+
+ private:
+  sk_sp<SkImage> image_;
+};
+}  // namespace
+
+TEST(RasterCache, DisplayListWithGpuImagesIsRasterizedSynchronously) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  auto task_runner = std::make_shared<DeferredTaskRunner>();
+  cache.SetAsyncRasterizeTaskRunner(task_runner, 4);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto image = sk_make_sp<RasterContextImage>(TestImage1->skia_image());
+  DisplayListBuilder image_builder(SkRect::MakeWH(150, 100));
+  image_builder.drawImage(image, SkPoint::Make(10, 10),
+                          DlImageSampling::kNearestNeighbor, false);
+  auto image_display_list = image_builder.Build();
+  ASSERT_TRUE(image_display_list->has_gpu_images());
+
+  DisplayListBuilder nested_builder(SkRect::MakeWH(150, 100));
+  nested_builder.drawDisplayList(image_display_list);
+  auto display_list = nested_builder.Build();
+  ASSERT_TRUE(display_list->has_gpu_images());
+  ASSERT_FALSE(GetSampleDisplayList()->has_gpu_images());
+
+  SkCanvas dummy_canvas(1000, 1000);
+  SkPaint paint;
+
+  LayerStateStack preroll_state_stack;
+  preroll_state_stack.set_preroll_delegate(kGiantRect, matrix);
+  LayerStateStack paint_state_stack;
+  paint_state_stack.set_delegate(&dummy_canvas);
+
+  FixedRefreshRateStopwatch raster_time;
+  FixedRefreshRateStopwatch ui_time;
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder(
+      preroll_state_stack, &cache, &raster_time, &ui_time);
+  PaintContextHolder paint_context_holder = GetSamplePaintContextHolder(
+      paint_state_stack, &cache, &raster_time, &ui_time);
+  auto& preroll_context = preroll_context_holder.preroll_context;
+  auto& paint_context = paint_context_holder.paint_context;
+
+  DisplayListRasterCacheItem display_list_item(display_list.get(), SkPoint(),
+                                               true, false);
+
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item, preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  cache.EndFrame();
+
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item, preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  ASSERT_TRUE(
+      RasterCacheItemTryToRasterCache(display_list_item, paint_context));
+  ASSERT_EQ(task_runner->task_count(), 0u);
+  ASSERT_EQ(cache.GetInFlightRasterizeJobCount(), 0u);
+  ASSERT_TRUE(display_list_item.Draw(paint_context, &dummy_canvas, &paint));
+  cache.EndFrame();
+}
+
 TEST(RasterCache, ComputeDeviceRectBasedOnFractionalTranslation) {
   SkRect logical_rect = SkRect::MakeLTRB(0, 0, 300.2, 300.3);
   SkMatrix ctm = SkMatrix::MakeAll(2.0, 0, 0, 0, 2.0, 0, 0, 0, 1);
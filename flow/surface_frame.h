@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "flutter/common/graphics/gl_context_switch.h"
 #include "flutter/display_list/display_list_canvas_recorder.h"
@@ -52,6 +53,15 @@ class SurfaceFrame {
     // rasterized (no partial redraw). To signal that there is no existing
     // damage use an empty SkIRect.
     std::optional<SkIRect> existing_damage = std::nullopt;
+
+    // Optional breakdown of existing_damage into disjoint rects. If empty,
+    // existing_damage is treated as a single rect.
+    std::vector<SkIRect> existing_damage_rects;
+
+    // The maximum number of disjoint rects the target can make use of in
+    // SubmitInfo::frame_damage_rects and SubmitInfo::buffer_damage_rects.
+    // With the default of 1 damage is always reported as a single rect.
+    size_t max_damage_rects = 1;
   };
 
   SurfaceFrame(sk_sp<SkSurface> surface,
@@ -75,6 +85,14 @@ class SurfaceFrame {
     // Corresponds to EGL_KHR_partial_update
     std::optional<SkIRect> buffer_damage;
 
+    // frame_damage split into disjoint rects, at most
+    // FramebufferInfo::max_damage_rects of them.
+    std::vector<SkIRect> frame_damage_rects;
+
+    // buffer_damage split into disjoint rects, at most
+    // FramebufferInfo::max_damage_rects of them.
+    std::vector<SkIRect> buffer_damage_rects;
+
     // Time at which this frame is scheduled to be presented. This is a hint
     // that can be passed to the platform to drop queued frames.
     std::optional<fml::TimePoint> presentation_time;
@@ -20,7 +20,8 @@ Damage DiffContextTest::DiffLayerTree(MockLayerTree& layer_tree,
                                       const SkIRect& additional_damage,
                                       int horizontal_clip_alignment,
                                       int vertical_clip_alignment,
-                                      bool use_raster_cache) {
+                                      bool use_raster_cache,
+                                      const DamageMergePolicy& merge_policy) {
   FML_CHECK(layer_tree.size() == old_layer_tree.size());
 
   DiffContext dc(layer_tree.size(), 1, layer_tree.paint_region_map(),
@@ -28,8 +29,9 @@ Damage DiffContextTest::DiffLayerTree(MockLayerTree& layer_tree,
   dc.PushCullRect(
       SkRect::MakeIWH(layer_tree.size().width(), layer_tree.size().height()));
   layer_tree.root()->Diff(&dc, old_layer_tree.root());
-  return dc.ComputeDamage(additional_damage, horizontal_clip_alignment,
-                          vertical_clip_alignment);
+  return dc.ComputeDamage(std::vector<SkIRect>{additional_damage},
+                          horizontal_clip_alignment, vertical_clip_alignment,
+                          merge_policy);
 }
 
 sk_sp<DisplayList> DiffContextTest::CreateDisplayList(const SkRect& bounds,
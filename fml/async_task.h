@@ -0,0 +1,360 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_ASYNC_TASK_H_
+#define FLUTTER_FML_ASYNC_TASK_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "flutter/fml/closure.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/make_copyable.h"
+#include "flutter/fml/memory/ref_counted.h"
+#include "flutter/fml/memory/ref_ptr.h"
+#include "flutter/fml/task_runner.h"
+
+namespace fml {
+
+template <typename T>
+class AsyncTask;
+
+/// Completes with the results of all of |tasks| once they are all done, or is
+/// canceled if any of them is.
+template <typename... Ts>
+AsyncTask<std::tuple<Ts...>> WhenAll(AsyncTask<Ts>... tasks);
+
+namespace internal {
+
+/// Where the steps of an |AsyncTask| run. Steps run right away if they are
+/// ready on the thread of a |TaskRunner|, like |TaskRunner::RunNowOrPostTask|,
+/// and are posted otherwise. Steps for other runners, such as a
+/// |ConcurrentTaskRunner|, are always posted.
+class AsyncTaskRunner {
+ public:
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  AsyncTaskRunner(fml::RefPtr<fml::TaskRunner> runner)
+      : task_runner_(std::move(runner)) {
+    FML_DCHECK(task_runner_);
+  }
+
+  template <typename Runner>
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  AsyncTaskRunner(std::shared_ptr<Runner> runner)
+      : basic_runner_(std::move(runner)) {
+    FML_DCHECK(basic_runner_);
+  }
+
+  void RunNowOrPostTask(const fml::closure& task) const {
+    if (task_runner_) {
+      fml::TaskRunner::RunNowOrPostTask(task_runner_, task);
+    } else {
+      basic_runner_->PostTask(task);
+    }
+  }
+
+ private:
+  fml::RefPtr<fml::TaskRunner> task_runner_;
+  std::shared_ptr<fml::BasicTaskRunner> basic_runner_;
+};
+
+/// The result of an |AsyncTask| and what to do once it is available. Shared
+/// between the task and the step that produces its result.
+template <typename T>
+class AsyncTaskState : public fml::RefCountedThreadSafe<AsyncTaskState<T>> {
+ public:
+  using CompletionCallback = std::function<void(bool canceled)>;
+
+  /// Stores the result, unless the task was canceled, and calls the
+  /// completion callback.
+  void Complete(T value) {
+    CompletionCallback on_complete;
+    {
+      std::scoped_lock lock(mutex_);
+      if (canceled_) {
+        return;
+      }
+      FML_DCHECK(!value_.has_value());
+      value_.emplace(std::move(value));
+      on_complete = std::move(on_complete_);
+    }
+    condition_.notify_all();
+    if (on_complete) {
+      on_complete(false);
+    }
+  }
+
+  /// Drops the result, if any, and calls the completion callback.
+  void Cancel() {
+    CompletionCallback on_complete;
+    {
+      std::scoped_lock lock(mutex_);
+      if (canceled_) {
+        return;
+      }
+      canceled_ = true;
+      value_.reset();
+      on_complete = std::move(on_complete_);
+    }
+    condition_.notify_all();
+    if (on_complete) {
+      on_complete(true);
+    }
+  }
+
+  bool IsCanceled() const {
+    std::scoped_lock lock(mutex_);
+    return canceled_;
+  }
+
+  /// Calls |on_complete| on the completing thread once the task is done or
+  /// canceled, or right away if it already is. Only one callback is allowed.
+  /// The callback must not hold a reference to this state, which is alive
+  /// while it is called.
+  void OnComplete(CompletionCallback on_complete) {
+    bool canceled;
+    {
+      std::scoped_lock lock(mutex_);
+      FML_DCHECK(!on_complete_);
+      if (!IsDoneLocked()) {
+        on_complete_ = std::move(on_complete);
+        return;
+      }
+      canceled = canceled_;
+    }
+    on_complete(canceled);
+  }
+
+  void Wait() const {
+    std::unique_lock lock(mutex_);
+    condition_.wait(lock, [this]() { return IsDoneLocked(); });
+  }
+
+  /// Moves the result out, or returns nothing if the task was canceled.
+  std::optional<T> Take() {
+    std::scoped_lock lock(mutex_);
+    FML_DCHECK(IsDoneLocked());
+    std::optional<T> value = std::move(value_);
+    value_.reset();
+    return value;
+  }
+
+ private:
+  FML_FRIEND_REF_COUNTED_THREAD_SAFE(AsyncTaskState);
+  FML_FRIEND_MAKE_REF_COUNTED(AsyncTaskState);
+
+  mutable std::mutex mutex_;
+  mutable std::condition_variable condition_;
+  std::optional<T> value_;
+  bool canceled_ = false;
+  CompletionCallback on_complete_;
+
+  AsyncTaskState() = default;
+
+  ~AsyncTaskState() {
+    // The step that produces the result was dropped without running, like a
+    // task posted to a task runner that was shut down.
+    if (on_complete_) {
+      on_complete_(true);
+    }
+  }
+
+  bool IsDoneLocked() const { return canceled_ || value_.has_value(); }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(AsyncTaskState);
+};
+
+/// The results of the tasks of a |WhenAll| that are already done.
+template <typename... Ts>
+class WhenAllState : public fml::RefCountedThreadSafe<WhenAllState<Ts...>> {
+ public:
+  std::tuple<std::optional<Ts>...> values;
+  std::atomic<size_t> remaining = sizeof...(Ts);
+
+ private:
+  FML_FRIEND_REF_COUNTED_THREAD_SAFE(WhenAllState);
+  FML_FRIEND_MAKE_REF_COUNTED(WhenAllState);
+
+  WhenAllState() = default;
+
+  ~WhenAllState() = default;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(WhenAllState);
+};
+
+}  // namespace internal
+
+//------------------------------------------------------------------------------
+/// @brief      A value of type |T| that is computed by a sequence of steps on
+///             task runners, without blocking the threads in between.
+///
+///             Instead of posting a task that blocks its thread on an
+///             |AutoResetWaitableEvent| or a |std::future| until another
+///             thread is done, each step is posted to its runner once the
+///             steps it depends on are done:
+///
+///             auto image = fml::AsyncTask<Data>::Run(io_runner, LoadData)
+///                 .Then(worker_runner, Decode)
+///                 .Then(ui_runner, [](Image image) { ...; return image; });
+///
+///             The result of a step is moved to the next. A task has a single
+///             consumer: |Then| and |Get| take the task.
+///
+///             Canceling a task drops its result and skips the steps that
+///             depend on it, which are canceled in turn. A step that has
+///             already started runs to completion.
+///
+template <typename T>
+class AsyncTask {
+ public:
+  static_assert(!std::is_void_v<T> && !std::is_reference_v<T>,
+                "AsyncTask results must be values.");
+
+  /// Runs |function| on |runner| and completes with its result.
+  template <typename Function>
+  static AsyncTask Run(const internal::AsyncTaskRunner& runner,
+                       Function function) {
+    AsyncTask task;
+    runner.RunNowOrPostTask(fml::MakeCopyable(
+        [state = task.state_, function = std::move(function)]() mutable {
+          if (!state->IsCanceled()) {
+            state->Complete(function());
+          }
+        }));
+    return task;
+  }
+
+  /// Returns a task that is already complete with |value|.
+  static AsyncTask FromValue(T value) {
+    AsyncTask task;
+    task.state_->Complete(std::move(value));
+    return task;
+  }
+
+  AsyncTask(AsyncTask&& other) = default;
+
+  AsyncTask& operator=(AsyncTask&& other) = default;
+
+  ~AsyncTask() = default;
+
+  bool IsValid() const { return !!state_; }
+
+  /// Runs |continuation| with the result of this task on |runner| once the
+  /// result is available, and completes with what it returns.
+  template <typename Function>
+  AsyncTask<std::invoke_result_t<Function, T>> Then(
+      const internal::AsyncTaskRunner& runner,
+      Function continuation) && {
+    using Result = std::invoke_result_t<Function, T>;
+    FML_DCHECK(IsValid());
+    AsyncTask<Result> next;
+    auto state = std::move(state_);
+    state->OnComplete(fml::MakeCopyable(
+        [state = state.get(), next_state = next.state_, runner,
+         continuation = std::move(continuation)](bool canceled) mutable {
+          if (canceled) {
+            next_state->Cancel();
+            return;
+          }
+          runner.RunNowOrPostTask(fml::MakeCopyable(
+              [state = fml::Ref(state), next_state,
+               continuation = std::move(continuation)]() mutable {
+                if (next_state->IsCanceled()) {
+                  return;
+                }
+                std::optional<T> value = state->Take();
+                if (!value.has_value()) {
+                  next_state->Cancel();
+                  return;
+                }
+                next_state->Complete(continuation(std::move(*value)));
+              }));
+        }));
+    return next;
+  }
+
+  /// Drops the result and skips the steps that depend on this task.
+  void Cancel() {
+    FML_DCHECK(IsValid());
+    state_->Cancel();
+  }
+
+  /// Blocks until the task is done or canceled. Don't wait on the thread of a
+  /// runner that the task still needs to run a step on.
+  void Wait() const {
+    FML_DCHECK(IsValid());
+    state_->Wait();
+  }
+
+  /// Waits for the task and takes its result, or returns nothing if it was
+  /// canceled.
+  std::optional<T> Get() && {
+    FML_DCHECK(IsValid());
+    auto state = std::move(state_);
+    state->Wait();
+    return state->Take();
+  }
+
+ private:
+  template <typename U>
+  friend class AsyncTask;
+
+  template <typename... Ts>
+  friend AsyncTask<std::tuple<Ts...>> WhenAll(AsyncTask<Ts>... tasks);
+
+  fml::RefPtr<internal::AsyncTaskState<T>> state_;
+
+  AsyncTask() : state_(fml::MakeRefCounted<internal::AsyncTaskState<T>>()) {}
+
+  template <typename... Ts, size_t... Indices>
+  static AsyncTask WhenAll(std::index_sequence<Indices...>,
+                           AsyncTask<Ts>... tasks) {
+    AsyncTask result;
+    auto all = fml::MakeRefCounted<internal::WhenAllState<Ts...>>();
+    (AddToWhenAll<Indices>(std::move(tasks.state_), all, result.state_), ...);
+    return result;
+  }
+
+  // Stores the result of |state| in its slot of |all|. The last task to finish
+  // completes |result|.
+  template <size_t Index, typename U, typename... Ts>
+  static void AddToWhenAll(fml::RefPtr<internal::AsyncTaskState<U>> state,
+                           fml::RefPtr<internal::WhenAllState<Ts...>> all,
+                           fml::RefPtr<internal::AsyncTaskState<T>> result) {
+    state->OnComplete([state = state.get(), all = std::move(all),
+                       result = std::move(result)](bool canceled) {
+      if (canceled) {
+        result->Cancel();
+        return;
+      }
+      std::get<Index>(all->values) = state->Take();
+      if (all->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        result->Complete(std::apply(
+            [](auto&... values) { return T(std::move(*values)...); },
+            all->values));
+      }
+    });
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(AsyncTask);
+};
+
+template <typename... Ts>
+AsyncTask<std::tuple<Ts...>> WhenAll(AsyncTask<Ts>... tasks) {
+  static_assert(sizeof...(Ts) > 0, "WhenAll needs at least one task.");
+  return AsyncTask<std::tuple<Ts...>>::WhenAll(std::index_sequence_for<Ts...>(),
+                                               std::move(tasks)...);
+}
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_ASYNC_TASK_H_
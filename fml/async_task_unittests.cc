@@ -0,0 +1,151 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#define FML_USED_ON_EMBEDDER
+
+#include "flutter/fml/async_task.h"
+
+#include <memory>
+#include <string>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/message_loop.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace testing {
+
+TEST(AsyncTaskTest, RunsStepsOnTheirRunners) {
+  fml::Thread thread1("thread1");
+  fml::Thread thread2("thread2");
+  auto runner1 = thread1.GetTaskRunner();
+  auto runner2 = thread2.GetTaskRunner();
+
+  auto task = AsyncTask<int>::Run(runner1,
+                                  [runner1]() {
+                                    EXPECT_TRUE(
+                                        runner1->RunsTasksOnCurrentThread());
+                                    return 1;
+                                  })
+                  .Then(runner2, [runner2](int value) {
+                    EXPECT_TRUE(runner2->RunsTasksOnCurrentThread());
+                    return std::to_string(value + 1);
+                  });
+  ASSERT_EQ(std::move(task).Get(), "2");
+}
+
+TEST(AsyncTaskTest, RunsNowOnTheCurrentThread) {
+  fml::MessageLoop::EnsureInitializedForCurrentThread();
+  auto runner = fml::MessageLoop::GetCurrent().GetTaskRunner();
+  auto task = AsyncTask<int>::FromValue(1).Then(
+      runner, [](int value) { return value + 1; });
+  // Doesn't wait for the message loop to run.
+  ASSERT_EQ(std::move(task).Get(), 2);
+}
+
+TEST(AsyncTaskTest, MovesResultsBetweenSteps) {
+  fml::Thread thread("thread");
+  auto task = AsyncTask<std::unique_ptr<int>>::Run(
+                  thread.GetTaskRunner(),
+                  []() { return std::make_unique<int>(1); })
+                  .Then(thread.GetTaskRunner(),
+                        [](std::unique_ptr<int> value) {
+                          *value += 1;
+                          return value;
+                        });
+  auto result = std::move(task).Get();
+  ASSERT_TRUE(result.has_value());
+  ASSERT_EQ(**result, 2);
+}
+
+TEST(AsyncTaskTest, WhenAllWaitsForAllTasks) {
+  fml::Thread thread1("thread1");
+  fml::Thread thread2("thread2");
+  fml::AutoResetWaitableEvent latch;
+  auto first = AsyncTask<int>::Run(thread1.GetTaskRunner(), [&latch]() {
+    latch.Wait();
+    return 1;
+  });
+  auto second = AsyncTask<std::string>::Run(thread2.GetTaskRunner(),
+                                            []() { return std::string("2"); });
+  auto all = WhenAll(std::move(first), std::move(second))
+                 .Then(thread2.GetTaskRunner(),
+                       [](std::tuple<int, std::string> values) {
+                         return std::to_string(std::get<0>(values)) +
+                                std::get<1>(values);
+                       });
+  latch.Signal();
+  ASSERT_EQ(std::move(all).Get(), "12");
+}
+
+TEST(AsyncTaskTest, CancelSkipsDependentSteps) {
+  fml::Thread thread("thread");
+  fml::AutoResetWaitableEvent latch;
+  bool ran_continuation = false;
+  auto task = AsyncTask<int>::Run(thread.GetTaskRunner(),
+                                  [&latch]() {
+                                    latch.Wait();
+                                    return 1;
+                                  })
+                  .Then(thread.GetTaskRunner(), [&ran_continuation](int) {
+                    ran_continuation = true;
+                    return 2;
+                  });
+  auto last = std::move(task).Then(thread.GetTaskRunner(),
+                                   [](int value) { return value; });
+  last.Cancel();
+  latch.Signal();
+  ASSERT_FALSE(std::move(last).Get().has_value());
+  thread.Join();
+  ASSERT_TRUE(ran_continuation);
+}
+
+TEST(AsyncTaskTest, CancelPropagatesToDependentTasks) {
+  fml::Thread thread("thread");
+  fml::AutoResetWaitableEvent latch;
+  auto first = AsyncTask<int>::Run(thread.GetTaskRunner(), [&latch]() {
+    latch.Wait();
+    return 1;
+  });
+  first.Cancel();
+  bool ran_continuation = false;
+  auto second = std::move(first).Then(thread.GetTaskRunner(),
+                                      [&ran_continuation](int value) {
+                                        ran_continuation = true;
+                                        return value;
+                                      });
+  latch.Signal();
+  ASSERT_FALSE(std::move(second).Get().has_value());
+  ASSERT_FALSE(ran_continuation);
+}
+
+TEST(AsyncTaskTest, DroppedStepsCancelDependentTasks) {
+  // Drops its tasks, like a task runner that was shut down.
+  class DroppingTaskRunner : public fml::BasicTaskRunner {
+   public:
+    void PostTask(const fml::closure& task) override {}
+  };
+  auto runner = std::make_shared<DroppingTaskRunner>();
+  fml::Thread thread("thread");
+  auto task = AsyncTask<int>::Run(runner, []() { return 1; })
+                  .Then(thread.GetTaskRunner(),
+                        [](int value) { return value + 1; });
+  ASSERT_FALSE(std::move(task).Get().has_value());
+}
+
+TEST(AsyncTaskTest, RunsOnConcurrentTaskRunner) {
+  auto loop = fml::ConcurrentMessageLoop::Create(2);
+  fml::Thread thread("thread");
+  auto task = AsyncTask<int>::Run(loop->GetTaskRunner(), []() { return 1; })
+                  .Then(thread.GetTaskRunner(),
+                        [](int value) { return value + 1; })
+                  .Then(loop->GetTaskRunner(),
+                        [](int value) { return value * 2; });
+  ASSERT_EQ(std::move(task).Get(), 4);
+}
+
+}  // namespace testing
+}  // namespace fml
@@ -5,12 +5,26 @@
 #include "flutter/fml/concurrent_message_loop.h"
 
 #include <algorithm>
+#include <iterator>
 
 #include "flutter/fml/thread.h"
+#include "flutter/fml/thread_local.h"
 #include "flutter/fml/trace_event.h"
 
 namespace fml {
 
+namespace {
+
+// Identifies the worker, if any, that the current thread is.
+struct CurrentWorker {
+  const ConcurrentMessageLoop* loop;
+  size_t worker_index;
+};
+
+}  // namespace
+
+FML_THREAD_LOCAL ThreadLocalUniquePtr<CurrentWorker> tls_current_worker;
+
 std::shared_ptr<ConcurrentMessageLoop> ConcurrentMessageLoop::Create(
     size_t worker_count) {
   return std::shared_ptr<ConcurrentMessageLoop>{
@@ -19,17 +33,17 @@ std::shared_ptr<ConcurrentMessageLoop> ConcurrentMessageLoop::Create(
 
 ConcurrentMessageLoop::ConcurrentMessageLoop(size_t worker_count)
     : worker_count_(std::max<size_t>(worker_count, 1ul)) {
+  for (size_t i = 0; i < worker_count_; ++i) {
+    worker_queues_.emplace_back(std::make_unique<WorkerQueue>());
+  }
+
   for (size_t i = 0; i < worker_count_; ++i) {
     workers_.emplace_back([i, this]() {
       fml::Thread::SetCurrentThreadName(fml::Thread::ThreadConfig(
           std::string{"io.worker." + std::to_string(i + 1)}));
-      WorkerMain();
+      WorkerMain(i);
     });
   }
-
-  for (const auto& worker : workers_) {
-    worker_thread_ids_.emplace_back(worker.get_id());
-  }
 }
 
 ConcurrentMessageLoop::~ConcurrentMessageLoop() {
@@ -47,58 +61,167 @@ std::shared_ptr<ConcurrentTaskRunner> ConcurrentMessageLoop::GetTaskRunner() {
   return std::make_shared<ConcurrentTaskRunner>(weak_from_this());
 }
 
-void ConcurrentMessageLoop::PostTask(const fml::closure& task) {
+size_t ConcurrentMessageLoop::GetQueueForPostingThread() {
+  // Keep tasks posted by a worker local to it. Other workers will steal them
+  // if it falls behind.
+  const CurrentWorker* current_worker = tls_current_worker.get();
+  if (current_worker && current_worker->loop == this) {
+    return current_worker->worker_index;
+  }
+  return next_worker_++ % worker_count_;
+}
+
+void ConcurrentMessageLoop::PostTask(const fml::closure& task,
+                                     TaskPriority priority) {
   if (!task) {
     return;
   }
 
-  std::unique_lock lock(tasks_mutex_);
-
   // Don't just drop tasks on the floor in case of shutdown.
   if (shutdown_) {
     FML_DLOG(WARNING)
         << "Tried to post a task to shutdown concurrent message "
            "loop. The task will be executed on the callers thread.";
-    lock.unlock();
     task();
     return;
   }
 
-  tasks_.push(task);
+  const size_t priority_index = static_cast<size_t>(priority);
+  {
+    auto& queue = *worker_queues_[GetQueueForPostingThread()];
+    std::scoped_lock lock(queue.mutex);
+    queue.tasks[priority_index].push_back(task);
+    ++pending_tasks_[priority_index];
+  }
+
+  WakeUpWorkers(1);
+}
+
+void ConcurrentMessageLoop::PostTasks(std::vector<fml::closure> tasks,
+                                      TaskPriority priority) {
+  tasks.erase(std::remove(tasks.begin(), tasks.end(), nullptr), tasks.end());
+  if (tasks.empty()) {
+    return;
+  }
+
+  if (shutdown_) {
+    FML_DLOG(WARNING)
+        << "Tried to post tasks to shutdown concurrent message "
+           "loop. The tasks will be executed on the callers thread.";
+    for (const auto& task : tasks) {
+      task();
+    }
+    return;
+  }
 
-  // Unlock the mutex before notifying the condition variable because that mutex
-  // has to be acquired on the other thread anyway. Waiting in this scope till
-  // it is acquired there is a pessimization.
-  lock.unlock();
+  const size_t priority_index = static_cast<size_t>(priority);
+  const size_t task_count = tasks.size();
+  const CurrentWorker* current_worker = tls_current_worker.get();
+  if (current_worker && current_worker->loop == this) {
+    auto& queue = *worker_queues_[current_worker->worker_index];
+    std::scoped_lock lock(queue.mutex);
+    auto& queue_tasks = queue.tasks[priority_index];
+    queue_tasks.insert(queue_tasks.end(),
+                       std::make_move_iterator(tasks.begin()),
+                       std::make_move_iterator(tasks.end()));
+    pending_tasks_[priority_index] += task_count;
+  } else {
+    // Spread the tasks evenly so that the workers don't have to steal them
+    // from one another.
+    const size_t tasks_per_queue =
+        (task_count + worker_count_ - 1) / worker_count_;
+    const size_t first_queue = next_worker_++;
+    auto next_task = tasks.begin();
+    for (size_t i = 0; next_task != tasks.end(); ++i) {
+      const size_t queue_task_count =
+          std::min<size_t>(tasks_per_queue, tasks.end() - next_task);
+      auto last_task = next_task + queue_task_count;
+      auto& queue = *worker_queues_[(first_queue + i) % worker_count_];
+      std::scoped_lock lock(queue.mutex);
+      auto& queue_tasks = queue.tasks[priority_index];
+      queue_tasks.insert(queue_tasks.end(), std::make_move_iterator(next_task),
+                         std::make_move_iterator(last_task));
+      pending_tasks_[priority_index] += queue_task_count;
+      next_task = last_task;
+    }
+  }
 
-  tasks_condition_.notify_one();
+  WakeUpWorkers(task_count);
 }
 
-void ConcurrentMessageLoop::WorkerMain() {
-  while (true) {
-    std::unique_lock lock(tasks_mutex_);
-    tasks_condition_.wait(lock, [&]() {
-      return !tasks_.empty() || shutdown_ || HasThreadTasksLocked();
-    });
+void ConcurrentMessageLoop::WakeUpWorkers(size_t task_count) {
+  // Workers count themselves as idle before they check for pending tasks and
+  // go to sleep, and the tasks have been counted as pending already. So if no
+  // worker is idle, any worker about to go to sleep will see the tasks.
+  if (idle_worker_count_ == 0) {
+    return;
+  }
 
-    // Shutdown cannot be read with the task mutex unlocked.
-    bool shutdown_now = shutdown_;
-    fml::closure task;
-    std::vector<fml::closure> thread_tasks;
+  // A worker that is idle but not yet waiting holds the mutex until it waits.
+  // Acquire it so that the notification is not missed, but don't hold onto it
+  // while notifying because the woken workers have to acquire it too.
+  { std::scoped_lock lock(tasks_mutex_); }
 
-    if (!tasks_.empty()) {
-      task = tasks_.front();
-      tasks_.pop();
+  if (task_count >= worker_count_) {
+    tasks_condition_.notify_all();
+  } else {
+    for (size_t i = 0; i < task_count; ++i) {
+      tasks_condition_.notify_one();
     }
+  }
+}
 
-    if (HasThreadTasksLocked()) {
-      thread_tasks = GetThreadTasksLocked();
-      FML_DCHECK(!HasThreadTasksLocked());
+bool ConcurrentMessageLoop::HasPendingTasks() const {
+  return std::any_of(std::begin(pending_tasks_), std::end(pending_tasks_),
+                     [](const auto& count) { return count > 0; });
+}
+
+fml::closure ConcurrentMessageLoop::PopTask(size_t worker_index) {
+  for (size_t priority = 0; priority < kPriorityCount; ++priority) {
+    if (pending_tasks_[priority] == 0) {
+      continue;
+    }
+    // Check the worker's own queue first, then steal from the others.
+    for (size_t i = 0; i < worker_count_; ++i) {
+      auto& queue = *worker_queues_[(worker_index + i) % worker_count_];
+      std::scoped_lock lock(queue.mutex);
+      auto& queue_tasks = queue.tasks[priority];
+      if (!queue_tasks.empty()) {
+        fml::closure task = std::move(queue_tasks.front());
+        queue_tasks.pop_front();
+        --pending_tasks_[priority];
+        return task;
+      }
+    }
+  }
+  return nullptr;
+}
+
+void ConcurrentMessageLoop::WorkerMain(size_t worker_index) {
+  tls_current_worker.reset(new CurrentWorker{this, worker_index});
+  auto& queue = *worker_queues_[worker_index];
+
+  while (true) {
+    fml::closure task = PopTask(worker_index);
+
+    if (!task && !queue.has_thread_tasks && !shutdown_) {
+      std::unique_lock lock(tasks_mutex_);
+      ++idle_worker_count_;
+      tasks_condition_.wait(lock, [&]() {
+        return HasPendingTasks() || shutdown_ || queue.has_thread_tasks;
+      });
+      --idle_worker_count_;
+      continue;
     }
 
-    // Don't hold onto the mutex while tasks are being executed as they could
-    // themselves try to post more tasks to the message loop.
-    lock.unlock();
+    bool shutdown_now = shutdown_;
+    std::vector<fml::closure> thread_tasks;
+
+    if (queue.has_thread_tasks) {
+      std::scoped_lock lock(tasks_mutex_);
+      std::swap(thread_tasks, queue.thread_tasks);
+      queue.has_thread_tasks = false;
+    }
 
     TRACE_EVENT0("flutter", "ConcurrentWorkerWake");
     // Execute the primary task we woke up for.
@@ -129,25 +252,13 @@ void ConcurrentMessageLoop::PostTaskToAllWorkers(const fml::closure& task) {
   }
 
   std::scoped_lock lock(tasks_mutex_);
-  for (const auto& worker_thread_id : worker_thread_ids_) {
-    thread_tasks_[worker_thread_id].emplace_back(task);
+  for (auto& queue : worker_queues_) {
+    queue->thread_tasks.emplace_back(task);
+    queue->has_thread_tasks = true;
   }
   tasks_condition_.notify_all();
 }
 
-bool ConcurrentMessageLoop::HasThreadTasksLocked() const {
-  return thread_tasks_.count(std::this_thread::get_id()) > 0;
-}
-
-std::vector<fml::closure> ConcurrentMessageLoop::GetThreadTasksLocked() {
-  auto found = thread_tasks_.find(std::this_thread::get_id());
-  FML_DCHECK(found != thread_tasks_.end());
-  std::vector<fml::closure> pending_tasks;
-  std::swap(pending_tasks, found->second);
-  thread_tasks_.erase(found);
-  return pending_tasks;
-}
-
 ConcurrentTaskRunner::ConcurrentTaskRunner(
     std::weak_ptr<ConcurrentMessageLoop> weak_loop)
     : weak_loop_(std::move(weak_loop)) {}
@@ -159,8 +270,18 @@ void ConcurrentTaskRunner::PostTask(const fml::closure& task) {
     return;
   }
 
+  PostTask(task, ConcurrentMessageLoop::TaskPriority::kNormal);
+}
+
+void ConcurrentTaskRunner::PostTask(
+    const fml::closure& task,
+    ConcurrentMessageLoop::TaskPriority priority) {
+  if (!task) {
+    return;
+  }
+
   if (auto loop = weak_loop_.lock()) {
-    loop->PostTask(task);
+    loop->PostTask(task, priority);
     return;
   }
 
@@ -170,4 +291,22 @@ void ConcurrentTaskRunner::PostTask(const fml::closure& task) {
   task();
 }
 
+void ConcurrentTaskRunner::PostTasks(
+    std::vector<fml::closure> tasks,
+    ConcurrentMessageLoop::TaskPriority priority) {
+  if (auto loop = weak_loop_.lock()) {
+    loop->PostTasks(std::move(tasks), priority);
+    return;
+  }
+
+  FML_DLOG(WARNING)
+      << "Tried to post to a concurrent message loop that has already died. "
+         "Executing the tasks on the callers thread.";
+  for (const auto& task : tasks) {
+    if (task) {
+      task();
+    }
+  }
+}
+
 }  // namespace fml
@@ -5,10 +5,13 @@
 #ifndef FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 #define FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 
+#include <atomic>
 #include <condition_variable>
-#include <map>
-#include <queue>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/closure.h"
 #include "flutter/fml/macros.h"
@@ -18,9 +21,25 @@ namespace fml {
 
 class ConcurrentTaskRunner;
 
+/// A pool of worker threads that run the tasks posted to its
+/// |ConcurrentTaskRunner|s.
+///
+/// Each worker has its own queue of tasks. Tasks posted from outside the pool
+/// are distributed over the queues in turn, and tasks posted from a worker go
+/// to that worker's own queue. Workers that run out of tasks steal from the
+/// queues of the other workers before going to sleep.
 class ConcurrentMessageLoop
     : public std::enable_shared_from_this<ConcurrentMessageLoop> {
  public:
+  /// Workers run all pending tasks of a higher priority before tasks of a
+  /// lower priority. Tasks of the same priority run in roughly the order they
+  /// were posted.
+  enum class TaskPriority {
+    kHigh,
+    kNormal,
+    kLow,
+  };
+
   static std::shared_ptr<ConcurrentMessageLoop> Create(
       size_t worker_count = std::thread::hardware_concurrency());
 
@@ -37,24 +56,46 @@ class ConcurrentMessageLoop
  private:
   friend ConcurrentTaskRunner;
 
+  static constexpr size_t kPriorityCount = 3;
+
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<fml::closure> tasks[kPriorityCount];
+    // Guarded by |tasks_mutex_| of the loop.
+    std::vector<fml::closure> thread_tasks;
+    std::atomic_bool has_thread_tasks{false};
+  };
+
   size_t worker_count_ = 0;
+  std::vector<std::unique_ptr<WorkerQueue>> worker_queues_;
   std::vector<std::thread> workers_;
+  // The number of tasks of each priority in all the worker queues.
+  std::atomic_size_t pending_tasks_[kPriorityCount] = {};
+  std::atomic_size_t idle_worker_count_{0};
+  std::atomic_size_t next_worker_{0};
+  // Only taken by workers going to sleep and by posters that need to wake
+  // them up.
   std::mutex tasks_mutex_;
   std::condition_variable tasks_condition_;
-  std::queue<fml::closure> tasks_;
-  std::vector<std::thread::id> worker_thread_ids_;
-  std::map<std::thread::id, std::vector<fml::closure>> thread_tasks_;
-  bool shutdown_ = false;
+  std::atomic_bool shutdown_{false};
 
   explicit ConcurrentMessageLoop(size_t worker_count);
 
-  void WorkerMain();
+  void WorkerMain(size_t worker_index);
+
+  void PostTask(const fml::closure& task, TaskPriority priority);
 
-  void PostTask(const fml::closure& task);
+  void PostTasks(std::vector<fml::closure> tasks, TaskPriority priority);
 
-  bool HasThreadTasksLocked() const;
+  // Returns the worker queue that tasks posted from the current thread
+  // should go to.
+  size_t GetQueueForPostingThread();
 
-  std::vector<fml::closure> GetThreadTasksLocked();
+  void WakeUpWorkers(size_t task_count);
+
+  bool HasPendingTasks() const;
+
+  fml::closure PopTask(size_t worker_index);
 
   FML_DISALLOW_COPY_AND_ASSIGN(ConcurrentMessageLoop);
 };
@@ -67,6 +108,16 @@ class ConcurrentTaskRunner : public BasicTaskRunner {
 
   void PostTask(const fml::closure& task) override;
 
+  void PostTask(const fml::closure& task,
+                ConcurrentMessageLoop::TaskPriority priority);
+
+  /// Posts all of |tasks| at once. This takes fewer locks and wakes up the
+  /// workers needed to run them in one go, which is cheaper than posting
+  /// them one by one.
+  void PostTasks(std::vector<fml::closure> tasks,
+                 ConcurrentMessageLoop::TaskPriority priority =
+                     ConcurrentMessageLoop::TaskPriority::kNormal);
+
  private:
   friend ConcurrentMessageLoop;
 
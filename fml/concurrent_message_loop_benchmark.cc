@@ -0,0 +1,110 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/concurrent_message_loop.h"
+
+#include <thread>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+
+namespace fml {
+namespace benchmarking {
+
+static const size_t kWorkerCount = 4;
+static const size_t kTaskCount = 1000;
+
+// Posts a burst of tasks one at a time from outside the loop, like a burst of
+// image decodes.
+static void BM_ConcurrentMessageLoopPostTasks(
+    benchmark::State& state) {  // NOLINT
+  auto loop = ConcurrentMessageLoop::Create(kWorkerCount);
+  auto task_runner = loop->GetTaskRunner();
+  while (state.KeepRunning()) {
+    CountDownLatch latch(kTaskCount);
+    for (size_t i = 0; i < kTaskCount; i++) {
+      task_runner->PostTask([&latch]() { latch.CountDown(); });
+    }
+    latch.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * kTaskCount);
+}
+
+BENCHMARK(BM_ConcurrentMessageLoopPostTasks)->UseRealTime();
+
+// Posts the same burst as one batch.
+static void BM_ConcurrentMessageLoopPostTaskBatch(
+    benchmark::State& state) {  // NOLINT
+  auto loop = ConcurrentMessageLoop::Create(kWorkerCount);
+  auto task_runner = loop->GetTaskRunner();
+  while (state.KeepRunning()) {
+    CountDownLatch latch(kTaskCount);
+    std::vector<fml::closure> tasks;
+    tasks.reserve(kTaskCount);
+    for (size_t i = 0; i < kTaskCount; i++) {
+      tasks.emplace_back([&latch]() { latch.CountDown(); });
+    }
+    task_runner->PostTasks(std::move(tasks));
+    latch.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * kTaskCount);
+}
+
+BENCHMARK(BM_ConcurrentMessageLoopPostTaskBatch)->UseRealTime();
+
+// Posts tasks from several threads at once while the workers run them.
+static void BM_ConcurrentMessageLoopContendedPostTasks(
+    benchmark::State& state) {  // NOLINT
+  const size_t num_producers = state.range(0);
+  auto loop = ConcurrentMessageLoop::Create(kWorkerCount);
+  auto task_runner = loop->GetTaskRunner();
+  while (state.KeepRunning()) {
+    CountDownLatch latch(num_producers * kTaskCount);
+    std::vector<std::thread> producers;
+    for (size_t i = 0; i < num_producers; i++) {
+      producers.emplace_back([&]() {
+        for (size_t j = 0; j < kTaskCount; j++) {
+          task_runner->PostTask([&latch]() { latch.CountDown(); });
+        }
+      });
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+    latch.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * num_producers * kTaskCount);
+}
+
+BENCHMARK(BM_ConcurrentMessageLoopContendedPostTasks)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime();
+
+// Each task posted from outside the loop fans out into more tasks from its
+// worker, which the other workers have to steal to stay busy.
+static void BM_ConcurrentMessageLoopNestedPostTasks(
+    benchmark::State& state) {  // NOLINT
+  const size_t kFanOut = 10;
+  auto loop = ConcurrentMessageLoop::Create(kWorkerCount);
+  auto task_runner = loop->GetTaskRunner();
+  while (state.KeepRunning()) {
+    CountDownLatch latch(kTaskCount);
+    for (size_t i = 0; i < kTaskCount / kFanOut; i++) {
+      task_runner->PostTask([&]() {
+        for (size_t j = 0; j < kFanOut; j++) {
+          task_runner->PostTask([&latch]() { latch.CountDown(); });
+        }
+      });
+    }
+    latch.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * kTaskCount);
+}
+
+BENCHMARK(BM_ConcurrentMessageLoopNestedPostTasks)->UseRealTime();
+
+}  // namespace benchmarking
+}  // namespace fml
@@ -6,25 +6,33 @@
 
 #include "flutter/fml/delayed_task.h"
 
+#include <algorithm>
+
 namespace fml {
 
 DelayedTask::DelayedTask(size_t order,
-                         const fml::closure& task,
+                         fml::UniqueClosure task,
                          fml::TimePoint target_time,
                          fml::TaskSourceGrade task_source_grade)
     : order_(order),
-      task_(task),
+      task_(std::move(task)),
       target_time_(target_time),
       task_source_grade_(task_source_grade) {}
 
 DelayedTask::~DelayedTask() = default;
 
-DelayedTask::DelayedTask(const DelayedTask& other) = default;
+DelayedTask::DelayedTask(DelayedTask&& other) = default;
+
+DelayedTask& DelayedTask::operator=(DelayedTask&& other) = default;
 
-const fml::closure& DelayedTask::GetTask() const {
+const fml::UniqueClosure& DelayedTask::GetTask() const {
   return task_;
 }
 
+fml::UniqueClosure DelayedTask::TakeTask() {
+  return std::move(task_);
+}
+
 fml::TimePoint DelayedTask::GetTargetTime() const {
   return target_time_;
 }
@@ -40,4 +48,11 @@ bool DelayedTask::operator>(const DelayedTask& other) const {
   return target_time_ > other.target_time_;
 }
 
+DelayedTask DelayedTaskQueue::TakeTop() {
+  std::pop_heap(c.begin(), c.end(), comp);
+  DelayedTask top = std::move(c.back());
+  c.pop_back();
+  return top;
+}
+
 }  // namespace fml
@@ -6,25 +6,32 @@
 #define FLUTTER_FML_DELAYED_TASK_H_
 
 #include <queue>
+#include <vector>
 
-#include "flutter/fml/closure.h"
 #include "flutter/fml/task_source_grade.h"
 #include "flutter/fml/time/time_point.h"
+#include "flutter/fml/unique_closure.h"
 
 namespace fml {
 
 class DelayedTask {
  public:
   DelayedTask(size_t order,
-              const fml::closure& task,
+              fml::UniqueClosure task,
               fml::TimePoint target_time,
               fml::TaskSourceGrade task_source_grade);
 
-  DelayedTask(const DelayedTask& other);
+  DelayedTask(DelayedTask&& other);
+
+  DelayedTask& operator=(DelayedTask&& other);
 
   ~DelayedTask();
 
-  const fml::closure& GetTask() const;
+  const fml::UniqueClosure& GetTask() const;
+
+  /// Moves the task out of this DelayedTask, which must no longer be in a
+  /// |DelayedTaskQueue|.
+  fml::UniqueClosure TakeTask();
 
   fml::TimePoint GetTargetTime() const;
 
@@ -34,14 +41,23 @@ class DelayedTask {
 
  private:
   size_t order_;
-  fml::closure task_;
+  fml::UniqueClosure task_;
   fml::TimePoint target_time_;
   fml::TaskSourceGrade task_source_grade_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DelayedTask);
 };
 
-using DelayedTaskQueue = std::priority_queue<DelayedTask,
-                                             std::deque<DelayedTask>,
-                                             std::greater<DelayedTask>>;
+// Backed by a vector, which unlike a deque keeps its storage as tasks are
+// popped, so that steady state posting doesn't allocate.
+class DelayedTaskQueue : public std::priority_queue<DelayedTask,
+                                                    std::vector<DelayedTask>,
+                                                    std::greater<DelayedTask>> {
+ public:
+  /// Removes the top task and returns it. Unlike |top| followed by |pop|, this
+  /// doesn't require copying the task.
+  DelayedTask TakeTop();
+};
 
 }  // namespace fml
 
@@ -0,0 +1,124 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/memory/ref_counted.h"
+#include "flutter/fml/memory/weak_ptr.h"
+
+namespace fml {
+namespace benchmarking {
+
+namespace {
+
+class Target {
+ public:
+  Target() : weak_factory_(this) {}
+
+  WeakPtr<Target> GetWeakPtr() const { return weak_factory_.GetWeakPtr(); }
+
+  int value() const { return value_; }
+
+ private:
+  int value_ = 1;
+  WeakPtrFactory<Target> weak_factory_;
+};
+
+class RefCountedTarget : public RefCountedThreadSafe<RefCountedTarget> {
+ private:
+  RefCountedTarget() = default;
+
+  FML_FRIEND_REF_COUNTED_THREAD_SAFE(RefCountedTarget);
+  FML_FRIEND_MAKE_REF_COUNTED(RefCountedTarget);
+};
+
+}  // namespace
+
+// Copies and destroys a weak pointer that all threads share a flag with, like
+// the weak pointers captured by tasks posted from many threads.
+static void BM_WeakPtrCopy(benchmark::State& state) {  // NOLINT
+  // Shared by all threads and never destroyed.
+  static const Target* target = new Target();
+  const WeakPtr<Target> weak_ptr = target->GetWeakPtr();
+  for (auto _ : state) {
+    WeakPtr<Target> copy = weak_ptr;
+    benchmark::DoNotOptimize(copy);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_WeakPtrCopy)->ThreadRange(1, 8)->UseRealTime();
+
+// Checks and dereferences a weak pointer on the thread of its factory.
+static void BM_WeakPtrDeref(benchmark::State& state) {  // NOLINT
+  Target target;
+  WeakPtr<Target> weak_ptr = target.GetWeakPtr();
+  int sum = 0;
+  for (auto _ : state) {
+    if (weak_ptr) {
+      sum += weak_ptr->value();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_WeakPtrDeref);
+
+// Creates a factory, vends |state.range(0)| weak pointers and invalidates them
+// by destroying the factory, on every thread concurrently.
+static void BM_WeakPtrInvalidate(benchmark::State& state) {  // NOLINT
+  const auto weak_ptr_count = static_cast<size_t>(state.range(0));
+  std::vector<WeakPtr<Target>> weak_ptrs;
+  weak_ptrs.reserve(weak_ptr_count);
+  for (auto _ : state) {
+    {
+      Target target;
+      for (size_t i = 0; i < weak_ptr_count; i++) {
+        weak_ptrs.push_back(target.GetWeakPtr());
+      }
+    }
+    benchmark::DoNotOptimize(weak_ptrs.data());
+    weak_ptrs.clear();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_WeakPtrInvalidate)
+    ->Arg(0)
+    ->Arg(1)
+    ->Arg(8)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+// Copies and destroys a reference that all threads share, like the task
+// runners captured by tasks posted from many threads.
+static void BM_RefPtrCopy(benchmark::State& state) {  // NOLINT
+  // Shared by all threads and never destroyed.
+  static const auto* ref =
+      new RefPtr<RefCountedTarget>(MakeRefCounted<RefCountedTarget>());
+  for (auto _ : state) {
+    RefPtr<RefCountedTarget> copy = *ref;
+    benchmark::DoNotOptimize(copy);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_RefPtrCopy)->ThreadRange(1, 8)->UseRealTime();
+
+// Creates and destroys a reference counted object that is never shared, which
+// takes the last-reference fast path of |Release|.
+static void BM_RefPtrCreateAndRelease(benchmark::State& state) {  // NOLINT
+  for (auto _ : state) {
+    auto ref = MakeRefCounted<RefCountedTarget>();
+    benchmark::DoNotOptimize(ref);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_RefPtrCreateAndRelease);
+
+}  // namespace benchmarking
+}  // namespace fml
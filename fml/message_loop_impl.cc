@@ -53,15 +53,17 @@ MessageLoopImpl::~MessageLoopImpl() {
   task_queue_->Dispose(queue_id_);
 }
 
-void MessageLoopImpl::PostTask(const fml::closure& task,
-                               fml::TimePoint target_time) {
-  FML_DCHECK(task != nullptr);
+void MessageLoopImpl::PostTask(fml::UniqueClosure task,
+                               fml::TimePoint target_time,
+                               fml::TaskSourceGrade task_source_grade) {
+  FML_DCHECK(task);
   if (terminated_) {
     // If the message loop has already been terminated, PostTask should destruct
     // |task| synchronously within this function.
     return;
   }
-  task_queue_->RegisterTask(queue_id_, task, target_time);
+  task_queue_->RegisterTask(queue_id_, std::move(task), target_time,
+                            task_source_grade);
 }
 
 void MessageLoopImpl::AddTaskObserver(intptr_t key,
@@ -117,7 +119,7 @@ void MessageLoopImpl::DoTerminate() {
 
 void MessageLoopImpl::FlushTasks(FlushType type) {
   const auto now = fml::TimePoint::Now();
-  fml::closure invocation;
+  fml::UniqueClosure invocation;
   do {
     invocation = task_queue_->GetNextTaskToRun(queue_id_, now);
     if (!invocation) {
@@ -143,6 +145,10 @@ void MessageLoopImpl::RunSingleExpiredTaskNow() {
   FlushTasks(FlushType::kSingle);
 }
 
+fml::RefPtr<MessageLoopImpl> MessageLoopImpl::GetCurrent() {
+  return MessageLoop::GetCurrent().GetLoopImpl();
+}
+
 TaskQueueId MessageLoopImpl::GetTaskQueueId() const {
   return queue_id_;
 }
@@ -10,10 +10,13 @@
 #include <iostream>
 #include <memory>
 #include <optional>
+#include <string>
 
 #include "flutter/fml/make_copyable.h"
+#include "flutter/fml/metrics.h"
 #include "flutter/fml/task_source.h"
 #include "flutter/fml/thread_local.h"
+#include "flutter/fml/trace_event.h"
 
 namespace fml {
 
@@ -30,6 +33,20 @@ class TaskSourceGradeHolder {
   explicit TaskSourceGradeHolder(TaskSourceGrade task_source_grade_arg)
       : task_source_grade(task_source_grade_arg) {}
 };
+
+const char* TaskLatencyCounterName(TaskSourceGrade grade) {
+  switch (grade) {
+    case TaskSourceGrade::kUserInteraction:
+      return "UserInteraction";
+    case TaskSourceGrade::kDartMicroTasks:
+      return "DartMicroTasks";
+    case TaskSourceGrade::kUnspecified:
+      return "Unspecified";
+    case TaskSourceGrade::kIdle:
+      return "Idle";
+  }
+  FML_UNREACHABLE();
+}
 }  // namespace
 
 FML_THREAD_LOCAL ThreadLocalUniquePtr<TaskSourceGradeHolder>
@@ -47,8 +64,22 @@ MessageLoopTaskQueues* MessageLoopTaskQueues::GetInstance() {
   return instance;
 }
 
+MessageLoopTaskQueues::QueueGroupLock::QueueGroupLock(
+    const MessageLoopTaskQueues& queues,
+    TaskQueueId owner) {
+  const auto& entry = queues.queue_entries_.at(owner);
+  owner_lock_ = std::unique_lock(entry->mutex);
+  if (entry->owner_of.empty()) {
+    return;
+  }
+  subsumed_locks_.reserve(entry->owner_of.size());
+  for (TaskQueueId subsumed : entry->owner_of) {
+    subsumed_locks_.emplace_back(queues.queue_entries_.at(subsumed)->mutex);
+  }
+}
+
 TaskQueueId MessageLoopTaskQueues::CreateTaskQueue() {
-  std::lock_guard guard(queue_mutex_);
+  fml::UniqueLock lock(*queue_mutex_);
   TaskQueueId loop_id = TaskQueueId(task_queue_id_counter_);
   ++task_queue_id_counter_;
   queue_entries_[loop_id] = std::make_unique<TaskQueueEntry>(loop_id);
@@ -56,7 +87,9 @@ TaskQueueId MessageLoopTaskQueues::CreateTaskQueue() {
 }
 
 MessageLoopTaskQueues::MessageLoopTaskQueues()
-    : task_queue_id_counter_(0), order_(0) {
+    : queue_mutex_(fml::SharedMutex::Create()),
+      task_queue_id_counter_(0),
+      order_(0) {
   tls_task_source_grade.reset(
       new TaskSourceGradeHolder{TaskSourceGrade::kUnspecified});
 }
@@ -64,7 +97,7 @@ MessageLoopTaskQueues::MessageLoopTaskQueues()
 MessageLoopTaskQueues::~MessageLoopTaskQueues() = default;
 
 void MessageLoopTaskQueues::Dispose(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
+  fml::UniqueLock lock(*queue_mutex_);
   const auto& queue_entry = queue_entries_.at(queue_id);
   FML_DCHECK(queue_entry->subsumed_by == _kUnmerged);
   auto& subsumed_set = queue_entry->owner_of;
@@ -76,7 +109,8 @@ void MessageLoopTaskQueues::Dispose(TaskQueueId queue_id) {
 }
 
 void MessageLoopTaskQueues::DisposeTasks(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock lock(*queue_mutex_);
+  QueueGroupLock group_lock(*this, queue_id);
   const auto& queue_entry = queue_entries_.at(queue_id);
   FML_DCHECK(queue_entry->subsumed_by == _kUnmerged);
   auto& subsumed_set = queue_entry->owner_of;
@@ -92,18 +126,20 @@ TaskSourceGrade MessageLoopTaskQueues::GetCurrentTaskSourceGrade() {
 
 void MessageLoopTaskQueues::RegisterTask(
     TaskQueueId queue_id,
-    const fml::closure& task,
+    fml::UniqueClosure task,
     fml::TimePoint target_time,
     fml::TaskSourceGrade task_source_grade) {
-  std::lock_guard guard(queue_mutex_);
-  size_t order = order_++;
+  fml::SharedLock lock(*queue_mutex_);
   const auto& queue_entry = queue_entries_.at(queue_id);
-  queue_entry->task_source->RegisterTask(
-      {order, task, target_time, task_source_grade});
   TaskQueueId loop_to_wake = queue_id;
   if (queue_entry->subsumed_by != _kUnmerged) {
     loop_to_wake = queue_entry->subsumed_by;
   }
+  // The group of the loop to wake includes |queue_id|.
+  QueueGroupLock group_lock(*this, loop_to_wake);
+  size_t order = order_++;
+  queue_entry->task_source->RegisterTask(
+      {order, std::move(task), target_time, task_source_grade});
 
   // This can happen when the secondary tasks are paused.
   if (HasPendingTasksUnlocked(loop_to_wake)) {
@@ -112,32 +148,57 @@ void MessageLoopTaskQueues::RegisterTask(
 }
 
 bool MessageLoopTaskQueues::HasPendingTasks(TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock lock(*queue_mutex_);
+  QueueGroupLock group_lock(*this, queue_id);
   return HasPendingTasksUnlocked(queue_id);
 }
 
-fml::closure MessageLoopTaskQueues::GetNextTaskToRun(TaskQueueId queue_id,
-                                                     fml::TimePoint from_time) {
-  std::lock_guard guard(queue_mutex_);
-  if (!HasPendingTasksUnlocked(queue_id)) {
-    return nullptr;
-  }
-  TaskSource::TopTask top = PeekNextTaskUnlocked(queue_id);
+fml::UniqueClosure MessageLoopTaskQueues::GetNextTaskToRun(
+    TaskQueueId queue_id,
+    fml::TimePoint from_time) {
+  fml::UniqueClosure invocation;
+  TaskSourceGrade task_source_grade;
+  fml::TimePoint target_time;
+  {
+    fml::SharedLock lock(*queue_mutex_);
+    QueueGroupLock group_lock(*this, queue_id);
+    if (!HasPendingTasksUnlocked(queue_id)) {
+      return nullptr;
+    }
+    TaskSource::TopTask top = PeekNextTaskUnlocked(queue_id);
 
-  if (!HasPendingTasksUnlocked(queue_id)) {
-    WakeUpUnlocked(queue_id, fml::TimePoint::Max());
-  } else {
-    WakeUpUnlocked(queue_id, GetNextWakeTimeUnlocked(queue_id));
-  }
+    if (!HasPendingTasksUnlocked(queue_id)) {
+      WakeUpUnlocked(queue_id, fml::TimePoint::Max());
+    } else {
+      WakeUpUnlocked(queue_id, GetNextWakeTimeUnlocked(queue_id));
+    }
 
-  if (top.task.GetTargetTime() > from_time) {
-    return nullptr;
+    if (top.target_time > from_time) {
+      return nullptr;
+    }
+    task_source_grade = top.task.GetTaskSourceGrade();
+    target_time = top.task.GetTargetTime();
+    const auto& queue_entry = queue_entries_.at(top.task_queue_id);
+    const auto& task_source = queue_entry->task_source;
+    // Sampled when a task is run rather than when tasks are posted, so that
+    // the histogram of a queue is only updated by the thread running it and
+    // not by every thread that posts to it.
+    if (queue_entry->depth_histogram) {
+      queue_entry->depth_histogram->Record(task_source->GetNumPendingTasks());
+    }
+    invocation = task_source->PopTask(task_source_grade).TakeTask();
   }
-  fml::closure invocation = top.task.GetTask();
-  queue_entries_.at(top.task_queue_id)
-      ->task_source->PopTask(top.task.GetTaskSourceGrade());
-  const auto task_source_grade = top.task.GetTaskSourceGrade();
-  tls_task_source_grade.reset(new TaskSourceGradeHolder{task_source_grade});
+  // Reuse the holder of this thread rather than allocating one per task.
+  if (auto* holder = tls_task_source_grade.get()) {
+    holder->task_source_grade = task_source_grade;
+  } else {
+    tls_task_source_grade.reset(new TaskSourceGradeHolder{task_source_grade});
+  }
+  // The time the task waited past its target time, including the time an idle
+  // task was held back by a frame deadline.
+  FML_TRACE_COUNTER("flutter", "TaskLatency", static_cast<int64_t>(queue_id),
+                    TaskLatencyCounterName(task_source_grade),
+                    (from_time - target_time).ToMicroseconds());
   return invocation;
 }
 
@@ -149,7 +210,8 @@ void MessageLoopTaskQueues::WakeUpUnlocked(TaskQueueId queue_id,
 }
 
 size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock lock(*queue_mutex_);
+  QueueGroupLock group_lock(*this, queue_id);
   const auto& queue_entry = queue_entries_.at(queue_id);
   if (queue_entry->subsumed_by != _kUnmerged) {
     return 0;
@@ -169,20 +231,25 @@ size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
 void MessageLoopTaskQueues::AddTaskObserver(TaskQueueId queue_id,
                                             intptr_t key,
                                             const fml::closure& callback) {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock lock(*queue_mutex_);
   FML_DCHECK(callback != nullptr) << "Observer callback must be non-null.";
-  queue_entries_.at(queue_id)->task_observers[key] = callback;
+  const auto& queue_entry = queue_entries_.at(queue_id);
+  std::lock_guard entry_lock(queue_entry->mutex);
+  queue_entry->task_observers[key] = callback;
 }
 
 void MessageLoopTaskQueues::RemoveTaskObserver(TaskQueueId queue_id,
                                                intptr_t key) {
-  std::lock_guard guard(queue_mutex_);
-  queue_entries_.at(queue_id)->task_observers.erase(key);
+  fml::SharedLock lock(*queue_mutex_);
+  const auto& queue_entry = queue_entries_.at(queue_id);
+  std::lock_guard entry_lock(queue_entry->mutex);
+  queue_entry->task_observers.erase(key);
 }
 
 std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
     TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock lock(*queue_mutex_);
+  QueueGroupLock group_lock(*this, queue_id);
   std::vector<fml::closure> observers;
 
   if (queue_entries_.at(queue_id)->subsumed_by != _kUnmerged) {
@@ -205,17 +272,32 @@ std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
 
 void MessageLoopTaskQueues::SetWakeable(TaskQueueId queue_id,
                                         fml::Wakeable* wakeable) {
-  std::lock_guard guard(queue_mutex_);
-  FML_CHECK(!queue_entries_.at(queue_id)->wakeable)
-      << "Wakeable can only be set once.";
-  queue_entries_.at(queue_id)->wakeable = wakeable;
+  fml::SharedLock lock(*queue_mutex_);
+  const auto& queue_entry = queue_entries_.at(queue_id);
+  std::lock_guard entry_lock(queue_entry->mutex);
+  FML_CHECK(!queue_entry->wakeable) << "Wakeable can only be set once.";
+  queue_entry->wakeable = wakeable;
+}
+
+void MessageLoopTaskQueues::SetLabel(TaskQueueId queue_id,
+                                     std::string_view label) {
+  std::string name = "fml.MessageLoop.";
+  name.append(label);
+  name.append(".TaskQueueDepth");
+  metrics::Histogram& histogram =
+      metrics::MetricsRegistry::GetInstance().GetHistogram(name);
+
+  fml::SharedLock lock(*queue_mutex_);
+  const auto& queue_entry = queue_entries_.at(queue_id);
+  std::lock_guard entry_lock(queue_entry->mutex);
+  queue_entry->depth_histogram = &histogram;
 }
 
 bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
   if (owner == subsumed) {
     return true;
   }
-  std::lock_guard guard(queue_mutex_);
+  fml::UniqueLock lock(*queue_mutex_);
   auto& owner_entry = queue_entries_.at(owner);
   auto& subsumed_entry = queue_entries_.at(subsumed);
   auto& subsumed_set = owner_entry->owner_of;
@@ -263,7 +345,7 @@ bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
 }
 
 bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner, TaskQueueId subsumed) {
-  std::lock_guard guard(queue_mutex_);
+  fml::UniqueLock lock(*queue_mutex_);
   const auto& owner_entry = queue_entries_.at(owner);
   if (owner_entry->owner_of.empty()) {
     FML_LOG(WARNING)
@@ -307,7 +389,7 @@ bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner, TaskQueueId subsumed) {
 
 bool MessageLoopTaskQueues::Owns(TaskQueueId owner,
                                  TaskQueueId subsumed) const {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock lock(*queue_mutex_);
   if (owner == _kUnmerged || subsumed == _kUnmerged) {
     return false;
   }
@@ -317,17 +399,20 @@ bool MessageLoopTaskQueues::Owns(TaskQueueId owner,
 
 std::set<TaskQueueId> MessageLoopTaskQueues::GetSubsumedTaskQueueId(
     TaskQueueId owner) const {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock lock(*queue_mutex_);
   return queue_entries_.at(owner)->owner_of;
 }
 
 void MessageLoopTaskQueues::PauseSecondarySource(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
-  queue_entries_.at(queue_id)->task_source->PauseSecondary();
+  fml::SharedLock lock(*queue_mutex_);
+  const auto& queue_entry = queue_entries_.at(queue_id);
+  std::lock_guard entry_lock(queue_entry->mutex);
+  queue_entry->task_source->PauseSecondary();
 }
 
 void MessageLoopTaskQueues::ResumeSecondarySource(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock lock(*queue_mutex_);
+  QueueGroupLock group_lock(*this, queue_id);
   queue_entries_.at(queue_id)->task_source->ResumeSecondary();
   // Schedule a wake as needed.
   if (HasPendingTasksUnlocked(queue_id)) {
@@ -335,6 +420,30 @@ void MessageLoopTaskQueues::ResumeSecondarySource(TaskQueueId queue_id) {
   }
 }
 
+void MessageLoopTaskQueues::SetFrameDeadline(TaskQueueId queue_id,
+                                             fml::TimePoint deadline) {
+  fml::SharedLock lock(*queue_mutex_);
+  const auto& queue_entry = queue_entries_.at(queue_id);
+  std::lock_guard entry_lock(queue_entry->mutex);
+  queue_entry->task_source->SetFrameDeadline(deadline);
+}
+
+void MessageLoopTaskQueues::ClearFrameDeadline(TaskQueueId queue_id) {
+  fml::SharedLock lock(*queue_mutex_);
+  const auto& queue_entry = queue_entries_.at(queue_id);
+  TaskQueueId loop_to_wake = queue_id;
+  if (queue_entry->subsumed_by != _kUnmerged) {
+    loop_to_wake = queue_entry->subsumed_by;
+  }
+  // The group of the loop to wake includes |queue_id|.
+  QueueGroupLock group_lock(*this, loop_to_wake);
+  queue_entry->task_source->ClearFrameDeadline();
+  // Wake up for the idle tasks that are no longer held back.
+  if (HasPendingTasksUnlocked(loop_to_wake)) {
+    WakeUpUnlocked(loop_to_wake, GetNextWakeTimeUnlocked(loop_to_wake));
+  }
+}
+
 // Subsumed queues will never have pending tasks.
 // Owning queues will consider both their and their subsumed tasks.
 bool MessageLoopTaskQueues::HasPendingTasksUnlocked(
@@ -358,7 +467,7 @@ bool MessageLoopTaskQueues::HasPendingTasksUnlocked(
 
 fml::TimePoint MessageLoopTaskQueues::GetNextWakeTimeUnlocked(
     TaskQueueId queue_id) const {
-  return PeekNextTaskUnlocked(queue_id).task.GetTargetTime();
+  return PeekNextTaskUnlocked(queue_id).target_time;
 }
 
 TaskSource::TopTask MessageLoopTaskQueues::PeekNextTaskUnlocked(
@@ -377,7 +486,7 @@ TaskSource::TopTask MessageLoopTaskQueues::PeekNextTaskUnlocked(
       [&top_task](const TaskSource* source) {
         if (source && !source->IsEmpty()) {
           TaskSource::TopTask other_task = source->Top();
-          if (!top_task.has_value() || top_task->task > other_task.task) {
+          if (!top_task.has_value() || top_task->RunsAfter(other_task)) {
             top_task.emplace(other_task);
           }
         }
@@ -9,6 +9,7 @@
 #include <memory>
 #include <mutex>
 #include <set>
+#include <string_view>
 #include <vector>
 
 #include "flutter/fml/closure.h"
@@ -18,10 +19,15 @@
 #include "flutter/fml/synchronization/shared_mutex.h"
 #include "flutter/fml/task_queue_id.h"
 #include "flutter/fml/task_source.h"
+#include "flutter/fml/unique_closure.h"
 #include "flutter/fml/wakeable.h"
 
 namespace fml {
 
+namespace metrics {
+class Histogram;
+}  // namespace metrics
+
 static const TaskQueueId _kUnmerged = TaskQueueId(TaskQueueId::kUnmerged);
 
 /// A collection of tasks and observers associated with one TaskQueue.
@@ -32,9 +38,18 @@ static const TaskQueueId _kUnmerged = TaskQueueId(TaskQueueId::kUnmerged);
 class TaskQueueEntry {
  public:
   using TaskObservers = std::map<intptr_t, fml::closure>;
+
+  /// Guards |wakeable|, |task_observers| and |task_source|. The merge state,
+  /// |owner_of| and |subsumed_by|, is guarded by the queue mutex of
+  /// \p fml::MessageLoopTaskQueues instead.
+  std::mutex mutex;
+
   Wakeable* wakeable;
   TaskObservers task_observers;
   std::unique_ptr<TaskSource> task_source;
+  /// The histogram the number of pending tasks is recorded in each time a
+  /// task is run, if the queue has a label.
+  metrics::Histogram* depth_histogram = nullptr;
 
   /// Set of the TaskQueueIds which is owned by this TaskQueue. If the set is
   /// empty, this TaskQueue does not own any other TaskQueues.
@@ -61,6 +76,13 @@ enum class FlushType {
 /// fml::MessageLoops.
 ///
 /// This also wakes up the loop at the required times.
+///
+/// Locking is two-level so that loops running on different threads don't
+/// serialize on each other. A reader/writer queue mutex guards the set of
+/// queues and how they are merged; it is only held exclusively to create,
+/// dispose, merge or unmerge queues. Everything else holds it shared and
+/// locks only the |TaskQueueEntry::mutex| of the queues it touches. An owner
+/// is always locked before the queues it has subsumed, in |owner_of| order.
 /// \see fml::MessageLoop
 /// \see fml::Wakeable
 class MessageLoopTaskQueues {
@@ -78,14 +100,15 @@ class MessageLoopTaskQueues {
   // Tasks methods.
 
   void RegisterTask(TaskQueueId queue_id,
-                    const fml::closure& task,
+                    fml::UniqueClosure task,
                     fml::TimePoint target_time,
                     fml::TaskSourceGrade task_source_grade =
                         fml::TaskSourceGrade::kUnspecified);
 
   bool HasPendingTasks(TaskQueueId queue_id) const;
 
-  fml::closure GetNextTaskToRun(TaskQueueId queue_id, fml::TimePoint from_time);
+  fml::UniqueClosure GetNextTaskToRun(TaskQueueId queue_id,
+                                      fml::TimePoint from_time);
 
   size_t GetNumPendingTasks(TaskQueueId queue_id) const;
 
@@ -105,6 +128,13 @@ class MessageLoopTaskQueues {
 
   void SetWakeable(TaskQueueId queue_id, fml::Wakeable* wakeable);
 
+  /// Records the number of pending tasks of \p queue_id in the
+  /// "fml.MessageLoop.<label>.TaskQueueDepth" histogram each time one of its
+  /// tasks is run. Queues without a label are not measured. Labels should
+  /// name the role of a thread rather than a single thread, since the
+  /// histograms live as long as the process.
+  void SetLabel(TaskQueueId queue_id, std::string_view label);
+
   // Invariants for merge and un-merge
   //  1. RegisterTask will always submit to the queue_id that is passed
   //     to it. It is not aware of whether a queue is merged or not. Same with
@@ -137,9 +167,30 @@ class MessageLoopTaskQueues {
 
   void ResumeSecondarySource(TaskQueueId queue_id);
 
+  /// Holds back the |TaskSourceGrade::kIdle| tasks of \p queue_id while the
+  /// frame work on it is in progress, until \p deadline at the latest.
+  void SetFrameDeadline(TaskQueueId queue_id, fml::TimePoint deadline);
+
+  /// Called once the frame work on \p queue_id is done, to run the idle tasks
+  /// that were held back.
+  void ClearFrameDeadline(TaskQueueId queue_id);
+
  private:
   class MergedQueuesRunner;
 
+  // Locks the entry for |owner| and the entries of all the queues it has
+  // subsumed. Requires the queue mutex to be held.
+  class QueueGroupLock {
+   public:
+    QueueGroupLock(const MessageLoopTaskQueues& queues, TaskQueueId owner);
+
+   private:
+    std::unique_lock<std::mutex> owner_lock_;
+    std::vector<std::unique_lock<std::mutex>> subsumed_locks_;
+
+    FML_DISALLOW_COPY_AND_ASSIGN(QueueGroupLock);
+  };
+
   MessageLoopTaskQueues();
 
   ~MessageLoopTaskQueues();
@@ -152,7 +203,10 @@ class MessageLoopTaskQueues {
 
   fml::TimePoint GetNextWakeTimeUnlocked(TaskQueueId queue_id) const;
 
-  mutable std::mutex queue_mutex_;
+  // The methods suffixed with |Unlocked| require the queue mutex to be held
+  // along with a |QueueGroupLock| for the queue they are passed, unless the
+  // queue mutex is held exclusively.
+  std::unique_ptr<fml::SharedMutex> queue_mutex_;
   std::map<TaskQueueId, std::unique_ptr<TaskQueueEntry>> queue_entries_;
 
   size_t task_queue_id_counter_;
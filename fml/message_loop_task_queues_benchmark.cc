@@ -44,7 +44,7 @@ static void BM_RegisterAndGetTasks(benchmark::State& state) {  // NOLINT
         const auto now = fml::TimePoint::Now();
         int num_invocations = 0;
         for (;;) {
-          fml::closure invocation =
+          fml::UniqueClosure invocation =
               task_queue->GetNextTaskToRun(TaskQueueId(task_runner_id), now);
           if (!invocation) {
             break;
@@ -66,5 +66,78 @@ static void BM_RegisterAndGetTasks(benchmark::State& state) {  // NOLINT
 
 BENCHMARK(BM_RegisterAndGetTasks);
 
+// Each of |num_producers| threads posts tasks to |num_queues| queues while one
+// consumer thread per queue drains it, as the platform, UI, raster and IO
+// loops do concurrently.
+static void RunContendedRegisterAndGetTasks(benchmark::State& state,
+                                            int num_producers,
+                                            int num_queues) {
+  auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+  const int num_tasks_per_producer = 1000;
+  const fml::TimePoint past = fml::TimePoint::Now();
+
+  std::vector<TaskQueueId> queue_ids;
+  for (int i = 0; i < num_queues; i++) {
+    queue_ids.push_back(task_queues->CreateTaskQueue());
+  }
+
+  while (state.KeepRunning()) {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_producers; i++) {
+      threads.emplace_back([&, producer = i]() {
+        for (int j = 0; j < num_tasks_per_producer; j++) {
+          task_queues->RegisterTask(
+              queue_ids[(producer + j) % num_queues], [] {}, past);
+        }
+      });
+    }
+    const int num_tasks_per_queue =
+        num_producers * num_tasks_per_producer / num_queues;
+    for (int i = 0; i < num_queues; i++) {
+      threads.emplace_back([&, queue_id = queue_ids[i]]() {
+        for (int num_invocations = 0; num_invocations < num_tasks_per_queue;) {
+          if (task_queues->GetNextTaskToRun(queue_id, fml::TimePoint::Now())) {
+            num_invocations++;
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_producers *
+                          num_tasks_per_producer);
+
+  for (auto queue_id : queue_ids) {
+    task_queues->Dispose(queue_id);
+  }
+}
+
+// Producers each post to their own queue; only contention between unrelated
+// queues is measured.
+static void BM_RegisterAndGetTasksIndependentQueues(
+    benchmark::State& state) {  // NOLINT
+  const int num_producers = state.range(0);
+  RunContendedRegisterAndGetTasks(state, num_producers, num_producers);
+}
+
+BENCHMARK(BM_RegisterAndGetTasksIndependentQueues)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime();
+
+// All producers post to every one of four queues.
+static void BM_RegisterAndGetTasksSharedQueues(
+    benchmark::State& state) {  // NOLINT
+  RunContendedRegisterAndGetTasks(state, state.range(0), 4);
+}
+
+BENCHMARK(BM_RegisterAndGetTasksSharedQueues)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime();
+
 }  // namespace benchmarking
 }  // namespace fml
@@ -11,6 +11,7 @@
 #include <thread>
 #include <utility>
 
+#include "flutter/fml/metrics.h"
 #include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/synchronization/waitable_event.h"
 #include "flutter/fml/time/chrono_timestamp_provider.h"
@@ -63,6 +64,33 @@ TEST(MessageLoopTaskQueue, RegisterTwoTasksAndCount) {
   ASSERT_TRUE(task_queue->GetNumPendingTasks(queue_id) == 2);
 }
 
+TEST(MessageLoopTaskQueue, TaskQueueDepthIsRecordedPerLabel) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto labeled_queue = task_queue->CreateTaskQueue();
+  auto unlabeled_queue = task_queue->CreateTaskQueue();
+  task_queue->SetLabel(labeled_queue, "test.labeled");
+  for (int i = 0; i < 3; i++) {
+    task_queue->RegisterTask(
+        labeled_queue, [] {}, ChronoTicksSinceEpoch());
+    task_queue->RegisterTask(
+        unlabeled_queue, [] {}, ChronoTicksSinceEpoch());
+  }
+
+  const auto now = ChronoTicksSinceEpoch();
+  while (task_queue->GetNextTaskToRun(labeled_queue, now)) {
+  }
+  while (task_queue->GetNextTaskToRun(unlabeled_queue, now)) {
+  }
+
+  auto snapshot =
+      metrics::MetricsRegistry::GetInstance()
+          .GetHistogram("fml.MessageLoop.test.labeled.TaskQueueDepth")
+          .GetSnapshot();
+  ASSERT_EQ(snapshot.count, 3u);
+  ASSERT_EQ(snapshot.min, 1);
+  ASSERT_EQ(snapshot.max, 3);
+}
+
 TEST(MessageLoopTaskQueue, RegisterTasksOnMergedQueuesAndCount) {
   auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
   auto platform_queue = task_queue->CreateTaskQueue();
@@ -108,7 +136,8 @@ TEST(MessageLoopTaskQueue, PreserveTaskOrdering) {
   const auto now = ChronoTicksSinceEpoch();
   int expected_value = 1;
   while (true) {
-    fml::closure invocation = task_queue->GetNextTaskToRun(queue_id, now);
+    fml::UniqueClosure invocation =
+        task_queue->GetNextTaskToRun(queue_id, now);
     if (!invocation) {
       break;
     }
@@ -148,7 +177,8 @@ TEST(MessageLoopTaskQueue, RegisterTasksOnMergedQueuesPreserveTaskOrdering) {
   // "test_val = 1" in platform_queue
   // "test_val = 2" in raster2_queue
   while (true) {
-    fml::closure invocation = task_queue->GetNextTaskToRun(platform_queue, now);
+    fml::UniqueClosure invocation =
+        task_queue->GetNextTaskToRun(platform_queue, now);
     if (!invocation) {
       break;
     }
@@ -191,7 +221,8 @@ TEST(MessageLoopTaskQueue, UnmergeRespectTheOriginalTaskOrderingInQueues) {
   // "test_val = 1" in platform_queue
   // "test_val = 2" in raster_queue (running on platform)
   for (int i = 0; i < 3; i++) {
-    fml::closure invocation = task_queue->GetNextTaskToRun(platform_queue, now);
+    fml::UniqueClosure invocation =
+        task_queue->GetNextTaskToRun(platform_queue, now);
     ASSERT_FALSE(!invocation);
     invocation();
     ASSERT_TRUE(test_val == i);
@@ -210,7 +241,8 @@ TEST(MessageLoopTaskQueue, UnmergeRespectTheOriginalTaskOrderingInQueues) {
   // platform_queue has 1 task left: "test_val = 4"
   {
     ASSERT_TRUE(task_queue->GetNumPendingTasks(platform_queue) == 1);
-    fml::closure invocation = task_queue->GetNextTaskToRun(platform_queue, now);
+    fml::UniqueClosure invocation =
+        task_queue->GetNextTaskToRun(platform_queue, now);
     ASSERT_FALSE(!invocation);
     invocation();
     ASSERT_TRUE(test_val == 4);
@@ -220,14 +252,16 @@ TEST(MessageLoopTaskQueue, UnmergeRespectTheOriginalTaskOrderingInQueues) {
   // raster_queue has 2 tasks left: "test_val = 3" and "test_val = 5"
   {
     ASSERT_TRUE(task_queue->GetNumPendingTasks(raster_queue) == 2);
-    fml::closure invocation = task_queue->GetNextTaskToRun(raster_queue, now);
+    fml::UniqueClosure invocation =
+        task_queue->GetNextTaskToRun(raster_queue, now);
     ASSERT_FALSE(!invocation);
     invocation();
     ASSERT_TRUE(test_val == 3);
   }
   {
     ASSERT_TRUE(task_queue->GetNumPendingTasks(raster_queue) == 1);
-    fml::closure invocation = task_queue->GetNextTaskToRun(raster_queue, now);
+    fml::UniqueClosure invocation =
+        task_queue->GetNextTaskToRun(raster_queue, now);
     ASSERT_FALSE(!invocation);
     invocation();
     ASSERT_TRUE(test_val == 5);
@@ -304,6 +338,46 @@ TEST(MessageLoopTaskQueue, WokenUpWithNewerTime) {
   latch.Wait();
 }
 
+TEST(MessageLoopTaskQueue, FrameDeadlineDefersIdleTasks) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+  const auto now = ChronoTicksSinceEpoch();
+  const auto deadline = now + fml::TimeDelta::FromMilliseconds(16);
+  fml::TimePoint wake_time;
+  auto wakeable = std::make_unique<TestWakeable>(
+      [&wake_time](fml::TimePoint time) { wake_time = time; });
+  task_queue->SetWakeable(queue_id, wakeable.get());
+
+  task_queue->SetFrameDeadline(queue_id, deadline);
+  int value = 0;
+  task_queue->RegisterTask(
+      queue_id, [&value]() { value = 1; }, now, fml::TaskSourceGrade::kIdle);
+  ASSERT_EQ(wake_time, deadline);
+  ASSERT_FALSE(task_queue->GetNextTaskToRun(queue_id, now));
+
+  task_queue->ClearFrameDeadline(queue_id);
+  ASSERT_EQ(wake_time, now);
+  auto invocation = task_queue->GetNextTaskToRun(queue_id, now);
+  ASSERT_TRUE(invocation);
+  invocation();
+  ASSERT_EQ(value, 1);
+  ASSERT_EQ(fml::MessageLoopTaskQueues::GetCurrentTaskSourceGrade(),
+            fml::TaskSourceGrade::kIdle);
+}
+
+TEST(MessageLoopTaskQueue, IdleTasksRunAfterFrameDeadline) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+  const auto now = ChronoTicksSinceEpoch();
+  const auto deadline = now + fml::TimeDelta::FromMilliseconds(16);
+
+  task_queue->SetFrameDeadline(queue_id, deadline);
+  task_queue->RegisterTask(
+      queue_id, []() {}, now, fml::TaskSourceGrade::kIdle);
+  ASSERT_FALSE(task_queue->GetNextTaskToRun(queue_id, now));
+  ASSERT_TRUE(task_queue->GetNextTaskToRun(queue_id, deadline));
+}
+
 TEST(MessageLoopTaskQueue, NotifyObserversWhileCreatingQueues) {
   auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
   fml::TaskQueueId queue_id = task_queues->CreateTaskQueue();
@@ -451,5 +525,48 @@ TEST(MessageLoopTaskQueue, RegisterTaskWakesUpOwnerQueue) {
   ASSERT_EQ(time1, wakes[2]);
 }
 
+TEST(MessageLoopTaskQueue, ConcurrentRegisterWhileMergingAndUnmerging) {
+  auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+  auto owner = task_queues->CreateTaskQueue();
+  auto subsumed = task_queues->CreateTaskQueue();
+
+  constexpr size_t kThreadCount = 4;
+  constexpr size_t kThreadTaskCount = 1000;
+  const auto now = ChronoTicksSinceEpoch();
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kThreadCount; i++) {
+    threads.emplace_back([&, i]() {
+      auto queue_id = (i % 2 == 0) ? owner : subsumed;
+      for (size_t j = 0; j < kThreadTaskCount; j++) {
+        task_queues->RegisterTask(
+            queue_id, []() {}, now);
+      }
+    });
+  }
+
+  for (int i = 0; i < 100; i++) {
+    ASSERT_TRUE(task_queues->Merge(owner, subsumed));
+    ASSERT_TRUE(task_queues->Owns(owner, subsumed));
+    ASSERT_TRUE(task_queues->Unmerge(owner, subsumed));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_TRUE(task_queues->Merge(owner, subsumed));
+  ASSERT_EQ(task_queues->GetNumPendingTasks(owner),
+            kThreadCount * kThreadTaskCount);
+  ASSERT_EQ(task_queues->GetNumPendingTasks(subsumed), 0u);
+
+  size_t tasks_run = 0;
+  while (task_queues->GetNextTaskToRun(owner, now)) {
+    tasks_run++;
+  }
+  ASSERT_EQ(tasks_run, kThreadCount * kThreadTaskCount);
+  ASSERT_FALSE(task_queues->HasPendingTasks(owner));
+}
+
 }  // namespace testing
 }  // namespace fml
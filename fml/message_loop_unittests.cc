@@ -339,3 +339,71 @@ TEST(MessageLoop, CanCreateConcurrentMessageLoop) {
   latch.Wait();
   ASSERT_GE(thread_ids.size(), 1u);
 }
+
+TEST(MessageLoop, ConcurrentMessageLoopRunsBatchedTasks) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  auto task_runner = loop->GetTaskRunner();
+  const size_t kCount = 100;
+  fml::CountDownLatch latch(kCount);
+  std::vector<fml::closure> tasks;
+  for (size_t i = 0; i < kCount; ++i) {
+    tasks.emplace_back([&latch]() { latch.CountDown(); });
+  }
+  task_runner->PostTasks(std::move(tasks));
+  latch.Wait();
+}
+
+TEST(MessageLoop, ConcurrentMessageLoopRunsHigherPriorityTasksFirst) {
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  auto task_runner = loop->GetTaskRunner();
+  fml::AutoResetWaitableEvent blocker;
+  fml::CountDownLatch latch(4);
+  std::vector<int> order;
+  // Keep the only worker busy until all the tasks have been posted.
+  task_runner->PostTask([&]() {
+    blocker.Wait();
+    latch.CountDown();
+  });
+  task_runner->PostTask(
+      [&]() {
+        order.push_back(3);
+        latch.CountDown();
+      },
+      fml::ConcurrentMessageLoop::TaskPriority::kLow);
+  task_runner->PostTask([&]() {
+    order.push_back(2);
+    latch.CountDown();
+  });
+  task_runner->PostTask(
+      [&]() {
+        order.push_back(1);
+        latch.CountDown();
+      },
+      fml::ConcurrentMessageLoop::TaskPriority::kHigh);
+  blocker.Signal();
+  latch.Wait();
+  ASSERT_EQ(order, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(MessageLoop, ConcurrentMessageLoopWorkersStealTasks) {
+  const size_t kWorkerCount = 4;
+  auto loop = fml::ConcurrentMessageLoop::Create(kWorkerCount);
+  auto task_runner = loop->GetTaskRunner();
+  // Tasks posted from a worker go to its own queue. Each of them waits for
+  // all the others to start, so they only complete if the other workers
+  // steal them.
+  fml::CountDownLatch started(kWorkerCount);
+  fml::CountDownLatch finished(kWorkerCount);
+  task_runner->PostTask([&]() {
+    std::vector<fml::closure> tasks;
+    for (size_t i = 0; i < kWorkerCount; ++i) {
+      tasks.emplace_back([&]() {
+        started.CountDown();
+        started.Wait();
+        finished.CountDown();
+      });
+    }
+    task_runner->PostTasks(std::move(tasks));
+  });
+  finished.Wait();
+}
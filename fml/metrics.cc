@@ -0,0 +1,194 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/metrics.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace fml {
+namespace metrics {
+
+namespace {
+
+// The index of the most significant bit set in |value|, which is not zero.
+int GetMostSignificantBit(uint64_t value) {
+  int bit = 0;
+  for (int shift = 32; shift > 0; shift /= 2) {
+    if (value >> shift) {
+      value >>= shift;
+      bit += shift;
+    }
+  }
+  return bit;
+}
+
+// Raises |target| to |value| if it is lower.
+void UpdateMax(std::atomic<int64_t>& target, int64_t value) {
+  int64_t current = target.load(std::memory_order_relaxed);
+  while (current < value &&
+         !target.compare_exchange_weak(current, value,
+                                       std::memory_order_relaxed)) {
+  }
+}
+
+// Lowers |target| to |value| if it is higher.
+void UpdateMin(std::atomic<int64_t>& target, int64_t value) {
+  int64_t current = target.load(std::memory_order_relaxed);
+  while (current > value &&
+         !target.compare_exchange_weak(current, value,
+                                       std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace
+
+int64_t Counter::GetValue() const {
+  int64_t value = 0;
+  for (const auto& stripe : stripes_) {
+    value += stripe.value.load(std::memory_order_relaxed);
+  }
+  return value;
+}
+
+size_t Counter::GetCurrentThreadStripe() {
+  static std::atomic<size_t> next_stripe = 0;
+  thread_local const size_t stripe =
+      next_stripe.fetch_add(1, std::memory_order_relaxed) % kStripeCount;
+  return stripe;
+}
+
+void Histogram::Record(int64_t value) {
+  value = std::max<int64_t>(value, 0);
+  buckets_[GetBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(value, std::memory_order_relaxed);
+  UpdateMin(min_, value);
+  UpdateMax(max_, value);
+}
+
+HistogramSnapshot Histogram::GetSnapshot() const {
+  std::array<uint64_t, kBucketCount> buckets;
+  uint64_t count = 0;
+  for (size_t i = 0; i < kBucketCount; i++) {
+    buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    count += buckets[i];
+  }
+
+  HistogramSnapshot snapshot;
+  if (count == 0) {
+    return snapshot;
+  }
+  // Values recorded while the buckets were read may or may not be included,
+  // so the count is the one of the buckets the percentiles are taken from.
+  snapshot.count = count;
+  snapshot.sum = sum_.load(std::memory_order_relaxed);
+  snapshot.max = max_.load(std::memory_order_relaxed);
+  snapshot.min = std::min(min_.load(std::memory_order_relaxed), snapshot.max);
+
+  const std::pair<double, int64_t*> percentiles[] = {
+      {0.5, &snapshot.p50},
+      {0.9, &snapshot.p90},
+      {0.99, &snapshot.p99},
+  };
+  size_t bucket = 0;
+  uint64_t seen = buckets[0];
+  for (const auto& [percentile, result] : percentiles) {
+    const auto rank = std::max<uint64_t>(
+        static_cast<uint64_t>(std::ceil(percentile * count)), 1);
+    while (seen < rank) {
+      seen += buckets[++bucket];
+    }
+    *result = std::clamp(GetBucketMaxValue(bucket), snapshot.min, snapshot.max);
+  }
+  return snapshot;
+}
+
+size_t Histogram::GetBucketIndex(int64_t value) {
+  if (value < kSubBucketCount) {
+    return static_cast<size_t>(value);
+  }
+  // Every power of two from |kSubBucketCount| up is split in
+  // |kSubBucketCount| buckets, selected by the bits after the top one.
+  const int shift = GetMostSignificantBit(value) - kSubBucketBits;
+  const auto sub_bucket = static_cast<size_t>(value >> shift);
+  return static_cast<size_t>(shift * kSubBucketCount) + sub_bucket;
+}
+
+int64_t Histogram::GetBucketMaxValue(size_t index) {
+  if (index < static_cast<size_t>(kSubBucketCount)) {
+    return static_cast<int64_t>(index);
+  }
+  const int shift = static_cast<int>(index / kSubBucketCount) - 1;
+  const int64_t sub_bucket = kSubBucketCount + index % kSubBucketCount;
+  const int64_t min_value = sub_bucket << shift;
+  return min_value + ((int64_t{1} << shift) - 1);
+}
+
+MetricsRegistry& MetricsRegistry::GetInstance() {
+  // Never destroyed, so that metrics can be updated until the process exits.
+  static MetricsRegistry* instance = new MetricsRegistry();
+  return *instance;
+}
+
+MetricsRegistry::MetricsRegistry() = default;
+
+MetricsRegistry::~MetricsRegistry() = default;
+
+namespace {
+
+template <typename Metric>
+Metric& GetOrCreate(
+    std::map<std::string, std::unique_ptr<Metric>, std::less<>>& metrics,
+    std::string_view name) {
+  auto found = metrics.find(name);
+  if (found == metrics.end()) {
+    found = metrics.emplace(name, std::make_unique<Metric>()).first;
+  }
+  return *found->second;
+}
+
+}  // namespace
+
+Counter& MetricsRegistry::GetCounter(std::string_view name) {
+  std::scoped_lock lock(mutex_);
+  return GetOrCreate(counters_, name);
+}
+
+Gauge& MetricsRegistry::GetGauge(std::string_view name) {
+  std::scoped_lock lock(mutex_);
+  return GetOrCreate(gauges_, name);
+}
+
+Histogram& MetricsRegistry::GetHistogram(std::string_view name) {
+  std::scoped_lock lock(mutex_);
+  return GetOrCreate(histograms_, name);
+}
+
+std::vector<MetricSnapshot> MetricsRegistry::GetSnapshot() const {
+  std::scoped_lock lock(mutex_);
+  std::vector<MetricSnapshot> snapshots;
+  snapshots.reserve(counters_.size() + gauges_.size() + histograms_.size());
+  for (const auto& [name, counter] : counters_) {
+    auto& snapshot = snapshots.emplace_back();
+    snapshot.name = name;
+    snapshot.type = MetricType::kCounter;
+    snapshot.value = counter->GetValue();
+  }
+  for (const auto& [name, gauge] : gauges_) {
+    auto& snapshot = snapshots.emplace_back();
+    snapshot.name = name;
+    snapshot.type = MetricType::kGauge;
+    snapshot.value = gauge->GetValue();
+  }
+  for (const auto& [name, histogram] : histograms_) {
+    auto& snapshot = snapshots.emplace_back();
+    snapshot.name = name;
+    snapshot.type = MetricType::kHistogram;
+    snapshot.histogram = histogram->GetSnapshot();
+  }
+  return snapshots;
+}
+
+}  // namespace metrics
+}  // namespace fml
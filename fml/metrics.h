@@ -0,0 +1,202 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_METRICS_H_
+#define FLUTTER_FML_METRICS_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+
+//------------------------------------------------------------------------------
+/// Returns the counter, gauge or histogram registered as |name|, which must be
+/// a string literal, creating it the first time. The lookup is done once per
+/// call site, which makes these cheap enough for hot paths:
+///
+///   FML_METRICS_HISTOGRAM("flutter.ImageDecoder.DecodeMicros").Record(micros);
+///
+#define FML_METRICS_COUNTER(name) \
+  FML_METRICS_INTERNAL_GET(GetCounter, ::fml::metrics::Counter, name)
+#define FML_METRICS_GAUGE(name) \
+  FML_METRICS_INTERNAL_GET(GetGauge, ::fml::metrics::Gauge, name)
+#define FML_METRICS_HISTOGRAM(name) \
+  FML_METRICS_INTERNAL_GET(GetHistogram, ::fml::metrics::Histogram, name)
+
+#define FML_METRICS_INTERNAL_GET(getter, type, name)                 \
+  ([]() -> type& {                                                   \
+    static type& metric =                                            \
+        ::fml::metrics::MetricsRegistry::GetInstance().getter(name); \
+    return metric;                                                   \
+  }())
+
+namespace fml {
+namespace metrics {
+
+//------------------------------------------------------------------------------
+/// @brief      A monotonic count, such as the number of platform messages
+///             sent. Increments from different threads mostly go to different
+///             cache lines, so they don't contend with each other.
+///
+class Counter {
+ public:
+  Counter() = default;
+
+  void Increment(int64_t delta = 1) {
+    stripes_[GetCurrentThreadStripe()].value.fetch_add(
+        delta, std::memory_order_relaxed);
+  }
+
+  /// The sum of all increments so far. Increments made concurrently may or
+  /// may not be included.
+  int64_t GetValue() const;
+
+ private:
+  static constexpr size_t kStripeCount = 8;
+
+  struct alignas(64) Stripe {
+    std::atomic<int64_t> value = 0;
+  };
+
+  std::array<Stripe, kStripeCount> stripes_;
+
+  static size_t GetCurrentThreadStripe();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(Counter);
+};
+
+//------------------------------------------------------------------------------
+/// @brief      A value that goes up and down, such as the number of bytes in
+///             a cache.
+///
+class Gauge {
+ public:
+  Gauge() = default;
+
+  void Set(int64_t value) { value_.store(value, std::memory_order_relaxed); }
+
+  void Add(int64_t delta) {
+    value_.fetch_add(delta, std::memory_order_relaxed);
+  }
+
+  int64_t GetValue() const { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<int64_t> value_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(Gauge);
+};
+
+/// A summary of the values recorded by a |Histogram|.
+struct HistogramSnapshot {
+  uint64_t count = 0;
+  int64_t sum = 0;
+  int64_t min = 0;
+  int64_t max = 0;
+  int64_t p50 = 0;
+  int64_t p90 = 0;
+  int64_t p99 = 0;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      The distribution of non-negative values, such as latencies in
+///             microseconds or sizes in bytes.
+///
+///             Like an HDR histogram, values are counted in buckets that grow
+///             with the magnitude of the values: below 16 every value has its
+///             own bucket, and every power of two above that is split in 16
+///             buckets. Percentiles are within 1/16th (about 6%) of the
+///             recorded values, whatever their range, and recording a value
+///             is a few relaxed atomic operations.
+///
+class Histogram {
+ public:
+  Histogram() = default;
+
+  /// Records |value|. Negative values are recorded as zero.
+  void Record(int64_t value);
+
+  HistogramSnapshot GetSnapshot() const;
+
+ private:
+  static constexpr int kSubBucketBits = 4;
+  static constexpr int64_t kSubBucketCount = 1 << kSubBucketBits;
+  static constexpr size_t kBucketCount =
+      (64 - kSubBucketBits) * kSubBucketCount;
+
+  std::array<std::atomic<uint64_t>, kBucketCount> buckets_ = {};
+  std::atomic<int64_t> sum_ = 0;
+  std::atomic<int64_t> min_ = INT64_MAX;
+  std::atomic<int64_t> max_ = 0;
+
+  static size_t GetBucketIndex(int64_t value);
+
+  /// The largest value counted in the bucket at |index|.
+  static int64_t GetBucketMaxValue(size_t index);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(Histogram);
+};
+
+enum class MetricType {
+  kCounter,
+  kGauge,
+  kHistogram,
+};
+
+/// The value of a metric at the time of |MetricsRegistry::GetSnapshot|.
+struct MetricSnapshot {
+  std::string name;
+  MetricType type;
+  /// The value of a counter or a gauge.
+  int64_t value = 0;
+  /// The summary of a histogram.
+  HistogramSnapshot histogram;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      The metrics of the process, always collected and cheap to
+///             update, so that they can be reported without tracing.
+///
+///             Metrics are created the first time they are looked up and live
+///             as long as the process, so references to them can be cached.
+///             Prefer the |FML_METRICS_*| macros, which do that.
+///
+class MetricsRegistry {
+ public:
+  static MetricsRegistry& GetInstance();
+
+  Counter& GetCounter(std::string_view name);
+
+  Gauge& GetGauge(std::string_view name);
+
+  Histogram& GetHistogram(std::string_view name);
+
+  /// The values of all metrics, sorted by type and name.
+  std::vector<MetricSnapshot> GetSnapshot() const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::map<std::string, std::unique_ptr<Counter>, std::less<>> counters_;
+  std::map<std::string, std::unique_ptr<Gauge>, std::less<>> gauges_;
+  std::map<std::string, std::unique_ptr<Histogram>, std::less<>> histograms_;
+
+  MetricsRegistry();
+
+  ~MetricsRegistry();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(MetricsRegistry);
+};
+
+}  // namespace metrics
+}  // namespace fml
+
+#endif  // FLUTTER_FML_METRICS_H_
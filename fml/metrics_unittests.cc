@@ -0,0 +1,140 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/metrics.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace metrics {
+namespace testing {
+
+namespace {
+
+const MetricSnapshot* FindMetric(const std::vector<MetricSnapshot>& snapshots,
+                                 const std::string& name) {
+  auto found = std::find_if(
+      snapshots.begin(), snapshots.end(),
+      [&name](const MetricSnapshot& snapshot) { return snapshot.name == name; });
+  return found == snapshots.end() ? nullptr : &*found;
+}
+
+}  // namespace
+
+TEST(MetricsTest, CounterSumsIncrementsFromAllThreads) {
+  Counter counter;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 16; i++) {
+    threads.emplace_back([&counter]() {
+      for (size_t j = 0; j < 1000; j++) {
+        counter.Increment();
+      }
+      counter.Increment(10);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(counter.GetValue(), 16 * 1010);
+}
+
+TEST(MetricsTest, GaugeKeepsLastValue) {
+  Gauge gauge;
+  gauge.Set(10);
+  gauge.Add(5);
+  gauge.Add(-7);
+  ASSERT_EQ(gauge.GetValue(), 8);
+  gauge.Set(3);
+  ASSERT_EQ(gauge.GetValue(), 3);
+}
+
+TEST(MetricsTest, EmptyHistogramIsAllZeros) {
+  Histogram histogram;
+  auto snapshot = histogram.GetSnapshot();
+  ASSERT_EQ(snapshot.count, 0u);
+  ASSERT_EQ(snapshot.min, 0);
+  ASSERT_EQ(snapshot.max, 0);
+  ASSERT_EQ(snapshot.p99, 0);
+}
+
+TEST(MetricsTest, HistogramCountsSmallValuesExactly) {
+  Histogram histogram;
+  for (int64_t value = 1; value <= 10; value++) {
+    histogram.Record(value);
+  }
+  histogram.Record(-5);
+  auto snapshot = histogram.GetSnapshot();
+  ASSERT_EQ(snapshot.count, 11u);
+  ASSERT_EQ(snapshot.sum, 55);
+  ASSERT_EQ(snapshot.min, 0);
+  ASSERT_EQ(snapshot.max, 10);
+  ASSERT_EQ(snapshot.p50, 5);
+  ASSERT_EQ(snapshot.p90, 9);
+  ASSERT_EQ(snapshot.p99, 10);
+}
+
+TEST(MetricsTest, HistogramPercentilesAreWithinBucketPrecision) {
+  Histogram histogram;
+  for (int64_t value = 1; value <= 100000; value++) {
+    histogram.Record(value);
+  }
+  auto snapshot = histogram.GetSnapshot();
+  ASSERT_EQ(snapshot.count, 100000u);
+  ASSERT_EQ(snapshot.min, 1);
+  ASSERT_EQ(snapshot.max, 100000);
+  ASSERT_NEAR(snapshot.p50, 50000, 50000 / 16);
+  ASSERT_NEAR(snapshot.p90, 90000, 90000 / 16);
+  ASSERT_NEAR(snapshot.p99, 99000, 99000 / 16);
+  ASSERT_LE(snapshot.p99, snapshot.max);
+}
+
+TEST(MetricsTest, HistogramRecordsExtremeValues) {
+  Histogram histogram;
+  histogram.Record(INT64_MAX);
+  histogram.Record(INT64_MAX / 3);
+  auto snapshot = histogram.GetSnapshot();
+  ASSERT_EQ(snapshot.count, 2u);
+  ASSERT_EQ(snapshot.min, INT64_MAX / 3);
+  ASSERT_EQ(snapshot.max, INT64_MAX);
+  ASSERT_EQ(snapshot.p99, INT64_MAX);
+}
+
+TEST(MetricsTest, RegistryReturnsSameMetricForSameName) {
+  auto& registry = MetricsRegistry::GetInstance();
+  ASSERT_EQ(&registry.GetCounter("test.RegistryCounter"),
+            &registry.GetCounter("test.RegistryCounter"));
+  ASSERT_NE(&registry.GetCounter("test.RegistryCounter"),
+            &registry.GetCounter("test.OtherRegistryCounter"));
+  ASSERT_EQ(&FML_METRICS_GAUGE("test.RegistryGauge"),
+            &registry.GetGauge("test.RegistryGauge"));
+}
+
+TEST(MetricsTest, RegistrySnapshotsAllMetrics) {
+  FML_METRICS_COUNTER("test.SnapshotCounter").Increment(3);
+  FML_METRICS_GAUGE("test.SnapshotGauge").Set(42);
+  FML_METRICS_HISTOGRAM("test.SnapshotHistogram").Record(7);
+
+  auto snapshots = MetricsRegistry::GetInstance().GetSnapshot();
+  auto counter = FindMetric(snapshots, "test.SnapshotCounter");
+  ASSERT_NE(counter, nullptr);
+  ASSERT_EQ(counter->type, MetricType::kCounter);
+  ASSERT_EQ(counter->value, 3);
+  auto gauge = FindMetric(snapshots, "test.SnapshotGauge");
+  ASSERT_NE(gauge, nullptr);
+  ASSERT_EQ(gauge->type, MetricType::kGauge);
+  ASSERT_EQ(gauge->value, 42);
+  auto histogram = FindMetric(snapshots, "test.SnapshotHistogram");
+  ASSERT_NE(histogram, nullptr);
+  ASSERT_EQ(histogram->type, MetricType::kHistogram);
+  ASSERT_EQ(histogram->histogram.count, 1u);
+  ASSERT_EQ(histogram->histogram.p50, 7);
+}
+
+}  // namespace testing
+}  // namespace metrics
+}  // namespace fml
@@ -24,6 +24,11 @@ MessageLoopLinux::MessageLoopLinux()
   FML_CHECK(added_source);
 }
 
+fml::RefPtr<MessageLoopLinux> MessageLoopLinux::GetCurrent() {
+  return fml::Ref(static_cast<MessageLoopLinux*>(
+      MessageLoopImpl::GetCurrent().get()));
+}
+
 MessageLoopLinux::~MessageLoopLinux() {
   bool removed_source = AddOrRemoveTimerSource(false);
   FML_CHECK(removed_source);
@@ -43,30 +48,68 @@ bool MessageLoopLinux::AddOrRemoveTimerSource(bool add) {
   return ctl_result == 0;
 }
 
+bool MessageLoopLinux::AddFileDescriptor(int fd,
+                                         uint32_t events,
+                                         FileDescriptorCallback callback) {
+  FML_DCHECK(callback);
+  std::scoped_lock lock(file_descriptors_mutex_);
+  if (fd == timer_fd_.get() ||
+      file_descriptors_.find(fd) != file_descriptors_.end()) {
+    return false;
+  }
+
+  struct epoll_event event = {};
+  event.events = events;
+  event.data.fd = fd;
+  if (::epoll_ctl(epoll_fd_.get(), EPOLL_CTL_ADD, fd, &event) != 0) {
+    return false;
+  }
+  file_descriptors_[fd] =
+      std::make_shared<FileDescriptorCallback>(std::move(callback));
+  return true;
+}
+
+bool MessageLoopLinux::RemoveFileDescriptor(int fd) {
+  std::scoped_lock lock(file_descriptors_mutex_);
+  auto found = file_descriptors_.find(fd);
+  if (found == file_descriptors_.end()) {
+    return false;
+  }
+  file_descriptors_.erase(found);
+  // The fd may already have been closed, which removes it from the epoll set.
+  ::epoll_ctl(epoll_fd_.get(), EPOLL_CTL_DEL, fd, nullptr);
+  return true;
+}
+
 // |fml::MessageLoopImpl|
 void MessageLoopLinux::Run() {
   running_ = true;
 
   while (running_) {
-    struct epoll_event event = {};
-
-    int epoll_result = FML_HANDLE_EINTR(
-        ::epoll_wait(epoll_fd_.get(), &event, 1, -1 /* timeout */));
+    struct epoll_event events[kMaxEventsPerWait] = {};
 
-    // Errors are fatal.
-    if (event.events & (EPOLLERR | EPOLLHUP)) {
-      running_ = false;
-      continue;
-    }
+    int epoll_result = FML_HANDLE_EINTR(::epoll_wait(
+        epoll_fd_.get(), events, kMaxEventsPerWait, -1 /* timeout */));
 
     // Timeouts are fatal since we specified an infinite timeout already.
-    // Likewise, > 1 is not possible since we waited for one result.
-    if (epoll_result != 1) {
+    if (epoll_result <= 0) {
       running_ = false;
       continue;
     }
 
-    if (event.data.fd == timer_fd_.get()) {
+    for (int i = 0; i < epoll_result && running_; i++) {
+      const struct epoll_event& event = events[i];
+      if (event.data.fd != timer_fd_.get()) {
+        OnFileDescriptorReady(event.data.fd, event.events);
+        continue;
+      }
+
+      // Errors on the timer are fatal.
+      if (event.events & (EPOLLERR | EPOLLHUP)) {
+        running_ = false;
+        continue;
+      }
+
       OnEventFired();
     }
   }
@@ -80,15 +123,60 @@ void MessageLoopLinux::Terminate() {
 
 // |fml::MessageLoopImpl|
 void MessageLoopLinux::WakeUp(fml::TimePoint time_point) {
+  std::scoped_lock lock(timer_mutex_);
+  if (running_expired_tasks_) {
+    // Running each expired task asks for a wake-up. Only the last one matters.
+    pending_wake_time_ = time_point;
+    return;
+  }
+  RearmTimer(time_point);
+}
+
+void MessageLoopLinux::RearmTimer(fml::TimePoint time_point) {
+  // Posting a burst of tasks asks for the same wake-up over and over.
+  if (armed_time_ == time_point) {
+    return;
+  }
   bool result = TimerRearm(timer_fd_.get(), time_point);
   (void)result;
   FML_DCHECK(result);
+  armed_time_ = time_point;
 }
 
 void MessageLoopLinux::OnEventFired() {
-  if (TimerDrain(timer_fd_.get())) {
-    RunExpiredTasksNow();
+  if (!TimerDrain(timer_fd_.get())) {
+    return;
+  }
+
+  {
+    std::scoped_lock lock(timer_mutex_);
+    // The timer has to be rearmed even for the time it just fired at.
+    armed_time_.reset();
+    running_expired_tasks_ = true;
+  }
+
+  RunExpiredTasksNow();
+
+  std::scoped_lock lock(timer_mutex_);
+  running_expired_tasks_ = false;
+  if (pending_wake_time_.has_value()) {
+    RearmTimer(pending_wake_time_.value());
+    pending_wake_time_.reset();
+  }
+}
+
+void MessageLoopLinux::OnFileDescriptorReady(int fd, uint32_t events) {
+  std::shared_ptr<FileDescriptorCallback> callback;
+  {
+    std::scoped_lock lock(file_descriptors_mutex_);
+    auto found = file_descriptors_.find(fd);
+    if (found == file_descriptors_.end()) {
+      // Removed by a callback earlier in the same batch.
+      return;
+    }
+    callback = found->second;
   }
+  (*callback)(events);
 }
 
 }  // namespace fml
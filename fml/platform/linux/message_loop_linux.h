@@ -6,6 +6,11 @@
 #define FLUTTER_FML_PLATFORM_LINUX_MESSAGE_LOOP_LINUX_H_
 
 #include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
 
 #include "flutter/fml/macros.h"
 #include "flutter/fml/message_loop_impl.h"
@@ -14,11 +19,45 @@
 namespace fml {
 
 class MessageLoopLinux : public MessageLoopImpl {
+ public:
+  /// Called on the thread of the loop with the epoll events that are ready.
+  using FileDescriptorCallback = std::function<void(uint32_t events)>;
+
+  /// Returns the loop of the current thread, which must have been initialized
+  /// with |MessageLoop::EnsureInitializedForCurrentThread|.
+  static fml::RefPtr<MessageLoopLinux> GetCurrent();
+
+  /// Calls |callback| on the thread of the loop whenever |fd| is ready for
+  /// any of the epoll |events|, such as |EPOLLIN|. The readiness is level
+  /// triggered, so the callback has to consume it. The loop doesn't own |fd|,
+  /// which must stay open until it is removed. Returns false if |fd| is
+  /// already being watched or can't be watched.
+  bool AddFileDescriptor(int fd,
+                         uint32_t events,
+                         FileDescriptorCallback callback);
+
+  /// Stops watching |fd|. Returns false if it wasn't being watched.
+  bool RemoveFileDescriptor(int fd);
+
  private:
+  // The most ready file descriptors handled per wait.
+  static constexpr int kMaxEventsPerWait = 16;
+
   fml::UniqueFD epoll_fd_;
   fml::UniqueFD timer_fd_;
   bool running_;
 
+  std::mutex file_descriptors_mutex_;
+  std::map<int, std::shared_ptr<FileDescriptorCallback>> file_descriptors_;
+
+  std::mutex timer_mutex_;
+  // The time the timer is armed for, if it hasn't fired since.
+  std::optional<fml::TimePoint> armed_time_;
+  // Whether the expired tasks are being run. Wake-ups requested meanwhile are
+  // applied once they have all run.
+  bool running_expired_tasks_ = false;
+  std::optional<fml::TimePoint> pending_wake_time_;
+
   MessageLoopLinux();
 
   ~MessageLoopLinux() override;
@@ -34,6 +73,11 @@ class MessageLoopLinux : public MessageLoopImpl {
 
   void OnEventFired();
 
+  void OnFileDescriptorReady(int fd, uint32_t events);
+
+  // Requires |timer_mutex_|.
+  void RearmTimer(fml::TimePoint time_point);
+
   bool AddOrRemoveTimerSource(bool add);
 
   FML_FRIEND_MAKE_REF_COUNTED(MessageLoopLinux);
@@ -0,0 +1,113 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#define FML_USED_ON_EMBEDDER
+
+#include "flutter/fml/platform/linux/message_loop_linux.h"
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <thread>
+
+#include "flutter/fml/message_loop.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/task_runner.h"
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace testing {
+
+namespace {
+
+// Runs a message loop on its own thread until destroyed.
+class LoopThread {
+ public:
+  LoopThread() {
+    fml::AutoResetWaitableEvent latch;
+    thread_ = std::thread([this, &latch]() {
+      fml::MessageLoop::EnsureInitializedForCurrentThread();
+      loop_ = MessageLoopLinux::GetCurrent();
+      task_runner_ = fml::MessageLoop::GetCurrent().GetTaskRunner();
+      latch.Signal();
+      fml::MessageLoop::GetCurrent().Run();
+    });
+    latch.Wait();
+  }
+
+  ~LoopThread() {
+    task_runner_->PostTask(
+        []() { fml::MessageLoop::GetCurrent().Terminate(); });
+    thread_.join();
+  }
+
+  MessageLoopLinux& loop() { return *loop_; }
+
+  const fml::RefPtr<fml::TaskRunner>& task_runner() { return task_runner_; }
+
+ private:
+  std::thread thread_;
+  fml::RefPtr<MessageLoopLinux> loop_;
+  fml::RefPtr<fml::TaskRunner> task_runner_;
+};
+
+}  // namespace
+
+TEST(MessageLoopLinuxTest, CallsBackWhenFileDescriptorIsReady) {
+  int fds[2];
+  ASSERT_EQ(::pipe(fds), 0);
+  LoopThread loop_thread;
+
+  fml::AutoResetWaitableEvent latch;
+  char received = 0;
+  std::thread::id callback_thread;
+  ASSERT_TRUE(loop_thread.loop().AddFileDescriptor(
+      fds[0], EPOLLIN, [&](uint32_t events) {
+        ASSERT_TRUE(events & EPOLLIN);
+        ASSERT_EQ(::read(fds[0], &received, 1), 1);
+        callback_thread = std::this_thread::get_id();
+        latch.Signal();
+      }));
+  ASSERT_FALSE(
+      loop_thread.loop().AddFileDescriptor(fds[0], EPOLLIN, [](uint32_t) {}));
+
+  const char sent = 'x';
+  ASSERT_EQ(::write(fds[1], &sent, 1), 1);
+  latch.Wait();
+  ASSERT_EQ(received, sent);
+  ASSERT_NE(callback_thread, std::this_thread::get_id());
+
+  ASSERT_TRUE(loop_thread.loop().RemoveFileDescriptor(fds[0]));
+  ASSERT_FALSE(loop_thread.loop().RemoveFileDescriptor(fds[0]));
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+TEST(MessageLoopLinuxTest, RunsBurstOfTasksPostedFromOtherThreads) {
+  LoopThread loop_thread;
+  const size_t kTaskCount = 1000;
+  fml::CountDownLatch latch(kTaskCount);
+  for (size_t i = 0; i < kTaskCount; i++) {
+    loop_thread.task_runner()->PostTask([&latch]() { latch.CountDown(); });
+  }
+  latch.Wait();
+}
+
+TEST(MessageLoopLinuxTest, RunsDelayedTaskPostedWhileRunningTasks) {
+  LoopThread loop_thread;
+  fml::AutoResetWaitableEvent latch;
+  const auto start = fml::TimePoint::Now();
+  const auto delay = fml::TimeDelta::FromMilliseconds(5);
+  loop_thread.task_runner()->PostTask([&]() {
+    loop_thread.task_runner()->PostDelayedTask([&]() { latch.Signal(); },
+                                               delay);
+    loop_thread.task_runner()->PostTask([]() {});
+  });
+  latch.Wait();
+  ASSERT_GE(fml::TimePoint::Now() - start, delay);
+}
+
+}  // namespace testing
+}  // namespace fml
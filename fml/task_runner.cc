@@ -35,6 +35,10 @@ void TaskRunner::PostDelayedTask(const fml::closure& task,
   loop_->PostTask(task, fml::TimePoint::Now() + delay);
 }
 
+void TaskRunner::PostIdleTask(const fml::closure& task) {
+  loop_->PostTask(task, fml::TimePoint::Now(), fml::TaskSourceGrade::kIdle);
+}
+
 TaskQueueId TaskRunner::GetTaskQueueId() {
   FML_DCHECK(loop_);
   return loop_->GetTaskQueueId();
@@ -49,6 +49,11 @@ class TaskRunner : public fml::RefCountedThreadSafe<TaskRunner>,
   /// tens of milliseconds.
   virtual void PostDelayedTask(const fml::closure& task, fml::TimeDelta delay);
 
+  /// Schedules a task of \p TaskSourceGrade::kIdle, which waits for the frame
+  /// work in progress on this TaskRunner to complete.
+  /// \see fml::MessageLoopTaskQueues::SetFrameDeadline
+  virtual void PostIdleTask(const fml::closure& task);
+
   /// Returns \p true when the current executing thread's TaskRunner matches
   /// this instance.
   virtual bool RunsTasksOnCurrentThread();
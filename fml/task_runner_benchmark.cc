@@ -0,0 +1,107 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#define FML_USED_ON_EMBEDDER
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/message_loop.h"
+#include "flutter/fml/message_loop_task_queues.h"
+#include "flutter/fml/task_runner.h"
+
+// Count every allocation made by the benchmark binary so that the benchmarks
+// below can report the allocations made per posted task.
+static std::atomic_size_t gAllocationCount{0};
+
+void* operator new(size_t size) {
+  gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (!ptr) {
+    std::abort();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t size) noexcept {
+  std::free(ptr);
+}
+
+namespace fml {
+namespace benchmarking {
+
+static const size_t kTaskCount = 1000;
+
+// A task capturing |capture_size| bytes, like a task that captures a few
+// pointers or smart pointers and some arguments.
+template <size_t capture_size>
+static auto MakeTask(size_t* counter) {
+  std::array<char, capture_size - sizeof(size_t*)> payload = {};
+  return [counter, payload]() { *counter += payload.size(); };
+}
+
+template <size_t capture_size>
+static void BM_RegisterTaskAllocations(benchmark::State& state) {  // NOLINT
+  auto task_queues = MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queues->CreateTaskQueue();
+  const auto now = TimePoint::Now();
+  size_t counter = 0;
+  size_t allocations = 0;
+  while (state.KeepRunning()) {
+    const size_t allocations_before = gAllocationCount;
+    for (size_t i = 0; i < kTaskCount; i++) {
+      task_queues->RegisterTask(queue_id, MakeTask<capture_size>(&counter),
+                                now);
+    }
+    while (auto invocation = task_queues->GetNextTaskToRun(queue_id, now)) {
+      invocation();
+    }
+    allocations += gAllocationCount - allocations_before;
+  }
+  task_queues->Dispose(queue_id);
+  state.counters["AllocationsPerTask"] = benchmark::Counter(
+      static_cast<double>(allocations) / (state.iterations() * kTaskCount));
+  state.SetItemsProcessed(state.iterations() * kTaskCount);
+}
+
+BENCHMARK_TEMPLATE(BM_RegisterTaskAllocations, 16);
+BENCHMARK_TEMPLATE(BM_RegisterTaskAllocations, 48);
+BENCHMARK_TEMPLATE(BM_RegisterTaskAllocations, 128);
+
+// Tasks posted through a |TaskRunner| still go through an |fml::closure| at
+// the API boundary.
+template <size_t capture_size>
+static void BM_TaskRunnerPostTaskAllocations(
+    benchmark::State& state) {  // NOLINT
+  MessageLoop::EnsureInitializedForCurrentThread();
+  auto& loop = MessageLoop::GetCurrent();
+  auto task_runner = loop.GetTaskRunner();
+  size_t counter = 0;
+  size_t allocations = 0;
+  while (state.KeepRunning()) {
+    const size_t allocations_before = gAllocationCount;
+    for (size_t i = 0; i < kTaskCount; i++) {
+      task_runner->PostTask(MakeTask<capture_size>(&counter));
+    }
+    loop.RunExpiredTasksNow();
+    allocations += gAllocationCount - allocations_before;
+  }
+  state.counters["AllocationsPerTask"] = benchmark::Counter(
+      static_cast<double>(allocations) / (state.iterations() * kTaskCount));
+  state.SetItemsProcessed(state.iterations() * kTaskCount);
+}
+
+BENCHMARK_TEMPLATE(BM_TaskRunnerPostTaskAllocations, 16);
+BENCHMARK_TEMPLATE(BM_TaskRunnerPostTaskAllocations, 48);
+
+}  // namespace benchmarking
+}  // namespace fml
@@ -6,8 +6,18 @@
 
 #include "flutter/fml/task_source.h"
 
+#include <algorithm>
+#include <optional>
+
 namespace fml {
 
+bool TaskSource::TopTask::RunsAfter(const TopTask& other) const {
+  if (target_time != other.target_time) {
+    return target_time > other.target_time;
+  }
+  return task > other.task;
+}
+
 TaskSource::TaskSource(TaskQueueId task_queue_id)
     : task_queue_id_(task_queue_id) {}
 
@@ -18,38 +28,42 @@ TaskSource::~TaskSource() {
 void TaskSource::ShutDown() {
   primary_task_queue_ = {};
   secondary_task_queue_ = {};
+  idle_task_queue_ = {};
 }
 
-void TaskSource::RegisterTask(const DelayedTask& task) {
+void TaskSource::RegisterTask(DelayedTask task) {
   switch (task.GetTaskSourceGrade()) {
     case TaskSourceGrade::kUserInteraction:
-      primary_task_queue_.push(task);
+      primary_task_queue_.push(std::move(task));
       break;
     case TaskSourceGrade::kUnspecified:
-      primary_task_queue_.push(task);
+      primary_task_queue_.push(std::move(task));
       break;
     case TaskSourceGrade::kDartMicroTasks:
-      secondary_task_queue_.push(task);
+      secondary_task_queue_.push(std::move(task));
+      break;
+    case TaskSourceGrade::kIdle:
+      idle_task_queue_.push(std::move(task));
       break;
   }
 }
 
-void TaskSource::PopTask(TaskSourceGrade grade) {
+DelayedTask TaskSource::PopTask(TaskSourceGrade grade) {
   switch (grade) {
     case TaskSourceGrade::kUserInteraction:
-      primary_task_queue_.pop();
-      break;
+      return primary_task_queue_.TakeTop();
     case TaskSourceGrade::kUnspecified:
-      primary_task_queue_.pop();
-      break;
+      return primary_task_queue_.TakeTop();
     case TaskSourceGrade::kDartMicroTasks:
-      secondary_task_queue_.pop();
-      break;
+      return secondary_task_queue_.TakeTop();
+    case TaskSourceGrade::kIdle:
+      return idle_task_queue_.TakeTop();
   }
+  FML_UNREACHABLE();
 }
 
 size_t TaskSource::GetNumPendingTasks() const {
-  size_t size = primary_task_queue_.size();
+  size_t size = primary_task_queue_.size() + idle_task_queue_.size();
   if (secondary_pause_requests_ == 0) {
     size += secondary_task_queue_.size();
   }
@@ -62,33 +76,29 @@ bool TaskSource::IsEmpty() const {
 
 TaskSource::TopTask TaskSource::Top() const {
   FML_CHECK(!IsEmpty());
-  if (secondary_pause_requests_ > 0 || secondary_task_queue_.empty()) {
-    const auto& primary_top = primary_task_queue_.top();
-    return {
-        .task_queue_id = task_queue_id_,
-        .task = primary_top,
-    };
-  } else if (primary_task_queue_.empty()) {
-    const auto& secondary_top = secondary_task_queue_.top();
-    return {
+  std::optional<TopTask> top_task;
+  auto update_top_task = [&](const DelayedTaskQueue& queue,
+                             fml::TimePoint not_before) {
+    if (queue.empty()) {
+      return;
+    }
+    const DelayedTask& task = queue.top();
+    TopTask candidate = {
         .task_queue_id = task_queue_id_,
-        .task = secondary_top,
+        .task = task,
+        .target_time = std::max(task.GetTargetTime(), not_before),
     };
-  } else {
-    const auto& primary_top = primary_task_queue_.top();
-    const auto& secondary_top = secondary_task_queue_.top();
-    if (primary_top > secondary_top) {
-      return {
-          .task_queue_id = task_queue_id_,
-          .task = secondary_top,
-      };
-    } else {
-      return {
-          .task_queue_id = task_queue_id_,
-          .task = primary_top,
-      };
+    if (!top_task.has_value() || top_task->RunsAfter(candidate)) {
+      top_task.emplace(candidate);
     }
+  };
+  update_top_task(primary_task_queue_, fml::TimePoint::Min());
+  if (secondary_pause_requests_ == 0) {
+    update_top_task(secondary_task_queue_, fml::TimePoint::Min());
   }
+  update_top_task(idle_task_queue_, frame_deadline_);
+  FML_CHECK(top_task.has_value());
+  return top_task.value();
 }
 
 void TaskSource::PauseSecondary() {
@@ -100,4 +110,12 @@ void TaskSource::ResumeSecondary() {
   FML_DCHECK(secondary_pause_requests_ >= 0);
 }
 
+void TaskSource::SetFrameDeadline(fml::TimePoint deadline) {
+  frame_deadline_ = deadline;
+}
+
+void TaskSource::ClearFrameDeadline() {
+  frame_deadline_ = fml::TimePoint::Min();
+}
+
 }  // namespace fml
@@ -20,6 +20,10 @@ class MessageLoopTaskQueues;
  * dispatcher. `TaskSourceGrade` determines what task heap the task is assigned
  * to.
  *
+ * Tasks of `TaskSourceGrade::kIdle` are kept in a third heap, which is held
+ * back while a frame deadline is set, until the deadline passes or the frame
+ * deadline is cleared.
+ *
  * Registering Tasks
  * -----------------
  * The task dispatcher associates a task source with each `TaskQueueID`. When
@@ -37,6 +41,12 @@ class TaskSource {
   struct TopTask {
     TaskQueueId task_queue_id;
     const DelayedTask& task;
+    /// The time at which the task may run. This is later than the target time
+    /// of the task if it is an idle task held back by a frame deadline.
+    fml::TimePoint target_time;
+
+    /// Whether this task is to run after |other|.
+    bool RunsAfter(const TopTask& other) const;
   };
 
   /// Construts a TaskSource with the given `task_queue_id`.
@@ -44,15 +54,16 @@ class TaskSource {
 
   ~TaskSource();
 
-  /// Drops the pending tasks from both primary and secondary task heaps.
+  /// Drops the pending tasks from all the task heaps.
   void ShutDown();
 
   /// Adds a task to the corresponding task heap as dictated by the
   /// `TaskSourceGrade` of the `DelayedTask`.
-  void RegisterTask(const DelayedTask& task);
+  void RegisterTask(DelayedTask task);
 
-  /// Pops the task heap corresponding to the `TaskSourceGrade`.
-  void PopTask(TaskSourceGrade grade);
+  /// Pops the task heap corresponding to the `TaskSourceGrade` and returns the
+  /// popped task.
+  DelayedTask PopTask(TaskSourceGrade grade);
 
   /// Returns the number of pending tasks. Excludes the tasks from the secondary
   /// heap if it's paused.
@@ -71,11 +82,21 @@ class TaskSource {
   /// Resume providing tasks from secondary task heap.
   void ResumeSecondary();
 
+  /// Holds back the tasks from the idle task heap until |deadline|, or until
+  /// the frame deadline is cleared. Frame deadlines don't nest; this replaces
+  /// the previous deadline.
+  void SetFrameDeadline(fml::TimePoint deadline);
+
+  /// Stops holding back the tasks from the idle task heap.
+  void ClearFrameDeadline();
+
  private:
   const fml::TaskQueueId task_queue_id_;
   fml::DelayedTaskQueue primary_task_queue_;
   fml::DelayedTaskQueue secondary_task_queue_;
+  fml::DelayedTaskQueue idle_task_queue_;
   int secondary_pause_requests_ = 0;
+  fml::TimePoint frame_deadline_ = fml::TimePoint::Min();
 
   FML_DISALLOW_COPY_ASSIGN_AND_MOVE(TaskSource);
 };
@@ -21,6 +21,10 @@ enum class TaskSourceGrade {
   kDartMicroTasks,
   /// The absence of a specialized `TaskSourceGrade`.
   kUnspecified,
+  /// This `TaskSourceGrade` indicates that a task can wait until the frame
+  /// work in progress on its queue has completed, such as handling a platform
+  /// channel message or responding to a memory pressure hint.
+  kIdle,
 };
 
 }  // namespace fml
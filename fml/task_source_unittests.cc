@@ -97,5 +97,48 @@ TEST(TaskSourceTests, OrderingMultiTaskHeapsSecondaryPaused) {
   ASSERT_EQ(value, 1);
 }
 
+TEST(TaskSourceTests, IdleTasksHeldBackByFrameDeadline) {
+  TaskSource task_source = TaskSource(TaskQueueId(1));
+  auto time_stamp = ChronoTicksSinceEpoch();
+  auto deadline = time_stamp + fml::TimeDelta::FromMilliseconds(16);
+  int value = 0;
+  task_source.RegisterTask(
+      {1, [&] { value = 1; }, time_stamp, TaskSourceGrade::kIdle});
+  task_source.RegisterTask({2, [&] { value = 7; },
+                            time_stamp + fml::TimeDelta::FromMilliseconds(1),
+                            TaskSourceGrade::kUnspecified});
+
+  task_source.SetFrameDeadline(deadline);
+  ASSERT_EQ(task_source.GetNumPendingTasks(), 2u);
+
+  auto top_task = task_source.Top();
+  ASSERT_EQ(top_task.task.GetTaskSourceGrade(), TaskSourceGrade::kUnspecified);
+  top_task.task.GetTask()();
+  task_source.PopTask(top_task.task.GetTaskSourceGrade());
+  ASSERT_EQ(value, 7);
+
+  auto idle_task = task_source.Top();
+  ASSERT_EQ(idle_task.task.GetTaskSourceGrade(), TaskSourceGrade::kIdle);
+  ASSERT_EQ(idle_task.target_time, deadline);
+
+  task_source.ClearFrameDeadline();
+  ASSERT_EQ(task_source.Top().target_time, time_stamp);
+}
+
+TEST(TaskSourceTests, IdleTasksKeepOrderWithoutFrameDeadline) {
+  TaskSource task_source = TaskSource(TaskQueueId(1));
+  auto time_stamp = ChronoTicksSinceEpoch();
+  int value = 0;
+  task_source.RegisterTask(
+      {1, [&] { value = 1; }, time_stamp, TaskSourceGrade::kIdle});
+  task_source.RegisterTask(
+      {2, [&] { value = 7; }, time_stamp, TaskSourceGrade::kUserInteraction});
+
+  auto top_task = task_source.Top();
+  top_task.task.GetTask()();
+  task_source.PopTask(top_task.task.GetTaskSourceGrade());
+  ASSERT_EQ(value, 1);
+}
+
 }  // namespace testing
 }  // namespace fml
@@ -7,23 +7,92 @@
 #include "flutter/fml/thread.h"
 
 #include <memory>
+#include <sstream>
 #include <string>
 #include <utility>
 
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/trace_event.h"
 
 #if defined(FML_OS_WIN)
 #include <windows.h>
 #elif defined(OS_FUCHSIA)
 #include <lib/zx/thread.h>
+#include <pthread.h>
 #else
 #include <pthread.h>
 #endif
 
+#if defined(FML_OS_LINUX) || defined(FML_OS_ANDROID)
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define FML_THREAD_CONFIG_SUPPORTED 1
+#else
+#define FML_THREAD_CONFIG_SUPPORTED 0
+#endif
+
 namespace fml {
 
+/// Starts a thread with a given stack size, which |std::thread| can't do.
+class ThreadHandle {
+ public:
+  using ThreadFunction = std::function<void()>;
+
+  ThreadHandle(ThreadFunction&& function, size_t stack_size);
+
+  void Join();
+
+ private:
+#if defined(FML_OS_WIN)
+  std::thread thread_;
+#else
+  pthread_t thread_;
+#endif
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ThreadHandle);
+};
+
+#if defined(FML_OS_WIN)
+ThreadHandle::ThreadHandle(ThreadFunction&& function, size_t stack_size)
+    : thread_(std::move(function)) {}
+
+void ThreadHandle::Join() {
+  thread_.join();
+}
+#else
+ThreadHandle::ThreadHandle(ThreadFunction&& function, size_t stack_size) {
+  pthread_attr_t attributes;
+  int result = pthread_attr_init(&attributes);
+  FML_CHECK(result == 0);
+  if (stack_size > 0 &&
+      pthread_attr_setstacksize(&attributes, stack_size) != 0) {
+    FML_LOG(ERROR) << "Could not set the thread stack size to " << stack_size
+                   << " bytes.";
+  }
+  auto* thread_function = new ThreadFunction(std::move(function));
+  result = pthread_create(
+      &thread_, &attributes,
+      [](void* arg) -> void* {
+        std::unique_ptr<ThreadFunction> function(
+            static_cast<ThreadFunction*>(arg));
+        (*function)();
+        return nullptr;
+      },
+      thread_function);
+  FML_CHECK(result == 0);
+  result = pthread_attr_destroy(&attributes);
+  FML_CHECK(result == 0);
+}
+
+void ThreadHandle::Join() {
+  pthread_join(thread_, nullptr);
+}
+#endif
+
 #if defined(FML_OS_WIN)
 // The information on how to set the thread name comes from
 // a MSDN article: http://msdn2.microsoft.com/en-us/library/xcb2z8hs.aspx
@@ -67,6 +136,82 @@ void Thread::SetCurrentThreadName(const Thread::ThreadConfig& config) {
   SetThreadName(config.name);
 }
 
+static const char* ThreadPriorityToString(Thread::ThreadPriority priority) {
+  switch (priority) {
+    case Thread::ThreadPriority::BACKGROUND:
+      return "background";
+    case Thread::ThreadPriority::NORMAL:
+      return "normal";
+    case Thread::ThreadPriority::DISPLAY:
+      return "display";
+    case Thread::ThreadPriority::RASTER:
+      return "raster";
+  }
+  return "unknown";
+}
+
+void Thread::ApplyCurrentThreadConfig(const Thread::ThreadConfig& config) {
+  std::stringstream description;
+  description << "priority:" << ThreadPriorityToString(config.priority);
+
+#if FML_THREAD_CONFIG_SUPPORTED
+  if (!config.cpu_affinity.empty()) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    description << " cpus:";
+    for (size_t i = 0; i < config.cpu_affinity.size(); i++) {
+      const size_t cpu = config.cpu_affinity[i];
+      if (cpu < CPU_SETSIZE) {
+        CPU_SET(cpu, &cpu_set);
+      }
+      description << (i > 0 ? "," : "") << cpu;
+    }
+    if (::sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+      FML_LOG(ERROR) << "Could not set the CPU affinity of thread '"
+                     << config.name << "'.";
+      description << "(failed)";
+    }
+  }
+
+  if (config.realtime_priority.has_value()) {
+    struct sched_param param = {};
+    param.sched_priority = config.realtime_priority.value();
+    description << " fifo:" << param.sched_priority;
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+      FML_LOG(ERROR) << "Could not set the real time priority of thread '"
+                     << config.name << "'.";
+      description << "(failed)";
+    }
+  }
+
+  if (config.nice_value.has_value()) {
+    description << " nice:" << config.nice_value.value();
+    // On Linux, the nice value of a thread ID only applies to that thread.
+    const auto thread_id = static_cast<id_t>(::syscall(SYS_gettid));
+    if (::setpriority(PRIO_PROCESS, thread_id, config.nice_value.value()) !=
+        0) {
+      FML_LOG(ERROR) << "Could not set the nice value of thread '"
+                     << config.name << "'.";
+      description << "(failed)";
+    }
+  }
+#else   // FML_THREAD_CONFIG_SUPPORTED
+  if (!config.cpu_affinity.empty() || config.realtime_priority.has_value() ||
+      config.nice_value.has_value()) {
+    FML_DLOG(INFO) << "CPU affinity, real time priority and nice values are "
+                      "not supported on this platform.";
+  }
+#endif  // FML_THREAD_CONFIG_SUPPORTED
+
+  if (config.stack_size > 0) {
+    description << " stack:" << config.stack_size;
+  }
+
+  const std::string description_string = description.str();
+  TRACE_EVENT_INSTANT2("flutter", "ThreadConfig", "name", config.name.c_str(),
+                       "config", description_string.c_str());
+}
+
 Thread::Thread(const std::string& name)
     : Thread(Thread::SetCurrentThreadName, ThreadConfig(name)) {}
 
@@ -75,15 +220,17 @@ Thread::Thread(const ThreadConfigSetter& setter, const ThreadConfig& config)
   fml::AutoResetWaitableEvent latch;
   fml::RefPtr<fml::TaskRunner> runner;
 
-  thread_ = std::make_unique<std::thread>(
+  thread_ = std::make_unique<ThreadHandle>(
       [&latch, &runner, setter, config]() -> void {
         setter(config);
+        ApplyCurrentThreadConfig(config);
         fml::MessageLoop::EnsureInitializedForCurrentThread();
         auto& loop = MessageLoop::GetCurrent();
         runner = loop.GetTaskRunner();
         latch.Signal();
         loop.Run();
-      });
+      },
+      config.stack_size);
   latch.Wait();
   task_runner_ = runner;
 }
@@ -102,7 +249,7 @@ void Thread::Join() {
   }
   joined_ = true;
   task_runner_->PostTask([]() { MessageLoop::GetCurrent().Terminate(); });
-  thread_->join();
+  thread_->Join();
 }
 
 }  // namespace fml
@@ -8,14 +8,18 @@
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/macros.h"
 #include "flutter/fml/task_runner.h"
 
 namespace fml {
 
+class ThreadHandle;
+
 class Thread {
  public:
   /// Valid values for priority of Thread.
@@ -42,6 +46,23 @@ class Thread {
 
     std::string name;
     ThreadPriority priority;
+
+    /// The CPUs the thread may run on. Empty to run on any CPU. Only supported
+    /// on Linux and Android.
+    std::vector<size_t> cpu_affinity;
+
+    /// The stack size of the thread in bytes, or 0 for the platform default.
+    /// Not supported on Windows.
+    size_t stack_size = 0;
+
+    /// Runs the thread with the |SCHED_FIFO| real time policy at this
+    /// priority, from 1 to 99. Only supported on Linux and Android, and only
+    /// for processes allowed to do so.
+    std::optional<int> realtime_priority;
+
+    /// The nice value of the thread, from -20 to 19. Only supported on Linux
+    /// and Android.
+    std::optional<int> nice_value;
   };
 
   using ThreadConfigSetter = std::function<void(const ThreadConfig&)>;
@@ -59,8 +80,13 @@ class Thread {
 
   static void SetCurrentThreadName(const ThreadConfig& config);
 
+  /// Applies the CPU affinity, real time priority and nice value of \p config
+  /// to the current thread and reports the configuration in a trace event.
+  /// Threads started by |Thread| call this after the |ThreadConfigSetter|.
+  static void ApplyCurrentThreadConfig(const ThreadConfig& config);
+
  private:
-  std::unique_ptr<std::thread> thread_;
+  std::unique_ptr<ThreadHandle> thread_;
 
   fml::RefPtr<fml::TaskRunner> task_runner_;
 
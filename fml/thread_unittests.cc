@@ -4,6 +4,8 @@
 
 #include "flutter/fml/thread.h"
 
+#include "flutter/fml/build_config.h"
+
 #if defined(FML_OS_MACOSX) || defined(FML_OS_LINUX) || defined(FML_OS_ANDROID)
 #define FLUTTER_PTHREAD_SUPPORTED 1
 #else
@@ -15,6 +17,10 @@
 #else
 #endif
 
+#if defined(FML_OS_LINUX)
+#include <sched.h>
+#endif
+
 #include <memory>
 #include "gtest/gtest.h"
 
@@ -45,15 +51,17 @@ TEST(Thread, ThreadNameCreatedWithConfig) {
   bool done = false;
   thread.GetTaskRunner()->PostTask([&done, &name]() {
     done = true;
-    char thread_name[8];
+    char thread_name[16];
     pthread_t current_thread = pthread_self();
-    pthread_getname_np(current_thread, thread_name, 8);
+    pthread_getname_np(current_thread, thread_name, 16);
     ASSERT_EQ(thread_name, name);
   });
   thread.Join();
   ASSERT_TRUE(done);
 }
 
+// Linux only accepts a priority of 0 for |SCHED_OTHER|.
+#if defined(FML_OS_MACOSX)
 static void MockThreadConfigSetter(const fml::Thread::ThreadConfig& config) {
   // set thread name
   fml::Thread::SetCurrentThreadName(config);
@@ -84,9 +92,9 @@ TEST(Thread, ThreadPriorityCreatedWithConfig) {
   int policy;
   thread.GetTaskRunner()->PostTask([&]() {
     done = true;
-    char thread_name[8];
+    char thread_name[16];
     pthread_t current_thread = pthread_self();
-    pthread_getname_np(current_thread, thread_name, 8);
+    pthread_getname_np(current_thread, thread_name, 16);
     pthread_getschedparam(current_thread, &policy, &param);
     ASSERT_EQ(thread_name, thread1_name);
     ASSERT_EQ(policy, SCHED_OTHER);
@@ -98,9 +106,9 @@ TEST(Thread, ThreadPriorityCreatedWithConfig) {
                           thread2_name, fml::Thread::ThreadPriority::DISPLAY));
   thread2.GetTaskRunner()->PostTask([&]() {
     done = true;
-    char thread_name[8];
+    char thread_name[16];
     pthread_t current_thread = pthread_self();
-    pthread_getname_np(current_thread, thread_name, 8);
+    pthread_getname_np(current_thread, thread_name, 16);
     pthread_getschedparam(current_thread, &policy, &param);
     ASSERT_EQ(thread_name, thread2_name);
     ASSERT_EQ(policy, SCHED_OTHER);
@@ -109,4 +117,47 @@ TEST(Thread, ThreadPriorityCreatedWithConfig) {
   thread.Join();
   ASSERT_TRUE(done);
 }
+#endif  // defined(FML_OS_MACOSX)
+
+#if defined(FML_OS_LINUX)
+TEST(Thread, StackSizeCreatedWithConfig) {
+  fml::Thread::ThreadConfig config("Thread1",
+                                   fml::Thread::ThreadPriority::NORMAL);
+  config.stack_size = 4 * 1024 * 1024;
+  fml::Thread thread(fml::Thread::SetCurrentThreadName, config);
+
+  size_t stack_size = 0;
+  thread.GetTaskRunner()->PostTask([&stack_size]() {
+    pthread_attr_t attributes;
+    ASSERT_EQ(pthread_getattr_np(pthread_self(), &attributes), 0);
+    pthread_attr_getstacksize(&attributes, &stack_size);
+    pthread_attr_destroy(&attributes);
+  });
+  thread.Join();
+  ASSERT_GE(stack_size, config.stack_size);
+}
+
+TEST(Thread, CpuAffinityCreatedWithConfig) {
+  cpu_set_t available;
+  ASSERT_EQ(sched_getaffinity(0, sizeof(available), &available), 0);
+  size_t cpu = 0;
+  while (!CPU_ISSET(cpu, &available)) {
+    cpu++;
+  }
+
+  fml::Thread::ThreadConfig config("Thread1",
+                                   fml::Thread::ThreadPriority::NORMAL);
+  config.cpu_affinity = {cpu};
+  fml::Thread thread(fml::Thread::SetCurrentThreadName, config);
+
+  cpu_set_t affinity;
+  CPU_ZERO(&affinity);
+  thread.GetTaskRunner()->PostTask([&affinity]() {
+    sched_getaffinity(0, sizeof(affinity), &affinity);
+  });
+  thread.Join();
+  ASSERT_EQ(CPU_COUNT(&affinity), 1);
+  ASSERT_TRUE(CPU_ISSET(cpu, &affinity));
+}
+#endif  // defined(FML_OS_LINUX)
 #endif
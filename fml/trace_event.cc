@@ -15,8 +15,6 @@
 namespace fml {
 namespace tracing {
 
-#if FLUTTER_TIMELINE_ENABLED
-
 namespace {
 
 int64_t DefaultMicrosSource() {
@@ -24,22 +22,48 @@ int64_t DefaultMicrosSource() {
 }
 
 AsciiTrie gAllowlist;
+#if FLUTTER_TIMELINE_ENABLED
 std::atomic<TimelineEventHandler> gTimelineEventHandler;
+#endif  // FLUTTER_TIMELINE_ENABLED
 std::atomic<TimelineMicrosSource> gTimelineMicrosSource = DefaultMicrosSource;
 
-inline void FlutterTimelineEvent(const char* label,
+// Forwards an event to the timeline event handler, if there is one.
+inline void DispatchTimelineEvent(const char* label,
+                                  int64_t timestamp0,
+                                  int64_t timestamp1_or_async_id,
+                                  Dart_Timeline_Event_Type type,
+                                  intptr_t argument_count,
+                                  const char** argument_names,
+                                  const char** argument_values) {
+#if FLUTTER_TIMELINE_ENABLED
+  TimelineEventHandler handler =
+      gTimelineEventHandler.load(std::memory_order_relaxed);
+  if (handler && gAllowlist.Query(label)) {
+    handler(label, timestamp0, timestamp1_or_async_id, type, argument_count,
+            argument_names, argument_values);
+  }
+#endif  // FLUTTER_TIMELINE_ENABLED
+}
+
+// Records an event into the ring buffer of the current thread, if recording,
+// and forwards it to the timeline event handler.
+inline void FlutterTimelineEvent(const char* category_group,
+                                 const char* label,
                                  int64_t timestamp0,
                                  int64_t timestamp1_or_async_id,
                                  Dart_Timeline_Event_Type type,
                                  intptr_t argument_count,
                                  const char** argument_names,
                                  const char** argument_values) {
-  TimelineEventHandler handler =
-      gTimelineEventHandler.load(std::memory_order_relaxed);
-  if (handler && gAllowlist.Query(label)) {
-    handler(label, timestamp0, timestamp1_or_async_id, type, argument_count,
-            argument_names, argument_values);
+  if (TraceRingBuffer* ring = TraceRingBufferForEvent(label)) {
+    TraceRingBufferWriter writer(*ring, category_group, label, timestamp0,
+                                 timestamp1_or_async_id, type);
+    for (intptr_t i = 0; i < argument_count; i++) {
+      writer.AddArg(argument_names[i], argument_values[i]);
+    }
   }
+  DispatchTimelineEvent(label, timestamp0, timestamp1_or_async_id, type,
+                        argument_count, argument_names, argument_values);
 }
 }  // namespace
 
@@ -48,12 +72,25 @@ void TraceSetAllowlist(const std::vector<std::string>& allowlist) {
 }
 
 void TraceSetTimelineEventHandler(TimelineEventHandler handler) {
+#if FLUTTER_TIMELINE_ENABLED
   gTimelineEventHandler = handler;
+#endif  // FLUTTER_TIMELINE_ENABLED
 }
 
 bool TraceHasTimelineEventHandler() {
+#if FLUTTER_TIMELINE_ENABLED
   return static_cast<bool>(
       gTimelineEventHandler.load(std::memory_order_relaxed));
+#else   // FLUTTER_TIMELINE_ENABLED
+  return false;
+#endif  // FLUTTER_TIMELINE_ENABLED
+}
+
+TraceRingBuffer* TraceRingBufferForEvent(TraceArg name) {
+  if (!TraceRingBufferIsEnabled() || !gAllowlist.Query(name)) {
+    return nullptr;
+  }
+  return TraceRingBufferForCurrentThread();
 }
 
 int64_t TraceGetTimelineMicros() {
@@ -85,7 +122,7 @@ void TraceTimelineEvent(TraceArg category_group,
     c_values[i] = values[i].c_str();
   }
 
-  FlutterTimelineEvent(
+  DispatchTimelineEvent(
       name,                                      // label
       timestamp_micros,                          // timestamp0
       identifier,                                // timestamp1_or_async_id
@@ -113,7 +150,8 @@ void TraceTimelineEvent(TraceArg category_group,
 }
 
 void TraceEvent0(TraceArg category_group, TraceArg name) {
-  FlutterTimelineEvent(name,                            // label
+  FlutterTimelineEvent(category_group,                  // category_group
+                       name,                            // label
                        gTimelineMicrosSource.load()(),  // timestamp0
                        0,                          // timestamp1_or_async_id
                        Dart_Timeline_Event_Begin,  // event type
@@ -129,7 +167,8 @@ void TraceEvent1(TraceArg category_group,
                  TraceArg arg1_val) {
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
-  FlutterTimelineEvent(name,                            // label
+  FlutterTimelineEvent(category_group,                  // category_group
+                       name,                            // label
                        gTimelineMicrosSource.load()(),  // timestamp0
                        0,                          // timestamp1_or_async_id
                        Dart_Timeline_Event_Begin,  // event type
@@ -147,7 +186,8 @@ void TraceEvent2(TraceArg category_group,
                  TraceArg arg2_val) {
   const char* arg_names[] = {arg1_name, arg2_name};
   const char* arg_values[] = {arg1_val, arg2_val};
-  FlutterTimelineEvent(name,                            // label
+  FlutterTimelineEvent(category_group,                  // category_group
+                       name,                            // label
                        gTimelineMicrosSource.load()(),  // timestamp0
                        0,                          // timestamp1_or_async_id
                        Dart_Timeline_Event_Begin,  // event type
@@ -158,7 +198,8 @@ void TraceEvent2(TraceArg category_group,
 }
 
 void TraceEventEnd(TraceArg name) {
-  FlutterTimelineEvent(name,                            // label
+  FlutterTimelineEvent(nullptr,                         // category_group
+                       name,                            // label
                        gTimelineMicrosSource.load()(),  // timestamp0
                        0,                        // timestamp1_or_async_id
                        Dart_Timeline_Event_End,  // event type
@@ -171,7 +212,8 @@ void TraceEventEnd(TraceArg name) {
 void TraceEventAsyncBegin0(TraceArg category_group,
                            TraceArg name,
                            TraceIDArg id) {
-  FlutterTimelineEvent(name,                            // label
+  FlutterTimelineEvent(category_group,                  // category_group
+                       name,                            // label
                        gTimelineMicrosSource.load()(),  // timestamp0
                        id,  // timestamp1_or_async_id
                        Dart_Timeline_Event_Async_Begin,  // event type
@@ -184,7 +226,8 @@ void TraceEventAsyncBegin0(TraceArg category_group,
 void TraceEventAsyncEnd0(TraceArg category_group,
                          TraceArg name,
                          TraceIDArg id) {
-  FlutterTimelineEvent(name,                            // label
+  FlutterTimelineEvent(category_group,                  // category_group
+                       name,                            // label
                        gTimelineMicrosSource.load()(),  // timestamp0
                        id,                             // timestamp1_or_async_id
                        Dart_Timeline_Event_Async_End,  // event type
@@ -201,7 +244,8 @@ void TraceEventAsyncBegin1(TraceArg category_group,
                            TraceArg arg1_val) {
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
-  FlutterTimelineEvent(name,                            // label
+  FlutterTimelineEvent(category_group,                  // category_group
+                       name,                            // label
                        gTimelineMicrosSource.load()(),  // timestamp0
                        id,  // timestamp1_or_async_id
                        Dart_Timeline_Event_Async_Begin,  // event type
@@ -218,7 +262,8 @@ void TraceEventAsyncEnd1(TraceArg category_group,
                          TraceArg arg1_val) {
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
-  FlutterTimelineEvent(name,                            // label
+  FlutterTimelineEvent(category_group,                  // category_group
+                       name,                            // label
                        gTimelineMicrosSource.load()(),  // timestamp0
                        id,                             // timestamp1_or_async_id
                        Dart_Timeline_Event_Async_End,  // event type
@@ -229,7 +274,8 @@ void TraceEventAsyncEnd1(TraceArg category_group,
 }
 
 void TraceEventInstant0(TraceArg category_group, TraceArg name) {
-  FlutterTimelineEvent(name,                            // label
+  FlutterTimelineEvent(category_group,                  // category_group
+                       name,                            // label
                        gTimelineMicrosSource.load()(),  // timestamp0
                        0,                            // timestamp1_or_async_id
                        Dart_Timeline_Event_Instant,  // event type
@@ -245,7 +291,8 @@ void TraceEventInstant1(TraceArg category_group,
                         TraceArg arg1_val) {
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
-  FlutterTimelineEvent(name,                            // label
+  FlutterTimelineEvent(category_group,                  // category_group
+                       name,                            // label
                        gTimelineMicrosSource.load()(),  // timestamp0
                        0,                            // timestamp1_or_async_id
                        Dart_Timeline_Event_Instant,  // event type
@@ -263,7 +310,8 @@ void TraceEventInstant2(TraceArg category_group,
                         TraceArg arg2_val) {
   const char* arg_names[] = {arg1_name, arg2_name};
   const char* arg_values[] = {arg1_val, arg2_val};
-  FlutterTimelineEvent(name,                            // label
+  FlutterTimelineEvent(category_group,                  // category_group
+                       name,                            // label
                        gTimelineMicrosSource.load()(),  // timestamp0
                        0,                            // timestamp1_or_async_id
                        Dart_Timeline_Event_Instant,  // event type
@@ -276,7 +324,8 @@ void TraceEventInstant2(TraceArg category_group,
 void TraceEventFlowBegin0(TraceArg category_group,
                           TraceArg name,
                           TraceIDArg id) {
-  FlutterTimelineEvent(name,                            // label
+  FlutterTimelineEvent(category_group,                  // category_group
+                       name,                            // label
                        gTimelineMicrosSource.load()(),  // timestamp0
                        id,  // timestamp1_or_async_id
                        Dart_Timeline_Event_Flow_Begin,  // event type
@@ -289,7 +338,8 @@ void TraceEventFlowBegin0(TraceArg category_group,
 void TraceEventFlowStep0(TraceArg category_group,
                          TraceArg name,
                          TraceIDArg id) {
-  FlutterTimelineEvent(name,                            // label
+  FlutterTimelineEvent(category_group,                  // category_group
+                       name,                            // label
                        gTimelineMicrosSource.load()(),  // timestamp0
                        id,                             // timestamp1_or_async_id
                        Dart_Timeline_Event_Flow_Step,  // event type
@@ -300,7 +350,8 @@ void TraceEventFlowStep0(TraceArg category_group,
 }
 
 void TraceEventFlowEnd0(TraceArg category_group, TraceArg name, TraceIDArg id) {
-  FlutterTimelineEvent(name,                            // label
+  FlutterTimelineEvent(category_group,                  // category_group
+                       name,                            // label
                        gTimelineMicrosSource.load()(),  // timestamp0
                        id,                            // timestamp1_or_async_id
                        Dart_Timeline_Event_Flow_End,  // event type
@@ -310,108 +361,5 @@ void TraceEventFlowEnd0(TraceArg category_group, TraceArg name, TraceIDArg id) {
   );
 }
 
-#else  // FLUTTER_TIMELINE_ENABLED
-
-void TraceSetAllowlist(const std::vector<std::string>& allowlist) {}
-
-void TraceSetTimelineEventHandler(TimelineEventHandler handler) {}
-
-bool TraceHasTimelineEventHandler() {
-  return false;
-}
-
-int64_t TraceGetTimelineMicros() {
-  return -1;
-}
-
-void TraceSetTimelineMicrosSource(TimelineMicrosSource source) {}
-
-size_t TraceNonce() {
-  return 0;
-}
-
-void TraceTimelineEvent(TraceArg category_group,
-                        TraceArg name,
-                        int64_t timestamp_micros,
-                        TraceIDArg identifier,
-                        Dart_Timeline_Event_Type type,
-                        const std::vector<const char*>& c_names,
-                        const std::vector<std::string>& values) {}
-
-void TraceTimelineEvent(TraceArg category_group,
-                        TraceArg name,
-                        TraceIDArg identifier,
-                        Dart_Timeline_Event_Type type,
-                        const std::vector<const char*>& c_names,
-                        const std::vector<std::string>& values) {}
-
-void TraceEvent0(TraceArg category_group, TraceArg name) {}
-
-void TraceEvent1(TraceArg category_group,
-                 TraceArg name,
-                 TraceArg arg1_name,
-                 TraceArg arg1_val) {}
-
-void TraceEvent2(TraceArg category_group,
-                 TraceArg name,
-                 TraceArg arg1_name,
-                 TraceArg arg1_val,
-                 TraceArg arg2_name,
-                 TraceArg arg2_val) {}
-
-void TraceEventEnd(TraceArg name) {}
-
-void TraceEventAsyncComplete(TraceArg category_group,
-                             TraceArg name,
-                             TimePoint begin,
-                             TimePoint end) {}
-
-void TraceEventAsyncBegin0(TraceArg category_group,
-                           TraceArg name,
-                           TraceIDArg id) {}
-
-void TraceEventAsyncEnd0(TraceArg category_group,
-                         TraceArg name,
-                         TraceIDArg id) {}
-
-void TraceEventAsyncBegin1(TraceArg category_group,
-                           TraceArg name,
-                           TraceIDArg id,
-                           TraceArg arg1_name,
-                           TraceArg arg1_val) {}
-
-void TraceEventAsyncEnd1(TraceArg category_group,
-                         TraceArg name,
-                         TraceIDArg id,
-                         TraceArg arg1_name,
-                         TraceArg arg1_val) {}
-
-void TraceEventInstant0(TraceArg category_group, TraceArg name) {}
-
-void TraceEventInstant1(TraceArg category_group,
-                        TraceArg name,
-                        TraceArg arg1_name,
-                        TraceArg arg1_val) {}
-
-void TraceEventInstant2(TraceArg category_group,
-                        TraceArg name,
-                        TraceArg arg1_name,
-                        TraceArg arg1_val,
-                        TraceArg arg2_name,
-                        TraceArg arg2_val) {}
-
-void TraceEventFlowBegin0(TraceArg category_group,
-                          TraceArg name,
-                          TraceIDArg id) {}
-
-void TraceEventFlowStep0(TraceArg category_group,
-                         TraceArg name,
-                         TraceIDArg id) {}
-
-void TraceEventFlowEnd0(TraceArg category_group, TraceArg name, TraceIDArg id) {
-}
-
-#endif  // FLUTTER_TIMELINE_ENABLED
-
 }  // namespace tracing
 }  // namespace fml
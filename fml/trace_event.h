@@ -45,6 +45,7 @@
 
 #include "flutter/fml/macros.h"
 #include "flutter/fml/time/time_point.h"
+#include "flutter/fml/trace_ring_buffer.h"
 #include "third_party/dart/runtime/include/dart_tools_api.h"
 
 #if (FLUTTER_RELEASE && !defined(OS_FUCHSIA) && !defined(FML_OS_ANDROID))
@@ -161,6 +162,10 @@ void TraceSetTimelineEventHandler(TimelineEventHandler handler);
 
 bool TraceHasTimelineEventHandler();
 
+/// Returns the ring buffer to record an event called |name| into, or null if
+/// it shouldn't be recorded.
+TraceRingBuffer* TraceRingBufferForEvent(TraceArg name);
+
 void TraceSetTimelineMicrosSource(TimelineMicrosSource source);
 
 int64_t TraceGetTimelineMicros();
@@ -232,10 +237,18 @@ void TraceCounter(TraceArg category,
                   TraceArg name,
                   TraceIDArg identifier,
                   Args... args) {
+  if (TraceRingBuffer* ring = TraceRingBufferForEvent(name)) {
+    TraceRingBufferWriter writer(*ring, category, name,
+                                 TraceGetTimelineMicros(), identifier,
+                                 Dart_Timeline_Event_Counter);
+    writer.AddArgs(args...);
+  }
 #if FLUTTER_TIMELINE_ENABLED
-  auto split = SplitArguments(args...);
-  TraceTimelineEvent(category, name, identifier, Dart_Timeline_Event_Counter,
-                     split.first, split.second);
+  if (TraceHasTimelineEventHandler()) {
+    auto split = SplitArguments(args...);
+    TraceTimelineEvent(category, name, identifier, Dart_Timeline_Event_Counter,
+                       split.first, split.second);
+  }
 #endif  // FLUTTER_TIMELINE_ENABLED
 }
 
@@ -249,10 +262,18 @@ void TraceCounterNopHACK(TraceArg category,
 
 template <typename... Args>
 void TraceEvent(TraceArg category, TraceArg name, Args... args) {
+  if (TraceRingBuffer* ring = TraceRingBufferForEvent(name)) {
+    TraceRingBufferWriter writer(*ring, category, name,
+                                 TraceGetTimelineMicros(), 0,
+                                 Dart_Timeline_Event_Begin);
+    writer.AddArgs(args...);
+  }
 #if FLUTTER_TIMELINE_ENABLED
-  auto split = SplitArguments(args...);
-  TraceTimelineEvent(category, name, 0, Dart_Timeline_Event_Begin, split.first,
-                     split.second);
+  if (TraceHasTimelineEventHandler()) {
+    auto split = SplitArguments(args...);
+    TraceTimelineEvent(category, name, 0, Dart_Timeline_Event_Begin,
+                       split.first, split.second);
+  }
 #endif  // FLUTTER_TIMELINE_ENABLED
 }
 
@@ -278,9 +299,12 @@ void TraceEventAsyncComplete(TraceArg category_group,
                              TimePoint begin,
                              TimePoint end,
                              Args... args) {
-#if FLUTTER_TIMELINE_ENABLED
+  TraceRingBuffer* ring = TraceRingBufferForEvent(name);
+  if (!ring && !TraceHasTimelineEventHandler()) {
+    return;
+  }
+
   auto identifier = TraceNonce();
-  const auto split = SplitArguments(args...);
 
   if (begin > end) {
     std::swap(begin, end);
@@ -289,6 +313,24 @@ void TraceEventAsyncComplete(TraceArg category_group,
   const int64_t begin_micros = begin.ToEpochDelta().ToMicroseconds();
   const int64_t end_micros = end.ToEpochDelta().ToMicroseconds();
 
+  if (ring) {
+    {
+      TraceRingBufferWriter writer(*ring, category_group, name, begin_micros,
+                                   identifier,
+                                   Dart_Timeline_Event_Async_Begin);
+      writer.AddArgs(args...);
+    }
+    TraceRingBufferWriter writer(*ring, category_group, name, end_micros,
+                                 identifier, Dart_Timeline_Event_Async_End);
+  }
+
+#if FLUTTER_TIMELINE_ENABLED
+  if (!TraceHasTimelineEventHandler()) {
+    return;
+  }
+
+  const auto split = SplitArguments(args...);
+
   TraceTimelineEvent(category_group,                   // group
                      name,                             // name
                      begin_micros,                     // timestamp_micros
@@ -0,0 +1,282 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/trace_ring_buffer.h"
+
+#include <cstdio>
+#include <mutex>
+#include <sstream>
+
+#include "flutter/fml/thread_local.h"
+
+namespace fml {
+namespace tracing {
+
+namespace internal {
+std::atomic_bool gTraceRingBufferEnabled = false;
+}  // namespace internal
+
+namespace {
+
+size_t RoundUpToPowerOfTwo(size_t value) {
+  size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+// The ring buffers of all threads that recorded events in the current session.
+struct TraceRingBufferRegistry {
+  std::mutex mutex;
+  size_t records_per_thread = 0;
+  // Incremented by every |TraceRingBufferEnable| so that threads drop the
+  // rings of previous sessions.
+  uint64_t session = 0;
+  std::vector<std::shared_ptr<TraceRingBuffer>> rings;
+  int64_t next_thread_id = 1;
+};
+
+TraceRingBufferRegistry& GetRegistry() {
+  static TraceRingBufferRegistry* registry = new TraceRingBufferRegistry();
+  return *registry;
+}
+
+// The current session, read without the registry lock on every event.
+std::atomic<uint64_t> gTraceRingBufferSession = 0;
+
+struct ThreadRing {
+  std::shared_ptr<TraceRingBuffer> ring;
+  uint64_t session = 0;
+};
+
+FML_THREAD_LOCAL ThreadLocalUniquePtr<ThreadRing> tls_thread_ring;
+
+const char* PhaseForType(Dart_Timeline_Event_Type type) {
+  switch (type) {
+    case Dart_Timeline_Event_Begin:
+      return "B";
+    case Dart_Timeline_Event_End:
+      return "E";
+    case Dart_Timeline_Event_Instant:
+      return "i";
+    case Dart_Timeline_Event_Duration:
+      return "X";
+    case Dart_Timeline_Event_Async_Begin:
+      return "b";
+    case Dart_Timeline_Event_Async_End:
+      return "e";
+    case Dart_Timeline_Event_Async_Instant:
+      return "n";
+    case Dart_Timeline_Event_Counter:
+      return "C";
+    case Dart_Timeline_Event_Flow_Begin:
+      return "s";
+    case Dart_Timeline_Event_Flow_Step:
+      return "t";
+    case Dart_Timeline_Event_Flow_End:
+      return "f";
+    default:
+      return "i";
+  }
+}
+
+void WriteJSONString(std::ostream& out, const char* string) {
+  out << '"';
+  for (const char* c = string; *c; c++) {
+    switch (*c) {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      case '\n':
+        out << "\\n";
+        break;
+      case '\r':
+        out << "\\r";
+        break;
+      case '\t':
+        out << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(*c) < 0x20) {
+          char escaped[7];
+          std::snprintf(escaped, sizeof(escaped), "\\u%04x", *c);
+          out << escaped;
+        } else {
+          out << *c;
+        }
+        break;
+    }
+  }
+  out << '"';
+}
+
+void WriteJSONArgs(std::ostream& out,
+                   const TraceRecord& record,
+                   bool* first_arg) {
+  for (size_t i = 0; i < record.arg_count; i++) {
+    if (!*first_arg) {
+      out << ',';
+    }
+    *first_arg = false;
+    WriteJSONString(out, record.arg_names[i] ? record.arg_names[i] : "");
+    out << ':';
+    switch (record.arg_types[i]) {
+      case TraceRecord::ArgType::kInt:
+        out << record.arg_values[i].int_value;
+        break;
+      case TraceRecord::ArgType::kDouble:
+        out << record.arg_values[i].double_value;
+        break;
+      case TraceRecord::ArgType::kString:
+        WriteJSONString(out, record.arg_values[i].string_value);
+        break;
+    }
+  }
+}
+
+}  // namespace
+
+TraceRingBuffer::TraceRingBuffer(size_t capacity, int64_t thread_id)
+    : thread_id_(thread_id),
+      mask_(RoundUpToPowerOfTwo(std::max<size_t>(capacity, 1)) - 1),
+      slots_(new Slot[mask_ + 1]) {}
+
+TraceRingBuffer::~TraceRingBuffer() = default;
+
+TraceRecord& TraceRingBuffer::BeginWrite() {
+  const uint64_t index = write_count_.load(std::memory_order_relaxed);
+  Slot& slot = slots_[index & mask_];
+  slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+  // Keep the record writes below from being reordered before the odd
+  // sequence number is visible.
+  std::atomic_thread_fence(std::memory_order_release);
+  return slot.record;
+}
+
+void TraceRingBuffer::EndWrite() {
+  const uint64_t index = write_count_.load(std::memory_order_relaxed);
+  slots_[index & mask_].sequence.store(2 * index + 2,
+                                       std::memory_order_release);
+  write_count_.store(index + 1, std::memory_order_release);
+}
+
+std::vector<TraceRecord> TraceRingBuffer::Snapshot() const {
+  const uint64_t end = write_count_.load(std::memory_order_acquire);
+  const uint64_t begin = end > capacity() ? end - capacity() : 0;
+  std::vector<TraceRecord> records;
+  records.reserve(end - begin);
+  for (uint64_t index = begin; index < end; index++) {
+    const Slot& slot = slots_[index & mask_];
+    const uint64_t expected = 2 * index + 2;
+    if (slot.sequence.load(std::memory_order_acquire) != expected) {
+      continue;
+    }
+    TraceRecord record;
+    std::memcpy(&record, &slot.record, sizeof(TraceRecord));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != expected) {
+      // Overwritten while it was being copied.
+      continue;
+    }
+    records.push_back(record);
+  }
+  return records;
+}
+
+void TraceRingBufferEnable(size_t records_per_thread) {
+  auto& registry = GetRegistry();
+  std::scoped_lock lock(registry.mutex);
+  registry.records_per_thread = records_per_thread;
+  registry.rings.clear();
+  registry.next_thread_id = 1;
+  gTraceRingBufferSession.store(++registry.session, std::memory_order_relaxed);
+  internal::gTraceRingBufferEnabled.store(true, std::memory_order_relaxed);
+}
+
+void TraceRingBufferDisable() {
+  internal::gTraceRingBufferEnabled.store(false, std::memory_order_relaxed);
+}
+
+TraceRingBuffer* TraceRingBufferForCurrentThread() {
+  if (!TraceRingBufferIsEnabled()) {
+    return nullptr;
+  }
+  if (!tls_thread_ring.get()) {
+    tls_thread_ring.reset(new ThreadRing());
+  }
+  ThreadRing& thread_ring = *tls_thread_ring.get();
+  if (thread_ring.ring &&
+      thread_ring.session ==
+          gTraceRingBufferSession.load(std::memory_order_relaxed)) {
+    return thread_ring.ring.get();
+  }
+  auto& registry = GetRegistry();
+  std::scoped_lock lock(registry.mutex);
+  if (!TraceRingBufferIsEnabled()) {
+    return nullptr;
+  }
+  thread_ring.ring = std::make_shared<TraceRingBuffer>(
+      registry.records_per_thread, registry.next_thread_id++);
+  thread_ring.session = registry.session;
+  registry.rings.push_back(thread_ring.ring);
+  return thread_ring.ring.get();
+}
+
+std::string TraceRingBufferExportJSON() {
+  std::vector<std::shared_ptr<TraceRingBuffer>> rings;
+  {
+    auto& registry = GetRegistry();
+    std::scoped_lock lock(registry.mutex);
+    rings = registry.rings;
+  }
+
+  std::ostringstream out;
+  out << "{\"traceEvents\":[";
+  bool first_event = true;
+  for (const auto& ring : rings) {
+    const std::vector<TraceRecord> records = ring->Snapshot();
+    for (size_t i = 0; i < records.size(); i++) {
+      const TraceRecord& record = records[i];
+      if (record.continuation) {
+        // The beginning of the event was overwritten.
+        continue;
+      }
+      if (!first_event) {
+        out << ',';
+      }
+      first_event = false;
+      out << "{\"name\":";
+      WriteJSONString(out, record.name ? record.name : "");
+      if (record.category) {
+        out << ",\"cat\":";
+        WriteJSONString(out, record.category);
+      }
+      out << ",\"ph\":\"" << PhaseForType(record.type) << '"';
+      if (record.type == Dart_Timeline_Event_Instant) {
+        out << ",\"s\":\"t\"";
+      }
+      out << ",\"ts\":" << record.timestamp_micros;
+      if (record.id != 0) {
+        out << ",\"id\":\"0x" << std::hex << record.id << std::dec << '"';
+      }
+      out << ",\"pid\":0,\"tid\":" << ring->thread_id();
+      out << ",\"args\":{";
+      bool first_arg = true;
+      WriteJSONArgs(out, record, &first_arg);
+      while (i + 1 < records.size() && records[i + 1].continuation) {
+        WriteJSONArgs(out, records[++i], &first_arg);
+      }
+      out << "}}";
+    }
+  }
+  out << "]}";
+  return out.str();
+}
+
+}  // namespace tracing
+}  // namespace fml
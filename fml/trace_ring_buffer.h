@@ -0,0 +1,250 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_TRACE_RING_BUFFER_H_
+#define FLUTTER_FML_TRACE_RING_BUFFER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_point.h"
+#include "third_party/dart/runtime/include/dart_tools_api.h"
+
+namespace fml {
+namespace tracing {
+
+//------------------------------------------------------------------------------
+/// @brief      A fixed-size binary record of one trace event.
+///
+///             The category, name and argument names are not copied, so like
+///             the name of a |TRACE_EVENT0|, they must be string literals.
+///             Argument values keep their type; string values are copied and
+///             truncated to |kMaxStringValueLength| characters. Events with
+///             more than |kMaxArgs| arguments continue in the records that
+///             follow them.
+///
+struct TraceRecord {
+  static constexpr size_t kMaxArgs = 2;
+  static constexpr size_t kMaxStringValueLength = 15;
+
+  enum class ArgType : uint8_t {
+    kInt,
+    kDouble,
+    kString,
+  };
+
+  union ArgValue {
+    int64_t int_value;
+    double double_value;
+    char string_value[kMaxStringValueLength + 1];
+  };
+
+  int64_t timestamp_micros;
+  int64_t id;
+  const char* category;
+  const char* name;
+  const char* arg_names[kMaxArgs];
+  ArgValue arg_values[kMaxArgs];
+  Dart_Timeline_Event_Type type;
+  uint8_t arg_count;
+  ArgType arg_types[kMaxArgs];
+  // Whether this record holds more arguments of the event before it.
+  bool continuation;
+
+  void Init(const char* category_arg,
+            const char* name_arg,
+            int64_t timestamp_micros_arg,
+            int64_t id_arg,
+            Dart_Timeline_Event_Type type_arg,
+            bool continuation_arg = false) {
+    timestamp_micros = timestamp_micros_arg;
+    id = id_arg;
+    category = category_arg;
+    name = name_arg;
+    type = type_arg;
+    arg_count = 0;
+    continuation = continuation_arg;
+  }
+
+  bool IsFull() const { return arg_count == kMaxArgs; }
+
+  void AddArg(const char* arg_name, const char* value) {
+    if (auto* arg = NextArg(arg_name, ArgType::kString)) {
+      CopyString(arg, value ? value : "", value ? std::strlen(value) : 0);
+    }
+  }
+
+  void AddArg(const char* arg_name, const std::string& value) {
+    if (auto* arg = NextArg(arg_name, ArgType::kString)) {
+      CopyString(arg, value.data(), value.size());
+    }
+  }
+
+  void AddArg(const char* arg_name, TimePoint value) {
+    if (auto* arg = NextArg(arg_name, ArgType::kInt)) {
+      arg->int_value = value.ToEpochDelta().ToNanoseconds();
+    }
+  }
+
+  template <typename T,
+            typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+  void AddArg(const char* arg_name, T value) {
+    if constexpr (std::is_floating_point<T>::value) {
+      if (auto* arg = NextArg(arg_name, ArgType::kDouble)) {
+        arg->double_value = value;
+      }
+    } else {
+      if (auto* arg = NextArg(arg_name, ArgType::kInt)) {
+        arg->int_value = static_cast<int64_t>(value);
+      }
+    }
+  }
+
+ private:
+  ArgValue* NextArg(const char* arg_name, ArgType arg_type) {
+    if (arg_count == kMaxArgs) {
+      return nullptr;
+    }
+    arg_names[arg_count] = arg_name;
+    arg_types[arg_count] = arg_type;
+    return &arg_values[arg_count++];
+  }
+
+  static void CopyString(ArgValue* arg, const char* value, size_t length) {
+    length = std::min(length, kMaxStringValueLength);
+    std::memcpy(arg->string_value, value, length);
+    arg->string_value[length] = '\0';
+  }
+};
+
+//------------------------------------------------------------------------------
+/// @brief      A ring of trace records written by one thread and read by any.
+///
+///             Writing a record never blocks or allocates; when the ring is
+///             full the oldest record is overwritten. Each slot carries a
+///             sequence number so that readers can skip records that were
+///             overwritten while they were being copied.
+///
+class TraceRingBuffer {
+ public:
+  /// |capacity| is rounded up to a power of two.
+  TraceRingBuffer(size_t capacity, int64_t thread_id);
+
+  ~TraceRingBuffer();
+
+  int64_t thread_id() const { return thread_id_; }
+
+  size_t capacity() const { return mask_ + 1; }
+
+  /// Returns the record to write, which must be followed by |EndWrite|.
+  /// May only be called on the thread that owns the ring.
+  TraceRecord& BeginWrite();
+
+  void EndWrite();
+
+  /// Returns a copy of the records currently in the ring, oldest first.
+  std::vector<TraceRecord> Snapshot() const;
+
+ private:
+  struct Slot {
+    // Odd while the record is being written.
+    std::atomic<uint64_t> sequence{0};
+    TraceRecord record;
+  };
+
+  const int64_t thread_id_;
+  const size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+  // The number of records ever written. Only the owning thread writes it.
+  std::atomic<uint64_t> write_count_{0};
+
+  FML_DISALLOW_COPY_AND_ASSIGN(TraceRingBuffer);
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Writes one event to a |TraceRingBuffer|. The event is published
+///             when the writer is destroyed.
+///
+class TraceRingBufferWriter {
+ public:
+  /// A negative |timestamp_micros|, which is what the timeline clock returns
+  /// before there is a Dart VM, records the event at |TimePoint::Now|.
+  TraceRingBufferWriter(TraceRingBuffer& ring,
+                        const char* category,
+                        const char* name,
+                        int64_t timestamp_micros,
+                        int64_t id,
+                        Dart_Timeline_Event_Type type)
+      : ring_(ring), record_(&ring.BeginWrite()) {
+    if (timestamp_micros < 0) {
+      timestamp_micros = TimePoint::Now().ToEpochDelta().ToMicroseconds();
+    }
+    record_->Init(category, name, timestamp_micros, id, type);
+  }
+
+  ~TraceRingBufferWriter() { ring_.EndWrite(); }
+
+  template <typename T>
+  void AddArg(const char* arg_name, const T& value) {
+    if (record_->IsFull()) {
+      // Copy the header first, a ring of one record reuses the same slot.
+      const TraceRecord event = *record_;
+      ring_.EndWrite();
+      record_ = &ring_.BeginWrite();
+      record_->Init(event.category, event.name, event.timestamp_micros,
+                    event.id, event.type, true);
+    }
+    record_->AddArg(arg_name, value);
+  }
+
+  void AddArgs() {}
+
+  template <typename Key, typename Value, typename... Rest>
+  void AddArgs(Key key, const Value& value, const Rest&... rest) {
+    AddArg(key, value);
+    AddArgs(rest...);
+  }
+
+ private:
+  TraceRingBuffer& ring_;
+  TraceRecord* record_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(TraceRingBufferWriter);
+};
+
+namespace internal {
+extern std::atomic_bool gTraceRingBufferEnabled;
+}  // namespace internal
+
+/// Starts recording trace events into a ring buffer of |records_per_thread|
+/// records for each thread that emits events. Events recorded by a previous
+/// session are discarded.
+void TraceRingBufferEnable(size_t records_per_thread);
+
+/// Stops recording trace events. The recorded events can still be exported.
+void TraceRingBufferDisable();
+
+inline bool TraceRingBufferIsEnabled() {
+  return internal::gTraceRingBufferEnabled.load(std::memory_order_relaxed);
+}
+
+/// Returns the ring buffer of the current thread, creating it if needed, or
+/// null if recording is not enabled.
+TraceRingBuffer* TraceRingBufferForCurrentThread();
+
+/// Serializes the recorded events of all threads to the Chrome JSON trace
+/// event format, which can be loaded in Perfetto and chrome://tracing.
+std::string TraceRingBufferExportJSON();
+
+}  // namespace tracing
+}  // namespace fml
+
+#endif  // FLUTTER_FML_TRACE_RING_BUFFER_H_
@@ -0,0 +1,158 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/trace_ring_buffer.h"
+
+#include <string>
+#include <thread>
+
+#include "flutter/fml/trace_event.h"
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace tracing {
+namespace testing {
+
+TEST(TraceRingBufferTest, RoundsCapacityUpToPowerOfTwo) {
+  TraceRingBuffer ring(5, 1);
+  ASSERT_EQ(ring.capacity(), 8u);
+}
+
+TEST(TraceRingBufferTest, SnapshotReturnsRecordsInOrder) {
+  TraceRingBuffer ring(4, 1);
+  for (int64_t i = 0; i < 3; i++) {
+    TraceRingBufferWriter writer(ring, "flutter", "event", i, 0,
+                                 Dart_Timeline_Event_Begin);
+  }
+  auto records = ring.Snapshot();
+  ASSERT_EQ(records.size(), 3u);
+  for (int64_t i = 0; i < 3; i++) {
+    ASSERT_EQ(records[i].timestamp_micros, i);
+    ASSERT_STREQ(records[i].name, "event");
+  }
+}
+
+TEST(TraceRingBufferTest, OverwritesOldestRecords) {
+  TraceRingBuffer ring(4, 1);
+  for (int64_t i = 0; i < 10; i++) {
+    TraceRingBufferWriter writer(ring, "flutter", "event", i, 0,
+                                 Dart_Timeline_Event_Instant);
+  }
+  auto records = ring.Snapshot();
+  ASSERT_EQ(records.size(), 4u);
+  ASSERT_EQ(records.front().timestamp_micros, 6);
+  ASSERT_EQ(records.back().timestamp_micros, 9);
+}
+
+TEST(TraceRingBufferTest, KeepsArgumentTypes) {
+  TraceRingBuffer ring(4, 1);
+  {
+    TraceRingBufferWriter writer(ring, "flutter", "event", 1, 0,
+                                 Dart_Timeline_Event_Begin);
+    writer.AddArgs("count", 42, "ratio", 0.5);
+  }
+  auto records = ring.Snapshot();
+  ASSERT_EQ(records.size(), 1u);
+  ASSERT_EQ(records[0].arg_count, 2u);
+  ASSERT_EQ(records[0].arg_types[0], TraceRecord::ArgType::kInt);
+  ASSERT_EQ(records[0].arg_values[0].int_value, 42);
+  ASSERT_EQ(records[0].arg_types[1], TraceRecord::ArgType::kDouble);
+  ASSERT_EQ(records[0].arg_values[1].double_value, 0.5);
+}
+
+TEST(TraceRingBufferTest, TruncatesStringArguments) {
+  TraceRingBuffer ring(4, 1);
+  {
+    TraceRingBufferWriter writer(ring, "flutter", "event", 1, 0,
+                                 Dart_Timeline_Event_Begin);
+    writer.AddArg("value", std::string("abcdefghijklmnopqrstuvwxyz"));
+  }
+  auto records = ring.Snapshot();
+  ASSERT_EQ(records.size(), 1u);
+  ASSERT_EQ(records[0].arg_types[0], TraceRecord::ArgType::kString);
+  ASSERT_STREQ(records[0].arg_values[0].string_value, "abcdefghijklmno");
+}
+
+TEST(TraceRingBufferTest, ContinuesEventsWithManyArguments) {
+  TraceRingBuffer ring(4, 1);
+  {
+    TraceRingBufferWriter writer(ring, "flutter", "event", 7, 3,
+                                 Dart_Timeline_Event_Counter);
+    writer.AddArgs("a", 1, "b", 2, "c", 3);
+  }
+  auto records = ring.Snapshot();
+  ASSERT_EQ(records.size(), 2u);
+  ASSERT_FALSE(records[0].continuation);
+  ASSERT_EQ(records[0].arg_count, 2u);
+  ASSERT_TRUE(records[1].continuation);
+  ASSERT_EQ(records[1].arg_count, 1u);
+  ASSERT_STREQ(records[1].arg_names[0], "c");
+  ASSERT_EQ(records[1].timestamp_micros, 7);
+  ASSERT_EQ(records[1].id, 3);
+}
+
+TEST(TraceRingBufferTest, UsesCurrentTimeWithoutTimelineClock) {
+  TraceRingBuffer ring(1, 1);
+  {
+    TraceRingBufferWriter writer(ring, nullptr, "event", -1, 0,
+                                 Dart_Timeline_Event_End);
+  }
+  ASSERT_GE(ring.Snapshot()[0].timestamp_micros, 0);
+}
+
+TEST(TraceRingBufferTest, RecordsTraceEvents) {
+  TraceRingBufferEnable(16);
+  TraceEvent0("flutter", "RecordsTraceEvents");
+  TraceEventEnd("RecordsTraceEvents");
+  TraceEvent("flutter", "Templated", "frame", 12);
+  TraceEventInstant1("flutter", "Instant", "key", "value");
+  TraceRingBufferDisable();
+  TraceEvent0("flutter", "NotRecorded");
+
+  ASSERT_EQ(TraceRingBufferForEvent("RecordsTraceEvents"), nullptr);
+
+  const std::string json = TraceRingBufferExportJSON();
+  ASSERT_NE(json.find("{\"name\":\"RecordsTraceEvents\",\"cat\":\"flutter\","
+                      "\"ph\":\"B\""),
+            std::string::npos);
+  ASSERT_NE(json.find("{\"name\":\"RecordsTraceEvents\",\"ph\":\"E\""),
+            std::string::npos);
+  ASSERT_NE(json.find("\"args\":{\"frame\":12}"), std::string::npos);
+  ASSERT_NE(json.find("\"ph\":\"i\",\"s\":\"t\""), std::string::npos);
+  ASSERT_NE(json.find("\"args\":{\"key\":\"value\"}"), std::string::npos);
+  ASSERT_EQ(json.find("NotRecorded"), std::string::npos);
+}
+
+TEST(TraceRingBufferTest, ExportsEachThread) {
+  TraceRingBufferEnable(16);
+  TraceEvent0("flutter", "MainThread");
+  std::thread thread([]() {
+    TraceEvent1("flutter", "OtherThread", "quote", "\"");
+    TraceEventEnd("OtherThread");
+  });
+  thread.join();
+  TraceEventEnd("MainThread");
+  TraceRingBufferDisable();
+
+  const std::string json = TraceRingBufferExportJSON();
+  ASSERT_NE(json.find("\"tid\":1"), std::string::npos);
+  ASSERT_NE(json.find("\"tid\":2"), std::string::npos);
+  ASSERT_NE(json.find("\"args\":{\"quote\":\"\\\"\"}"), std::string::npos);
+}
+
+TEST(TraceRingBufferTest, MergesContinuationsWhenExporting) {
+  TraceRingBufferEnable(16);
+  TraceCounter("flutter", "Counter", 5, "a", 1, "b", 2, "c", 3);
+  TraceRingBufferDisable();
+
+  const std::string json = TraceRingBufferExportJSON();
+  ASSERT_NE(json.find("\"ph\":\"C\""), std::string::npos);
+  ASSERT_NE(json.find("\"id\":\"0x5\""), std::string::npos);
+  ASSERT_NE(json.find("\"args\":{\"a\":1,\"b\":2,\"c\":3}"),
+            std::string::npos);
+}
+
+}  // namespace testing
+}  // namespace tracing
+}  // namespace fml
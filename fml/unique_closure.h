@@ -0,0 +1,158 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_UNIQUE_CLOSURE_H_
+#define FLUTTER_FML_UNIQUE_CLOSURE_H_
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "flutter/fml/closure.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/macros.h"
+
+namespace fml {
+
+//------------------------------------------------------------------------------
+/// @brief      A move-only wrapper for a callable that takes no arguments and
+///             returns nothing.
+///
+///             This is what task queues store their tasks as. Unlike an
+///             |fml::closure|, it never copies the callable, and callables of
+///             up to |kInlineStorageSize| bytes that can be moved without
+///             throwing are stored inline instead of on the heap. This covers
+///             the typical task lambda that captures a few pointers, a
+///             |std::shared_ptr| or an |fml::closure|.
+///
+class UniqueClosure {
+ public:
+  static constexpr size_t kInlineStorageSize = 56;
+
+  UniqueClosure() = default;
+
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  UniqueClosure(std::nullptr_t) {}
+
+  template <typename Callable,
+            typename Decayed = std::decay_t<Callable>,
+            typename = std::enable_if_t<
+                !std::is_same_v<Decayed, UniqueClosure> &&
+                std::is_invocable_r_v<void, Decayed&>>>
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  UniqueClosure(Callable&& callable) {
+    if constexpr (std::is_pointer_v<Decayed> ||
+                  std::is_same_v<Decayed, fml::closure>) {
+      if (!callable) {
+        return;
+      }
+    }
+    if constexpr (IsStoredInline<Decayed>()) {
+      new (storage_) Decayed(std::forward<Callable>(callable));
+    } else {
+      *reinterpret_cast<Decayed**>(storage_) =
+          new Decayed(std::forward<Callable>(callable));
+    }
+    ops_ = &kOps<Decayed>;
+  }
+
+  UniqueClosure(UniqueClosure&& other) noexcept { MoveFrom(other); }
+
+  UniqueClosure& operator=(UniqueClosure&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  UniqueClosure& operator=(std::nullptr_t) {
+    Reset();
+    return *this;
+  }
+
+  ~UniqueClosure() { Reset(); }
+
+  explicit operator bool() const { return ops_ != nullptr; }
+
+  void operator()() const {
+    FML_DCHECK(ops_);
+    ops_->invoke(storage_);
+  }
+
+ private:
+  struct Ops {
+    void (*invoke)(void* storage);
+    // Move-constructs the callable into |to| and destroys it in |from|.
+    void (*relocate)(void* from, void* to);
+    void (*destroy)(void* storage);
+  };
+
+  template <typename Callable>
+  static constexpr bool IsStoredInline() {
+    return sizeof(Callable) <= kInlineStorageSize &&
+           alignof(std::max_align_t) % alignof(Callable) == 0 &&
+           std::is_nothrow_move_constructible_v<Callable>;
+  }
+
+  template <typename Callable>
+  static Callable& Get(void* storage) {
+    if constexpr (IsStoredInline<Callable>()) {
+      return *std::launder(reinterpret_cast<Callable*>(storage));
+    } else {
+      return **reinterpret_cast<Callable**>(storage);
+    }
+  }
+
+  template <typename Callable>
+  static constexpr Ops kOps = {
+      .invoke = [](void* storage) { Get<Callable>(storage)(); },
+      .relocate =
+          [](void* from, void* to) {
+            if constexpr (IsStoredInline<Callable>()) {
+              new (to) Callable(std::move(Get<Callable>(from)));
+              Get<Callable>(from).~Callable();
+            } else {
+              *reinterpret_cast<Callable**>(to) =
+                  *reinterpret_cast<Callable**>(from);
+            }
+          },
+      .destroy =
+          [](void* storage) {
+            if constexpr (IsStoredInline<Callable>()) {
+              Get<Callable>(storage).~Callable();
+            } else {
+              delete *reinterpret_cast<Callable**>(storage);
+            }
+          },
+  };
+
+  void MoveFrom(UniqueClosure& other) {
+    if (other.ops_) {
+      other.ops_->relocate(other.storage_, storage_);
+      ops_ = other.ops_;
+      other.ops_ = nullptr;
+    }
+  }
+
+  void Reset() {
+    if (ops_) {
+      // Clear |ops_| first so that this reads as empty while the callable is
+      // being destroyed.
+      const Ops* ops = ops_;
+      ops_ = nullptr;
+      ops->destroy(storage_);
+    }
+  }
+
+  alignas(std::max_align_t) mutable unsigned char storage_[kInlineStorageSize];
+  const Ops* ops_ = nullptr;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(UniqueClosure);
+};
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_UNIQUE_CLOSURE_H_
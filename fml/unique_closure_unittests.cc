@@ -0,0 +1,76 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/unique_closure.h"
+
+#include <array>
+#include <memory>
+
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace testing {
+
+TEST(UniqueClosureTest, DefaultIsEmpty) {
+  UniqueClosure closure;
+  ASSERT_FALSE(closure);
+  UniqueClosure null_closure = nullptr;
+  ASSERT_FALSE(null_closure);
+  UniqueClosure empty_function = fml::closure();
+  ASSERT_FALSE(empty_function);
+}
+
+TEST(UniqueClosureTest, InvokesCallable) {
+  int count = 0;
+  UniqueClosure closure = [&count]() { count++; };
+  ASSERT_TRUE(closure);
+  closure();
+  closure();
+  ASSERT_EQ(count, 2);
+}
+
+TEST(UniqueClosureTest, AcceptsMoveOnlyCallables) {
+  auto value = std::make_unique<int>(42);
+  int result = 0;
+  UniqueClosure closure = [value = std::move(value), &result]() {
+    result = *value;
+  };
+  UniqueClosure moved = std::move(closure);
+  ASSERT_FALSE(closure);  // NOLINT(bugprone-use-after-move)
+  moved();
+  ASSERT_EQ(result, 42);
+}
+
+TEST(UniqueClosureTest, DestroysInlineAndHeapCallables) {
+  auto inline_capture = std::make_shared<int>(0);
+  auto heap_capture = std::make_shared<int>(0);
+  {
+    UniqueClosure inline_closure = [inline_capture]() {};
+    std::array<char, UniqueClosure::kInlineStorageSize> padding = {};
+    UniqueClosure heap_closure = [heap_capture, padding]() {};
+    ASSERT_EQ(inline_capture.use_count(), 2);
+    ASSERT_EQ(heap_capture.use_count(), 2);
+
+    UniqueClosure moved_inline = std::move(inline_closure);
+    UniqueClosure moved_heap = std::move(heap_closure);
+    ASSERT_EQ(inline_capture.use_count(), 2);
+    ASSERT_EQ(heap_capture.use_count(), 2);
+
+    moved_inline = nullptr;
+    ASSERT_EQ(inline_capture.use_count(), 1);
+  }
+  ASSERT_EQ(heap_capture.use_count(), 1);
+}
+
+TEST(UniqueClosureTest, MoveAssignmentDestroysPreviousCallable) {
+  auto first = std::make_shared<int>(0);
+  auto second = std::make_shared<int>(0);
+  UniqueClosure closure = [first]() {};
+  closure = UniqueClosure([second]() {});
+  ASSERT_EQ(first.use_count(), 1);
+  ASSERT_EQ(second.use_count(), 2);
+}
+
+}  // namespace testing
+}  // namespace fml
@@ -48,4 +48,11 @@ bool AiksContext::Render(const Picture& picture, RenderTarget& render_target) {
   return true;
 }
 
+void AiksContext::NotifyLowMemoryWarning() {
+  if (!IsValid()) {
+    return;
+  }
+  content_context_->NotifyLowMemoryWarning();
+}
+
 }  // namespace impeller
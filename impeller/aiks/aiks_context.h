@@ -30,6 +30,10 @@ class AiksContext {
 
   bool Render(const Picture& picture, RenderTarget& render_target);
 
+  /// Frees the resources that the next frames can do without, when memory is
+  /// low.
+  void NotifyLowMemoryWarning();
+
  private:
   std::shared_ptr<Context> context_;
   std::unique_ptr<ContentContext> content_context_;
@@ -955,7 +955,14 @@ static Path ToPath(const SkPath& path) {
       fill_type = FillType::kNonZero;
       break;
   }
-  return builder.TakePath(fill_type);
+  auto result = builder.TakePath(fill_type);
+  // The generation ID changes whenever the path does. Paths that changed
+  // recently are volatile and likely to change again, so they aren't worth
+  // caching.
+  if (!path.isVolatile()) {
+    result.SetCacheKey(path.getGenerationID());
+  }
+  return result;
 }
 
 static Path ToPath(const SkRRect& rrect) {
@@ -7,6 +7,7 @@
 #include <sstream>
 
 #include "impeller/entity/entity.h"
+#include "impeller/entity/tessellation_cache.h"
 #include "impeller/renderer/command_buffer.h"
 #include "impeller/renderer/formats.h"
 #include "impeller/renderer/render_pass.h"
@@ -146,6 +147,7 @@ static std::unique_ptr<PipelineT> CreateDefaultPipeline(
 ContentContext::ContentContext(std::shared_ptr<Context> context)
     : context_(std::move(context)),
       tessellator_(std::make_shared<Tessellator>()),
+      tessellation_cache_(std::make_shared<TessellationCache>(tessellator_)),
       glyph_atlas_context_(std::make_shared<GlyphAtlasContext>()) {
   if (!context_ || !context_->IsValid()) {
     return;
@@ -302,6 +304,15 @@ std::shared_ptr<Tessellator> ContentContext::GetTessellator() const {
   return tessellator_;
 }
 
+std::shared_ptr<TessellationCache> ContentContext::GetTessellationCache()
+    const {
+  return tessellation_cache_;
+}
+
+void ContentContext::NotifyLowMemoryWarning() {
+  tessellation_cache_->Clear();
+}
+
 std::shared_ptr<GlyphAtlasContext> ContentContext::GetGlyphAtlasContext()
     const {
   return glyph_atlas_context_;
@@ -207,6 +207,7 @@ struct ContentContextOptions {
 };
 
 class Tessellator;
+class TessellationCache;
 
 class ContentContext {
  public:
@@ -218,6 +219,12 @@ class ContentContext {
 
   std::shared_ptr<Tessellator> GetTessellator() const;
 
+  std::shared_ptr<TessellationCache> GetTessellationCache() const;
+
+  /// Drops the caches that are rebuilt as frames are rendered, such as the
+  /// tessellation cache, to free memory when it is low.
+  void NotifyLowMemoryWarning();
+
   std::shared_ptr<Pipeline<PipelineDescriptor>> GetLinearGradientFillPipeline(
       ContentContextOptions opts) const {
     return GetPipeline(linear_gradient_fill_pipelines_, opts);
@@ -521,6 +528,7 @@ class ContentContext {
 
   bool is_valid_ = false;
   std::shared_ptr<Tessellator> tessellator_;
+  std::shared_ptr<TessellationCache> tessellation_cache_;
   std::shared_ptr<GlyphAtlasContext> glyph_atlas_context_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ContentContext);
@@ -32,6 +32,7 @@
 #include "impeller/entity/entity_pass_delegate.h"
 #include "impeller/entity/entity_playground.h"
 #include "impeller/entity/geometry.h"
+#include "impeller/entity/tessellation_cache.h"
 #include "impeller/geometry/color.h"
 #include "impeller/geometry/geometry_unittests.h"
 #include "impeller/geometry/path_builder.h"
@@ -2177,5 +2178,120 @@ TEST_P(EntityTest, RuntimeEffect) {
   ASSERT_TRUE(OpenPlaygroundHere(callback));
 }
 
+TEST_P(EntityTest, TessellationCacheReusesTessellationsOfPathsWithACacheKey) {
+  TessellationCache cache(std::make_shared<Tessellator>());
+  auto& allocator = *GetContext()->GetResourceAllocator();
+  auto host_buffer = HostBuffer::Create();
+  auto path = PathBuilder{}
+                  .MoveTo({0, 0})
+                  .LineTo({100, 0})
+                  .LineTo({50, 50})
+                  .LineTo({100, 100})
+                  .LineTo({0, 100})
+                  .Close()
+                  .TakePath();
+  path.SetCacheKey(1);
+
+  // The first time, the tessellation is copied to the host buffer.
+  auto first = cache.GetVertexBuffer(path, kDefaultCurveTolerance, allocator,
+                                     *host_buffer);
+  ASSERT_TRUE(first.has_value());
+  ASSERT_TRUE(first.value());
+  ASSERT_GT(first->index_count, 0u);
+  ASSERT_EQ(first->vertex_buffer.buffer, host_buffer);
+  const size_t host_buffer_length = host_buffer->GetLength();
+
+  // From the second time on, it is in a device buffer of its own.
+  auto second = cache.GetVertexBuffer(path, kDefaultCurveTolerance, allocator,
+                                      *host_buffer);
+  ASSERT_TRUE(second.has_value());
+  ASSERT_NE(second->vertex_buffer.buffer, host_buffer);
+  ASSERT_EQ(second->index_count, first->index_count);
+  auto third = cache.GetVertexBuffer(path, kDefaultCurveTolerance, allocator,
+                                     *host_buffer);
+  ASSERT_TRUE(third.has_value());
+  ASSERT_EQ(second->vertex_buffer.buffer, third->vertex_buffer.buffer);
+  ASSERT_EQ(second->index_buffer.range, third->index_buffer.range);
+  ASSERT_EQ(host_buffer->GetLength(), host_buffer_length);
+  ASSERT_EQ(cache.GetEntryCount(), 1u);
+
+  // Tolerances in the same bucket share the tessellation.
+  ASSERT_TRUE(cache
+                  .GetVertexBuffer(path, kDefaultCurveTolerance * 1.5,
+                                   allocator, *host_buffer)
+                  .has_value());
+  ASSERT_EQ(cache.GetEntryCount(), 1u);
+  ASSERT_TRUE(cache
+                  .GetVertexBuffer(path, kDefaultCurveTolerance * 4, allocator,
+                                   *host_buffer)
+                  .has_value());
+  ASSERT_EQ(cache.GetEntryCount(), 2u);
+
+  path.SetFillType(FillType::kOdd);
+  size_t index_count = 0;
+  ASSERT_EQ(cache.Tessellate(path, kDefaultCurveTolerance,
+                             [&index_count](const float* vertices,
+                                            size_t vertices_count,
+                                            const uint16_t* indices,
+                                            size_t indices_count) {
+                               index_count = indices_count;
+                               return true;
+                             }),
+            Tessellator::Result::kSuccess);
+  ASSERT_EQ(index_count, first->index_count);
+  ASSERT_EQ(cache.GetEntryCount(), 3u);
+
+  // Paths without a cache key are tessellated every time.
+  path.SetCacheKey(std::nullopt);
+  ASSERT_EQ(cache.Tessellate(path, kDefaultCurveTolerance,
+                             [](const float* vertices, size_t vertices_count,
+                                const uint16_t* indices,
+                                size_t indices_count) { return true; }),
+            Tessellator::Result::kSuccess);
+  ASSERT_EQ(cache.GetEntryCount(), 3u);
+}
+
+TEST_P(EntityTest, TessellationCacheEvictsLeastRecentlyUsedTessellations) {
+  auto tessellate = [](TessellationCache& cache, uint64_t key) {
+    auto path = PathBuilder{}.AddRect(Rect::MakeLTRB(0, 0, 10, 10)).TakePath();
+    path.SetCacheKey(key);
+    return cache.Tessellate(path, kDefaultCurveTolerance,
+                            [](const float* vertices, size_t vertices_count,
+                               const uint16_t* indices,
+                               size_t indices_count) { return true; });
+  };
+  // 4 vertices and 6 indices.
+  constexpr size_t kEntrySize = 4 * 2 * sizeof(float) + 6 * sizeof(uint16_t);
+  TessellationCache cache(std::make_shared<Tessellator>(), kEntrySize * 2);
+
+  ASSERT_EQ(tessellate(cache, 1), Tessellator::Result::kSuccess);
+  ASSERT_EQ(tessellate(cache, 2), Tessellator::Result::kSuccess);
+  ASSERT_EQ(cache.GetByteSize(), kEntrySize * 2);
+  // Uses the first tessellation again, so that the second is evicted next.
+  ASSERT_EQ(tessellate(cache, 1), Tessellator::Result::kSuccess);
+  ASSERT_EQ(tessellate(cache, 3), Tessellator::Result::kSuccess);
+  ASSERT_EQ(cache.GetEntryCount(), 2u);
+  ASSERT_EQ(cache.GetByteSize(), kEntrySize * 2);
+
+  // The device buffer, created the second time a vertex buffer is requested,
+  // counts as a copy of the tessellation.
+  auto path = PathBuilder{}.AddRect(Rect::MakeLTRB(0, 0, 10, 10)).TakePath();
+  path.SetCacheKey(3);
+  auto host_buffer = HostBuffer::Create();
+  for (int i = 0; i < 2; i++) {
+    ASSERT_TRUE(cache
+                    .GetVertexBuffer(path, kDefaultCurveTolerance,
+                                     *GetContext()->GetResourceAllocator(),
+                                     *host_buffer)
+                    .has_value());
+  }
+  ASSERT_EQ(cache.GetEntryCount(), 1u);
+  ASSERT_EQ(cache.GetByteSize(), kEntrySize * 2);
+
+  cache.Clear();
+  ASSERT_EQ(cache.GetEntryCount(), 0u);
+  ASSERT_EQ(cache.GetByteSize(), 0u);
+}
+
 }  // namespace testing
 }  // namespace impeller
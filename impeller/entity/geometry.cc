@@ -5,6 +5,7 @@
 #include "impeller/entity/geometry.h"
 #include "impeller/entity/contents/content_context.h"
 #include "impeller/entity/position_color.vert.h"
+#include "impeller/entity/tessellation_cache.h"
 #include "impeller/geometry/matrix.h"
 #include "impeller/geometry/path_builder.h"
 #include "impeller/renderer/device_buffer.h"
@@ -209,22 +210,44 @@ GeometryResult FillPathGeometry::GetPositionBuffer(
     const Entity& entity,
     RenderPass& pass) {
   VertexBuffer vertex_buffer;
-  auto& host_buffer = pass.GetTransientsBuffer();
-  auto tesselation_result = renderer.GetTessellator()->Tessellate(
-      path_.GetFillType(), path_.CreatePolyline(),
-      [&vertex_buffer, &host_buffer](
-          const float* vertices, size_t vertices_count, const uint16_t* indices,
-          size_t indices_count) {
-        vertex_buffer.vertex_buffer = host_buffer.Emplace(
-            vertices, vertices_count * sizeof(float), alignof(float));
-        vertex_buffer.index_buffer = host_buffer.Emplace(
-            indices, indices_count * sizeof(uint16_t), alignof(uint16_t));
-        vertex_buffer.index_count = indices_count;
-        vertex_buffer.index_type = IndexType::k16bit;
-        return true;
-      });
-  if (tesselation_result != Tessellator::Result::kSuccess) {
-    return {};
+  if (path_.GetCacheKey().has_value()) {
+    auto cached_vertex_buffer =
+        renderer.GetTessellationCache()->GetVertexBuffer(
+            path_, kDefaultCurveTolerance,
+            *renderer.GetContext()->GetResourceAllocator(),
+            pass.GetTransientsBuffer());
+    if (!cached_vertex_buffer.has_value()) {
+      return {};
+    }
+    vertex_buffer = cached_vertex_buffer.value();
+  } else {
+    auto& host_buffer = pass.GetTransientsBuffer();
+    auto emplace_vertices = [&vertex_buffer, &host_buffer](
+                                const float* vertices, size_t vertices_count,
+                                const uint16_t* indices,
+                                size_t indices_count) {
+      vertex_buffer.vertex_buffer = host_buffer.Emplace(
+          vertices, vertices_count * sizeof(float), alignof(float));
+      vertex_buffer.index_buffer = host_buffer.Emplace(
+          indices, indices_count * sizeof(uint16_t), alignof(uint16_t));
+      vertex_buffer.index_count = indices_count;
+      vertex_buffer.index_type = IndexType::k16bit;
+      return true;
+    };
+    auto tessellator = renderer.GetTessellator();
+    const auto fill_type = path_.GetFillType();
+    const auto polyline = path_.CreatePolyline();
+    // Paths known to be convex skip the check |Tessellate| does for them.
+    const bool is_convex =
+        path_.GetConvexity() == Convexity::kConvex &&
+        (fill_type == FillType::kNonZero || fill_type == FillType::kOdd);
+    auto tesselation_result =
+        is_convex
+            ? tessellator->TessellateConvex(polyline, emplace_vertices)
+            : tessellator->Tessellate(fill_type, polyline, emplace_vertices);
+    if (tesselation_result != Tessellator::Result::kSuccess) {
+      return {};
+    }
   }
   return GeometryResult{
       .type = PrimitiveType::kTriangle,
@@ -0,0 +1,199 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/entity/tessellation_cache.h"
+
+#include <cmath>
+
+namespace impeller {
+
+namespace {
+
+// The power of two that |tolerance| is rounded down to, in multiples of
+// |kDefaultCurveTolerance|, which is its own bucket.
+std::optional<int> GetToleranceBucket(Scalar tolerance) {
+  if (!(tolerance > 0) || !std::isfinite(tolerance)) {
+    return std::nullopt;
+  }
+  return static_cast<int>(
+      std::floor(std::log2(tolerance / kDefaultCurveTolerance)));
+}
+
+}  // namespace
+
+TessellationCache::TessellationCache(std::shared_ptr<Tessellator> tessellator,
+                                     size_t max_bytes)
+    : tessellator_(std::move(tessellator)), max_bytes_(max_bytes) {}
+
+TessellationCache::~TessellationCache() = default;
+
+Tessellator::Result TessellationCache::Tessellate(
+    const Path& path,
+    Scalar tolerance,
+    const Tessellator::BuilderCallback& callback) {
+  if (!callback) {
+    return Tessellator::Result::kInputError;
+  }
+  auto result = Tessellator::Result::kSuccess;
+  auto entry = GetEntry(path, tolerance, result);
+  if (!entry) {
+    if (result != Tessellator::Result::kSuccess) {
+      return result;
+    }
+    return tessellator_->Tessellate(path.GetFillType(),
+                                    path.CreatePolyline(tolerance), callback);
+  }
+  if (!callback(entry->vertices.data(), entry->vertices.size(),
+                entry->indices.data(), entry->indices.size())) {
+    result = Tessellator::Result::kInputError;
+  }
+  EvictEntries();
+  return result;
+}
+
+std::optional<VertexBuffer> TessellationCache::GetVertexBuffer(
+    const Path& path,
+    Scalar tolerance,
+    Allocator& allocator,
+    HostBuffer& host_buffer) {
+  auto result = Tessellator::Result::kSuccess;
+  auto entry = GetEntry(path, tolerance, result);
+  if (!entry) {
+    return std::nullopt;
+  }
+  entry->vertex_buffer_requests++;
+
+  VertexBuffer vertex_buffer;
+  vertex_buffer.index_count = entry->indices.size();
+  vertex_buffer.index_type = IndexType::k16bit;
+  if (!entry->indices.empty() && !entry->device_buffer &&
+      entry->vertex_buffer_requests == 1) {
+    // Most paths that are drawn once are never drawn again, so they don't get
+    // a device buffer until they are.
+    vertex_buffer.vertex_buffer = host_buffer.Emplace(
+        entry->vertices.data(), entry->vertices.size() * sizeof(float),
+        alignof(float));
+    vertex_buffer.index_buffer = host_buffer.Emplace(
+        entry->indices.data(), entry->indices.size() * sizeof(uint16_t),
+        alignof(uint16_t));
+  } else if (!entry->indices.empty()) {
+    if (!entry->device_buffer && !CreateDeviceBuffer(*entry, allocator)) {
+      return std::nullopt;
+    }
+    auto view = entry->device_buffer->AsBufferView();
+    vertex_buffer.vertex_buffer = view;
+    vertex_buffer.vertex_buffer.range =
+        Range{0, entry->vertices.size() * sizeof(float)};
+    vertex_buffer.index_buffer = view;
+    vertex_buffer.index_buffer.range =
+        Range{entry->indices_offset, entry->indices.size() * sizeof(uint16_t)};
+  }
+  // Evicting the entry now is fine, the vertex buffer keeps its device buffer.
+  EvictEntries();
+  return vertex_buffer;
+}
+
+void TessellationCache::Clear() {
+  entries_.clear();
+  lru_.clear();
+  byte_size_ = 0;
+}
+
+size_t TessellationCache::GetEntryCount() const {
+  return entries_.size();
+}
+
+size_t TessellationCache::GetByteSize() const {
+  return byte_size_;
+}
+
+TessellationCache::Entry* TessellationCache::GetEntry(
+    const Path& path,
+    Scalar tolerance,
+    Tessellator::Result& result) {
+  const auto path_key = path.GetCacheKey();
+  const auto tolerance_bucket = GetToleranceBucket(tolerance);
+  if (!path_key.has_value() || !tolerance_bucket.has_value()) {
+    return nullptr;
+  }
+
+  const Key key = {path_key.value(), path.GetFillType(),
+                   tolerance_bucket.value()};
+  auto found = entries_.find(key);
+  if (found != entries_.end()) {
+    lru_.splice(lru_.begin(), lru_, found->second.lru_position);
+    return &found->second;
+  }
+
+  Entry entry;
+  // Every path of the bucket is flattened as finely as the smallest
+  // tolerance of the bucket asks for.
+  const Scalar bucket_tolerance =
+      std::ldexp(kDefaultCurveTolerance, key.tolerance_bucket);
+  result = tessellator_->Tessellate(
+      path.GetFillType(), path.CreatePolyline(bucket_tolerance),
+      [&entry](const float* vertices, size_t vertices_count,
+               const uint16_t* indices, size_t indices_count) {
+        entry.vertices.assign(vertices, vertices + vertices_count);
+        entry.indices.assign(indices, indices + indices_count);
+        return true;
+      });
+  if (result != Tessellator::Result::kSuccess) {
+    return nullptr;
+  }
+
+  lru_.push_front(key);
+  entry.lru_position = lru_.begin();
+  byte_size_ += GetByteSize(entry);
+  return &entries_.emplace(key, std::move(entry)).first->second;
+}
+
+bool TessellationCache::CreateDeviceBuffer(Entry& entry,
+                                           Allocator& allocator) {
+  const size_t vertices_size = entry.vertices.size() * sizeof(float);
+  const size_t indices_size = entry.indices.size() * sizeof(uint16_t);
+  // The indices follow the floats of the vertices, so they are aligned.
+  static_assert(alignof(float) % alignof(uint16_t) == 0);
+
+  DeviceBufferDescriptor desc;
+  desc.size = vertices_size + indices_size;
+  desc.storage_mode = StorageMode::kHostVisible;
+  auto device_buffer = allocator.CreateBuffer(desc);
+  if (!device_buffer) {
+    return false;
+  }
+  if (!device_buffer->CopyHostBuffer(
+          reinterpret_cast<const uint8_t*>(entry.vertices.data()),
+          Range{0, vertices_size}, 0) ||
+      !device_buffer->CopyHostBuffer(
+          reinterpret_cast<const uint8_t*>(entry.indices.data()),
+          Range{0, indices_size}, vertices_size)) {
+    return false;
+  }
+  device_buffer->SetLabel("Cached Tessellation");
+
+  byte_size_ -= GetByteSize(entry);
+  entry.device_buffer = std::move(device_buffer);
+  entry.indices_offset = vertices_size;
+  byte_size_ += GetByteSize(entry);
+  return true;
+}
+
+void TessellationCache::EvictEntries() {
+  while (byte_size_ > max_bytes_ && !lru_.empty()) {
+    auto found = entries_.find(lru_.back());
+    byte_size_ -= GetByteSize(found->second);
+    entries_.erase(found);
+    lru_.pop_back();
+  }
+}
+
+size_t TessellationCache::GetByteSize(const Entry& entry) {
+  const size_t size = entry.vertices.size() * sizeof(float) +
+                      entry.indices.size() * sizeof(uint16_t);
+  // The device buffer is a copy of the vertices and the indices.
+  return entry.device_buffer ? size * 2 : size;
+}
+
+}  // namespace impeller
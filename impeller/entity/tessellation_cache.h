@@ -0,0 +1,147 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/macros.h"
+#include "impeller/geometry/path.h"
+#include "impeller/renderer/allocator.h"
+#include "impeller/renderer/device_buffer.h"
+#include "impeller/renderer/host_buffer.h"
+#include "impeller/renderer/vertex_buffer.h"
+#include "impeller/tessellator/tessellator.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      Keeps the tessellations of the paths that are drawn unchanged
+///             frame after frame, such as icons, borders and clips, so that
+///             they aren't flattened and tessellated again every frame.
+///
+///             Only paths with a cache key are cached, see
+///             |Path::SetCacheKey|. Tessellations are looked up by that key,
+///             the fill type and the curve tolerance, rounded down to a power
+///             of two times |kDefaultCurveTolerance|. The least recently used
+///             ones are dropped once they take more than the byte budget.
+///
+///             Not thread safe, it is used by the thread that renders with the
+///             |ContentContext| that owns it.
+///
+class TessellationCache {
+ public:
+  static constexpr size_t kDefaultMaxBytes = 8 * 1024 * 1024;
+
+  explicit TessellationCache(std::shared_ptr<Tessellator> tessellator,
+                             size_t max_bytes = kDefaultMaxBytes);
+
+  ~TessellationCache();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Like |Tessellator::Tessellate| with the polyline of the path,
+  ///             but gives the callback the tessellation cached for the path
+  ///             if there is one.
+  ///
+  /// @param[in]  path       The path to fill.
+  /// @param[in]  tolerance  The curve tolerance to flatten the path with.
+  /// @param[in]  callback   The callback, return false to indicate failure.
+  ///
+  /// @return The result status of the tessellation.
+  ///
+  Tessellator::Result Tessellate(const Path& path,
+                                 Scalar tolerance,
+                                 const Tessellator::BuilderCallback& callback);
+
+  //----------------------------------------------------------------------------
+  /// @brief      The tessellation of a path with a cache key. The first time
+  ///             it is requested, it is copied to the host buffer like a
+  ///             tessellation that isn't cached. From the second time on, it
+  ///             is in a device buffer that is reused by every frame that
+  ///             draws the path, so that paths drawn only once don't get one.
+  ///
+  /// @param[in]  path         The path to fill, which must have a cache key.
+  /// @param[in]  tolerance    The curve tolerance to flatten the path with.
+  /// @param[in]  allocator    The allocator of the device buffer.
+  /// @param[in]  host_buffer  The buffer to copy the tessellation to the
+  ///                          first time.
+  ///
+  /// @return The vertex buffer, which has no vertices if the path is empty,
+  ///         or std::nullopt if the path couldn't be tessellated.
+  ///
+  std::optional<VertexBuffer> GetVertexBuffer(const Path& path,
+                                              Scalar tolerance,
+                                              Allocator& allocator,
+                                              HostBuffer& host_buffer);
+
+  /// Drops every cached tessellation, when memory is low for instance.
+  void Clear();
+
+  /// The number of cached tessellations.
+  size_t GetEntryCount() const;
+
+  /// The bytes taken by the cached tessellations, including their device
+  /// buffers.
+  size_t GetByteSize() const;
+
+ private:
+  struct Key {
+    uint64_t path_key;
+    FillType fill_type;
+    int tolerance_bucket;
+
+    struct Hash {
+      constexpr std::size_t operator()(const Key& o) const {
+        return fml::HashCombine(o.path_key, o.fill_type, o.tolerance_bucket);
+      }
+    };
+
+    struct Equal {
+      constexpr bool operator()(const Key& lhs, const Key& rhs) const {
+        return lhs.path_key == rhs.path_key &&
+               lhs.fill_type == rhs.fill_type &&
+               lhs.tolerance_bucket == rhs.tolerance_bucket;
+      }
+    };
+  };
+
+  struct Entry {
+    std::vector<float> vertices;
+    std::vector<uint16_t> indices;
+    // The number of times a vertex buffer was requested for the entry.
+    size_t vertex_buffer_requests = 0;
+    // The vertices followed by the indices, created the second time a vertex
+    // buffer is requested.
+    std::shared_ptr<DeviceBuffer> device_buffer;
+    size_t indices_offset = 0;
+    std::list<Key>::iterator lru_position;
+  };
+
+  const std::shared_ptr<Tessellator> tessellator_;
+  const size_t max_bytes_;
+  std::unordered_map<Key, Entry, Key::Hash, Key::Equal> entries_;
+  // The keys of |entries_|, the most recently used first.
+  std::list<Key> lru_;
+  size_t byte_size_ = 0;
+
+  /// The entry for the path, tessellated now if it wasn't cached.
+  Entry* GetEntry(const Path& path,
+                  Scalar tolerance,
+                  Tessellator::Result& result);
+
+  bool CreateDeviceBuffer(Entry& entry, Allocator& allocator);
+
+  void EvictEntries();
+
+  static size_t GetByteSize(const Entry& entry);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(TessellationCache);
+};
+
+}  // namespace impeller
@@ -16,6 +16,9 @@ namespace {
 Path CreateCubic();
 /// Similar to the path above, but with all cubics replaced by quadratics.
 Path CreateQuadratic();
+/// A grid of small icons made of cubic and quadratic contours, like the
+/// paths of a detailed SVG image.
+Path CreateSVGStyle();
 }  // namespace
 
 static Tessellator tess;
@@ -47,6 +50,28 @@ BENCHMARK_CAPTURE(BM_Polyline, cubic_polyline, CreateCubic(), false);
 BENCHMARK_CAPTURE(BM_Polyline, cubic_polyline_tess, CreateCubic(), true);
 BENCHMARK_CAPTURE(BM_Polyline, quad_polyline, CreateQuadratic(), false);
 BENCHMARK_CAPTURE(BM_Polyline, quad_polyline_tess, CreateQuadratic(), true);
+BENCHMARK_CAPTURE(
+    BM_Polyline,
+    rect_polyline_tess,
+    PathBuilder{}.AddRect(Rect::MakeLTRB(0, 0, 100, 100)).TakePath(),
+    true);
+BENCHMARK_CAPTURE(
+    BM_Polyline,
+    rrect_polyline_tess,
+    PathBuilder{}.AddRoundedRect(Rect::MakeLTRB(0, 0, 100, 100), 10).TakePath(),
+    true);
+BENCHMARK_CAPTURE(
+    BM_Polyline,
+    oval_polyline_tess,
+    PathBuilder{}.AddOval(Rect::MakeLTRB(0, 0, 100, 50)).TakePath(),
+    true);
+BENCHMARK_CAPTURE(BM_Polyline, svg_polyline, CreateSVGStyle(), false);
+BENCHMARK_CAPTURE(BM_Polyline, svg_polyline_tess, CreateSVGStyle(), true);
+BENCHMARK_CAPTURE(
+    BM_Polyline,
+    large_oval_polyline,
+    PathBuilder{}.AddOval(Rect::MakeLTRB(0, 0, 2000, 1000)).TakePath(),
+    false);
 
 namespace {
 Path CreateCubic() {
@@ -312,5 +337,32 @@ Path CreateQuadratic() {
       .TakePath();
 }
 
+Path CreateSVGStyle() {
+  PathBuilder builder;
+  for (int row = 0; row < 16; row++) {
+    for (int column = 0; column < 16; column++) {
+      const Point origin(column * 48.0f, row * 48.0f);
+      // A four-leaf clover.
+      const Point center = origin + Point(20, 20);
+      builder.MoveTo(center)
+          .CubicCurveTo(origin + Point(-4, 8), origin + Point(8, -4), center)
+          .CubicCurveTo(origin + Point(32, -4), origin + Point(44, 8), center)
+          .CubicCurveTo(origin + Point(44, 32), origin + Point(32, 44), center)
+          .CubicCurveTo(origin + Point(8, 44), origin + Point(-4, 32), center)
+          .Close();
+      // A wavy underline.
+      builder.MoveTo(origin + Point(0, 42));
+      for (int wave = 0; wave < 4; wave++) {
+        const Scalar x = wave * 10.0f;
+        builder.QuadraticCurveTo(origin + Point(x + 5, wave % 2 ? 46 : 38),
+                                 origin + Point(x + 10, 42));
+      }
+      builder.LineTo(origin + Point(40, 44)).LineTo(origin + Point(0, 44));
+      builder.Close();
+    }
+  }
+  return builder.TakePath();
+}
+
 }  // namespace
 }  // namespace impeller
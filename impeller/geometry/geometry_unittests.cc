@@ -1480,6 +1480,24 @@ TEST(GeometryTest, CubicPathComponentPolylineDoesNotIncludePointOne) {
   ASSERT_EQ(polyline.back().y, 40);
 }
 
+TEST(GeometryTest, QuadraticPathComponentPolylinePointsLieOnTheCurve) {
+  // x is 100 * t and y is 200 * t * (1 - t) on this curve.
+  QuadraticPathComponent component({0, 0}, {50, 100}, {100, 0});
+  auto polyline = component.CreatePolyline();
+  // Enough points between the ends to be solved in several groups of four
+  // and a partial one.
+  ASSERT_GT(polyline.size() - 1, 8u);
+  ASSERT_NE((polyline.size() - 1) % 4, 0u);
+  for (const auto& point : polyline) {
+    auto t = point.x / 100;
+    ASSERT_NEAR(point.y, 200 * t * (1 - t), 1e-3);
+  }
+  ASSERT_EQ(polyline.back(), Point(100, 0));
+  for (size_t i = 1; i < polyline.size(); i++) {
+    ASSERT_GT(polyline[i].x, polyline[i - 1].x);
+  }
+}
+
 TEST(GeometryTest, PathCreatePolyLineDoesNotDuplicatePoints) {
   Path path;
   path.AddContourComponent({10, 10});
@@ -1646,6 +1664,41 @@ TEST(GeometryTest, PathPolylineDuplicatesAreRemovedForSameContour) {
   ASSERT_EQ(polyline.points[6], Point(0, 100));
 }
 
+TEST(GeometryTest, PathBuilderSetsConvexityOfSingleConvexShapes) {
+  auto rect = Rect::MakeLTRB(0, 0, 100, 100);
+  ASSERT_EQ(PathBuilder{}.AddRect(rect).TakePath().GetConvexity(),
+            Convexity::kConvex);
+  ASSERT_EQ(PathBuilder{}.AddOval(rect).TakePath().GetConvexity(),
+            Convexity::kConvex);
+  ASSERT_EQ(PathBuilder{}.AddCircle({50, 50}, 10).TakePath().GetConvexity(),
+            Convexity::kConvex);
+  ASSERT_EQ(PathBuilder{}.AddRoundedRect(rect, 10).TakePath().GetConvexity(),
+            Convexity::kConvex);
+
+  // Corners that overlap make the outline intersect itself.
+  ASSERT_EQ(PathBuilder{}.AddRoundedRect(rect, 60).TakePath().GetConvexity(),
+            Convexity::kUnknown);
+  // More than one shape.
+  ASSERT_EQ(
+      PathBuilder{}.AddRect(rect).AddOval(rect).TakePath().GetConvexity(),
+      Convexity::kUnknown);
+  ASSERT_EQ(PathBuilder{}
+                .AddRect(rect)
+                .MoveTo({0, 0})
+                .LineTo({200, 200})
+                .TakePath()
+                .GetConvexity(),
+            Convexity::kUnknown);
+  ASSERT_EQ(PathBuilder{}
+                .MoveTo({0, 0})
+                .LineTo({100, 0})
+                .LineTo({100, 100})
+                .Close()
+                .TakePath()
+                .GetConvexity(),
+            Convexity::kUnknown);
+}
+
 TEST(GeometryTest, VerticesConstructorAndGetters) {
   std::vector<Point> points = {Point(1, 2), Point(2, 3), Point(3, 4)};
   std::vector<uint16_t> indices = {0, 1, 2};
@@ -40,6 +40,22 @@ FillType Path::GetFillType() const {
   return fill_;
 }
 
+void Path::SetConvexity(Convexity convexity) {
+  convexity_ = convexity;
+}
+
+Convexity Path::GetConvexity() const {
+  return convexity_;
+}
+
+void Path::SetCacheKey(std::optional<uint64_t> key) {
+  cache_key_ = key;
+}
+
+std::optional<uint64_t> Path::GetCacheKey() const {
+  return cache_key_;
+}
+
 Path& Path::AddLinearComponent(Point p1, Point p2) {
   linears_.emplace_back(p1, p2);
   components_.emplace_back(ComponentType::kLinear, linears_.size() - 1);
@@ -223,37 +239,35 @@ bool Path::UpdateContourComponentAtIndex(size_t index,
 
 Path::Polyline Path::CreatePolyline(Scalar tolerance) const {
   Polyline polyline;
-
-  std::optional<Point> previous_contour_point;
-  auto collect_points = [&polyline, &previous_contour_point](
-                            const std::vector<Point>& collection) {
-    if (collection.empty()) {
-      return;
-    }
-
-    for (const auto& point : collection) {
-      if (previous_contour_point.has_value() &&
-          previous_contour_point.value() == point) {
-        // Skip over duplicate points in the same contour.
+  auto& points = polyline.points;
+
+  // Components write their points straight to the polyline, then the points
+  // that repeat the previous one of the same contour are removed.
+  size_t contour_start = 0;
+  auto remove_duplicate_points = [&points, &contour_start](size_t first) {
+    size_t end = first;
+    for (size_t i = first; i < points.size(); i++) {
+      if (end > contour_start && points[end - 1] == points[i]) {
         continue;
       }
-      previous_contour_point = point;
-      polyline.points.push_back(point);
+      points[end++] = points[i];
     }
+    points.resize(end);
   };
 
   for (size_t component_i = 0; component_i < components_.size();
        component_i++) {
     const auto& component = components_[component_i];
+    const size_t first = points.size();
     switch (component.type) {
       case ComponentType::kLinear:
-        collect_points(linears_[component.index].CreatePolyline());
+        points.push_back(linears_[component.index].p2);
         break;
       case ComponentType::kQuadratic:
-        collect_points(quads_[component.index].CreatePolyline(tolerance));
+        quads_[component.index].FillPointsForPolyline(points, tolerance);
         break;
       case ComponentType::kCubic:
-        collect_points(cubics_[component.index].CreatePolyline(tolerance));
+        cubics_[component.index].FillPointsForPolyline(points, tolerance);
         break;
       case ComponentType::kContour:
         if (component_i == components_.size() - 1) {
@@ -262,12 +276,13 @@ Path::Polyline Path::CreatePolyline(Scalar tolerance) const {
           continue;
         }
         const auto& contour = contours_[component.index];
-        polyline.contours.push_back({.start_index = polyline.points.size(),
+        polyline.contours.push_back({.start_index = points.size(),
                                      .is_closed = contour.is_closed});
-        previous_contour_point = std::nullopt;
-        collect_points({contour.destination});
+        contour_start = points.size();
+        points.push_back(contour.destination);
         break;
     }
+    remove_duplicate_points(first);
   }
   return polyline;
 }
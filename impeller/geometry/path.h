@@ -22,6 +22,14 @@ enum class FillType {
   kAbsGeqTwo,
 };
 
+enum class Convexity {
+  /// The path may or may not be convex.
+  kUnknown,
+  /// The path is a single convex contour, such as a rect, a rounded rect or
+  /// an oval, which can be filled without a general tessellation.
+  kConvex,
+};
+
 //------------------------------------------------------------------------------
 /// @brief      Paths are lightweight objects that describe a collection of
 ///             linear, quadratic, or cubic segments. These segments may be
@@ -77,6 +85,23 @@ class Path {
 
   FillType GetFillType() const;
 
+  /// Marks the path as known to be convex, which lets it be filled faster.
+  /// |PathBuilder| does that for the paths it builds from a single rect,
+  /// rounded rect or oval. It isn't reset when components are added or
+  /// updated later.
+  void SetConvexity(Convexity convexity);
+
+  Convexity GetConvexity() const;
+
+  /// Identifies paths that are drawn again unchanged, such as the paths of a
+  /// display list that is drawn every frame, so that their tessellation can
+  /// be reused. Paths with the same key must have the same components, but
+  /// may have different fill types. Like the convexity, the key isn't reset
+  /// when components are added or updated later.
+  void SetCacheKey(std::optional<uint64_t> key);
+
+  std::optional<uint64_t> GetCacheKey() const;
+
   Path& AddLinearComponent(Point p1, Point p2);
 
   Path& AddQuadraticComponent(Point p1, Point cp, Point p2);
@@ -137,6 +162,8 @@ class Path {
   };
 
   FillType fill_ = FillType::kNonZero;
+  Convexity convexity_ = Convexity::kUnknown;
+  std::optional<uint64_t> cache_key_;
   std::vector<ComponentIndexPair> components_;
   std::vector<LinearPathComponent> linears_;
   std::vector<QuadraticPathComponent> quads_;
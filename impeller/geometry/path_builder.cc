@@ -15,15 +15,28 @@ PathBuilder::~PathBuilder() = default;
 Path PathBuilder::CopyPath(FillType fill) const {
   auto path = prototype_;
   path.SetFillType(fill);
+  path.SetConvexity(GetConvexity());
   return path;
 }
 
 Path PathBuilder::TakePath(FillType fill) {
   auto path = prototype_;
   path.SetFillType(fill);
+  path.SetConvexity(GetConvexity());
   return path;
 }
 
+Convexity PathBuilder::GetConvexity() const {
+  return convex_component_count_ > 0 &&
+                 convex_component_count_ == prototype_.GetComponentCount()
+             ? Convexity::kConvex
+             : Convexity::kUnknown;
+}
+
+bool PathBuilder::IsEmpty() const {
+  return prototype_.GetComponentCount() <= 1;
+}
+
 PathBuilder& PathBuilder::MoveTo(Point point, bool relative) {
   current_ = relative ? current_ + point : point;
   subpath_start_ = current_;
@@ -169,6 +182,7 @@ PathBuilder& PathBuilder::AddCubicCurve(Point p1,
 }
 
 PathBuilder& PathBuilder::AddRect(Rect rect) {
+  const bool is_only_shape = IsEmpty();
   current_ = rect.origin;
 
   auto tl = rect.origin;
@@ -182,6 +196,9 @@ PathBuilder& PathBuilder::AddRect(Rect rect) {
       .AddLinearComponent(br, bl);
   Close();
 
+  if (is_only_shape) {
+    convex_component_count_ = prototype_.GetComponentCount();
+  }
   return *this;
 }
 
@@ -199,6 +216,14 @@ PathBuilder& PathBuilder::AddRoundedRect(Rect rect, RoundingRadii radii) {
     return AddRect(rect);
   }
 
+  // Corners that overlap make the outline intersect itself.
+  const bool corners_fit =
+      radii.top_left.x + radii.top_right.x <= rect.size.width &&
+      radii.bottom_left.x + radii.bottom_right.x <= rect.size.width &&
+      radii.top_left.y + radii.bottom_left.y <= rect.size.height &&
+      radii.top_right.y + radii.bottom_right.y <= rect.size.height;
+  const bool is_only_shape = corners_fit && IsEmpty();
+
   current_ = rect.origin + Point{radii.top_left.x, 0.0};
 
   const auto magic_top_right = radii.top_right * kArcApproximationMagic;
@@ -286,6 +311,9 @@ PathBuilder& PathBuilder::AddRoundedRect(Rect rect, RoundingRadii radii) {
 
   Close();
 
+  if (is_only_shape) {
+    convex_component_count_ = prototype_.GetComponentCount();
+  }
   return *this;
 }
 
@@ -353,6 +381,7 @@ PathBuilder& PathBuilder::AddOval(const Rect& container) {
   const Point r = {container.size.width * 0.5f, container.size.height * 0.5f};
   const Point c = {container.origin.x + r.x, container.origin.y + r.y};
   const Point m = {kArcApproximationMagic * r.x, kArcApproximationMagic * r.y};
+  const bool is_only_shape = IsEmpty();
 
   MoveTo({c.x, c.y - r.y});
 
@@ -394,6 +423,9 @@ PathBuilder& PathBuilder::AddOval(const Rect& container) {
 
   Close();
 
+  if (is_only_shape) {
+    convex_component_count_ = prototype_.GetComponentCount();
+  }
   return *this;
 }
 
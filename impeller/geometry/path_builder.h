@@ -108,6 +108,15 @@ class PathBuilder {
   Point subpath_start_;
   Point current_;
   Path prototype_;
+  // The component count of |prototype_| after a convex shape was added to it
+  // while it was empty, or zero. The path is convex while that shape is all
+  // there is to it.
+  size_t convex_component_count_ = 0;
+
+  Convexity GetConvexity() const;
+
+  /// Whether nothing but the initial contour was added to |prototype_|.
+  bool IsEmpty() const;
 
   Point ReflectedQuadraticControlPoint1() const;
 
@@ -6,6 +6,8 @@
 
 #include <cmath>
 
+#include "impeller/geometry/simd.h"
+
 namespace impeller {
 
 /*
@@ -86,6 +88,13 @@ static Scalar ApproximateParabolaIntegral(Scalar x) {
   return x / (1.0 - d + sqrt(sqrt(pow(d, 4) + 0.25 * x * x)));
 }
 
+static Float32x4 ApproximateParabolaIntegral(Float32x4 x) {
+  constexpr Scalar d = 0.67;
+  constexpr Scalar d4 = d * d * d * d;
+  const auto root = (Float32x4(d4) + Float32x4(0.25) * x * x).Sqrt().Sqrt();
+  return x / (Float32x4(1.0 - d) + root);
+}
+
 std::vector<Point> QuadraticPathComponent::CreatePolyline(
     Scalar tolerance) const {
   std::vector<Point> points;
@@ -125,13 +134,37 @@ void QuadraticPathComponent::FillPointsForPolyline(std::vector<Point>& points,
 
   auto line_count = std::max(1., ceil(0.5 * val / sqrt_tolerance));
   auto step = 1 / line_count;
-  for (size_t i = 1; i < line_count; i += 1) {
-    auto u = i * step;
-    auto a = a0 + (a2 - a0) * u;
-    auto t = (ApproximateParabolaIntegral(a) - u0) * uscale;
-    points.emplace_back(Solve(t));
+
+  // The points between the ends don't depend on each other, so they are
+  // solved four at a time, and written straight to the end of |points|.
+  const size_t inner_count = static_cast<size_t>(line_count) - 1;
+  const size_t first = points.size();
+  points.resize(first + inner_count + 1);
+  const Float32x4 lanes(0, 1, 2, 3);
+  const Float32x4 a0x4(a0);
+  const Float32x4 da(a2 - a0);
+  const Float32x4 u0x4(u0);
+  const Float32x4 uscale_x4(uscale);
+  const Float32x4 one(1);
+  const Float32x4 two(2);
+  for (size_t i = 0; i < inner_count; i += 4) {
+    auto u = (Float32x4(static_cast<Scalar>(i + 1)) + lanes) * Float32x4(step);
+    auto t = (ApproximateParabolaIntegral(a0x4 + da * u) - u0x4) * uscale_x4;
+    // Same as |QuadraticSolve|.
+    auto mt = one - t;
+    auto a = mt * mt;
+    auto b = two * mt * t;
+    auto c = t * t;
+    Scalar xs[4];
+    Scalar ys[4];
+    (a * Float32x4(p1.x) + b * Float32x4(cp.x) + c * Float32x4(p2.x)).Store(xs);
+    (a * Float32x4(p1.y) + b * Float32x4(cp.y) + c * Float32x4(p2.y)).Store(ys);
+    const size_t lane_count = std::min<size_t>(4, inner_count - i);
+    for (size_t lane = 0; lane < lane_count; lane++) {
+      points[first + i + lane] = {xs[lane], ys[lane]};
+    }
   }
-  points.emplace_back(p2);
+  points.back() = p2;
 }
 
 std::vector<Point> QuadraticPathComponent::Extrema() const {
@@ -153,15 +186,54 @@ Point CubicPathComponent::SolveDerivative(Scalar time) const {
   };
 }
 
+// Calls |callback| with each of the quadratics that approximate |cubic|, from
+// its start to its end.
+template <class Callback>
+static void EnumerateQuadraticPathComponents(const CubicPathComponent& cubic,
+                                             Scalar accuracy,
+                                             const Callback& callback) {
+  // The maximum error, as a vector from the cubic to the best approximating
+  // quadratic, is proportional to the third derivative, which is constant
+  // across the segment. Thus, the error scales down as the third power of
+  // the number of subdivisions. Our strategy then is to subdivide `t` evenly.
+  //
+  // This is an overestimate of the error because only the component
+  // perpendicular to the first derivative is important. But the simplicity is
+  // appealing.
+
+  // This magic number is the square of 36 / sqrt(3).
+  // See: http://caffeineowl.com/graphics/2d/vectorial/cubic2quad01.html
+  auto max_hypot2 = 432.0 * accuracy * accuracy;
+  auto p1x2 = 3.0 * cubic.cp1 - cubic.p1;
+  auto p2x2 = 3.0 * cubic.cp2 - cubic.p2;
+  auto p = p2x2 - p1x2;
+  auto err = p.Dot(p);
+  auto quad_count = std::max(1., ceil(pow(err / max_hypot2, 1. / 6.0)));
+
+  for (size_t i = 0; i < quad_count; i++) {
+    auto t0 = i / quad_count;
+    auto t1 = (i + 1) / quad_count;
+    auto seg = cubic.Subsegment(t0, t1);
+    auto p1x2 = 3.0 * seg.cp1 - seg.p1;
+    auto p2x2 = 3.0 * seg.cp2 - seg.p2;
+    callback(QuadraticPathComponent(seg.p1, ((p1x2 + p2x2) / 4.0), seg.p2));
+  }
+}
+
 std::vector<Point> CubicPathComponent::CreatePolyline(Scalar tolerance) const {
-  auto quads = ToQuadraticPathComponents(.1);
   std::vector<Point> points;
-  for (const auto& quad : quads) {
-    quad.FillPointsForPolyline(points, tolerance);
-  }
+  FillPointsForPolyline(points, tolerance);
   return points;
 }
 
+void CubicPathComponent::FillPointsForPolyline(std::vector<Point>& points,
+                                               Scalar tolerance) const {
+  EnumerateQuadraticPathComponents(
+      *this, .1, [&points, tolerance](const QuadraticPathComponent& quad) {
+        quad.FillPointsForPolyline(points, tolerance);
+      });
+}
+
 inline QuadraticPathComponent CubicPathComponent::Lower() const {
   return QuadraticPathComponent(3.0 * (cp1 - p1), 3.0 * (cp2 - cp1),
                                 3.0 * (p2 - cp2));
@@ -180,33 +252,9 @@ CubicPathComponent CubicPathComponent::Subsegment(Scalar t0, Scalar t1) const {
 std::vector<QuadraticPathComponent>
 CubicPathComponent::ToQuadraticPathComponents(Scalar accuracy) const {
   std::vector<QuadraticPathComponent> quads;
-  // The maximum error, as a vector from the cubic to the best approximating
-  // quadratic, is proportional to the third derivative, which is constant
-  // across the segment. Thus, the error scales down as the third power of
-  // the number of subdivisions. Our strategy then is to subdivide `t` evenly.
-  //
-  // This is an overestimate of the error because only the component
-  // perpendicular to the first derivative is important. But the simplicity is
-  // appealing.
-
-  // This magic number is the square of 36 / sqrt(3).
-  // See: http://caffeineowl.com/graphics/2d/vectorial/cubic2quad01.html
-  auto max_hypot2 = 432.0 * accuracy * accuracy;
-  auto p1x2 = 3.0 * cp1 - p1;
-  auto p2x2 = 3.0 * cp2 - p2;
-  auto p = p2x2 - p1x2;
-  auto err = p.Dot(p);
-  auto quad_count = std::max(1., ceil(pow(err / max_hypot2, 1. / 6.0)));
-
-  for (size_t i = 0; i < quad_count; i++) {
-    auto t0 = i / quad_count;
-    auto t1 = (i + 1) / quad_count;
-    auto seg = Subsegment(t0, t1);
-    auto p1x2 = 3.0 * seg.cp1 - seg.p1;
-    auto p2x2 = 3.0 * seg.cp2 - seg.p2;
-    quads.emplace_back(
-        QuadraticPathComponent(seg.p1, ((p1x2 + p2x2) / 4.0), seg.p2));
-  }
+  EnumerateQuadraticPathComponents(
+      *this, accuracy,
+      [&quads](const QuadraticPathComponent& quad) { quads.push_back(quad); });
   return quads;
 }
 
@@ -106,6 +106,9 @@ struct CubicPathComponent {
   std::vector<Point> CreatePolyline(
       Scalar tolerance = kDefaultCurveTolerance) const;
 
+  void FillPointsForPolyline(std::vector<Point>& points,
+                             Scalar tolerance = kDefaultCurveTolerance) const;
+
   std::vector<Point> Extrema() const;
 
   std::vector<QuadraticPathComponent> ToQuadraticPathComponents(
@@ -0,0 +1,155 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <cmath>
+
+#include "impeller/geometry/scalar.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMPELLER_SIMD_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+// 32-bit ARM NEON has no division or square root, so it uses the fallback.
+#define IMPELLER_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      Four scalars that are computed together, with SSE2 on x86 and
+///             NEON on arm64, and one after the other on other targets.
+///
+///             Meant for loops whose iterations don't depend on each other,
+///             such as the ones that solve a curve at many times.
+///
+class Float32x4 {
+ public:
+  explicit Float32x4(Scalar value) {
+#if IMPELLER_SIMD_SSE2
+    value_ = _mm_set1_ps(value);
+#elif IMPELLER_SIMD_NEON
+    value_ = vdupq_n_f32(value);
+#else
+    for (auto& lane : value_) {
+      lane = value;
+    }
+#endif
+  }
+
+  Float32x4(Scalar a, Scalar b, Scalar c, Scalar d) {
+#if IMPELLER_SIMD_SSE2
+    value_ = _mm_setr_ps(a, b, c, d);
+#elif IMPELLER_SIMD_NEON
+    const float lanes[4] = {a, b, c, d};
+    value_ = vld1q_f32(lanes);
+#else
+    value_[0] = a;
+    value_[1] = b;
+    value_[2] = c;
+    value_[3] = d;
+#endif
+  }
+
+  /// Writes the four lanes to |values|.
+  void Store(Scalar* values) const {
+#if IMPELLER_SIMD_SSE2
+    _mm_storeu_ps(values, value_);
+#elif IMPELLER_SIMD_NEON
+    vst1q_f32(values, value_);
+#else
+    for (int i = 0; i < 4; i++) {
+      values[i] = value_[i];
+    }
+#endif
+  }
+
+  Float32x4 Sqrt() const {
+#if IMPELLER_SIMD_SSE2
+    return Float32x4(_mm_sqrt_ps(value_));
+#elif IMPELLER_SIMD_NEON
+    return Float32x4(vsqrtq_f32(value_));
+#else
+    return Map([](Scalar lane) { return std::sqrt(lane); });
+#endif
+  }
+
+  Float32x4 operator+(const Float32x4& o) const {
+#if IMPELLER_SIMD_SSE2
+    return Float32x4(_mm_add_ps(value_, o.value_));
+#elif IMPELLER_SIMD_NEON
+    return Float32x4(vaddq_f32(value_, o.value_));
+#else
+    return Zip(o, [](Scalar a, Scalar b) { return a + b; });
+#endif
+  }
+
+  Float32x4 operator-(const Float32x4& o) const {
+#if IMPELLER_SIMD_SSE2
+    return Float32x4(_mm_sub_ps(value_, o.value_));
+#elif IMPELLER_SIMD_NEON
+    return Float32x4(vsubq_f32(value_, o.value_));
+#else
+    return Zip(o, [](Scalar a, Scalar b) { return a - b; });
+#endif
+  }
+
+  Float32x4 operator*(const Float32x4& o) const {
+#if IMPELLER_SIMD_SSE2
+    return Float32x4(_mm_mul_ps(value_, o.value_));
+#elif IMPELLER_SIMD_NEON
+    return Float32x4(vmulq_f32(value_, o.value_));
+#else
+    return Zip(o, [](Scalar a, Scalar b) { return a * b; });
+#endif
+  }
+
+  Float32x4 operator/(const Float32x4& o) const {
+#if IMPELLER_SIMD_SSE2
+    return Float32x4(_mm_div_ps(value_, o.value_));
+#elif IMPELLER_SIMD_NEON
+    return Float32x4(vdivq_f32(value_, o.value_));
+#else
+    return Zip(o, [](Scalar a, Scalar b) { return a / b; });
+#endif
+  }
+
+ private:
+#if IMPELLER_SIMD_SSE2
+  __m128 value_;
+
+  explicit Float32x4(__m128 value) : value_(value) {}
+#elif IMPELLER_SIMD_NEON
+  float32x4_t value_;
+
+  explicit Float32x4(float32x4_t value) : value_(value) {}
+#else
+  Scalar value_[4];
+
+  Float32x4() = default;
+
+  template <class Function>
+  Float32x4 Map(const Function& function) const {
+    Float32x4 result;
+    for (int i = 0; i < 4; i++) {
+      result.value_[i] = function(value_[i]);
+    }
+    return result;
+  }
+
+  template <class Function>
+  Float32x4 Zip(const Float32x4& o, const Function& function) const {
+    Float32x4 result;
+    for (int i = 0; i < 4; i++) {
+      result.value_[i] = function(value_[i], o.value_[i]);
+    }
+    return result;
+  }
+#endif
+};
+
+}  // namespace impeller
@@ -71,7 +71,7 @@ PlaygroundImplVK::PlaygroundImplVK()
   auto context = ContextVK::Create(reinterpret_cast<PFN_vkGetInstanceProcAddr>(
                                        &::glfwGetInstanceProcAddress),    //
                                    ShaderLibraryMappingsForPlayground(),  //
-                                   nullptr,                               //
+                                   fml::UniqueFD{},                       //
                                    concurrent_loop_->GetTaskRunner(),     //
                                    "Playground Library"                   //
   );
@@ -4,8 +4,10 @@
 
 #include "impeller/renderer/backend/gles/texture_gles.h"
 
+#include <cstring>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "flutter/fml/mapping.h"
 #include "flutter/fml/trace_event.h"
@@ -267,6 +269,116 @@ bool TextureGLES::OnSetContents(std::shared_ptr<const fml::Mapping> mapping,
   return contents_initialized_;
 }
 
+// |Texture|
+bool TextureGLES::OnSetContents(const uint8_t* contents,
+                                const IRect& region,
+                                size_t bytes_per_row,
+                                size_t slice) {
+  if (GetType() != Type::kTexture) {
+    VALIDATION_LOG << "Incorrect texture usage flags for setting contents on "
+                      "this texture object.";
+    return false;
+  }
+
+  if (is_wrapped_) {
+    VALIDATION_LOG << "Cannot set the contents of a wrapped texture.";
+    return false;
+  }
+
+  const auto& tex_descriptor = GetTextureDescriptor();
+
+  GLenum texture_type;
+  GLenum texture_target;
+  switch (tex_descriptor.type) {
+    case TextureType::kTexture2D:
+      texture_type = GL_TEXTURE_2D;
+      texture_target = GL_TEXTURE_2D;
+      break;
+    case TextureType::kTexture2DMultisample:
+      VALIDATION_LOG << "Multisample texture uploading is not supported for "
+                        "the OpenGLES backend.";
+      return false;
+    case TextureType::kTextureCube:
+      texture_type = GL_TEXTURE_CUBE_MAP;
+      texture_target = GL_TEXTURE_CUBE_MAP_POSITIVE_X + slice;
+      break;
+  }
+
+  // The upload happens later on the reactor, and OpenGL ES 2 can't skip the
+  // rest of a row, so the rows of the region are copied next to each other.
+  const size_t region_bytes_per_row =
+      region.size.width * BytesPerPixelForPixelFormat(tex_descriptor.format);
+  std::vector<uint8_t> region_contents(region_bytes_per_row *
+                                       region.size.height);
+  for (int64_t row = 0; row < region.size.height; row++) {
+    memcpy(region_contents.data() + row * region_bytes_per_row,
+           contents + row * bytes_per_row, region_bytes_per_row);
+  }
+  auto data = std::make_shared<TexImage2DData>(
+      tex_descriptor.format,
+      std::make_shared<fml::DataMapping>(std::move(region_contents)));
+  if (!data || !data->IsValid()) {
+    VALIDATION_LOG << "Invalid texture format.";
+    return false;
+  }
+
+  // Allocates the texture first if its contents were never set.
+  const bool initialize = !contents_initialized_;
+  ReactorGLES::Operation texture_upload = [handle = handle_,            //
+                                           data,                        //
+                                           region,                      //
+                                           size = tex_descriptor.size,  //
+                                           initialize,                  //
+                                           texture_type,                //
+                                           texture_target               //
+  ](const auto& reactor) {
+    auto gl_handle = reactor.GetGLHandle(handle);
+    if (!gl_handle.has_value()) {
+      VALIDATION_LOG
+          << "Texture was collected before it could be uploaded to the GPU.";
+      return;
+    }
+    const auto& gl = reactor.GetProcTable();
+    gl.BindTexture(texture_type, gl_handle.value());
+    if (initialize) {
+      gl.TexImage2D(texture_target,         // target
+                    0u,                     // LOD level
+                    data->internal_format,  // internal format
+                    size.width,             // width
+                    size.height,            // height
+                    0u,                     // border
+                    data->external_format,  // external format
+                    data->type,             // type
+                    nullptr                 // data
+      );
+    }
+
+    {
+      TRACE_EVENT1("impeller", "TexSubImage2DUpload", "Bytes",
+                   std::to_string(data->data->GetSize()).c_str());
+      // The rows of the region are not padded to 4 bytes.
+      gl.PixelStorei(GL_UNPACK_ALIGNMENT, 1);
+      gl.TexSubImage2D(texture_target,           // target
+                       0u,                       // LOD level
+                       region.origin.x,          // x offset
+                       region.origin.y,          // y offset
+                       region.size.width,        // width
+                       region.size.height,       // height
+                       data->external_format,    // external format
+                       data->type,               // type
+                       data->data->GetMapping()  // data
+      );
+      gl.PixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    }
+  };
+
+  if (!reactor_->AddOperation(texture_upload)) {
+    return false;
+  }
+  contents_initialized_ = true;
+  return true;
+}
+
 // |Texture|
 ISize TextureGLES::GetSize() const {
   return GetTextureDescriptor().size;
@@ -78,6 +78,12 @@ class TextureGLES final : public Texture,
   bool OnSetContents(std::shared_ptr<const fml::Mapping> mapping,
                      size_t slice) override;
 
+  // |Texture|
+  bool OnSetContents(const uint8_t* contents,
+                     const IRect& region,
+                     size_t bytes_per_row,
+                     size_t slice) override;
+
   // |Texture|
   bool IsValid() const override;
 
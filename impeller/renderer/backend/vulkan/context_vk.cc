@@ -216,13 +216,13 @@ static std::optional<QueueVK> PickPresentQueue(const vk::PhysicalDevice& device,
 std::shared_ptr<ContextVK> ContextVK::Create(
     PFN_vkGetInstanceProcAddr proc_address_callback,
     const std::vector<std::shared_ptr<fml::Mapping>>& shader_libraries_data,
-    const std::shared_ptr<const fml::Mapping>& pipeline_cache_data,
+    fml::UniqueFD cache_directory,
     std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner,
     const std::string& label) {
   auto context = std::shared_ptr<ContextVK>(new ContextVK(
       proc_address_callback,          //
       shader_libraries_data,          //
-      pipeline_cache_data,            //
+      std::move(cache_directory),     //
       std::move(worker_task_runner),  //
       label                           //
       ));
@@ -235,7 +235,7 @@ std::shared_ptr<ContextVK> ContextVK::Create(
 ContextVK::ContextVK(
     PFN_vkGetInstanceProcAddr proc_address_callback,
     const std::vector<std::shared_ptr<fml::Mapping>>& shader_libraries_data,
-    const std::shared_ptr<const fml::Mapping>& pipeline_cache_data,
+    fml::UniqueFD cache_directory,
     std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner,
     const std::string& label)
     : worker_task_runner_(std::move(worker_task_runner)) {
@@ -447,10 +447,13 @@ ContextVK::ContextVK(
     return;
   }
 
+  auto pipeline_cache = std::make_unique<PipelineCacheVK>(
+      physical_device->getProperties(), std::move(cache_directory));
+
   auto pipeline_library = std::shared_ptr<PipelineLibraryVK>(
-      new PipelineLibraryVK(device.value.get(),   //
-                            pipeline_cache_data,  //
-                            worker_task_runner_   //
+      new PipelineLibraryVK(device.value.get(),         //
+                            std::move(pipeline_cache),  //
+                            worker_task_runner_         //
                             ));
 
   if (!pipeline_library->IsValid()) {
@@ -496,7 +499,11 @@ ContextVK::ContextVK(
   is_valid_ = true;
 }
 
-ContextVK::~ContextVK() = default;
+ContextVK::~ContextVK() {
+  if (pipeline_library_) {
+    pipeline_library_->PersistPipelineCacheToDisk();
+  }
+}
 
 bool ContextVK::IsValid() const {
   return is_valid_;
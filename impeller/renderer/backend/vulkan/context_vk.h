@@ -9,6 +9,7 @@
 #include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
 #include "impeller/base/backend_cast.h"
 #include "impeller/renderer/backend/vulkan/command_pool_vk.h"
 #include "impeller/renderer/backend/vulkan/descriptor_pool_vk.h"
@@ -34,10 +35,17 @@ bool HasValidationLayers();
 
 class ContextVK final : public Context, public BackendCast<ContextVK, Context> {
  public:
+  //----------------------------------------------------------------------------
+  /// @brief      Create a Vulkan context.
+  ///
+  /// @param[in]  cache_directory  The directory to persist the pipeline cache
+  ///                              in across runs. It isn't persisted if the
+  ///                              directory is invalid.
+  ///
   static std::shared_ptr<ContextVK> Create(
       PFN_vkGetInstanceProcAddr proc_address_callback,
       const std::vector<std::shared_ptr<fml::Mapping>>& shader_libraries_data,
-      const std::shared_ptr<const fml::Mapping>& pipeline_cache_data,
+      fml::UniqueFD cache_directory,
       std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner,
       const std::string& label);
 
@@ -117,7 +125,7 @@ class ContextVK final : public Context, public BackendCast<ContextVK, Context> {
   ContextVK(
       PFN_vkGetInstanceProcAddr proc_address_callback,
       const std::vector<std::shared_ptr<fml::Mapping>>& shader_libraries_data,
-      const std::shared_ptr<const fml::Mapping>& pipeline_cache_data,
+      fml::UniqueFD cache_directory,
       std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner,
       const std::string& label);
 
@@ -0,0 +1,100 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/renderer/backend/vulkan/pipeline_cache_vk.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/trace_event.h"
+
+namespace impeller {
+
+// "IPVK" in little endian. Bump it when the header changes.
+static constexpr uint32_t kPipelineCacheMagic = 0x4B565049;
+
+PipelineCacheVK::PipelineCacheVK(const vk::PhysicalDeviceProperties& properties,
+                                 fml::UniqueFD cache_directory)
+    : cache_directory_(std::move(cache_directory)) {
+  header_.magic = kPipelineCacheMagic;
+  header_.pointer_size = sizeof(void*);
+  header_.vendor_id = properties.vendorID;
+  header_.device_id = properties.deviceID;
+  header_.driver_version = properties.driverVersion;
+  std::copy(properties.pipelineCacheUUID.begin(),
+            properties.pipelineCacheUUID.end(), header_.pipeline_cache_uuid);
+}
+
+PipelineCacheVK::~PipelineCacheVK() = default;
+
+bool PipelineCacheVK::IsValid() const {
+  return cache_directory_.is_valid();
+}
+
+std::unique_ptr<fml::Mapping> PipelineCacheVK::ReadCacheData() const {
+  if (!IsValid()) {
+    return nullptr;
+  }
+  TRACE_EVENT0("impeller", "PipelineCacheVK::ReadCacheData");
+
+  std::shared_ptr<fml::FileMapping> file =
+      fml::FileMapping::CreateReadOnly(cache_directory_, kCacheFileName);
+  if (!file || !file->GetMapping() || file->GetSize() < sizeof(Header)) {
+    return nullptr;
+  }
+
+  Header header;
+  std::memcpy(&header, file->GetMapping(), sizeof(Header));
+  if (!header_.IsCompatibleWith(header)) {
+    FML_LOG(INFO) << "Ignoring the Vulkan pipeline cache of another device or "
+                     "driver.";
+    return nullptr;
+  }
+  if (header.data_size == 0 ||
+      header.data_size != file->GetSize() - sizeof(Header)) {
+    FML_LOG(ERROR) << "Ignoring a truncated Vulkan pipeline cache.";
+    return nullptr;
+  }
+
+  return std::make_unique<fml::NonOwnedMapping>(
+      file->GetMapping() + sizeof(Header),          // data
+      header.data_size,                             // size
+      [file](auto, auto) mutable { file.reset(); }  // proc
+  );
+}
+
+bool PipelineCacheVK::WriteCacheData(const std::vector<uint8_t>& data) const {
+  if (!IsValid() || data.empty()) {
+    return false;
+  }
+  TRACE_EVENT0("impeller", "PipelineCacheVK::WriteCacheData");
+
+  Header header = header_;
+  header.data_size = data.size();
+
+  std::vector<uint8_t> contents(sizeof(Header) + data.size());
+  std::memcpy(contents.data(), &header, sizeof(Header));
+  std::memcpy(contents.data() + sizeof(Header), data.data(), data.size());
+  fml::DataMapping mapping(std::move(contents));
+
+  Lock lock(write_mutex_);
+  if (!fml::WriteAtomically(cache_directory_, kCacheFileName, mapping)) {
+    FML_LOG(ERROR) << "Could not write the Vulkan pipeline cache.";
+    return false;
+  }
+  return true;
+}
+
+bool PipelineCacheVK::Header::IsCompatibleWith(const Header& other) const {
+  return magic == other.magic &&                    //
+         pointer_size == other.pointer_size &&      //
+         vendor_id == other.vendor_id &&            //
+         device_id == other.device_id &&            //
+         driver_version == other.driver_version &&  //
+         std::memcmp(pipeline_cache_uuid, other.pipeline_cache_uuid,
+                     VK_UUID_SIZE) == 0;
+}
+
+}  // namespace impeller
@@ -0,0 +1,93 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+#include "impeller/base/thread.h"
+#include "impeller/renderer/backend/vulkan/vk.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      Reads and writes the data of a Vulkan pipeline cache in a
+///             directory, so that the pipelines compiled by one run of the
+///             application are not compiled again by the next one.
+///
+///             The data is written after a header that identifies the device
+///             and the driver that created it. Data that another device or
+///             driver created, or that was cut short, is ignored when it is
+///             read instead of being handed to the driver.
+///
+class PipelineCacheVK {
+ public:
+  static constexpr const char* kCacheFileName = "flutter.impeller.vkcache";
+
+  //----------------------------------------------------------------------------
+  /// @param[in]  properties       The properties of the physical device the
+  ///                              pipelines are created on.
+  /// @param[in]  cache_directory  The directory of the cache file. The cache
+  ///                              isn't read or written if it is invalid.
+  ///
+  PipelineCacheVK(const vk::PhysicalDeviceProperties& properties,
+                  fml::UniqueFD cache_directory);
+
+  ~PipelineCacheVK();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether there is a directory to read and write the cache in.
+  ///
+  bool IsValid() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Read the data of the pipeline cache written by a previous run
+  ///             on the same device and driver.
+  ///
+  /// @return     The data to create the pipeline cache with, or nullptr if
+  ///             there is none.
+  ///
+  std::unique_ptr<fml::Mapping> ReadCacheData() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Replace the data written by the previous runs with the data
+  ///             of the pipeline cache. Can be called from any thread.
+  ///
+  /// @param[in]  data  The data, as returned by `vkGetPipelineCacheData`.
+  ///
+  /// @return     If the data was written.
+  ///
+  bool WriteCacheData(const std::vector<uint8_t>& data) const;
+
+ private:
+  struct Header {
+    uint32_t magic = 0;
+    uint32_t pointer_size = 0;
+    uint32_t vendor_id = 0;
+    uint32_t device_id = 0;
+    uint32_t driver_version = 0;
+    uint8_t pipeline_cache_uuid[VK_UUID_SIZE] = {};
+    // Takes the place of the padding before |data_size|, so that no bytes of
+    // the header are written uninitialized.
+    uint32_t reserved = 0;
+    uint64_t data_size = 0;
+
+    bool IsCompatibleWith(const Header& other) const;
+  };
+  static_assert(sizeof(Header) == 48, "The header must have no padding.");
+
+  Header header_;
+  const fml::UniqueFD cache_directory_;
+  // Writes of the file from different threads would race on its temporary
+  // file.
+  mutable Mutex write_mutex_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PipelineCacheVK);
+};
+
+}  // namespace impeller
@@ -0,0 +1,107 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/file.h"
+#include "flutter/testing/testing.h"
+#include "gtest/gtest.h"
+#include "impeller/renderer/backend/vulkan/pipeline_cache_vk.h"
+
+namespace impeller {
+namespace testing {
+
+static vk::PhysicalDeviceProperties CreateProperties() {
+  vk::PhysicalDeviceProperties properties;
+  properties.vendorID = 0x1234;
+  properties.deviceID = 0x5678;
+  properties.driverVersion = 42;
+  for (size_t i = 0; i < VK_UUID_SIZE; i++) {
+    properties.pipelineCacheUUID[i] = static_cast<uint8_t>(i);
+  }
+  return properties;
+}
+
+static fml::UniqueFD OpenCacheDirectory(
+    const fml::ScopedTemporaryDirectory& directory) {
+  return fml::OpenDirectory(directory.path().c_str(), false,
+                            fml::FilePermission::kReadWrite);
+}
+
+static const std::vector<uint8_t> kCacheData = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+TEST(PipelineCacheVKTest, ReadsTheDataItWrote) {
+  fml::ScopedTemporaryDirectory directory;
+  {
+    PipelineCacheVK cache(CreateProperties(), OpenCacheDirectory(directory));
+    ASSERT_TRUE(cache.IsValid());
+    ASSERT_EQ(cache.ReadCacheData(), nullptr);
+    ASSERT_TRUE(cache.WriteCacheData(kCacheData));
+  }
+
+  // The next run on the same device and driver reads it.
+  PipelineCacheVK cache(CreateProperties(), OpenCacheDirectory(directory));
+  auto data = cache.ReadCacheData();
+  ASSERT_NE(data, nullptr);
+  ASSERT_EQ(std::vector<uint8_t>(data->GetMapping(),
+                                 data->GetMapping() + data->GetSize()),
+            kCacheData);
+}
+
+TEST(PipelineCacheVKTest, IgnoresTheDataOfAnotherDeviceOrDriver) {
+  fml::ScopedTemporaryDirectory directory;
+  {
+    PipelineCacheVK cache(CreateProperties(), OpenCacheDirectory(directory));
+    ASSERT_TRUE(cache.WriteCacheData(kCacheData));
+  }
+
+  auto other_uuid = CreateProperties();
+  other_uuid.pipelineCacheUUID[VK_UUID_SIZE - 1] ^= 0xff;
+  ASSERT_EQ(PipelineCacheVK(other_uuid, OpenCacheDirectory(directory))
+                .ReadCacheData(),
+            nullptr);
+
+  auto other_driver = CreateProperties();
+  other_driver.driverVersion++;
+  ASSERT_EQ(PipelineCacheVK(other_driver, OpenCacheDirectory(directory))
+                .ReadCacheData(),
+            nullptr);
+
+  auto other_device = CreateProperties();
+  other_device.deviceID++;
+  ASSERT_EQ(PipelineCacheVK(other_device, OpenCacheDirectory(directory))
+                .ReadCacheData(),
+            nullptr);
+}
+
+TEST(PipelineCacheVKTest, IgnoresTruncatedData) {
+  fml::ScopedTemporaryDirectory directory;
+  PipelineCacheVK cache(CreateProperties(), OpenCacheDirectory(directory));
+  ASSERT_TRUE(cache.WriteCacheData(kCacheData));
+
+  auto directory_fd = OpenCacheDirectory(directory);
+  auto file = fml::FileMapping::CreateReadOnly(directory_fd,
+                                               PipelineCacheVK::kCacheFileName);
+  ASSERT_NE(file, nullptr);
+  const std::vector<uint8_t> contents(file->GetMapping(),
+                                      file->GetMapping() + file->GetSize());
+  file.reset();
+
+  // Cut short in the data, then in the header.
+  for (size_t size : {contents.size() - 1, size_t{8}}) {
+    fml::DataMapping truncated(
+        std::vector<uint8_t>(contents.begin(), contents.begin() + size));
+    ASSERT_TRUE(fml::WriteAtomically(
+        directory_fd, PipelineCacheVK::kCacheFileName, truncated));
+    ASSERT_EQ(cache.ReadCacheData(), nullptr);
+  }
+}
+
+TEST(PipelineCacheVKTest, DoesNothingWithoutADirectory) {
+  PipelineCacheVK cache(CreateProperties(), fml::UniqueFD{});
+  ASSERT_FALSE(cache.IsValid());
+  ASSERT_FALSE(cache.WriteCacheData(kCacheData));
+  ASSERT_EQ(cache.ReadCacheData(), nullptr);
+}
+
+}  // namespace testing
+}  // namespace impeller
@@ -20,15 +20,17 @@ namespace impeller {
 
 PipelineLibraryVK::PipelineLibraryVK(
     const vk::Device& device,
-    const std::shared_ptr<const fml::Mapping>& pipeline_cache_data,
+    std::unique_ptr<PipelineCacheVK> pipeline_cache,
     std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner)
-    : worker_task_runner_(std::move(worker_task_runner)) {
-  if (!worker_task_runner_) {
+    : pipeline_cache_(std::move(pipeline_cache)),
+      worker_task_runner_(std::move(worker_task_runner)) {
+  if (!pipeline_cache_ || !worker_task_runner_) {
     return;
   }
 
   vk::PipelineCacheCreateInfo cache_info;
 
+  auto pipeline_cache_data = pipeline_cache_->ReadCacheData();
   if (pipeline_cache_data) {
     cache_info.pInitialData = pipeline_cache_data->GetMapping();
     cache_info.initialDataSize = pipeline_cache_data->GetSize();
@@ -36,6 +38,15 @@ PipelineLibraryVK::PipelineLibraryVK(
 
   auto cache = device.createPipelineCacheUnique(cache_info);
 
+  if (cache.result != vk::Result::eSuccess && pipeline_cache_data) {
+    // Drivers should ignore data they can't use, but start from scratch if
+    // one fails instead.
+    FML_LOG(ERROR) << "Could not create pipeline cache with the data of the "
+                      "previous run: "
+                   << vk::to_string(cache.result);
+    cache = device.createPipelineCacheUnique(vk::PipelineCacheCreateInfo{});
+  }
+
   if (cache.result != vk::Result::eSuccess) {
     VALIDATION_LOG << "Could not create pipeline cache.";
     return;
@@ -75,6 +86,7 @@ PipelineFuture<PipelineDescriptor> PipelineLibraryVK::GetPipeline(
 
   auto weak_this = weak_from_this();
 
+  pending_pipeline_count_++;
   worker_task_runner_->PostTask([descriptor, weak_this, promise]() {
     auto thiz = weak_this.lock();
     if (!thiz) {
@@ -83,15 +95,44 @@ PipelineFuture<PipelineDescriptor> PipelineLibraryVK::GetPipeline(
                         "could be created.";
       return;
     }
-    auto pipeline_create_info =
-        PipelineLibraryVK::Cast(thiz.get())->CreatePipeline(descriptor);
+    auto library = PipelineLibraryVK::Cast(thiz.get());
+    auto pipeline_create_info = library->CreatePipeline(descriptor);
     promise->set_value(std::make_shared<PipelineVK>(
         weak_this, descriptor, std::move(pipeline_create_info)));
+    library->DidCreatePipeline();
   });
 
   return pipeline_future;
 }
 
+void PipelineLibraryVK::DidCreatePipeline() {
+  if (--pending_pipeline_count_ != 0u || !pipeline_cache_->IsValid()) {
+    return;
+  }
+  // The worker that created the last pipeline is free to write the cache.
+  PersistPipelineCacheToDisk();
+}
+
+void PipelineLibraryVK::PersistPipelineCacheToDisk() {
+  if (!IsValid() || !pipeline_cache_->IsValid()) {
+    return;
+  }
+  TRACE_EVENT0("impeller", "PipelineLibraryVK::PersistPipelineCacheToDisk");
+  std::vector<uint8_t> data;
+  {
+    // See the note in the header about why this is a writer lock.
+    WriterLock lock(cache_mutex_);
+    auto result = device_.getPipelineCacheData(cache_.get());
+    if (result.result != vk::Result::eSuccess) {
+      VALIDATION_LOG << "Could not get the pipeline cache data: "
+                     << vk::to_string(result.result);
+      return;
+    }
+    data = std::move(result.value);
+  }
+  pipeline_cache_->WriteCacheData(data);
+}
+
 // |PipelineLibrary|
 PipelineFuture<ComputePipelineDescriptor> PipelineLibraryVK::GetPipeline(
     ComputePipelineDescriptor descriptor) {
@@ -4,11 +4,14 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/mapping.h"
 #include "impeller/base/backend_cast.h"
 #include "impeller/base/thread.h"
+#include "impeller/renderer/backend/vulkan/pipeline_cache_vk.h"
 #include "impeller/renderer/backend/vulkan/pipeline_vk.h"
 #include "impeller/renderer/backend/vulkan/vk.h"
 #include "impeller/renderer/pipeline_library.h"
@@ -37,14 +40,19 @@ class PipelineLibraryVK final
   // necessary when fetching pipeline cache data for persisting to disk.
   mutable RWMutex cache_mutex_;
   vk::UniquePipelineCache cache_ IPLR_GUARDED_BY(cache_mutex_);
+  std::unique_ptr<PipelineCacheVK> pipeline_cache_;
   std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner_;
   Mutex pipelines_mutex_;
   PipelineMap pipelines_ IPLR_GUARDED_BY(pipelines_mutex_);
+  // The pipelines being created on the workers. The worker that creates the
+  // last of them persists the pipeline cache, so that a burst of pipelines,
+  // like the ones of a new content context, writes the cache once.
+  std::atomic_size_t pending_pipeline_count_ = 0u;
   bool is_valid_ = false;
 
   PipelineLibraryVK(
       const vk::Device& device,
-      const std::shared_ptr<const fml::Mapping>& pipeline_cache_data,
+      std::unique_ptr<PipelineCacheVK> pipeline_cache,
       std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner);
 
   // |PipelineLibrary|
@@ -68,6 +76,14 @@ class PipelineLibraryVK final
   std::optional<vk::UniqueRenderPass> CreateRenderPass(
       const PipelineDescriptor& desc);
 
+  void DidCreatePipeline();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Write the data of the pipeline cache to the cache directory,
+  ///             if there is one, for the next run of the application.
+  ///
+  void PersistPipelineCacheToDisk();
+
   FML_DISALLOW_COPY_AND_ASSIGN(PipelineLibraryVK);
 };
 
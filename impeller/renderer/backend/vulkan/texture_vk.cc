@@ -63,6 +63,39 @@ bool TextureVK::OnSetContents(std::shared_ptr<const fml::Mapping> mapping,
   return OnSetContents(mapping->GetMapping(), mapping->GetSize(), slice);
 }
 
+bool TextureVK::OnSetContents(const uint8_t* contents,
+                              const IRect& region,
+                              size_t bytes_per_row,
+                              size_t slice) {
+  if (IsWrapped()) {
+    FML_LOG(ERROR) << "Cannot set contents of a wrapped texture";
+    return false;
+  }
+
+  if (!IsValid()) {
+    return false;
+  }
+
+  // The staging buffer holds the whole base mip level and is copied to the
+  // image when the texture is used, so only the rows of the region are
+  // written into it.
+  auto mapping = static_cast<uint8_t*>(
+      texture_info_->allocated_texture.staging_buffer.GetMapping());
+  if (!mapping) {
+    return false;
+  }
+
+  const auto& desc = GetTextureDescriptor();
+  const size_t bytes_per_pixel = BytesPerPixelForPixelFormat(desc.format);
+  const size_t region_bytes_per_row = region.size.width * bytes_per_pixel;
+  for (int64_t row = 0; row < region.size.height; row++) {
+    memcpy(mapping + (region.origin.y + row) * desc.GetBytesPerRow() +
+               region.origin.x * bytes_per_pixel,
+           contents + row * bytes_per_row, region_bytes_per_row);
+  }
+  return true;
+}
+
 bool TextureVK::IsValid() const {
   switch (texture_info_->backing_type) {
     case TextureBackingTypeVK::kUnknownType:
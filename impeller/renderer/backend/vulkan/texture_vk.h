@@ -75,6 +75,12 @@ class TextureVK final : public Texture, public BackendCast<TextureVK, Texture> {
   bool OnSetContents(std::shared_ptr<const fml::Mapping> mapping,
                      size_t slice) override;
 
+  // |Texture|
+  bool OnSetContents(const uint8_t* contents,
+                     const IRect& region,
+                     size_t bytes_per_row,
+                     size_t slice) override;
+
   // |Texture|
   bool IsValid() const override;
 
@@ -4,6 +4,7 @@
 
 #include "flutter/testing/testing.h"
 #include "impeller/base/strings.h"
+#include "impeller/base/validation.h"
 #include "impeller/fixtures/array.frag.h"
 #include "impeller/fixtures/array.vert.h"
 #include "impeller/fixtures/box_fade.frag.h"
@@ -995,6 +996,40 @@ TEST_P(RendererTest, CanCreateCPUBackedTexture) {
   } while (dimension <= 8192);
 }
 
+TEST_P(RendererTest, CanSetContentsOfTextureRegion) {
+  auto context = GetContext();
+  ASSERT_TRUE(context);
+
+  TextureDescriptor texture_desc;
+  texture_desc.storage_mode = StorageMode::kHostVisible;
+  texture_desc.format = PixelFormat::kR8G8B8A8UNormInt;
+  texture_desc.size = {16, 16};
+  auto texture = context->GetResourceAllocator()->CreateTexture(texture_desc);
+  ASSERT_TRUE(texture);
+
+  // The region is read from rows of the size of the whole texture.
+  std::vector<uint8_t> contents(texture_desc.GetByteSizeOfBaseMipLevel(),
+                                0xff);
+  const size_t bytes_per_row = texture_desc.GetBytesPerRow();
+  ASSERT_TRUE(texture->SetContents(contents.data(), contents.size(),
+                                   IRect::MakeXYWH(4, 4, 8, 2),
+                                   bytes_per_row));
+
+  ScopedValidationDisable disable_validation;
+  // Regions outside of the texture.
+  ASSERT_FALSE(texture->SetContents(contents.data(), contents.size(),
+                                    IRect::MakeXYWH(12, 12, 8, 8),
+                                    bytes_per_row));
+  ASSERT_FALSE(texture->SetContents(contents.data(), contents.size(),
+                                    IRect::MakeXYWH(-1, 0, 4, 4),
+                                    bytes_per_row));
+  // Rows shorter than the region, and too few bytes for its last row.
+  ASSERT_FALSE(texture->SetContents(contents.data(), contents.size(),
+                                    IRect::MakeXYWH(0, 0, 8, 2), 8 * 4 - 1));
+  ASSERT_FALSE(texture->SetContents(contents.data(), 8 * 4 * 2 - 1,
+                                    IRect::MakeXYWH(0, 0, 8, 2), 8 * 4));
+}
+
 TEST_P(RendererTest, DefaultIndexSize) {
   using VS = BoxFadeVertexShader;
 
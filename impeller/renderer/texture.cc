@@ -42,6 +42,35 @@ bool Texture::SetContents(std::shared_ptr<const fml::Mapping> mapping,
   return true;
 }
 
+bool Texture::SetContents(const uint8_t* contents,
+                          size_t length,
+                          const IRect& region,
+                          size_t bytes_per_row,
+                          size_t slice) {
+  if (!IsSliceValid(slice)) {
+    VALIDATION_LOG << "Invalid slice for texture.";
+    return false;
+  }
+  if (!contents || region.IsEmpty() ||
+      !IRect::MakeSize(desc_.size).Contains(region)) {
+    VALIDATION_LOG << "Invalid region for texture contents.";
+    return false;
+  }
+  const size_t region_bytes_per_row =
+      region.size.width * BytesPerPixelForPixelFormat(desc_.format);
+  if (bytes_per_row < region_bytes_per_row ||
+      length < bytes_per_row * (region.size.height - 1) +
+                   region_bytes_per_row) {
+    VALIDATION_LOG << "Texture contents are too small for the region.";
+    return false;
+  }
+  if (!OnSetContents(contents, region, bytes_per_row, slice)) {
+    return false;
+  }
+  intent_ = TextureIntent::kUploadFromHost;
+  return true;
+}
+
 size_t Texture::GetMipCount() const {
   return GetTextureDescriptor().mip_count;
 }
@@ -8,6 +8,7 @@
 
 #include "flutter/fml/macros.h"
 #include "flutter/fml/mapping.h"
+#include "impeller/geometry/rect.h"
 #include "impeller/geometry/size.h"
 #include "impeller/renderer/formats.h"
 #include "impeller/renderer/texture_descriptor.h"
@@ -27,6 +28,15 @@ class Texture {
   [[nodiscard]] bool SetContents(std::shared_ptr<const fml::Mapping> mapping,
                                  size_t slice = 0);
 
+  /// Replaces the texels of |region| in the base mip level of |slice| and
+  /// leaves the rest of the texture alone. |contents| holds the rows of the
+  /// region, |bytes_per_row| apart.
+  [[nodiscard]] bool SetContents(const uint8_t* contents,
+                                 size_t length,
+                                 const IRect& region,
+                                 size_t bytes_per_row,
+                                 size_t slice = 0);
+
   virtual bool IsValid() const = 0;
 
   virtual ISize GetSize() const = 0;
@@ -52,6 +62,11 @@ class Texture {
       std::shared_ptr<const fml::Mapping> mapping,
       size_t slice) = 0;
 
+  [[nodiscard]] virtual bool OnSetContents(const uint8_t* contents,
+                                           const IRect& region,
+                                           size_t bytes_per_row,
+                                           size_t slice) = 0;
+
  private:
   TextureIntent intent_ = TextureIntent::kRenderToTexture;
   const TextureDescriptor desc_;
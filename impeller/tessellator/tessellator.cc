@@ -4,6 +4,9 @@
 
 #include "impeller/tessellator/tessellator.h"
 
+#include <limits>
+#include <optional>
+
 #include "third_party/libtess2/Include/tesselator.h"
 
 namespace impeller {
@@ -64,6 +67,11 @@ Tessellator::Result Tessellator::Tessellate(
     return Result::kInputError;
   }
 
+  if ((fill_type == FillType::kNonZero || fill_type == FillType::kOdd) &&
+      IsConvex(polyline)) {
+    return TessellateConvex(polyline, callback);
+  }
+
   auto tessellator = c_tessellator_.get();
   if (!tessellator) {
     return Result::kTessellationError;
@@ -122,6 +130,100 @@ Tessellator::Result Tessellator::Tessellate(
   return Result::kSuccess;
 }
 
+// The number of points of the only contour of |polyline|, without the last
+// one if it closes the contour by repeating the first.
+static size_t GetConvexPointCount(const Path::Polyline& polyline) {
+  const auto& points = polyline.points;
+  if (points.size() > 1 && points.front() == points.back()) {
+    return points.size() - 1;
+  }
+  return points.size();
+}
+
+// Fans are indexed with 16 bit indices.
+static constexpr size_t kMaxConvexPointCount =
+    std::numeric_limits<uint16_t>::max() + 1u;
+
+Tessellator::Result Tessellator::TessellateConvex(
+    const Path::Polyline& polyline,
+    const BuilderCallback& callback) const {
+  if (!callback) {
+    return Result::kInputError;
+  }
+
+  const size_t point_count = GetConvexPointCount(polyline);
+  if (point_count == 0 || point_count > kMaxConvexPointCount) {
+    return Result::kInputError;
+  }
+
+  static_assert(sizeof(Point) == 2 * sizeof(float));
+  std::vector<uint16_t> indices;
+  if (point_count >= 3) {
+    indices.reserve((point_count - 2) * 3);
+    for (size_t i = 1; i + 1 < point_count; i++) {
+      indices.push_back(0);
+      indices.push_back(static_cast<uint16_t>(i));
+      indices.push_back(static_cast<uint16_t>(i + 1));
+    }
+  }
+  if (!callback(reinterpret_cast<const float*>(polyline.points.data()),
+                point_count * 2, indices.data(), indices.size())) {
+    return Result::kInputError;
+  }
+
+  return Result::kSuccess;
+}
+
+bool Tessellator::IsConvex(const Path::Polyline& polyline) {
+  if (polyline.contours.size() != 1) {
+    return false;
+  }
+  const auto& points = polyline.points;
+  const size_t point_count = GetConvexPointCount(polyline);
+  if (point_count < 3 || point_count > kMaxConvexPointCount) {
+    return false;
+  }
+
+  // Every turn of a convex polygon is in the same direction, and it only
+  // goes around once, so the sign of the x and y deltas of its edges only
+  // changes twice. Going around more than once, like a pentagram does, takes
+  // more changes. The first edge is visited twice so that the turn and the
+  // changes from the last edge to the first are counted.
+  std::optional<Point> previous_edge;
+  Scalar turn = 0;
+  Scalar previous_dx = 0;
+  Scalar previous_dy = 0;
+  size_t dx_changes = 0;
+  size_t dy_changes = 0;
+  for (size_t i = 0; i <= point_count; i++) {
+    const Point edge =
+        points[(i + 1) % point_count] - points[i % point_count];
+    if (edge.IsZero()) {
+      continue;
+    }
+    if (previous_edge.has_value()) {
+      const Scalar cross = previous_edge->Cross(edge);
+      if (cross * turn < 0) {
+        return false;
+      }
+      if (cross != 0) {
+        turn = cross;
+      }
+    }
+    previous_edge = edge;
+
+    if (edge.x != 0) {
+      dx_changes += edge.x * previous_dx < 0;
+      previous_dx = edge.x;
+    }
+    if (edge.y != 0) {
+      dy_changes += edge.y * previous_dy < 0;
+      previous_dy = edge.y;
+    }
+  }
+  return dx_changes <= 2 && dy_changes <= 2;
+}
+
 void DestroyTessellator(TESStesselator* tessellator) {
   if (tessellator != nullptr) {
     ::tessDeleteTess(tessellator);
@@ -52,6 +52,11 @@ class Tessellator {
   /// @brief      Generates filled triangles from the polyline. A callback is
   ///             invoked once for the entire tessellation.
   ///
+  ///             A polyline that is a single convex contour, which all rects,
+  ///             rounded rects and ovals are, is filled with a triangle fan.
+  ///             Other polylines go through the general tessellator, which is
+  ///             much slower.
+  ///
   /// @param[in]  fill_type The fill rule to use when filling.
   /// @param[in]  polyline  The polyline
   /// @param[in]  callback  The callback, return false to indicate failure.
@@ -62,6 +67,27 @@ class Tessellator {
                                  const Path::Polyline& polyline,
                                  const BuilderCallback& callback) const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Generates a triangle fan that fills the polyline, which must
+  ///             be a single convex contour, such as the polyline of a path
+  ///             with |Convexity::kConvex|. Either fill rule that fills the
+  ///             inside of a simple contour, |FillType::kNonZero| or
+  ///             |FillType::kOdd|, fills it the same way.
+  ///
+  /// @param[in]  polyline  The polyline
+  /// @param[in]  callback  The callback, return false to indicate failure.
+  ///
+  /// @return The result status of the tessellation.
+  ///
+  Tessellator::Result TessellateConvex(const Path::Polyline& polyline,
+                                       const BuilderCallback& callback) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether the polyline is a single contour that is a convex
+  ///             polygon, and can be filled by |TessellateConvex|.
+  ///
+  static bool IsConvex(const Path::Polyline& polyline);
+
  private:
   CTessellator c_tessellator_;
 
@@ -83,5 +83,106 @@ TEST(TessellatorTest, TessellatorBuilderReturnsCorrectResultStatus) {
   }
 }
 
+TEST(TessellatorTest, TessellatesConvexPolylinesWithAFan) {
+  Tessellator t;
+  auto polyline = PathBuilder{}
+                      .AddRect(Rect::MakeLTRB(0, 0, 10, 10))
+                      .TakePath()
+                      .CreatePolyline();
+  ASSERT_TRUE(Tessellator::IsConvex(polyline));
+
+  std::vector<uint16_t> fan;
+  size_t vertex_count = 0;
+  auto result = t.Tessellate(
+      FillType::kNonZero, polyline,
+      [&fan, &vertex_count](const float* vertices, size_t vertices_size,
+                            const uint16_t* indices, size_t indices_size) {
+        vertex_count = vertices_size / 2;
+        fan.assign(indices, indices + indices_size);
+        return true;
+      });
+  ASSERT_EQ(result, Tessellator::Result::kSuccess);
+  // The point that closes the contour is dropped.
+  ASSERT_EQ(vertex_count, 4u);
+  ASSERT_EQ(fan, std::vector<uint16_t>({0, 1, 2, 0, 2, 3}));
+}
+
+TEST(TessellatorTest, DetectsConvexPolylines) {
+  auto rect = Rect::MakeLTRB(0, 0, 100, 100);
+  ASSERT_TRUE(Tessellator::IsConvex(
+      PathBuilder{}.AddOval(rect).TakePath().CreatePolyline()));
+  ASSERT_TRUE(Tessellator::IsConvex(
+      PathBuilder{}.AddRoundedRect(rect, 20).TakePath().CreatePolyline()));
+  // Counter-clockwise, open and with collinear points.
+  ASSERT_TRUE(Tessellator::IsConvex(PathBuilder{}
+                                        .MoveTo({0, 0})
+                                        .LineTo({0, 100})
+                                        .LineTo({50, 100})
+                                        .LineTo({100, 100})
+                                        .LineTo({100, 0})
+                                        .TakePath()
+                                        .CreatePolyline()));
+
+  // Concave.
+  ASSERT_FALSE(Tessellator::IsConvex(PathBuilder{}
+                                         .MoveTo({0, 0})
+                                         .LineTo({100, 0})
+                                         .LineTo({50, 50})
+                                         .LineTo({100, 100})
+                                         .LineTo({0, 100})
+                                         .Close()
+                                         .TakePath()
+                                         .CreatePolyline()));
+  // Turns the same way at every point, but goes around twice.
+  ASSERT_FALSE(Tessellator::IsConvex(PathBuilder{}
+                                         .MoveTo({50, 0})
+                                         .LineTo({80, 90})
+                                         .LineTo({0, 35})
+                                         .LineTo({100, 35})
+                                         .LineTo({20, 90})
+                                         .Close()
+                                         .TakePath()
+                                         .CreatePolyline()));
+  // More than one contour.
+  auto other_rect = Rect::MakeXYWH(200, 0, 100, 100);
+  ASSERT_FALSE(Tessellator::IsConvex(PathBuilder{}
+                                         .AddRect(rect)
+                                         .AddRect(other_rect)
+                                         .TakePath()
+                                         .CreatePolyline()));
+}
+
+TEST(TessellatorTest, ConvexFanCoversTheShape) {
+  Tessellator t;
+  auto polyline = PathBuilder{}
+                      .AddRoundedRect(Rect::MakeLTRB(0, 0, 100, 50), 10)
+                      .TakePath()
+                      .CreatePolyline();
+  for (auto fill_type : {FillType::kNonZero, FillType::kOdd}) {
+    Scalar area = 0;
+    auto result = t.Tessellate(
+        fill_type, polyline,
+        [&area](const float* vertices, size_t vertices_size,
+                const uint16_t* indices, size_t indices_size) {
+          auto points = reinterpret_cast<const Point*>(vertices);
+          for (size_t i = 0; i < indices_size; i += 3) {
+            auto a = points[indices[i]];
+            auto b = points[indices[i + 1]];
+            auto c = points[indices[i + 2]];
+            area += std::abs((b - a).Cross(c - a)) / 2;
+          }
+          return true;
+        });
+    ASSERT_EQ(result, Tessellator::Result::kSuccess);
+    // The fan covers the flattened outline exactly once.
+    Scalar expected_area = 0;
+    const auto& points = polyline.points;
+    for (size_t i = 0; i < points.size(); i++) {
+      expected_area += points[i].Cross(points[(i + 1) % points.size()]) / 2;
+    }
+    ASSERT_NEAR(area, std::abs(expected_area), 0.01);
+  }
+}
+
 }  // namespace testing
 }  // namespace impeller
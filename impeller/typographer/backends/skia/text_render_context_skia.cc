@@ -4,6 +4,8 @@
 
 #include "impeller/typographer/backends/skia/text_render_context_skia.h"
 
+#include <algorithm>
+#include <cmath>
 #include <utility>
 
 #include "flutter/fml/logging.h"
@@ -58,33 +60,26 @@ static FontGlyphPair::Vector CollectUniqueFontGlyphPairs(
   return vector;
 }
 
-static size_t PairsFitInAtlasOfSize(const FontGlyphPair::Vector& pairs,
-                                    const ISize& atlas_size,
-                                    std::vector<Rect>& glyph_positions) {
-  if (atlas_size.IsEmpty()) {
-    return false;
-  }
-
-  auto rect_packer = std::unique_ptr<GrRectanizer>(
-      GrRectanizer::Factory(atlas_size.width, atlas_size.height));
+// TODO(114563): We might be able to remove this per-glyph padding if we fix
+//               the underlying causes of the overlap.
+static constexpr auto kGlyphPadding = 2;
 
+static size_t AppendPairsToRectPacker(const FontGlyphPair::Vector& pairs,
+                                      GrRectanizer& rect_packer,
+                                      std::vector<Rect>& glyph_positions) {
   glyph_positions.clear();
   glyph_positions.reserve(pairs.size());
 
-  // TODO(114563): We might be able to remove this per-glyph padding if we fix
-  //               the underlying causes of the overlap.
-  constexpr auto padding = 2;
-
   for (size_t i = 0; i < pairs.size(); i++) {
     const auto& pair = pairs[i];
     const auto glyph_size =
         ISize::Ceil(pair.font.GetMetrics().GetBoundingBox().size *
                     pair.font.GetMetrics().scale);
     SkIPoint16 location_in_atlas;
-    if (!rect_packer->addRect(glyph_size.width + padding,   //
-                              glyph_size.height + padding,  //
-                              &location_in_atlas            //
-                              )) {
+    if (!rect_packer.addRect(glyph_size.width + kGlyphPadding,   //
+                             glyph_size.height + kGlyphPadding,  //
+                             &location_in_atlas                  //
+                             )) {
       return pairs.size() - i;
     }
     glyph_positions.emplace_back(Rect::MakeXYWH(location_in_atlas.x(),  //
@@ -97,9 +92,25 @@ static size_t PairsFitInAtlasOfSize(const FontGlyphPair::Vector& pairs,
   return 0;
 }
 
+static size_t PairsFitInAtlasOfSize(
+    const FontGlyphPair::Vector& pairs,
+    const ISize& atlas_size,
+    std::vector<Rect>& glyph_positions,
+    std::shared_ptr<GrRectanizer>& rect_packer) {
+  if (atlas_size.IsEmpty()) {
+    return false;
+  }
+
+  rect_packer = std::shared_ptr<GrRectanizer>(
+      GrRectanizer::Factory(atlas_size.width, atlas_size.height));
+
+  return AppendPairsToRectPacker(pairs, *rect_packer, glyph_positions);
+}
+
 static ISize OptimumAtlasSizeForFontGlyphPairs(
     const FontGlyphPair::Vector& pairs,
-    std::vector<Rect>& glyph_positions) {
+    std::vector<Rect>& glyph_positions,
+    std::shared_ptr<GrRectanizer>& rect_packer) {
   static constexpr auto kMinAtlasSize = 8u;
   static constexpr auto kMaxAtlasSize = 4096u;
 
@@ -108,8 +119,8 @@ static ISize OptimumAtlasSizeForFontGlyphPairs(
   ISize current_size(kMinAtlasSize, kMinAtlasSize);
   size_t total_pairs = pairs.size() + 1;
   do {
-    auto remaining_pairs =
-        PairsFitInAtlasOfSize(pairs, current_size, glyph_positions);
+    auto remaining_pairs = PairsFitInAtlasOfSize(pairs, current_size,
+                                                 glyph_positions, rect_packer);
     if (remaining_pairs == 0) {
       return current_size;
     } else if (remaining_pairs < std::ceil(total_pairs / 2)) {
@@ -242,6 +253,33 @@ static void ConvertBitmapToSignedDistanceField(uint8_t* pixels,
 #undef nearestpt
 }
 
+static void DrawGlyph(SkCanvas* canvas,
+                      const FontGlyphPair& font_glyph,
+                      const Rect& location) {
+  const auto& metrics = font_glyph.font.GetMetrics();
+  const auto position = SkPoint::Make(location.origin.x / metrics.scale,
+                                      location.origin.y / metrics.scale);
+  SkGlyphID glyph_id = font_glyph.glyph.index;
+
+  SkFont sk_font(
+      TypefaceSkia::Cast(*font_glyph.font.GetTypeface()).GetSkiaTypeface(),
+      metrics.point_size);
+  auto glyph_color = SK_ColorWHITE;
+
+  SkPaint glyph_paint;
+  glyph_paint.setColor(glyph_color);
+  canvas->resetMatrix();
+  canvas->scale(metrics.scale, metrics.scale);
+  canvas->drawGlyphs(1u,         // count
+                     &glyph_id,  // glyphs
+                     &position,  // positions
+                     SkPoint::Make(-metrics.min_extent.x,
+                                   -metrics.ascent),  // origin
+                     sk_font,                         // font
+                     glyph_paint                      // paint
+  );
+}
+
 static std::shared_ptr<SkBitmap> CreateAtlasBitmap(const GlyphAtlas& atlas,
                                                    const ISize& atlas_size) {
   TRACE_EVENT0("impeller", __FUNCTION__);
@@ -273,34 +311,93 @@ static std::shared_ptr<SkBitmap> CreateAtlasBitmap(const GlyphAtlas& atlas,
 
   atlas.IterateGlyphs([canvas](const FontGlyphPair& font_glyph,
                                const Rect& location) -> bool {
-    const auto& metrics = font_glyph.font.GetMetrics();
-    const auto position = SkPoint::Make(location.origin.x / metrics.scale,
-                                        location.origin.y / metrics.scale);
-    SkGlyphID glyph_id = font_glyph.glyph.index;
-
-    SkFont sk_font(
-        TypefaceSkia::Cast(*font_glyph.font.GetTypeface()).GetSkiaTypeface(),
-        metrics.point_size);
-    auto glyph_color = SK_ColorWHITE;
-
-    SkPaint glyph_paint;
-    glyph_paint.setColor(glyph_color);
-    canvas->resetMatrix();
-    canvas->scale(metrics.scale, metrics.scale);
-    canvas->drawGlyphs(1u,         // count
-                       &glyph_id,  // glyphs
-                       &position,  // positions
-                       SkPoint::Make(-metrics.min_extent.x,
-                                     -metrics.ascent),  // origin
-                       sk_font,                         // font
-                       glyph_paint                      // paint
-    );
+    DrawGlyph(canvas, font_glyph, location);
     return true;
   });
 
   return bitmap;
 }
 
+static bool UpdateAtlasBitmap(SkBitmap& bitmap,
+                              const FontGlyphPair::Vector& pairs,
+                              const std::vector<Rect>& glyph_positions) {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  FML_DCHECK(pairs.size() == glyph_positions.size());
+  auto surface = SkSurface::MakeRasterDirect(bitmap.pixmap());
+  if (!surface) {
+    return false;
+  }
+  auto canvas = surface->getCanvas();
+  if (!canvas) {
+    return false;
+  }
+
+  for (size_t i = 0; i < pairs.size(); i++) {
+    DrawGlyph(canvas, pairs[i], glyph_positions[i]);
+  }
+  return true;
+}
+
+static bool UpdateGlyphTextureAtlas(std::shared_ptr<SkBitmap> bitmap,
+                                    const std::shared_ptr<Texture>& texture) {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+
+  FML_DCHECK(bitmap != nullptr);
+  const auto& pixmap = bitmap->pixmap();
+  const auto& texture_descriptor = texture->GetTextureDescriptor();
+
+  if (pixmap.rowBytes() * pixmap.height() !=
+      texture_descriptor.GetByteSizeOfBaseMipLevel()) {
+    return false;
+  }
+
+  auto mapping = std::make_shared<fml::NonOwnedMapping>(
+      reinterpret_cast<const uint8_t*>(bitmap->getAddr(0, 0)),  // data
+      texture_descriptor.GetByteSizeOfBaseMipLevel(),           // size
+      [bitmap](auto, auto) mutable { bitmap.reset(); }          // proc
+  );
+
+  return texture->SetContents(mapping);
+}
+
+// Uploads only the bounds of the glyphs at |glyph_positions| and their
+// padding from |bitmap|. The glyphs that frames in flight may still sample
+// are left alone, except for the ones within the bounds, which are written
+// with the values they already hold.
+static bool UpdateGlyphTextureAtlas(const SkBitmap& bitmap,
+                                    const std::shared_ptr<Texture>& texture,
+                                    const std::vector<Rect>& glyph_positions) {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  if (glyph_positions.empty()) {
+    return true;
+  }
+
+  Rect bounds = glyph_positions.front();
+  for (const auto& position : glyph_positions) {
+    bounds = bounds.Union(position);
+  }
+  const auto& pixmap = bitmap.pixmap();
+  const auto region =
+      IRect::MakeLTRB(
+          std::max<int64_t>(std::floor(bounds.GetLeft()) - kGlyphPadding, 0),
+          std::max<int64_t>(std::floor(bounds.GetTop()) - kGlyphPadding, 0),
+          std::min<int64_t>(std::ceil(bounds.GetRight()) + kGlyphPadding,
+                            pixmap.width()),
+          std::min<int64_t>(std::ceil(bounds.GetBottom()) + kGlyphPadding,
+                            pixmap.height()));
+  if (region.IsEmpty()) {
+    return true;
+  }
+
+  const size_t length =
+      pixmap.rowBytes() * (region.size.height - 1) +
+      region.size.width * pixmap.info().bytesPerPixel();
+  return texture->SetContents(
+      reinterpret_cast<const uint8_t*>(
+          pixmap.addr(region.origin.x, region.origin.y)),
+      length, region, pixmap.rowBytes());
+}
+
 static std::shared_ptr<Texture> UploadGlyphTextureAtlas(
     const std::shared_ptr<Allocator>& allocator,
     std::shared_ptr<SkBitmap> bitmap,
@@ -311,32 +408,18 @@ static std::shared_ptr<Texture> UploadGlyphTextureAtlas(
     return nullptr;
   }
 
-  FML_DCHECK(bitmap != nullptr);
-  const auto& pixmap = bitmap->pixmap();
-
   TextureDescriptor texture_descriptor;
   texture_descriptor.storage_mode = StorageMode::kHostVisible;
   texture_descriptor.format = format;
   texture_descriptor.size = atlas_size;
 
-  if (pixmap.rowBytes() * pixmap.height() !=
-      texture_descriptor.GetByteSizeOfBaseMipLevel()) {
-    return nullptr;
-  }
-
   auto texture = allocator->CreateTexture(texture_descriptor);
   if (!texture || !texture->IsValid()) {
     return nullptr;
   }
   texture->SetLabel("GlyphAtlas");
 
-  auto mapping = std::make_shared<fml::NonOwnedMapping>(
-      reinterpret_cast<const uint8_t*>(bitmap->getAddr(0, 0)),  // data
-      texture_descriptor.GetByteSizeOfBaseMipLevel(),           // size
-      [bitmap](auto, auto) mutable { bitmap.reset(); }          // proc
-  );
-
-  if (!texture->SetContents(mapping)) {
+  if (!UpdateGlyphTextureAtlas(std::move(bitmap), texture)) {
     return nullptr;
   }
   return texture;
@@ -370,21 +453,82 @@ std::shared_ptr<GlyphAtlas> TextRenderContextSkia::CreateGlyphAtlas(
     return last_atlas;
   }
 
-  auto glyph_atlas = std::make_shared<GlyphAtlas>(type);
-  atlas_context->UpdateGlyphAtlas(glyph_atlas);
+  // ---------------------------------------------------------------------------
+  // Step 3: Place the pairs missing from the current atlas in its free space,
+  //         draw them into its bitmap and upload the part of the bitmap that
+  //         holds them. Signed distance fields are computed over the whole
+  //         bitmap, so those atlases keep no bitmap and are always built
+  //         again. An atlas is a single texture; once it is full it is built
+  //         again at a larger size rather than adding another page.
+  // ---------------------------------------------------------------------------
+  auto last_bitmap = atlas_context->GetBitmap();
+  auto last_rect_packer = atlas_context->GetRectPacker();
+  if (last_atlas->GetType() == type && last_atlas->IsValid() && last_bitmap &&
+      last_rect_packer) {
+    FontGlyphPair::Vector new_pairs;
+    for (const auto& pair : font_glyph_pairs) {
+      if (!last_atlas->FindFontGlyphPosition(pair).has_value()) {
+        new_pairs.push_back(pair);
+      }
+    }
+    std::vector<Rect> new_positions;
+    if (AppendPairsToRectPacker(new_pairs, *last_rect_packer, new_positions) ==
+            0 &&
+        UpdateAtlasBitmap(*last_bitmap, new_pairs, new_positions) &&
+        UpdateGlyphTextureAtlas(*last_bitmap, last_atlas->GetTexture(),
+                                new_positions)) {
+      for (size_t i = 0, count = new_positions.size(); i < count; i++) {
+        last_atlas->AddTypefaceGlyphPosition(new_pairs[i], new_positions[i]);
+      }
+      return last_atlas;
+    }
+    // The rect packer holds the space of the pairs placed before the one that
+    // didn't fit, or of pairs that aren't in the atlas if the upload failed.
+    // Drop it with the bitmap so that glyphs are only added to the atlas again
+    // once it is built again below, or by a later frame if that fails.
+    atlas_context->UpdateBitmap(nullptr, nullptr);
+  }
 
   // ---------------------------------------------------------------------------
-  // Step 3: Get the optimum size of the texture atlas.
+  // Step 4: Get the optimum size of a new texture atlas, and drop the pairs
+  //         the frame doesn't use. While the pairs of the frames keep running
+  //         out of space in the atlas, it keeps its last size if they fit in
+  //         it, so that the next frames have room to add pairs. It shrinks
+  //         back to the optimum size once the pairs take a quarter of it or
+  //         less, or it was built again at the same size
+  //         |kMaxSameSizeRebuilds| times in a row.
   // ---------------------------------------------------------------------------
+  static constexpr size_t kMaxSameSizeRebuilds = 8u;
   std::vector<Rect> glyph_positions;
-  const auto atlas_size =
-      OptimumAtlasSizeForFontGlyphPairs(font_glyph_pairs, glyph_positions);
+  std::shared_ptr<GrRectanizer> rect_packer;
+  auto atlas_size = OptimumAtlasSizeForFontGlyphPairs(
+      font_glyph_pairs, glyph_positions, rect_packer);
   if (atlas_size.IsEmpty()) {
     return nullptr;
   }
+  if (last_atlas->GetType() == type && last_atlas->IsValid()) {
+    const auto last_size = atlas_context->GetAtlasSize();
+    if (atlas_size != last_size && atlas_size.width <= last_size.width &&
+        atlas_size.height <= last_size.height &&
+        atlas_size.Area() * 4 > last_size.Area() &&
+        atlas_context->GetSameSizeRebuildCount() < kMaxSameSizeRebuilds) {
+      std::vector<Rect> last_size_positions;
+      std::shared_ptr<GrRectanizer> last_size_rect_packer;
+      if (PairsFitInAtlasOfSize(font_glyph_pairs, last_size,
+                                last_size_positions,
+                                last_size_rect_packer) == 0) {
+        atlas_size = last_size;
+        glyph_positions = std::move(last_size_positions);
+        rect_packer = std::move(last_size_rect_packer);
+      }
+    }
+  }
+
+  auto glyph_atlas = std::make_shared<GlyphAtlas>(type);
+  atlas_context->UpdateGlyphAtlas(glyph_atlas, atlas_size);
 
   // ---------------------------------------------------------------------------
-  // Step 4: Find location of font-glyph pairs in the atlas. We have this from
+  // Step 5: Find location of font-glyph pairs in the atlas. We have this from
   // the last step. So no need to do create another rect packer. But just do a
   // sanity check of counts. This could also be just an assertion as only a
   // construction issue would cause such a failure.
@@ -394,7 +538,7 @@ std::shared_ptr<GlyphAtlas> TextRenderContextSkia::CreateGlyphAtlas(
   }
 
   // ---------------------------------------------------------------------------
-  // Step 5: Record the positions in the glyph atlas.
+  // Step 6: Record the positions in the glyph atlas.
   // ---------------------------------------------------------------------------
   for (size_t i = 0, count = glyph_positions.size(); i < count; i++) {
     glyph_atlas->AddTypefaceGlyphPosition(font_glyph_pairs[i],
@@ -402,7 +546,7 @@ std::shared_ptr<GlyphAtlas> TextRenderContextSkia::CreateGlyphAtlas(
   }
 
   // ---------------------------------------------------------------------------
-  // Step 6: Draw font-glyph pairs in the correct spot in the atlas.
+  // Step 7: Draw font-glyph pairs in the correct spot in the atlas.
   // ---------------------------------------------------------------------------
   auto bitmap = CreateAtlasBitmap(*glyph_atlas, atlas_size);
   if (!bitmap) {
@@ -410,7 +554,7 @@ std::shared_ptr<GlyphAtlas> TextRenderContextSkia::CreateGlyphAtlas(
   }
 
   // ---------------------------------------------------------------------------
-  // Step 7: Upload the atlas as a texture.
+  // Step 8: Upload the atlas as a texture.
   // ---------------------------------------------------------------------------
   PixelFormat format;
   switch (type) {
@@ -432,9 +576,12 @@ std::shared_ptr<GlyphAtlas> TextRenderContextSkia::CreateGlyphAtlas(
   }
 
   // ---------------------------------------------------------------------------
-  // Step 8: Record the texture in the glyph atlas.
+  // Step 9: Record the texture in the glyph atlas.
   // ---------------------------------------------------------------------------
   glyph_atlas->SetTexture(std::move(texture));
+  if (type != GlyphAtlas::Type::kSignedDistanceField) {
+    atlas_context->UpdateBitmap(std::move(bitmap), std::move(rect_packer));
+  }
 
   return glyph_atlas;
 }
@@ -17,8 +17,38 @@ std::shared_ptr<GlyphAtlas> GlyphAtlasContext::GetGlyphAtlas() const {
   return atlas_;
 }
 
-void GlyphAtlasContext::UpdateGlyphAtlas(std::shared_ptr<GlyphAtlas> atlas) {
+const ISize& GlyphAtlasContext::GetAtlasSize() const {
+  return atlas_size_;
+}
+
+size_t GlyphAtlasContext::GetSameSizeRebuildCount() const {
+  return same_size_rebuild_count_;
+}
+
+std::shared_ptr<SkBitmap> GlyphAtlasContext::GetBitmap() const {
+  return bitmap_;
+}
+
+std::shared_ptr<GrRectanizer> GlyphAtlasContext::GetRectPacker() const {
+  return rect_packer_;
+}
+
+void GlyphAtlasContext::UpdateGlyphAtlas(std::shared_ptr<GlyphAtlas> atlas,
+                                         ISize size) {
+  same_size_rebuild_count_ =
+      atlas_->IsValid() && size == atlas_size_ ? same_size_rebuild_count_ + 1
+                                               : 0;
   atlas_ = std::move(atlas);
+  atlas_size_ = size;
+  bitmap_.reset();
+  rect_packer_.reset();
+}
+
+void GlyphAtlasContext::UpdateBitmap(
+    std::shared_ptr<SkBitmap> bitmap,
+    std::shared_ptr<GrRectanizer> rect_packer) {
+  bitmap_ = std::move(bitmap);
+  rect_packer_ = std::move(rect_packer);
 }
 
 GlyphAtlas::GlyphAtlas(Type type) : type_(type) {}
@@ -15,6 +15,9 @@
 #include "impeller/renderer/texture.h"
 #include "impeller/typographer/font_glyph_pair.h"
 
+class SkBitmap;
+class GrRectanizer;
+
 namespace impeller {
 
 //------------------------------------------------------------------------------
@@ -142,6 +145,11 @@ class GlyphAtlas {
 //------------------------------------------------------------------------------
 /// @brief      A container for caching a glyph atlas across frames.
 ///
+///             Along with the atlas, it keeps the bitmap the glyphs were drawn
+///             into and the rect packer that placed them, so that the glyphs
+///             a later frame adds can be placed in the free space of the atlas
+///             instead of building it again.
+///
 class GlyphAtlasContext {
  public:
   GlyphAtlasContext();
@@ -152,12 +160,40 @@ class GlyphAtlasContext {
   /// @brief      Retrieve the current glyph atlas.
   std::shared_ptr<GlyphAtlas> GetGlyphAtlas() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Retrieve the size of the current glyph atlas.
+  const ISize& GetAtlasSize() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Retrieve the number of times in a row the glyph atlas was
+  ///             replaced by one of the same size.
+  size_t GetSameSizeRebuildCount() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Retrieve the bitmap the glyphs of the current atlas were
+  ///             drawn into, if any.
+  std::shared_ptr<SkBitmap> GetBitmap() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Retrieve the rect packer that placed the glyphs of the
+  ///             current atlas, if any.
+  std::shared_ptr<GrRectanizer> GetRectPacker() const;
+
   //----------------------------------------------------------------------------
   /// @brief      Update the context with a newly constructed glyph atlas.
-  void UpdateGlyphAtlas(std::shared_ptr<GlyphAtlas> atlas);
+  void UpdateGlyphAtlas(std::shared_ptr<GlyphAtlas> atlas, ISize size);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Update the bitmap and the rect packer of the glyph atlas.
+  void UpdateBitmap(std::shared_ptr<SkBitmap> bitmap,
+                    std::shared_ptr<GrRectanizer> rect_packer);
 
  private:
   std::shared_ptr<GlyphAtlas> atlas_;
+  ISize atlas_size_;
+  size_t same_size_rebuild_count_ = 0;
+  std::shared_ptr<SkBitmap> bitmap_;
+  std::shared_ptr<GrRectanizer> rect_packer_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(GlyphAtlasContext);
 };
@@ -137,6 +137,108 @@ TEST_P(TypographerTest, GlyphAtlasIsRecycledIfUnchanged) {
   ASSERT_EQ(atlas_context->GetGlyphAtlas(), atlas);
 }
 
+TEST_P(TypographerTest, GlyphAtlasAppendsNewGlyphsToLastAtlas) {
+  auto context = TextRenderContext::Create(GetContext());
+  auto atlas_context = std::make_shared<GlyphAtlasContext>();
+  ASSERT_TRUE(context && context->IsValid());
+  SkFont sk_font;
+  auto blob = SkTextBlob::MakeFromString("spooky skellingtons", sk_font);
+  ASSERT_TRUE(blob);
+  auto atlas =
+      context->CreateGlyphAtlas(GlyphAtlas::Type::kAlphaBitmap, atlas_context,
+                                TextFrameFromTextBlob(blob));
+  ASSERT_NE(atlas, nullptr);
+  ASSERT_NE(atlas->GetTexture(), nullptr);
+  auto texture = atlas->GetTexture();
+  auto glyph_count = atlas->GetGlyphCount();
+
+  // A glyph of a tiny font fits in the space the first glyphs left free.
+  SkFont tiny_font(sk_font.refTypeface(), 1);
+  auto tiny_frame =
+      TextFrameFromTextBlob(SkTextBlob::MakeFromString("s", tiny_font));
+  TextFrame frame;
+  size_t count = 0;
+  TextRenderContext::FrameIterator iterator = [&]() -> const TextFrame* {
+    count++;
+    if (count == 1) {
+      frame = TextFrameFromTextBlob(blob);
+      return &frame;
+    }
+    return count == 2 ? &tiny_frame : nullptr;
+  };
+  auto next_atlas = context->CreateGlyphAtlas(GlyphAtlas::Type::kAlphaBitmap,
+                                              atlas_context, iterator);
+  ASSERT_EQ(next_atlas, atlas);
+  ASSERT_EQ(next_atlas->GetTexture(), texture);
+  ASSERT_EQ(next_atlas->GetGlyphCount(), glyph_count + 1);
+  for (const auto& run : tiny_frame.GetRuns()) {
+    for (const auto& glyph_position : run.GetGlyphPositions()) {
+      ASSERT_TRUE(next_atlas
+                      ->FindFontGlyphPosition(
+                          {run.GetFont(), glyph_position.glyph})
+                      .has_value());
+    }
+  }
+}
+
+TEST_P(TypographerTest, GlyphAtlasGrowsAndDropsUnusedGlyphsWhenFull) {
+  auto context = TextRenderContext::Create(GetContext());
+  auto atlas_context = std::make_shared<GlyphAtlasContext>();
+  ASSERT_TRUE(context && context->IsValid());
+  SkFont sk_font;
+  auto blob = SkTextBlob::MakeFromString("spooky skellingtons", sk_font);
+  ASSERT_TRUE(blob);
+  auto atlas =
+      context->CreateGlyphAtlas(GlyphAtlas::Type::kAlphaBitmap, atlas_context,
+                                TextFrameFromTextBlob(blob));
+  ASSERT_NE(atlas, nullptr);
+  ASSERT_NE(atlas->GetTexture(), nullptr);
+  auto atlas_size = atlas->GetTexture()->GetSize();
+
+  // Glyphs this large can't fit in the space left in the atlas.
+  SkFont large_font(sk_font.refTypeface(), 200);
+  auto large_frame =
+      TextFrameFromTextBlob(SkTextBlob::MakeFromString("AGH", large_font));
+  auto next_atlas = context->CreateGlyphAtlas(
+      GlyphAtlas::Type::kAlphaBitmap, atlas_context, large_frame);
+  ASSERT_NE(next_atlas, nullptr);
+  ASSERT_NE(next_atlas, atlas);
+  ASSERT_EQ(atlas_context->GetGlyphAtlas(), next_atlas);
+  ASSERT_EQ(next_atlas->GetGlyphCount(), 3u);
+  ASSERT_GE(next_atlas->GetTexture()->GetSize().width, atlas_size.width);
+  ASSERT_GE(next_atlas->GetTexture()->GetSize().height, atlas_size.height);
+}
+
+TEST_P(TypographerTest, GlyphAtlasKeepsItsSizeUntilGlyphsFitInAQuarterOfIt) {
+  auto context = TextRenderContext::Create(GetContext());
+  auto atlas_context = std::make_shared<GlyphAtlasContext>();
+  ASSERT_TRUE(context && context->IsValid());
+  // Signed distance field atlases keep no bitmap, so every frame with other
+  // glyphs builds them again.
+  auto create_atlas = [&](const char* text, SkScalar size) {
+    SkFont font(SkFont{}.refTypeface(), size);
+    return context->CreateGlyphAtlas(
+        GlyphAtlas::Type::kSignedDistanceField, atlas_context,
+        TextFrameFromTextBlob(SkTextBlob::MakeFromString(text, font)));
+  };
+  auto atlas = create_atlas("AGH", 200);
+  ASSERT_NE(atlas, nullptr);
+  ASSERT_NE(atlas->GetTexture(), nullptr);
+  const auto atlas_size = atlas->GetTexture()->GetSize();
+
+  // Fewer glyphs of the same size are placed in an atlas as large.
+  auto fewer_glyphs_atlas = create_atlas("AG", 200);
+  ASSERT_NE(fewer_glyphs_atlas, nullptr);
+  ASSERT_NE(fewer_glyphs_atlas, atlas);
+  ASSERT_EQ(fewer_glyphs_atlas->GetTexture()->GetSize(), atlas_size);
+
+  // Glyphs that fit in a quarter of it get a smaller atlas.
+  auto small_glyphs_atlas = create_atlas("AG", 12);
+  ASSERT_NE(small_glyphs_atlas, nullptr);
+  ASSERT_LT(small_glyphs_atlas->GetTexture()->GetSize().Area() * 4,
+            atlas_size.Area());
+}
+
 TEST_P(TypographerTest, GlyphAtlasWithLotsOfdUniqueGlyphSize) {
   auto context = TextRenderContext::Create(GetContext());
   auto atlas_context = std::make_shared<GlyphAtlasContext>();
@@ -4,6 +4,7 @@
 
 #include "flutter/lib/ui/painting/image_decoder.h"
 
+#include "flutter/fml/metrics.h"
 #include "flutter/lib/ui/painting/image_decoder_skia.h"
 
 #if IMPELLER_SUPPORTS_RENDERING
@@ -52,4 +53,9 @@ fml::WeakPtr<ImageDecoder> ImageDecoder::GetWeakPtr() const {
   return weak_factory_.GetWeakPtr();
 }
 
+void ImageDecoder::RecordDecodeLatency(fml::TimePoint start) {
+  FML_METRICS_HISTOGRAM("flutter.ImageDecoder.DecodeMicros")
+      .Record((fml::TimePoint::Now() - start).ToMicroseconds());
+}
+
 }  // namespace flutter
@@ -11,6 +11,7 @@
 #include "flutter/common/task_runners.h"
 #include "flutter/display_list/display_list_image.h"
 #include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/lib/ui/io_manager.h"
 #include "flutter/lib/ui/painting/image_descriptor.h"
 
@@ -55,6 +56,10 @@ class ImageDecoder {
       std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
       fml::WeakPtr<IOManager> io_manager);
 
+  // Records the time from the call to |Decode| at |start| until its result
+  // is delivered on the UI thread, which is now.
+  static void RecordDecodeLatency(fml::TimePoint start);
+
  private:
   fml::WeakPtrFactory<ImageDecoder> weak_factory_;
 
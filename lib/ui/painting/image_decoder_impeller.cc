@@ -215,12 +215,14 @@ void ImageDecoderImpeller::Decode(fml::RefPtr<ImageDescriptor> descriptor,
   // Wrap the result callback so that it can be invoked from any thread.
   auto raw_descriptor = descriptor.get();
   raw_descriptor->AddRef();
-  ImageResult result = [p_result,                               //
-                        raw_descriptor,                         //
-                        ui_runner = runners_.GetUITaskRunner()  //
+  ImageResult result = [p_result,                                //
+                        raw_descriptor,                          //
+                        ui_runner = runners_.GetUITaskRunner(),  //
+                        start = fml::TimePoint::Now()            //
   ](auto image) {
-    ui_runner->PostTask([raw_descriptor, p_result, image]() {
+    ui_runner->PostTask([raw_descriptor, p_result, image, start]() {
       raw_descriptor->Release();
+      RecordDecodeLatency(start);
       p_result(std::move(image));
     });
   };
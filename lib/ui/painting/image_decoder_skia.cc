@@ -241,15 +241,17 @@ void ImageDecoderSkia::Decode(fml::RefPtr<ImageDescriptor> descriptor_ref_ptr,
 
   // Always service the callback (and cleanup the descriptor) on the UI thread.
   auto result =
-      [callback, raw_descriptor, ui_runner = runners_.GetUITaskRunner()](
-          SkiaGPUObject<SkImage> image, fml::tracing::TraceFlow flow) {
+      [callback, raw_descriptor, ui_runner = runners_.GetUITaskRunner(),
+       start = fml::TimePoint::Now()](SkiaGPUObject<SkImage> image,
+                                      fml::tracing::TraceFlow flow) {
         ui_runner->PostTask(fml::MakeCopyable(
-            [callback, raw_descriptor, image = std::move(image),
+            [callback, raw_descriptor, start, image = std::move(image),
              flow = std::move(flow)]() mutable {
               // We are going to terminate the trace flow here. Flows cannot
               // terminate without a base trace. Add one explicitly.
               TRACE_EVENT0("flutter", "ImageDecodeCallback");
               flow.End();
+              RecordDecodeLatency(start);
               callback(DlImageGPU::Make(std::move(image)));
               raw_descriptor->Release();
             }));
@@ -38,8 +38,13 @@ fml::RefPtr<Picture> PictureRecorder::endRecording(Dart_Handle dart_picture) {
 
   fml::RefPtr<Picture> picture;
 
-  picture = Picture::Create(dart_picture, UIDartState::CreateGPUObject(
-                                              display_list_recorder_->Build()));
+  // Content that is recorded again unchanged keeps using the DisplayList
+  // built for it previously, along with its raster cache entries.
+  sk_sp<DisplayList> display_list =
+      UIDartState::Current()->GetDisplayListReuseCache().Reuse(
+          display_list_recorder_->Build());
+  picture = Picture::Create(dart_picture,
+                            UIDartState::CreateGPUObject(display_list));
   display_list_recorder_ = nullptr;
 
   canvas_->Invalidate();
@@ -11,6 +11,7 @@
 
 #include "flutter/common/settings.h"
 #include "flutter/common/task_runners.h"
+#include "flutter/display_list/display_list_reuse_cache.h"
 #include "flutter/flow/skia_gpu_object.h"
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/memory/weak_ptr.h"
@@ -155,6 +156,12 @@ class UIDartState : public tonic::DartState {
 
   bool enable_skparagraph() const;
 
+  // The cache through which Pictures recorded by this isolate share the
+  // DisplayLists of content that is recorded again unchanged.
+  DisplayListReuseCache& GetDisplayListReuseCache() {
+    return display_list_reuse_cache_;
+  }
+
   template <class T>
   static flutter::SkiaGPUObject<T> CreateGPUObject(sk_sp<T> object) {
     if (!object) {
@@ -212,6 +219,7 @@ class UIDartState : public tonic::DartState {
   const std::shared_ptr<IsolateNameServer> isolate_name_server_;
   const bool enable_skparagraph_;
   UIDartState::Context context_;
+  DisplayListReuseCache display_list_reuse_cache_;
 
   void AddOrRemoveTaskObserver(bool add);
 };
@@ -256,6 +256,16 @@ bool RuntimeController::NotifyDestroyed() {
   return true;
 }
 
+bool RuntimeController::NotifyLowMemoryWarning() {
+  std::shared_ptr<DartIsolate> root_isolate = root_isolate_.lock();
+  if (!root_isolate) {
+    return false;
+  }
+
+  root_isolate->GetDisplayListReuseCache().Clear();
+  return true;
+}
+
 bool RuntimeController::DispatchPlatformMessage(
     std::unique_ptr<PlatformMessage> message) {
   if (auto* platform_configuration = GetPlatformConfigurationIfAvailable()) {
@@ -371,6 +371,15 @@ class RuntimeController : public PlatformConfigurationClient {
   ///
   virtual bool NotifyDestroyed();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Notify the root isolate that the system is running low on
+  ///             memory, so that it releases the DisplayLists it keeps for
+  ///             reuse by unchanged pictures.
+  ///
+  /// @return     If the notification was delivered to the root isolate.
+  ///
+  bool NotifyLowMemoryWarning();
+
   //----------------------------------------------------------------------------
   /// @brief      Returns if the root isolate is running. The isolate must be
   ///             transitioned to the running phase manually. The isolate can
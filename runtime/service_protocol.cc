@@ -12,8 +12,10 @@
 #include <utility>
 #include <vector>
 
+#include "flutter/fml/metrics.h"
 #include "flutter/fml/posix_wrappers.h"
 #include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/trace_ring_buffer.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
 #include "third_party/dart/runtime/include/dart_tools_api.h"
@@ -42,6 +44,10 @@ const std::string_view
         "_flutter.renderFrameWithRasterStats";
 const std::string_view ServiceProtocol::kReloadAssetFonts =
     "_flutter.reloadAssetFonts";
+const std::string_view ServiceProtocol::kGetMetricsExtensionName =
+    "_flutter.getMetrics";
+const std::string_view ServiceProtocol::kGetRingBufferTraceExtensionName =
+    "_flutter.getRingBufferTrace";
 
 static constexpr std::string_view kViewIdPrefx = "_flutterView/";
 static constexpr std::string_view kListViewsExtensionName =
@@ -63,6 +69,8 @@ ServiceProtocol::ServiceProtocol()
           kEstimateRasterCacheMemoryExtensionName,
           kRenderFrameWithRasterStatsExtensionName,
           kReloadAssetFonts,
+          kGetMetricsExtensionName,
+          kGetRingBufferTraceExtensionName,
       }),
       handlers_mutex_(fml::SharedMutex::Create()) {}
 
@@ -189,12 +197,19 @@ bool ServiceProtocol::HandleMessage(std::string_view method,
 bool ServiceProtocol::HandleMessage(std::string_view method,
                                     const Handler::ServiceProtocolMap& params,
                                     rapidjson::Document* response) const {
+  // The built-in methods do not forward to the dynamic set of handlers.
   if (method == kListViewsExtensionName) {
-    // So far, this is the only built-in method that does not forward to the
-    // dynamic set of handlers.
     return HandleListViewsMethod(response);
   }
 
+  if (method == kGetMetricsExtensionName) {
+    return HandleGetMetricsMethod(response);
+  }
+
+  if (method == kGetRingBufferTraceExtensionName) {
+    return HandleGetRingBufferTraceMethod(response);
+  }
+
   fml::SharedLock lock(*handlers_mutex_);
 
   if (handlers_.empty()) {
@@ -292,4 +307,59 @@ bool ServiceProtocol::HandleListViewsMethod(
   return true;
 }
 
+bool ServiceProtocol::HandleGetMetricsMethod(rapidjson::Document* response) {
+  auto& allocator = response->GetAllocator();
+  response->SetObject();
+  response->AddMember("type", "FlutterMetrics", allocator);
+
+  rapidjson::Value metrics(rapidjson::Type::kArrayType);
+  for (const auto& snapshot :
+       fml::metrics::MetricsRegistry::GetInstance().GetSnapshot()) {
+    rapidjson::Value metric(rapidjson::Type::kObjectType);
+    metric.AddMember("name", snapshot.name, allocator);
+    switch (snapshot.type) {
+      case fml::metrics::MetricType::kCounter:
+        metric.AddMember("type", "counter", allocator);
+        metric.AddMember("value", snapshot.value, allocator);
+        break;
+      case fml::metrics::MetricType::kGauge:
+        metric.AddMember("type", "gauge", allocator);
+        metric.AddMember("value", snapshot.value, allocator);
+        break;
+      case fml::metrics::MetricType::kHistogram: {
+        const auto& histogram = snapshot.histogram;
+        metric.AddMember("type", "histogram", allocator);
+        metric.AddMember("count", histogram.count, allocator);
+        metric.AddMember("sum", histogram.sum, allocator);
+        metric.AddMember("min", histogram.min, allocator);
+        metric.AddMember("max", histogram.max, allocator);
+        metric.AddMember("p50", histogram.p50, allocator);
+        metric.AddMember("p90", histogram.p90, allocator);
+        metric.AddMember("p99", histogram.p99, allocator);
+        break;
+      }
+    }
+    metrics.PushBack(metric, allocator);
+  }
+
+  response->AddMember("metrics", metrics, allocator);
+
+  return true;
+}
+
+bool ServiceProtocol::HandleGetRingBufferTraceMethod(
+    rapidjson::Document* response) {
+  auto& allocator = response->GetAllocator();
+  response->SetObject();
+  response->AddMember("type", "RingBufferTrace", allocator);
+  response->AddMember("enabled", fml::tracing::TraceRingBufferIsEnabled(),
+                      allocator);
+  // The events are already serialized in the Chrome trace event format,
+  // which the tools load as is.
+  rapidjson::Value trace(fml::tracing::TraceRingBufferExportJSON(), allocator);
+  response->AddMember("trace", trace, allocator);
+
+  return true;
+}
+
 }  // namespace flutter
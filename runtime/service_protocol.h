@@ -31,6 +31,8 @@ class ServiceProtocol {
   static const std::string_view kEstimateRasterCacheMemoryExtensionName;
   static const std::string_view kRenderFrameWithRasterStatsExtensionName;
   static const std::string_view kReloadAssetFonts;
+  static const std::string_view kGetMetricsExtensionName;
+  static const std::string_view kGetRingBufferTraceExtensionName;
 
   class Handler {
    public:
@@ -97,6 +99,14 @@ class ServiceProtocol {
 
   [[nodiscard]] bool HandleListViewsMethod(rapidjson::Document* response) const;
 
+  [[nodiscard]] static bool HandleGetMetricsMethod(
+      rapidjson::Document* response);
+
+  // Returns the events recorded with --trace-to-ring-buffer as a string of
+  // JSON in the Chrome trace event format.
+  [[nodiscard]] static bool HandleGetRingBufferTraceMethod(
+      rapidjson::Document* response);
+
   FML_DISALLOW_COPY_AND_ASSIGN(ServiceProtocol);
 };
 
@@ -48,7 +48,8 @@ class Animator final {
 
   Animator(Delegate& delegate,
            const TaskRunners& task_runners,
-           std::unique_ptr<VsyncWaiter> waiter);
+           std::unique_ptr<VsyncWaiter> waiter,
+           FramePipelinePolicy pipeline_policy = FramePipelinePolicy::kFifo);
 
   ~Animator();
 
@@ -261,6 +261,11 @@ void Engine::NotifyIdle(fml::TimeDelta deadline) {
   runtime_controller_->NotifyIdle(deadline);
 }
 
+void Engine::NotifyLowMemoryWarning() {
+  TRACE_EVENT0("flutter", "Engine::NotifyLowMemoryWarning");
+  runtime_controller_->NotifyLowMemoryWarning();
+}
+
 void Engine::NotifyDestroyed() {
   TRACE_EVENT0("flutter", "Engine::NotifyDestroyed");
   runtime_controller_->NotifyDestroyed();
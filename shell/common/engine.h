@@ -561,6 +561,13 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   ///             some cleanp activities.
   void NotifyDestroyed();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Notifies the engine that the system is running low on memory.
+  ///             The engine releases the caches of the UI isolate that are
+  ///             only kept to speed up later frames.
+  ///
+  void NotifyLowMemoryWarning();
+
   //----------------------------------------------------------------------------
   /// @brief      Dart code cannot fully measure the time it takes for a
   ///             specific frame to be rendered. This is because Dart code only
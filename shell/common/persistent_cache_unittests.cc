@@ -13,6 +13,7 @@
 #include "flutter/fml/command_line.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/log_settings.h"
+#include "flutter/fml/paths.h"
 #include "flutter/fml/unique_fd.h"
 #include "flutter/shell/common/shell_test.h"
 #include "flutter/shell/common/switches.h"
@@ -297,6 +298,36 @@ TEST_F(PersistentCacheTest, CanRemoveOldPersistentCache) {
   fml::RemoveFilesInDirectory(base_dir.fd());
 }
 
+TEST_F(PersistentCacheTest, CanOpenImpellerCacheDirectory) {
+  fml::ScopedTemporaryDirectory base_dir;
+  ASSERT_TRUE(base_dir.fd().is_valid());
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+
+  auto impeller_dir =
+      PersistentCache::GetCacheForProcess()->OpenImpellerCacheDirectory();
+  ASSERT_TRUE(impeller_dir.is_valid());
+  auto cache_dir = fml::OpenDirectoryReadOnly(
+      base_dir.fd(),
+      fml::paths::JoinPaths({"flutter_engine", GetFlutterEngineVersion(),
+                             "skia", GetSkiaVersion(),
+                             PersistentCache::kImpellerSubdirName})
+          .c_str());
+  ASSERT_TRUE(cache_dir.is_valid());
+
+  // A read only cache doesn't hand out a directory to write in.
+  PersistentCache::gIsReadOnly = true;
+  PersistentCache::ResetCacheForProcess();
+  ASSERT_FALSE(PersistentCache::GetCacheForProcess()
+                   ->OpenImpellerCacheDirectory()
+                   .is_valid());
+  PersistentCache::gIsReadOnly = false;
+  PersistentCache::ResetCacheForProcess();
+
+  // Cleanup
+  fml::RemoveFilesInDirectory(base_dir.fd());
+}
+
 TEST_F(PersistentCacheTest, CanPurgePersistentCache) {
   fml::ScopedTemporaryDirectory base_dir;
   ASSERT_TRUE(base_dir.fd().is_valid());
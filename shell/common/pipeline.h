@@ -5,15 +5,18 @@
 #ifndef FLUTTER_SHELL_COMMON_PIPELINE_H_
 #define FLUTTER_SHELL_COMMON_PIPELINE_H_
 
-#include <deque>
+#include <algorithm>
+#include <atomic>
 #include <memory>
-#include <mutex>
+#include <vector>
 
+#include "flutter/common/settings.h"
 #include "flutter/flow/frame_timings.h"
 #include "flutter/flow/layers/layer_tree.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
-#include "flutter/fml/synchronization/semaphore.h"
+#include "flutter/fml/metrics.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
 
 namespace flutter {
@@ -34,14 +37,34 @@ enum class PipelineConsumeResult {
 
 size_t GetNextPipelineTraceID();
 
-/// A thread-safe queue of resources for a single consumer and a single
+/// A lock-free queue of resources for a single consumer and a single
 /// producer.
+///
+/// Resources completed through |Produce| continuations are stored in a ring
+/// buffer and must all be completed on the same producer thread. Resources
+/// completed through |ProduceIfEmpty| continuations are put in front of the
+/// queue and must be completed on the consumer thread, which is how a
+/// consumer resubmits a resource it could not consume.
+///
+/// The |FramePipelinePolicy| determines which resources the consumer gets
+/// when more than one is queued, and how many resources may be in flight.
 template <class R>
 class Pipeline {
  public:
   using Resource = R;
   using ResourcePtr = std::unique_ptr<Resource>;
 
+  /// The depth an adaptive pipeline may grow to while the consumer is slow.
+  static constexpr uint32_t kMaxAdaptiveDepth = 3;
+
+  /// The number of consecutive slow frames after which an adaptive pipeline
+  /// grows by one resource.
+  static constexpr size_t kSlowFramesToGrow = 3;
+
+  /// The number of consecutive fast frames after which an adaptive pipeline
+  /// shrinks by one resource, down to the depth it was created with.
+  static constexpr size_t kFastFramesToShrink = 60;
+
   /// Denotes a spot in the pipeline reserved for the producer to finish
   /// preparing a completed pipeline resource.
   class ProducerContinuation {
@@ -101,22 +124,38 @@ class Pipeline {
     FML_DISALLOW_COPY_AND_ASSIGN(ProducerContinuation);
   };
 
-  explicit Pipeline(uint32_t depth)
-      : empty_(depth), available_(0), inflight_(0) {}
+  explicit Pipeline(uint32_t depth,
+                    FramePipelinePolicy policy = FramePipelinePolicy::kFifo)
+      : policy_(policy),
+        base_depth_(depth),
+        depth_(depth),
+        slots_(policy == FramePipelinePolicy::kAdaptiveDepth
+                   ? std::max(depth, kMaxAdaptiveDepth)
+                   : depth),
+        inflight_(0),
+        head_(0),
+        tail_(0) {}
 
   ~Pipeline() = default;
 
-  bool IsValid() const { return empty_.IsValid() && available_.IsValid(); }
+  bool IsValid() const { return depth_.load() <= slots_.size(); }
+
+  FramePipelinePolicy policy() const { return policy_; }
+
+  /// The number of resources that may currently be in flight, which only
+  /// differs from the depth the pipeline was created with for adaptive
+  /// pipelines.
+  uint32_t GetDepth() const { return depth_.load(std::memory_order_relaxed); }
+
+  /// The number of stale resources dropped by a latest-wins pipeline.
+  size_t GetDroppedCount() const {
+    return dropped_count_.load(std::memory_order_relaxed);
+  }
 
   ProducerContinuation Produce() {
-    if (!empty_.TryWait()) {
+    if (!TryReserve()) {
       return {};
     }
-    ++inflight_;
-    FML_TRACE_COUNTER("flutter", "Pipeline Depth",
-                      reinterpret_cast<int64_t>(this),      //
-                      "frames in flight", inflight_.load()  //
-    );
 
     return ProducerContinuation{
         std::bind(&Pipeline::ProducerCommit, this, std::placeholders::_1,
@@ -129,14 +168,9 @@ class Pipeline {
   // Prefer using |Produce|. ProducerContinuation returned by this method
   // doesn't guarantee that the frame will be rendered.
   ProducerContinuation ProduceIfEmpty() {
-    if (!empty_.TryWait()) {
+    if (!TryReserve()) {
       return {};
     }
-    ++inflight_;
-    FML_TRACE_COUNTER("flutter", "Pipeline Depth",
-                      reinterpret_cast<int64_t>(this),      //
-                      "frames in flight", inflight_.load()  //
-    );
 
     return ProducerContinuation{
         std::bind(&Pipeline::ProducerCommitIfEmpty, this, std::placeholders::_1,
@@ -152,68 +186,162 @@ class Pipeline {
       return PipelineConsumeResult::NoneAvailable;
     }
 
-    if (!available_.TryWait()) {
-      return PipelineConsumeResult::NoneAvailable;
+    Slot slot;
+    size_t head = head_.load(std::memory_order_relaxed);
+    size_t tail = tail_.load(std::memory_order_acquire);
+    if (front_slot_.resource && policy_ == FramePipelinePolicy::kLatestWins &&
+        head != tail) {
+      // The resubmitted resource is older than the ones produced since.
+      DropSlot(std::move(front_slot_));
+    }
+    if (front_slot_.resource) {
+      slot = std::move(front_slot_);
+    } else {
+      if (head == tail) {
+        return PipelineConsumeResult::NoneAvailable;
+      }
+      if (policy_ == FramePipelinePolicy::kLatestWins) {
+        // Only the most recent resource is consumed; the ones produced
+        // before it are stale.
+        while (tail - head > 1) {
+          DropSlot(std::move(slots_[head % slots_.size()]));
+          head_.store(++head, std::memory_order_release);
+        }
+      }
+      slot = std::move(slots_[head % slots_.size()]);
+      head_.store(head + 1, std::memory_order_release);
     }
 
-    ResourcePtr resource;
-    size_t trace_id = 0;
-    size_t items_count = 0;
+    fml::TimeDelta latency = fml::TimePoint::Now() - slot.produce_time;
+    FML_METRICS_HISTOGRAM("flutter.Pipeline.QueueLatencyMicros")
+        .Record(latency.ToMicroseconds());
+    FML_TRACE_COUNTER("flutter", "Pipeline Queue Latency",
+                      reinterpret_cast<int64_t>(this),          //
+                      "microseconds", latency.ToMicroseconds()  //
+    );
 
-    {
-      std::scoped_lock lock(queue_mutex_);
-      std::tie(resource, trace_id) = std::move(queue_.front());
-      queue_.pop_front();
-      items_count = queue_.size();
-    }
+    bool more_available = HasQueuedResources();
+
+    consumer(std::move(slot.resource));
 
-    consumer(std::move(resource));
+    Release();
 
-    empty_.Signal();
-    --inflight_;
+    TRACE_FLOW_END("flutter", "PipelineItem", slot.trace_id);
+    TRACE_EVENT_ASYNC_END0("flutter", "PipelineItem", slot.trace_id);
 
-    TRACE_FLOW_END("flutter", "PipelineItem", trace_id);
-    TRACE_EVENT_ASYNC_END0("flutter", "PipelineItem", trace_id);
+    return more_available ? PipelineConsumeResult::MoreAvailable
+                          : PipelineConsumeResult::Done;
+  }
 
-    return items_count > 0 ? PipelineConsumeResult::MoreAvailable
-                           : PipelineConsumeResult::Done;
+  /// Reports how long the consumer took to process the last resource, and
+  /// how long it could have taken without missing a frame. Adaptive
+  /// pipelines use this to let the producer run further ahead of a consumer
+  /// that keeps missing frames. Must be called on the consumer thread.
+  void ReportConsumerTime(fml::TimeDelta consumer_time,
+                          fml::TimeDelta frame_budget) {
+    if (policy_ != FramePipelinePolicy::kAdaptiveDepth) {
+      return;
+    }
+    uint32_t depth = depth_.load(std::memory_order_relaxed);
+    if (consumer_time > frame_budget) {
+      fast_frames_ = 0;
+      if (++slow_frames_ >= kSlowFramesToGrow && depth < slots_.size()) {
+        depth_.store(depth + 1, std::memory_order_relaxed);
+        slow_frames_ = 0;
+      }
+    } else {
+      slow_frames_ = 0;
+      if (++fast_frames_ >= kFastFramesToShrink && depth > base_depth_) {
+        depth_.store(depth - 1, std::memory_order_relaxed);
+        fast_frames_ = 0;
+      }
+    }
   }
 
  private:
-  fml::Semaphore empty_;
-  fml::Semaphore available_;
-  std::atomic<int> inflight_;
-  std::mutex queue_mutex_;
-  std::deque<std::pair<ResourcePtr, size_t>> queue_;
+  struct Slot {
+    ResourcePtr resource;
+    size_t trace_id = 0;
+    fml::TimePoint produce_time;
+  };
+
+  const FramePipelinePolicy policy_;
+  const uint32_t base_depth_;
+  std::atomic<uint32_t> depth_;
+  // Sized for the maximum depth. The reservations counted by |inflight_|
+  // guarantee that the producer never overwrites a slot that has not been
+  // consumed yet.
+  std::vector<Slot> slots_;
+  // The number of resources that have been reserved by the producer and not
+  // yet released by the consumer, including queued resources.
+  std::atomic<uint32_t> inflight_;
+  // Monotonic indices into |slots_|. |head_| is only written by the consumer
+  // and |tail_| only by the producer.
+  std::atomic<size_t> head_;
+  std::atomic<size_t> tail_;
+  // A resubmitted resource, only accessed on the consumer thread.
+  Slot front_slot_;
+  std::atomic<size_t> dropped_count_ = {0};
+  // Only accessed on the consumer thread.
+  size_t slow_frames_ = 0;
+  size_t fast_frames_ = 0;
+
+  bool TryReserve() {
+    uint32_t inflight = inflight_.load(std::memory_order_relaxed);
+    do {
+      if (inflight >= depth_.load(std::memory_order_relaxed)) {
+        return false;
+      }
+    } while (!inflight_.compare_exchange_weak(inflight, inflight + 1,
+                                              std::memory_order_acq_rel,
+                                              std::memory_order_relaxed));
+    FML_TRACE_COUNTER("flutter", "Pipeline Depth",
+                      reinterpret_cast<int64_t>(this),  //
+                      "frames in flight", inflight + 1  //
+    );
+    return true;
+  }
+
+  void Release() { inflight_.fetch_sub(1, std::memory_order_acq_rel); }
+
+  bool HasQueuedResources() const {
+    return front_slot_.resource != nullptr ||
+           head_.load(std::memory_order_relaxed) !=
+               tail_.load(std::memory_order_acquire);
+  }
+
+  void DropSlot(Slot slot) {
+    slot.resource.reset();
+    Release();
+    dropped_count_.fetch_add(1, std::memory_order_relaxed);
+    TRACE_FLOW_END("flutter", "PipelineItem", slot.trace_id);
+    TRACE_EVENT_ASYNC_END0("flutter", "PipelineItem", slot.trace_id);
+  }
 
   PipelineProduceResult ProducerCommit(ResourcePtr resource, size_t trace_id) {
-    bool is_first_item = false;
-    {
-      std::scoped_lock lock(queue_mutex_);
-      is_first_item = queue_.empty();
-      queue_.emplace_back(std::move(resource), trace_id);
+    if (!resource) {
+      // The continuation was dropped without a resource.
+      Release();
+      return {.success = false, .is_first_item = false};
     }
 
-    // Ensure the queue mutex is not held as that would be a pessimization.
-    available_.Signal();
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    bool is_first_item = tail == head_.load(std::memory_order_acquire);
+    slots_[tail % slots_.size()] = {std::move(resource), trace_id,
+                                    fml::TimePoint::Now()};
+    tail_.store(tail + 1, std::memory_order_release);
     return {.success = true, .is_first_item = is_first_item};
   }
 
   PipelineProduceResult ProducerCommitIfEmpty(ResourcePtr resource,
                                               size_t trace_id) {
-    {
-      std::scoped_lock lock(queue_mutex_);
-      if (!queue_.empty()) {
-        // Bail if the queue is not empty, opens up spaces to produce other
-        // frames.
-        empty_.Signal();
-        return {.success = false, .is_first_item = false};
-      }
-      queue_.emplace_back(std::move(resource), trace_id);
+    if (!resource || HasQueuedResources()) {
+      // Bail if the queue is not empty, opens up spaces to produce other
+      // frames.
+      Release();
+      return {.success = false, .is_first_item = false};
     }
-
-    // Ensure the queue mutex is not held as that would be a pessimization.
-    available_.Signal();
+    front_slot_ = {std::move(resource), trace_id, fml::TimePoint::Now()};
     return {.success = true, .is_first_item = true};
   }
 
@@ -9,7 +9,9 @@
 #include <functional>
 #include <future>
 #include <memory>
+#include <vector>
 
+#include "flutter/fml/metrics.h"
 #include "gtest/gtest.h"
 
 namespace flutter {
@@ -144,5 +146,157 @@ TEST(PipelineTest, ProduceIfEmptySuccessfulIfQueueIsEmpty) {
   ASSERT_EQ(consume_result_1, PipelineConsumeResult::Done);
 }
 
+TEST(PipelineTest, LatestWinsDropsStaleItems) {
+  const int depth = 3;
+  std::shared_ptr<IntPipeline> pipeline = std::make_shared<IntPipeline>(
+      depth, FramePipelinePolicy::kLatestWins);
+
+  for (int i = 1; i <= depth; i++) {
+    PipelineProduceResult result =
+        pipeline->Produce().Complete(std::make_unique<int>(i));
+    ASSERT_EQ(result.success, true);
+  }
+
+  PipelineConsumeResult consume_result = pipeline->Consume(
+      [](std::unique_ptr<int> v) { ASSERT_EQ(*v, depth); });
+  ASSERT_EQ(consume_result, PipelineConsumeResult::Done);
+  ASSERT_EQ(pipeline->GetDroppedCount(), 2u);
+
+  // The dropped items no longer count towards the depth.
+  std::vector<Continuation> continuations;
+  for (int i = 1; i <= depth; i++) {
+    continuations.push_back(pipeline->Produce());
+    ASSERT_TRUE(continuations.back());
+  }
+  ASSERT_FALSE(pipeline->Produce());
+}
+
+TEST(PipelineTest, ResubmittedItemIsConsumedFirst) {
+  const int depth = 2;
+  std::shared_ptr<IntPipeline> pipeline = std::make_shared<IntPipeline>(depth);
+
+  const int test_val_1 = 1, test_val_2 = 2;
+  PipelineProduceResult result =
+      pipeline->Produce().Complete(std::make_unique<int>(test_val_1));
+  ASSERT_EQ(result.success, true);
+
+  PipelineConsumeResult consume_result =
+      pipeline->Consume([&pipeline](std::unique_ptr<int> v) {
+        PipelineProduceResult result =
+            pipeline->ProduceIfEmpty().Complete(std::move(v));
+        ASSERT_EQ(result.success, true);
+      });
+  ASSERT_EQ(consume_result, PipelineConsumeResult::Done);
+
+  result = pipeline->Produce().Complete(std::make_unique<int>(test_val_2));
+  ASSERT_EQ(result.success, true);
+  ASSERT_EQ(result.is_first_item, true);
+
+  consume_result = pipeline->Consume(
+      [&test_val_1](std::unique_ptr<int> v) { ASSERT_EQ(*v, test_val_1); });
+  ASSERT_EQ(consume_result, PipelineConsumeResult::MoreAvailable);
+  consume_result = pipeline->Consume(
+      [&test_val_2](std::unique_ptr<int> v) { ASSERT_EQ(*v, test_val_2); });
+  ASSERT_EQ(consume_result, PipelineConsumeResult::Done);
+}
+
+TEST(PipelineTest, LatestWinsDropsResubmittedItemForNewerItem) {
+  const int depth = 3;
+  std::shared_ptr<IntPipeline> pipeline = std::make_shared<IntPipeline>(
+      depth, FramePipelinePolicy::kLatestWins);
+
+  const int test_val_1 = 1, test_val_2 = 2, test_val_3 = 3;
+  PipelineProduceResult result =
+      pipeline->Produce().Complete(std::make_unique<int>(test_val_1));
+  ASSERT_EQ(result.success, true);
+
+  PipelineConsumeResult consume_result =
+      pipeline->Consume([&pipeline](std::unique_ptr<int> v) {
+        PipelineProduceResult result =
+            pipeline->ProduceIfEmpty().Complete(std::move(v));
+        ASSERT_EQ(result.success, true);
+      });
+  ASSERT_EQ(consume_result, PipelineConsumeResult::Done);
+
+  result = pipeline->Produce().Complete(std::make_unique<int>(test_val_2));
+  ASSERT_EQ(result.success, true);
+  result = pipeline->Produce().Complete(std::make_unique<int>(test_val_3));
+  ASSERT_EQ(result.success, true);
+
+  consume_result = pipeline->Consume(
+      [&test_val_3](std::unique_ptr<int> v) { ASSERT_EQ(*v, test_val_3); });
+  ASSERT_EQ(consume_result, PipelineConsumeResult::Done);
+  ASSERT_EQ(pipeline->GetDroppedCount(), 2u);
+
+  // The dropped items no longer count towards the depth.
+  std::vector<Continuation> continuations;
+  for (int i = 1; i <= depth; i++) {
+    continuations.push_back(pipeline->Produce());
+    ASSERT_TRUE(continuations.back());
+  }
+}
+
+TEST(PipelineTest, AdaptiveDepthGrowsWhileConsumerIsSlow) {
+  const int depth = 1;
+  std::shared_ptr<IntPipeline> pipeline = std::make_shared<IntPipeline>(
+      depth, FramePipelinePolicy::kAdaptiveDepth);
+  const auto frame_budget = fml::TimeDelta::FromMilliseconds(16);
+  const auto slow_frame = fml::TimeDelta::FromMilliseconds(20);
+  const auto fast_frame = fml::TimeDelta::FromMilliseconds(8);
+
+  ASSERT_EQ(pipeline->GetDepth(), 1u);
+  Continuation continuation_1 = pipeline->Produce();
+  ASSERT_TRUE(continuation_1);
+  ASSERT_FALSE(pipeline->Produce());
+
+  for (size_t i = 0; i < 2 * IntPipeline::kSlowFramesToGrow; i++) {
+    pipeline->ReportConsumerTime(slow_frame, frame_budget);
+  }
+  ASSERT_EQ(pipeline->GetDepth(), IntPipeline::kMaxAdaptiveDepth);
+  Continuation continuation_2 = pipeline->Produce();
+  Continuation continuation_3 = pipeline->Produce();
+  ASSERT_TRUE(continuation_2);
+  ASSERT_TRUE(continuation_3);
+  ASSERT_FALSE(pipeline->Produce());
+
+  // The depth does not grow any further.
+  for (size_t i = 0; i < IntPipeline::kSlowFramesToGrow; i++) {
+    pipeline->ReportConsumerTime(slow_frame, frame_budget);
+  }
+  ASSERT_EQ(pipeline->GetDepth(), IntPipeline::kMaxAdaptiveDepth);
+
+  for (size_t i = 0; i < 2 * IntPipeline::kFastFramesToShrink; i++) {
+    pipeline->ReportConsumerTime(fast_frame, frame_budget);
+  }
+  ASSERT_EQ(pipeline->GetDepth(), 1u);
+}
+
+TEST(PipelineTest, FifoDepthIsFixed) {
+  const int depth = 2;
+  std::shared_ptr<IntPipeline> pipeline = std::make_shared<IntPipeline>(depth);
+  for (size_t i = 0; i < 2 * IntPipeline::kSlowFramesToGrow; i++) {
+    pipeline->ReportConsumerTime(fml::TimeDelta::FromMilliseconds(20),
+                                 fml::TimeDelta::FromMilliseconds(16));
+  }
+  ASSERT_EQ(pipeline->GetDepth(), 2u);
+}
+
+TEST(PipelineTest, QueueLatencyIsRecordedInMetrics) {
+  fml::metrics::Histogram& histogram =
+      fml::metrics::MetricsRegistry::GetInstance().GetHistogram(
+          "flutter.Pipeline.QueueLatencyMicros");
+  uint64_t count = histogram.GetSnapshot().count;
+
+  std::shared_ptr<IntPipeline> pipeline = std::make_shared<IntPipeline>(2);
+  pipeline->Produce().Complete(std::make_unique<int>(1));
+  pipeline->Produce().Complete(std::make_unique<int>(2));
+  ASSERT_EQ(pipeline->Consume([](std::unique_ptr<int> v) {}),
+            PipelineConsumeResult::MoreAvailable);
+  ASSERT_EQ(pipeline->Consume([](std::unique_ptr<int> v) {}),
+            PipelineConsumeResult::Done);
+
+  ASSERT_EQ(histogram.GetSnapshot().count, count + 2);
+}
+
 }  // namespace testing
 }  // namespace flutter
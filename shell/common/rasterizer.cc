@@ -22,6 +22,10 @@
 #include "third_party/skia/include/core/SkSurfaceCharacterization.h"
 #include "third_party/skia/include/utils/SkBase64.h"
 
+#if IMPELLER_SUPPORTS_RENDERING
+#include "flutter/impeller/aiks/aiks_context.h"  // nogncheck
+#endif  // IMPELLER_SUPPORTS_RENDERING
+
 namespace flutter {
 
 // The rasterizer will tell Skia to purge cached resources that have not been
@@ -38,6 +42,8 @@ Rasterizer::Rasterizer(Delegate& delegate,
           SnapshotController::Make(*this, delegate.GetSettings())),
       weak_factory_(this) {
   FML_DCHECK(compositor_context_);
+  compositor_context_->raster_cache().SetMaxBytes(
+      delegate.GetSettings().raster_cache_max_bytes);
 }
 
 Rasterizer::~Rasterizer() = default;
@@ -130,6 +136,12 @@ void Rasterizer::NotifyLowMemoryWarning() const {
         << "Rasterizer::NotifyLowMemoryWarning called with no surface.";
     return;
   }
+#if IMPELLER_SUPPORTS_RENDERING
+  if (auto aiks_context = surface_->GetAiksContext()) {
+    aiks_context->NotifyLowMemoryWarning();
+    return;
+  }
+#endif  // IMPELLER_SUPPORTS_RENDERING
   auto context = surface_->GetContext();
   if (!context) {
     FML_DLOG(INFO)
@@ -194,8 +206,16 @@ RasterStatus Rasterizer::Draw(
         if (discard_callback(*layer_tree.get())) {
           raster_status = RasterStatus::kDiscarded;
         } else {
+          fml::TimeDelta frame_budget =
+              frame_timings_recorder
+                  ? frame_timings_recorder->GetVsyncTargetTime() -
+                        frame_timings_recorder->GetVsyncStartTime()
+                  : fml::TimeDelta::Max();
+          fml::TimePoint raster_start = fml::TimePoint::Now();
           raster_status =
               DoDraw(std::move(frame_timings_recorder), std::move(layer_tree));
+          pipeline->ReportConsumerTime(fml::TimePoint::Now() - raster_start,
+                                       frame_budget);
         }
       };
 
@@ -554,10 +574,19 @@ RasterStatus Rasterizer::DrawToSurfaceUnsafe(
       damage = std::make_unique<FrameDamage>();
       if (frame->framebuffer_info().existing_damage && !force_full_repaint) {
         damage->SetPreviousLayerTree(last_layer_tree_.get());
-        damage->AddAdditionalDamage(*frame->framebuffer_info().existing_damage);
-        damage->SetClipAlignment(
-            frame->framebuffer_info().horizontal_clip_alignment,
-            frame->framebuffer_info().vertical_clip_alignment);
+        const auto& framebuffer_info = frame->framebuffer_info();
+        if (framebuffer_info.existing_damage_rects.empty()) {
+          damage->AddAdditionalDamage(*framebuffer_info.existing_damage);
+        } else {
+          for (const auto& rect : framebuffer_info.existing_damage_rects) {
+            damage->AddAdditionalDamage(rect);
+          }
+        }
+        damage->SetClipAlignment(framebuffer_info.horizontal_clip_alignment,
+                                 framebuffer_info.vertical_clip_alignment);
+        DamageMergePolicy merge_policy;
+        merge_policy.max_rects = framebuffer_info.max_damage_rects;
+        damage->SetMergePolicy(merge_policy);
       }
     }
 
@@ -589,6 +618,8 @@ RasterStatus Rasterizer::DrawToSurfaceUnsafe(
     if (damage) {
       submit_info.frame_damage = damage->GetFrameDamage();
       submit_info.buffer_damage = damage->GetBufferDamage();
+      submit_info.frame_damage_rects = damage->GetFrameDamageRects();
+      submit_info.buffer_damage_rects = damage->GetBufferDamageRects();
     }
 
     frame->set_submit_info(submit_info);
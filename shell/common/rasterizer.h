@@ -173,7 +173,8 @@ class Rasterizer final : public SnapshotDelegate,
   /// @brief      Notifies the rasterizer that there is a low memory situation
   ///             and it must purge as many unnecessary resources as possible.
   ///             Currently, the Skia context associated with onscreen rendering
-  ///             is told to free GPU resources.
+  ///             is told to free GPU resources, or with Impeller, the caches
+  ///             of its content context are dropped.
   ///
   void NotifyLowMemoryWarning() const;
 
@@ -12,6 +12,7 @@
 
 #include "flutter/assets/directory_asset_bundle.h"
 #include "flutter/common/graphics/persistent_cache.h"
+#include "flutter/fml/async_task.h"
 #include "flutter/fml/base32.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/icu_util.h"
@@ -19,6 +20,8 @@
 #include "flutter/fml/logging.h"
 #include "flutter/fml/make_copyable.h"
 #include "flutter/fml/message_loop.h"
+#include "flutter/fml/message_loop_task_queues.h"
+#include "flutter/fml/metrics.h"
 #include "flutter/fml/paths.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/runtime/dart_vm.h"
@@ -42,6 +45,74 @@ constexpr char kFontChange[] = "fontsChange";
 
 namespace {
 
+// Releases |object| on |task_runner|, the thread that created and uses it.
+template <typename T>
+void ReleaseOnTaskRunner(const fml::RefPtr<fml::TaskRunner>& task_runner,
+                         T object) {
+  if (!object) {
+    return;
+  }
+  fml::TaskRunner::RunNowOrPostTask(
+      task_runner,
+      fml::MakeCopyable([object = std::move(object)]() mutable {
+        object = nullptr;
+      }));
+}
+
+// The subsystems of a shell that are created on the raster thread. If the
+// shell isn't created, they may be dropped on any thread (by a cancelled
+// |fml::AsyncTask|, for instance), so whatever wasn't handed to the shell is
+// released back on the raster thread.
+struct RasterSubsystem {
+  RasterSubsystem(
+      fml::RefPtr<fml::TaskRunner> raster_task_runner,
+      std::unique_ptr<Rasterizer> rasterizer,
+      fml::TaskRunnerAffineWeakPtr<SnapshotDelegate> snapshot_delegate)
+      : raster_task_runner(std::move(raster_task_runner)),
+        rasterizer(std::move(rasterizer)),
+        snapshot_delegate(std::move(snapshot_delegate)) {}
+
+  RasterSubsystem(RasterSubsystem&&) = default;
+
+  RasterSubsystem& operator=(RasterSubsystem&&) = default;
+
+  ~RasterSubsystem() {
+    ReleaseOnTaskRunner(raster_task_runner, std::move(rasterizer));
+  }
+
+  fml::RefPtr<fml::TaskRunner> raster_task_runner;
+  std::unique_ptr<Rasterizer> rasterizer;
+  fml::TaskRunnerAffineWeakPtr<SnapshotDelegate> snapshot_delegate;
+};
+
+// The subsystems of a shell that are created on the IO thread. Like the raster
+// subsystem, whatever wasn't handed to the shell is released back on the IO
+// thread.
+struct IOSubsystem {
+  IOSubsystem(fml::RefPtr<fml::TaskRunner> io_task_runner,
+              std::shared_ptr<ShellIOManager> io_manager,
+              fml::WeakPtr<ShellIOManager> weak_io_manager,
+              fml::RefPtr<SkiaUnrefQueue> unref_queue)
+      : io_task_runner(std::move(io_task_runner)),
+        io_manager(std::move(io_manager)),
+        weak_io_manager(std::move(weak_io_manager)),
+        unref_queue(std::move(unref_queue)) {}
+
+  IOSubsystem(IOSubsystem&&) = default;
+
+  IOSubsystem& operator=(IOSubsystem&&) = default;
+
+  ~IOSubsystem() {
+    ReleaseOnTaskRunner(io_task_runner, std::move(unref_queue));
+    ReleaseOnTaskRunner(io_task_runner, std::move(io_manager));
+  }
+
+  fml::RefPtr<fml::TaskRunner> io_task_runner;
+  std::shared_ptr<ShellIOManager> io_manager;
+  fml::WeakPtr<ShellIOManager> weak_io_manager;
+  fml::RefPtr<SkiaUnrefQueue> unref_queue;
+};
+
 std::unique_ptr<Engine> CreateEngine(
     Engine::Delegate& delegate,
     const PointerDataDispatcherMaker& dispatcher_maker,
@@ -96,6 +167,10 @@ void PerformInitializationTasks(Settings& settings) {
       fml::tracing::TraceSetAllowlist(settings.trace_allowlist);
     }
 
+    if (settings.trace_ring_buffer_size > 0) {
+      fml::tracing::TraceRingBufferEnable(settings.trace_ring_buffer_size);
+    }
+
     if (!settings.skia_deterministic_rendering_on_cpu) {
       SkGraphics::Init();
     } else {
@@ -187,21 +262,27 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
                 is_gpu_disabled));
 
   // Create the rasterizer on the raster thread.
-  std::promise<std::unique_ptr<Rasterizer>> rasterizer_promise;
-  auto rasterizer_future = rasterizer_promise.get_future();
-  std::promise<fml::TaskRunnerAffineWeakPtr<SnapshotDelegate>>
-      snapshot_delegate_promise;
-  auto snapshot_delegate_future = snapshot_delegate_promise.get_future();
-  fml::TaskRunner::RunNowOrPostTask(
-      task_runners.GetRasterTaskRunner(), [&rasterizer_promise,  //
-                                           &snapshot_delegate_promise,
-                                           on_create_rasterizer,  //
-                                           shell = shell.get()    //
-  ]() {
+  auto raster_subsystem = fml::AsyncTask<RasterSubsystem>::Run(
+      task_runners.GetRasterTaskRunner(),
+      [on_create_rasterizer, shell = shell.get()]() {
         TRACE_EVENT0("flutter", "ShellSetupGPUSubsystem");
         std::unique_ptr<Rasterizer> rasterizer(on_create_rasterizer(*shell));
-        snapshot_delegate_promise.set_value(rasterizer->GetSnapshotDelegate());
-        rasterizer_promise.set_value(std::move(rasterizer));
+        if (shell->GetSettings().enable_concurrent_layer_painting) {
+          auto worker_loop = shell->GetDartVM()->GetConcurrentMessageLoop();
+          rasterizer->compositor_context()->SetConcurrentPaintTaskRunner(
+              worker_loop->GetTaskRunner(), worker_loop->GetWorkerCount());
+        }
+        if (shell->GetSettings().raster_cache_max_async_jobs > 0) {
+          rasterizer->compositor_context()
+              ->raster_cache()
+              .SetAsyncRasterizeTaskRunner(
+                  shell->GetDartVM()->GetConcurrentWorkerTaskRunner(),
+                  shell->GetSettings().raster_cache_max_async_jobs);
+        }
+        auto snapshot_delegate = rasterizer->GetSnapshotDelegate();
+        return RasterSubsystem(shell->GetTaskRunners().GetRasterTaskRunner(),
+                               std::move(rasterizer),
+                               std::move(snapshot_delegate));
       });
 
   // Create the platform view on the platform thread (this thread).
@@ -221,23 +302,14 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
   // first because it has state that the other subsystems depend on. It must
   // first be booted and the necessary references obtained to initialize the
   // other subsystems.
-  std::promise<std::shared_ptr<ShellIOManager>> io_manager_promise;
-  auto io_manager_future = io_manager_promise.get_future();
-  std::promise<fml::WeakPtr<ShellIOManager>> weak_io_manager_promise;
-  auto weak_io_manager_future = weak_io_manager_promise.get_future();
-  std::promise<fml::RefPtr<SkiaUnrefQueue>> unref_queue_promise;
-  auto unref_queue_future = unref_queue_promise.get_future();
   auto io_task_runner = shell->GetTaskRunners().GetIOTaskRunner();
 
   // The platform_view will be stored into shell's platform_view_ in
   // shell->Setup(std::move(platform_view), ...) at the end.
   PlatformView* platform_view_ptr = platform_view.get();
-  fml::TaskRunner::RunNowOrPostTask(
+  auto io_subsystem = fml::AsyncTask<IOSubsystem>::Run(
       io_task_runner,
-      [&io_manager_promise,                                               //
-       &weak_io_manager_promise,                                          //
-       &parent_io_manager,                                                //
-       &unref_queue_promise,                                              //
+      [parent_io_manager,                                                 //
        platform_view_ptr,                                                 //
        io_task_runner,                                                    //
        is_backgrounded_sync_switch = shell->GetIsGpuDisabledSyncSwitch()  //
@@ -254,57 +326,78 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
               platform_view_ptr->GetImpellerContext()  // impeller context
           );
         }
-        weak_io_manager_promise.set_value(io_manager->GetWeakPtr());
-        unref_queue_promise.set_value(io_manager->GetSkiaUnrefQueue());
-        io_manager_promise.set_value(io_manager);
+        auto weak_io_manager = io_manager->GetWeakPtr();
+        auto unref_queue = io_manager->GetSkiaUnrefQueue();
+        return IOSubsystem(io_task_runner, std::move(io_manager),
+                           std::move(weak_io_manager), std::move(unref_queue));
       });
 
   // Send dispatcher_maker to the engine constructor because shell won't have
   // platform_view set until Shell::Setup is called later.
   auto dispatcher_maker = platform_view->GetDispatcherMaker();
 
-  // Create the engine on the UI thread.
-  std::promise<std::unique_ptr<Engine>> engine_promise;
-  auto engine_future = engine_promise.get_future();
-  fml::TaskRunner::RunNowOrPostTask(
-      shell->GetTaskRunners().GetUITaskRunner(),
-      fml::MakeCopyable([&engine_promise,                                 //
-                         shell = shell.get(),                             //
-                         &dispatcher_maker,                               //
-                         &platform_data,                                  //
-                         isolate_snapshot = std::move(isolate_snapshot),  //
-                         vsync_waiter = std::move(vsync_waiter),          //
-                         &weak_io_manager_future,                         //
-                         &snapshot_delegate_future,                       //
-                         &unref_queue_future,                             //
-                         &on_create_engine]() mutable {
-        TRACE_EVENT0("flutter", "ShellSetupUISubsystem");
-        const auto& task_runners = shell->GetTaskRunners();
-
-        // The animator is owned by the UI thread but it gets its vsync pulses
-        // from the platform.
-        auto animator = std::make_unique<Animator>(*shell, task_runners,
-                                                   std::move(vsync_waiter));
-
-        engine_promise.set_value(
-            on_create_engine(*shell,                          //
-                             dispatcher_maker,                //
-                             *shell->GetDartVM(),             //
-                             std::move(isolate_snapshot),     //
-                             task_runners,                    //
-                             platform_data,                   //
-                             shell->GetSettings(),            //
-                             std::move(animator),             //
-                             weak_io_manager_future.get(),    //
-                             unref_queue_future.get(),        //
-                             snapshot_delegate_future.get(),  //
-                             shell->volatile_path_tracker_));
-      }));
+  // Create the engine on the UI thread once the IO and raster subsystems it
+  // needs are ready, instead of blocking the UI thread until they are.
+  auto ui_task_runner = shell->GetTaskRunners().GetUITaskRunner();
+  auto io_and_raster_subsystems =
+      fml::WhenAll(std::move(io_subsystem), std::move(raster_subsystem));
+  if (ui_task_runner->RunsTasksOnCurrentThread()) {
+    // The engine can't be created on this thread while it waits for the shell
+    // below, so wait for its dependencies first and create it right away.
+    io_and_raster_subsystems.Wait();
+  }
+  auto create_engine = [shell = shell.get(),                             //
+                        &dispatcher_maker,                               //
+                        &platform_data,                                  //
+                        isolate_snapshot = std::move(isolate_snapshot),  //
+                        vsync_waiter = std::move(vsync_waiter),          //
+                        &on_create_engine](
+                           std::tuple<IOSubsystem, RasterSubsystem>
+                               io_and_raster) mutable {
+    TRACE_EVENT0("flutter", "ShellSetupUISubsystem");
+    auto& [io, raster] = io_and_raster;
+    const auto& task_runners = shell->GetTaskRunners();
+
+    // The animator is owned by the UI thread but it gets its vsync pulses
+    // from the platform.
+    auto animator = std::make_unique<Animator>(
+        *shell, task_runners, std::move(vsync_waiter),
+        shell->GetSettings().frame_pipeline_policy);
+
+    auto engine = on_create_engine(*shell,                       //
+                                   dispatcher_maker,             //
+                                   *shell->GetDartVM(),          //
+                                   std::move(isolate_snapshot),  //
+                                   task_runners,                 //
+                                   platform_data,                //
+                                   shell->GetSettings(),         //
+                                   std::move(animator),          //
+                                   io.weak_io_manager,           //
+                                   io.unref_queue,               //
+                                   raster.snapshot_delegate,     //
+                                   shell->volatile_path_tracker_);
+    // The subsystems are handed on whole so that, until the shell takes
+    // them, they are still released on their own threads.
+    return std::make_tuple(std::move(engine), std::move(raster),
+                           std::move(io));
+  };
+  auto subsystems = std::move(io_and_raster_subsystems)
+                        .Then(ui_task_runner, std::move(create_engine));
 
-  if (!shell->Setup(std::move(platform_view),  //
-                    engine_future.get(),       //
-                    rasterizer_future.get(),   //
-                    io_manager_future.get())   //
+  auto created = std::move(subsystems).Get();
+  if (!created.has_value()) {
+    // A task runner was shut down before the subsystems could be created.
+    return nullptr;
+  }
+  auto& [engine, raster, io] = *created;
+  if (!engine || !raster.rasterizer) {
+    // The subsystems are released on their threads on the way out.
+    return nullptr;
+  }
+  if (!shell->Setup(std::move(platform_view),     //
+                    std::move(engine),            //
+                    std::move(raster.rasterizer), //
+                    std::move(io.io_manager))     //
   ) {
     return nullptr;
   }
@@ -560,7 +653,8 @@ void Shell::NotifyLowMemoryWarning() const {
   // running.
   ::Dart_NotifyLowMemory();
 
-  task_runners_.GetRasterTaskRunner()->PostTask(
+  // Purging can wait until the frame being rasterized is done.
+  task_runners_.GetRasterTaskRunner()->PostIdleTask(
       [rasterizer = rasterizer_->GetWeakPtr(), trace_id = trace_id]() {
         if (rasterizer) {
           rasterizer->NotifyLowMemoryWarning();
@@ -568,6 +662,11 @@ void Shell::NotifyLowMemoryWarning() const {
         TRACE_EVENT_ASYNC_END0("flutter", "Shell::NotifyLowMemoryWarning",
                                trace_id);
       });
+  task_runners_.GetUITaskRunner()->PostTask([engine = weak_engine_]() {
+    if (engine) {
+      engine->NotifyLowMemoryWarning();
+    }
+  });
   // The IO Manager uses resource cache limits of 0, so it is not necessary
   // to purge them.
 }
@@ -967,6 +1066,9 @@ void Shell::OnPlatformViewDispatchPlatformMessage(
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
 
+  FML_METRICS_HISTOGRAM("flutter.PlatformMessage.SentBytes")
+      .Record(message->data().GetSize());
+
   // The static leak checker gets confused by the use of fml::MakeCopyable.
   // NOLINTNEXTLINE(clang-analyzer-cplusplus.NewDeleteLeaks)
   task_runners_.GetUITaskRunner()->PostTask(fml::MakeCopyable(
@@ -1168,12 +1270,22 @@ void Shell::OnAnimatorDraw(std::shared_ptr<LayerTreePipeline> pipeline) {
            tree.frame_size() != expected_frame_size_;
   };
 
+  // Hold back the idle tasks of the raster task runner until the frame has
+  // been drawn.
+  auto raster_task_queue_id =
+      task_runners_.GetRasterTaskRunner()->GetTaskQueueId();
+  fml::MessageLoopTaskQueues::GetInstance()->SetFrameDeadline(
+      raster_task_queue_id, fml::TimePoint::Max());
+
   task_runners_.GetRasterTaskRunner()->PostTask(fml::MakeCopyable(
       [&waiting_for_first_frame = waiting_for_first_frame_,
        &waiting_for_first_frame_condition = waiting_for_first_frame_condition_,
        rasterizer = rasterizer_->GetWeakPtr(),
        weak_pipeline = std::weak_ptr<LayerTreePipeline>(pipeline),
-       discard_callback = std::move(discard_callback)]() mutable {
+       discard_callback = std::move(discard_callback),
+       raster_task_queue_id]() mutable {
+        fml::MessageLoopTaskQueues::GetInstance()->ClearFrameDeadline(
+            raster_task_queue_id);
         if (rasterizer) {
           std::shared_ptr<LayerTreePipeline> pipeline = weak_pipeline.lock();
           if (pipeline) {
@@ -1225,6 +1337,9 @@ void Shell::OnEngineHandlePlatformMessage(
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
 
+  FML_METRICS_HISTOGRAM("flutter.PlatformMessage.ReceivedBytes")
+      .Record(message->data().GetSize());
+
   if (message->channel() == kSkiaChannel) {
     HandleEngineSkiaMessage(std::move(message));
     return;
@@ -4,8 +4,12 @@
 
 #include "flutter/shell/common/shell.h"
 
+#include <chrono>
+#include <thread>
+
 #include "flutter/benchmarking/benchmarking.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/time/time_delta.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/testing/elf_loader.h"
@@ -13,9 +17,11 @@
 
 namespace flutter {
 
-static void StartupAndShutdownShell(benchmark::State& state,
-                                    bool measure_startup,
-                                    bool measure_shutdown) {
+static void StartupAndShutdownShell(
+    benchmark::State& state,
+    bool measure_startup,
+    bool measure_shutdown,
+    fml::TimeDelta rasterizer_creation_delay = fml::TimeDelta::Zero()) {
   auto assets_dir = fml::OpenDirectory(testing::GetFixturesPath(), false,
                                        fml::FilePermission::kRead);
   std::unique_ptr<Shell> shell;
@@ -59,7 +65,12 @@ static void StartupAndShutdownShell(benchmark::State& state,
         [](Shell& shell) {
           return std::make_unique<PlatformView>(shell, shell.GetTaskRunners());
         },
-        [](Shell& shell) { return std::make_unique<Rasterizer>(shell); });
+        [rasterizer_creation_delay](Shell& shell) {
+          // Stands in for the time a GPU context takes to set up.
+          std::this_thread::sleep_for(std::chrono::microseconds(
+              rasterizer_creation_delay.ToMicroseconds()));
+          return std::make_unique<Rasterizer>(shell);
+        });
   }
 
   FML_CHECK(shell);
@@ -104,6 +115,20 @@ static void BM_ShellInitialization(benchmark::State& state) {
 
 BENCHMARK(BM_ShellInitialization);
 
+// The IO and UI subsystems are set up while the rasterizer is created, so the
+// startup time should grow by less than the delay of the rasterizer.
+static void BM_ShellInitializationWithSlowRasterizer(benchmark::State& state) {
+  while (state.KeepRunning()) {
+    StartupAndShutdownShell(state, true, false,
+                            fml::TimeDelta::FromMilliseconds(state.range(0)));
+  }
+}
+
+BENCHMARK(BM_ShellInitializationWithSlowRasterizer)
+    ->Arg(0)
+    ->Arg(8)
+    ->Unit(benchmark::kMillisecond);
+
 static void BM_ShellShutdown(benchmark::State& state) {
   while (state.KeepRunning()) {
     StartupAndShutdownShell(state, false, true);
@@ -297,6 +297,22 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.enable_software_rendering =
       command_line.HasOption(FlagForSwitch(Switch::EnableSoftwareRendering));
 
+  settings.enable_concurrent_layer_painting = command_line.HasOption(
+      FlagForSwitch(Switch::EnableConcurrentLayerPainting));
+
+  std::string frame_pipeline_policy;
+  if (command_line.GetOptionValue(FlagForSwitch(Switch::FramePipelinePolicy),
+                                  &frame_pipeline_policy)) {
+    if (frame_pipeline_policy == "latest-wins") {
+      settings.frame_pipeline_policy = FramePipelinePolicy::kLatestWins;
+    } else if (frame_pipeline_policy == "adaptive-depth") {
+      settings.frame_pipeline_policy = FramePipelinePolicy::kAdaptiveDepth;
+    } else if (frame_pipeline_policy != "fifo") {
+      FML_LOG(ERROR) << "Unknown frame pipeline policy '"
+                     << frame_pipeline_policy << "', using 'fifo'.";
+    }
+  }
+
   settings.endless_trace_buffer =
       command_line.HasOption(FlagForSwitch(Switch::EndlessTraceBuffer));
 
@@ -332,6 +348,15 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.trace_systrace =
       command_line.HasOption(FlagForSwitch(Switch::TraceSystrace));
 
+  if (command_line.HasOption(FlagForSwitch(Switch::TraceToRingBuffer))) {
+    std::string trace_ring_buffer_size;
+    command_line.GetOptionValue(FlagForSwitch(Switch::TraceToRingBuffer),
+                                &trace_ring_buffer_size);
+    settings.trace_ring_buffer_size =
+        trace_ring_buffer_size.empty() ? 4096
+                                       : std::stoull(trace_ring_buffer_size);
+  }
+
   settings.skia_deterministic_rendering_on_cpu =
       command_line.HasOption(FlagForSwitch(Switch::SkiaDeterministicRendering));
 
@@ -474,6 +499,21 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
         std::stoi(resource_cache_max_bytes_threshold);
   }
 
+  if (command_line.HasOption(FlagForSwitch(Switch::RasterCacheMaxBytes))) {
+    std::string raster_cache_max_bytes;
+    command_line.GetOptionValue(FlagForSwitch(Switch::RasterCacheMaxBytes),
+                                &raster_cache_max_bytes);
+    settings.raster_cache_max_bytes = std::stoull(raster_cache_max_bytes);
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::RasterCacheMaxAsyncJobs))) {
+    std::string raster_cache_max_async_jobs;
+    command_line.GetOptionValue(FlagForSwitch(Switch::RasterCacheMaxAsyncJobs),
+                                &raster_cache_max_async_jobs);
+    settings.raster_cache_max_async_jobs =
+        std::stoull(raster_cache_max_async_jobs);
+  }
+
   if (command_line.HasOption(FlagForSwitch(Switch::MsaaSamples))) {
     std::string msaa_samples;
     command_line.GetOptionValue(FlagForSwitch(Switch::MsaaSamples),
@@ -105,6 +105,18 @@ DEF_SWITCH(EnableSoftwareRendering,
            "Enable rendering using the Skia software backend. This is useful "
            "when testing Flutter on emulators. By default, Flutter will "
            "attempt to either use OpenGL, Metal, or Vulkan.")
+DEF_SWITCH(FramePipelinePolicy,
+           "frame-pipeline-policy",
+           "How layer trees queued for the rasterizer are consumed. One of "
+           "'fifo' (the default), 'latest-wins' to drop stale layer trees, or "
+           "'adaptive-depth' to let the UI thread run further ahead while the "
+           "rasterizer misses frames.")
+DEF_SWITCH(EnableConcurrentLayerPainting,
+           "enable-concurrent-layer-painting",
+           "Paint independent sibling layer subtrees into separate display "
+           "lists on worker threads and combine them on the raster thread. "
+           "This is useful for complex scenes made of many layers when the "
+           "raster thread is the bottleneck.")
 DEF_SWITCH(Route,
            "route",
            "Start app with an specific route defined on the framework")
@@ -148,6 +160,13 @@ DEF_SWITCH(
     "trace-allowlist",
     "Filters out all trace events except those that are specified in this "
     "comma separated list of allowed prefixes.")
+DEF_SWITCH(TraceToRingBuffer,
+           "trace-to-ring-buffer",
+           "Record trace events into a fixed-size ring buffer for each thread, "
+           "which is cheaper than the timeline. The value is the number of "
+           "events kept per thread, 4096 if it is not specified. The events "
+           "are retrieved with the _flutter.getRingBufferTrace service "
+           "extension.")
 DEF_SWITCH(DumpSkpOnShaderCompilation,
            "dump-skp-on-shader-compilation",
            "Automatically dump the skp that triggers new shader compilations. "
@@ -229,6 +248,16 @@ DEF_SWITCH(OldGenHeapSize,
 DEF_SWITCH(ResourceCacheMaxBytesThreshold,
            "resource-cache-max-bytes-threshold",
            "The max bytes threshold of resource cache, or 0 for unlimited.")
+DEF_SWITCH(RasterCacheMaxBytes,
+           "raster-cache-max-bytes",
+           "The max bytes used by the images of the raster cache, or 0 for "
+           "unlimited.")
+DEF_SWITCH(RasterCacheMaxAsyncJobs,
+           "raster-cache-max-async-jobs",
+           "The max number of display lists rasterized into the raster cache "
+           "at the same time on worker threads. Display lists are drawn "
+           "directly until their cache image is ready. 0 rasterizes them on "
+           "the raster thread in the frame where they are first cached.")
 DEF_SWITCH(EnableSkParagraph,
            "enable-skparagraph",
            "Selects the SkParagraph implementation of the text layout engine.")
@@ -58,6 +58,23 @@ TEST(SwitchesTest, RouteParsedFlag) {
   EXPECT_TRUE(settings.route.empty());
 }
 
+TEST(SwitchesTest, TraceToRingBufferFlag) {
+  fml::CommandLine command_line =
+      fml::CommandLineFromInitializerList({"command"});
+  Settings settings = SettingsFromCommandLine(command_line);
+  EXPECT_EQ(settings.trace_ring_buffer_size, 0u);
+
+  command_line = fml::CommandLineFromInitializerList(
+      {"command", "--trace-to-ring-buffer"});
+  settings = SettingsFromCommandLine(command_line);
+  EXPECT_EQ(settings.trace_ring_buffer_size, 4096u);
+
+  command_line = fml::CommandLineFromInitializerList(
+      {"command", "--trace-to-ring-buffer=256"});
+  settings = SettingsFromCommandLine(command_line);
+  EXPECT_EQ(settings.trace_ring_buffer_size, 256u);
+}
+
 TEST(SwitchesTest, MsaaSamples) {
   for (int samples : {0, 1, 2, 4, 8, 16}) {
     fml::CommandLine command_line = fml::CommandLineFromInitializerList(
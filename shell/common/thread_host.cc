@@ -10,23 +10,30 @@
 #include <string>
 #include <utility>
 
+#include "flutter/fml/message_loop_task_queues.h"
+
 namespace flutter {
 
+// The role of a thread, which is the same for the threads of every host.
+static const char* GetThreadLabel(ThreadHost::Type type) {
+  switch (type) {
+    case ThreadHost::Type::Platform:
+      return "platform";
+    case ThreadHost::Type::UI:
+      return "ui";
+    case ThreadHost::Type::IO:
+      return "io";
+    case ThreadHost::Type::RASTER:
+      return "raster";
+    case ThreadHost::Type::Profiler:
+      return "profiler";
+  }
+}
+
 std::string ThreadHost::ThreadHostConfig::MakeThreadName(
     Type type,
     const std::string& prefix) {
-  switch (type) {
-    case Type::Platform:
-      return prefix + ".platform";
-    case Type::UI:
-      return prefix + ".ui";
-    case Type::IO:
-      return prefix + ".io";
-    case Type::RASTER:
-      return prefix + ".raster";
-    case Type::Profiler:
-      return prefix + ".profiler";
-  }
+  return prefix + "." + GetThreadLabel(type);
 }
 
 void ThreadHost::ThreadHostConfig::SetIOConfig(const ThreadConfig& config) {
@@ -65,8 +72,12 @@ std::unique_ptr<fml::Thread> ThreadHost::CreateThread(
     thread_config = ThreadConfig(
         ThreadHostConfig::MakeThreadName(type, host_config.name_prefix));
   }
-  return std::make_unique<fml::Thread>(host_config.config_setter,
-                                       thread_config.value());
+  auto thread = std::make_unique<fml::Thread>(host_config.config_setter,
+                                              thread_config.value());
+  // The depth of the task queue is measured per role rather than per thread.
+  fml::MessageLoopTaskQueues::GetInstance()->SetLabel(
+      thread->GetTaskRunner()->GetTaskQueueId(), GetThreadLabel(type));
+  return thread;
 }
 
 ThreadHost::ThreadHost() = default;
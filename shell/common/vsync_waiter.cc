@@ -113,6 +113,7 @@ void VsyncWaiter::FireCallback(fml::TimePoint frame_start_time,
     auto flow_identifier = fml::tracing::TraceNonce();
     if (pause_secondary_tasks) {
       PauseDartMicroTasks();
+      DeferIdleTasks(frame_target_time);
     }
 
     // The base trace ensures that flows have a root to begin from if one does
@@ -139,6 +140,7 @@ void VsyncWaiter::FireCallback(fml::TimePoint frame_start_time,
           TRACE_FLOW_END("flutter", kVsyncFlowName, flow_identifier);
           if (pause_secondary_tasks) {
             ResumeDartMicroTasks(ui_task_queue_id);
+            ResumeIdleTasks(ui_task_queue_id);
           }
         });
   }
@@ -159,4 +161,15 @@ void VsyncWaiter::ResumeDartMicroTasks(fml::TaskQueueId ui_task_queue_id) {
   task_queues->ResumeSecondarySource(ui_task_queue_id);
 }
 
+void VsyncWaiter::DeferIdleTasks(fml::TimePoint frame_target_time) {
+  auto ui_task_queue_id = task_runners_.GetUITaskRunner()->GetTaskQueueId();
+  auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+  task_queues->SetFrameDeadline(ui_task_queue_id, frame_target_time);
+}
+
+void VsyncWaiter::ResumeIdleTasks(fml::TaskQueueId ui_task_queue_id) {
+  auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+  task_queues->ClearFrameDeadline(ui_task_queue_id);
+}
+
 }  // namespace flutter
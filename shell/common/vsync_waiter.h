@@ -79,6 +79,11 @@ class VsyncWaiter : public std::enable_shared_from_this<VsyncWaiter> {
   void PauseDartMicroTasks();
   static void ResumeDartMicroTasks(fml::TaskQueueId ui_task_queue_id);
 
+  // Holds back the idle tasks of the UI task runner, such as platform message
+  // handlers, until the frame callback is done or the frame is due.
+  void DeferIdleTasks(fml::TimePoint frame_target_time);
+  static void ResumeIdleTasks(fml::TaskQueueId ui_task_queue_id);
+
   FML_DISALLOW_COPY_AND_ASSIGN(VsyncWaiter);
 };
 
@@ -6,6 +6,7 @@
 #define FLUTTER_SHELL_GPU_GPU_SURFACE_GL_DELEGATE_H_
 
 #include <optional>
+#include <vector>
 
 #include "flutter/common/graphics/gl_context_switch.h"
 #include "flutter/flow/embedded_views.h"
@@ -31,6 +32,8 @@ struct GLFBOInfo {
   const bool partial_repaint_enabled;
   // The frame buffer's existing damage (i.e. damage since it was last used).
   const std::optional<SkIRect> existing_damage;
+  // Optional breakdown of existing_damage into disjoint rects.
+  const std::vector<SkIRect> existing_damage_rects = {};
 };
 
 // Information passed during presentation of a frame.
@@ -48,6 +51,14 @@ struct GLPresentInfo {
   // The buffer damage refers to the region that needs to be set as damaged
   // within the frame buffer.
   const std::optional<SkIRect>& buffer_damage;
+
+  // The frame damage split into disjoint rects. Empty if the frame damage was
+  // not split, in which case frame_damage is the only damaged rect.
+  std::vector<SkIRect> frame_damage_rects = {};
+
+  // The buffer damage split into disjoint rects. Empty if the buffer damage
+  // was not split, in which case buffer_damage is the only damaged rect.
+  std::vector<SkIRect> buffer_damage_rects = {};
 };
 
 class GPUSurfaceGLDelegate {
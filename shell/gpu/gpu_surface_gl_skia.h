@@ -71,6 +71,7 @@ class GPUSurfaceGLSkia : public Surface {
   // still have an option of overriding this damage with their own in
   // `GLContextFrameBufferInfo`.
   std::optional<SkIRect> existing_damage_ = std::nullopt;
+  std::vector<SkIRect> existing_damage_rects_;
   bool context_owner_ = false;
   // TODO(38466): Refactor GPU surface APIs take into account the fact that an
   // external view embedder may want to render to the root surface. This is a
@@ -9,6 +9,11 @@
 
 namespace flutter {
 
+// The maximum number of disjoint damage rects a frame is repainted and
+// presented with. Each rect costs little on the CPU compared to the pixels
+// between rects that are saved.
+static constexpr size_t kMaxDamageRects = 16;
+
 GPUSurfaceSoftware::GPUSurfaceSoftware(GPUSurfaceSoftwareDelegate* delegate,
                                        bool render_to_surface)
     : delegate_(delegate),
@@ -55,6 +60,19 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
     return nullptr;
   }
 
+  const bool retains_contents = delegate_->BackingStoreRetainsContents();
+  if (retains_contents) {
+    framebuffer_info.supports_partial_repaint = true;
+    framebuffer_info.max_damage_rects = kMaxDamageRects;
+    // The contents of the backing store are only known to match the last
+    // frame if that frame was presented. Otherwise, the entire frame is
+    // repainted.
+    if (backing_store == last_presented_backing_store_) {
+      framebuffer_info.existing_damage = SkIRect::MakeEmpty();
+    }
+  }
+  last_presented_backing_store_ = nullptr;
+
   // If the surface has been scaled, we need to apply the inverse scaling to the
   // underlying canvas so that coordinates are mapped to the same spot
   // irrespective of surface scaling.
@@ -62,8 +80,8 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
   canvas->resetMatrix();
 
   SurfaceFrame::SubmitCallback on_submit =
-      [self = weak_factory_.GetWeakPtr()](const SurfaceFrame& surface_frame,
-                                          SkCanvas* canvas) -> bool {
+      [self = weak_factory_.GetWeakPtr(), retains_contents](
+          const SurfaceFrame& surface_frame, SkCanvas* canvas) -> bool {
     // If the surface itself went away, there is nothing more to do.
     if (!self || !self->IsValid() || canvas == nullptr) {
       return false;
@@ -71,7 +89,27 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
 
     canvas->flush();
 
-    return self->delegate_->PresentBackingStore(surface_frame.SkiaSurface());
+    if (!retains_contents) {
+      return self->delegate_->PresentBackingStore(surface_frame.SkiaSurface());
+    }
+
+    sk_sp<SkSurface> surface = surface_frame.SkiaSurface();
+    const auto& submit_info = surface_frame.submit_info();
+    std::vector<SkIRect> damage = submit_info.frame_damage_rects;
+    if (damage.empty()) {
+      // Without computed damage the entire frame has changed, otherwise the
+      // damage was not split and its bounds are the only damaged rect.
+      SkIRect bounds = submit_info.frame_damage.value_or(
+          SkIRect::MakeWH(surface->width(), surface->height()));
+      if (!bounds.isEmpty()) {
+        damage.push_back(bounds);
+      }
+    }
+    if (!self->delegate_->PresentDamagedBackingStore(surface, damage)) {
+      return false;
+    }
+    self->last_presented_backing_store_ = std::move(surface);
+    return true;
   };
 
   return std::make_unique<SurfaceFrame>(backing_store, framebuffer_info,
@@ -38,6 +38,9 @@ class GPUSurfaceSoftware : public Surface {
   // hack to make avoid allocating resources for the root surface when an
   // external view embedder is present.
   const bool render_to_surface_;
+  // The backing store that was presented last, if its contents can be reused
+  // by the next frame.
+  sk_sp<SkSurface> last_presented_backing_store_;
   fml::TaskRunnerAffineWeakPtrFactory<GPUSurfaceSoftware> weak_factory_;
   FML_DISALLOW_COPY_AND_ASSIGN(GPUSurfaceSoftware);
 };
@@ -5,6 +5,8 @@
 #ifndef FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_DELEGATE_H_
 #define FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_DELEGATE_H_
 
+#include <vector>
+
 #include "flutter/flow/embedded_views.h"
 #include "flutter/fml/macros.h"
 #include "third_party/skia/include/core/SkSurface.h"
@@ -48,6 +50,35 @@ class GPUSurfaceSoftwareDelegate {
   ///             the screen.
   ///
   virtual bool PresentBackingStore(sk_sp<SkSurface> backing_store) = 0;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether a backing store returned by |AcquireBackingStore|
+  ///             keeps its pixels until the same backing store is acquired
+  ///             again. If it does, only the areas that changed since the
+  ///             backing store was last presented are repainted and the
+  ///             backing store is presented using
+  ///             |PresentDamagedBackingStore|.
+  ///
+  /// @return     Returns if backing stores retain their contents between
+  ///             frames. The default is false.
+  ///
+  virtual bool BackingStoreRetainsContents() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Called instead of |PresentBackingStore| when backing stores
+  ///             retain their contents between frames.
+  ///
+  /// @param[in]  backing_store  The software backing store to present.
+  /// @param[in]  damage         The disjoint areas of the backing store that
+  ///                            changed since the previous frame was
+  ///                            presented.
+  ///
+  /// @return     Returns if the platform could present the backing store onto
+  ///             the screen. The default presents the entire backing store
+  ///             using |PresentBackingStore|.
+  ///
+  virtual bool PresentDamagedBackingStore(sk_sp<SkSurface> backing_store,
+                                          const std::vector<SkIRect>& damage);
 };
 
 }  // namespace flutter
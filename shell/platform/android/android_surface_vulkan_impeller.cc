@@ -7,6 +7,7 @@
 #include <memory>
 #include <utility>
 
+#include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/memory/ref_ptr.h"
@@ -31,10 +32,13 @@ std::shared_ptr<impeller::Context> CreateImpellerContext(
   PFN_vkGetInstanceProcAddr instance_proc_addr =
       proc_table->NativeGetInstanceProcAddr();
 
+  auto cache_directory =
+      PersistentCache::GetCacheForProcess()->OpenImpellerCacheDirectory();
+
   auto context =
       impeller::ContextVK::Create(instance_proc_addr,                //
                                   shader_mappings,                   //
-                                  nullptr,                           //
+                                  std::move(cache_directory),        //
                                   concurrent_loop->GetTaskRunner(),  //
                                   "Android Impeller Vulkan Lib"      //
       );
@@ -5,6 +5,7 @@
 #define FML_USED_ON_EMBEDDER
 #define RAPIDJSON_HAS_STDSTRING 1
 
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 #include <memory>
@@ -43,6 +44,7 @@ extern const intptr_t kPlatformStrongDillSize;
 #include "flutter/fml/file.h"
 #include "flutter/fml/make_copyable.h"
 #include "flutter/fml/message_loop.h"
+#include "flutter/fml/metrics.h"
 #include "flutter/fml/paths.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/shell/common/rasterizer.h"
@@ -142,8 +144,8 @@ static bool IsSoftwareRendererConfigValid(const FlutterRendererConfig* config) {
 
   const FlutterSoftwareRendererConfig* software_config = &config->software;
 
-  if (SAFE_ACCESS(software_config, surface_present_callback, nullptr) ==
-      nullptr) {
+  if (!SAFE_EXISTS_ONE_OF(software_config, surface_present_callback,
+                          surface_present_with_damage_callback)) {
     return false;
   }
 
@@ -222,7 +224,6 @@ static void* DefaultGLProcResolver(const char* name) {
 }
 #endif  // FML_OS_LINUX || FML_OS_WIN
 
-#ifdef SHELL_ENABLE_GL
 // Auxiliary function used to translate rectangles of type SkIRect to
 // FlutterRect.
 static FlutterRect SkIRectToFlutterRect(const SkIRect sk_rect) {
@@ -233,6 +234,7 @@ static FlutterRect SkIRectToFlutterRect(const SkIRect sk_rect) {
   return flutter_rect;
 }
 
+#ifdef SHELL_ENABLE_GL
 // Auxiliary function used to translate rectangles of type FlutterRect to
 // SkIRect.
 static const SkIRect FlutterRectToSkIRect(FlutterRect flutter_rect) {
@@ -242,6 +244,24 @@ static const SkIRect FlutterRectToSkIRect(FlutterRect flutter_rect) {
                   static_cast<int32_t>(flutter_rect.bottom)};
   return rect;
 }
+
+// Auxiliary function used to translate damage to the list of rectangles
+// passed to the embedder. If the damage was not split into multiple
+// rectangles, the bounds of the damage are its only rectangle.
+static std::vector<FlutterRect> DamageToFlutterRects(
+    const std::vector<SkIRect>& rects,
+    const SkIRect& bounds) {
+  std::vector<FlutterRect> flutter_rects;
+  if (rects.empty()) {
+    flutter_rects.push_back(SkIRectToFlutterRect(bounds));
+  } else {
+    flutter_rects.reserve(rects.size());
+    for (const auto& rect : rects) {
+      flutter_rects.push_back(SkIRectToFlutterRect(rect));
+    }
+  }
+  return flutter_rects;
+}
 #endif
 
 static inline flutter::Shell::CreateCallback<flutter::PlatformView>
@@ -270,28 +290,26 @@ InferOpenGLPlatformViewCreationCallback(
     if (present) {
       return present(user_data);
     } else {
-      // Format the frame and buffer damages accordingly. Note that, since the
-      // current compute damage algorithm only returns one rectangle for damage
-      // we are assuming the number of rectangles provided in frame and buffer
-      // damage are always 1. Once the function that computes damage implements
-      // support for multiple damage rectangles, GLPresentInfo should also
-      // contain the number of damage rectangles.
-      const size_t num_rects = 1;
-
-      std::array<FlutterRect, num_rects> frame_damage_rect = {
-          SkIRectToFlutterRect(*(gl_present_info.frame_damage))};
-      std::array<FlutterRect, num_rects> buffer_damage_rect = {
-          SkIRectToFlutterRect(*(gl_present_info.buffer_damage))};
+      // Format the frame and buffer damages accordingly. Damage that was not
+      // split into multiple rectangles (see max_damage_rects in
+      // FlutterOpenGLRendererConfig) is passed as its single bounding
+      // rectangle.
+      std::vector<FlutterRect> frame_damage_rects =
+          DamageToFlutterRects(gl_present_info.frame_damage_rects,
+                               *(gl_present_info.frame_damage));
+      std::vector<FlutterRect> buffer_damage_rects =
+          DamageToFlutterRects(gl_present_info.buffer_damage_rects,
+                               *(gl_present_info.buffer_damage));
 
       FlutterDamage frame_damage{
           .struct_size = sizeof(FlutterDamage),
-          .num_rects = frame_damage_rect.size(),
-          .damage = frame_damage_rect.data(),
+          .num_rects = frame_damage_rects.size(),
+          .damage = frame_damage_rects.data(),
       };
       FlutterDamage buffer_damage{
           .struct_size = sizeof(FlutterDamage),
-          .num_rects = buffer_damage_rect.size(),
-          .damage = buffer_damage_rect.data(),
+          .num_rects = buffer_damage_rects.size(),
+          .damage = buffer_damage_rects.data(),
       };
 
       // Construct the present information concerning the frame being rendered.
@@ -339,22 +357,21 @@ InferOpenGLPlatformViewCreationCallback(
     populate_existing_damage(user_data, id, &existing_damage);
 
     bool partial_repaint_enabled = true;
-    SkIRect existing_damage_rect;
+    SkIRect existing_damage_rect = SkIRect::MakeEmpty();
+    std::vector<SkIRect> existing_damage_rects;
 
     // Verify that at least one damage rectangle was provided.
     if (existing_damage.num_rects <= 0 || existing_damage.damage == nullptr) {
       FML_LOG(INFO) << "No damage was provided. Forcing full repaint.";
-      existing_damage_rect = SkIRect::MakeEmpty();
       partial_repaint_enabled = false;
-    } else if (existing_damage.num_rects > 1) {
-      // Log message notifying users that multi-damage is not yet available in
-      // case they try to make use of it.
-      FML_LOG(INFO) << "Damage with multiple rectangles not yet supported. "
-                       "Repainting the whole frame.";
-      existing_damage_rect = SkIRect::MakeEmpty();
-      partial_repaint_enabled = false;
-    } else {
+    } else if (existing_damage.num_rects == 1) {
       existing_damage_rect = FlutterRectToSkIRect(*(existing_damage.damage));
+    } else {
+      for (size_t i = 0; i < existing_damage.num_rects; i++) {
+        SkIRect rect = FlutterRectToSkIRect(existing_damage.damage[i]);
+        existing_damage_rect.join(rect);
+        existing_damage_rects.push_back(rect);
+      }
     }
 
     // Pass the information about this FBO to the rendering backend.
@@ -362,6 +379,7 @@ InferOpenGLPlatformViewCreationCallback(
         .fbo_id = static_cast<uint32_t>(id),
         .partial_repaint_enabled = partial_repaint_enabled,
         .existing_damage = existing_damage_rect,
+        .existing_damage_rects = std::move(existing_damage_rects),
     };
   };
 
@@ -414,6 +432,9 @@ InferOpenGLPlatformViewCreationCallback(
   bool fbo_reset_after_present =
       SAFE_ACCESS(open_gl_config, fbo_reset_after_present, false);
 
+  size_t max_damage_rects =
+      std::max<size_t>(SAFE_ACCESS(open_gl_config, max_damage_rects, 1), 1);
+
   flutter::EmbedderSurfaceGL::GLDispatchTable gl_dispatch_table = {
       gl_make_current,                     // gl_make_current_callback
       gl_clear_current,                    // gl_clear_current_callback
@@ -426,14 +447,15 @@ InferOpenGLPlatformViewCreationCallback(
   };
 
   return fml::MakeCopyable(
-      [gl_dispatch_table, fbo_reset_after_present, platform_dispatch_table,
-       external_view_embedder =
+      [gl_dispatch_table, fbo_reset_after_present, max_damage_rects,
+       platform_dispatch_table, external_view_embedder =
            std::move(external_view_embedder)](flutter::Shell& shell) mutable {
         return std::make_unique<flutter::PlatformViewEmbedder>(
             shell,                    // delegate
             shell.GetTaskRunners(),   // task runners
             gl_dispatch_table,        // embedder GL dispatch table
             fbo_reset_after_present,  // fbo reset after present
+            max_damage_rects,         // max damage rects
             platform_dispatch_table,  // embedder platform dispatch table
             std::move(external_view_embedder)  // external view embedder
         );
@@ -612,15 +634,44 @@ InferSoftwarePlatformViewCreationCallback(
     return nullptr;
   }
 
-  auto software_present_backing_store =
-      [ptr = config->software.surface_present_callback, user_data](
-          const void* allocation, size_t row_bytes, size_t height) -> bool {
-    return ptr(user_data, allocation, row_bytes, height);
-  };
+  const FlutterSoftwareRendererConfig* software_config = &config->software;
+
+  std::function<bool(const void*, size_t, size_t)>
+      software_present_backing_store = nullptr;
+  if (SAFE_EXISTS(software_config, surface_present_callback)) {
+    software_present_backing_store =
+        [ptr = software_config->surface_present_callback, user_data](
+            const void* allocation, size_t row_bytes, size_t height) -> bool {
+      return ptr(user_data, allocation, row_bytes, height);
+    };
+  }
+
+  std::function<bool(const void*, size_t, size_t,
+                     const std::vector<SkIRect>&)>
+      software_present_backing_store_with_damage = nullptr;
+  if (SAFE_EXISTS(software_config, surface_present_with_damage_callback)) {
+    software_present_backing_store_with_damage =
+        [ptr = software_config->surface_present_with_damage_callback,
+         user_data](const void* allocation, size_t row_bytes, size_t height,
+                    const std::vector<SkIRect>& damage) -> bool {
+      std::vector<FlutterRect> damage_rects;
+      damage_rects.reserve(damage.size());
+      for (const auto& rect : damage) {
+        damage_rects.push_back(SkIRectToFlutterRect(rect));
+      }
+      FlutterDamage flutter_damage{
+          .struct_size = sizeof(FlutterDamage),
+          .num_rects = damage_rects.size(),
+          .damage = damage_rects.data(),
+      };
+      return ptr(user_data, allocation, row_bytes, height, &flutter_damage);
+    };
+  }
 
   flutter::EmbedderSurfaceSoftware::SoftwareDispatchTable
       software_dispatch_table = {
-          software_present_backing_store,  // required
+          software_present_backing_store,              // present
+          software_present_backing_store_with_damage,  // present with damage
       };
 
   return fml::MakeCopyable(
@@ -2923,6 +2974,52 @@ FlutterEngineResult FlutterEngineSetNextFrameCallback(
   return kSuccess;
 }
 
+FlutterEngineResult FlutterEngineGetMetrics(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterMetricsCallback callback,
+    void* user_data) {
+  if (engine == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
+  }
+
+  if (callback == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Metrics callback was null.");
+  }
+
+  const auto snapshots =
+      fml::metrics::MetricsRegistry::GetInstance().GetSnapshot();
+  std::vector<FlutterMetric> metrics;
+  metrics.reserve(snapshots.size());
+  for (const auto& snapshot : snapshots) {
+    FlutterMetric metric = {};
+    metric.struct_size = sizeof(FlutterMetric);
+    metric.name = snapshot.name.c_str();
+    switch (snapshot.type) {
+      case fml::metrics::MetricType::kCounter:
+        metric.type = kFlutterMetricTypeCounter;
+        break;
+      case fml::metrics::MetricType::kGauge:
+        metric.type = kFlutterMetricTypeGauge;
+        break;
+      case fml::metrics::MetricType::kHistogram:
+        metric.type = kFlutterMetricTypeHistogram;
+        break;
+    }
+    metric.value = snapshot.value;
+    metric.count = snapshot.histogram.count;
+    metric.sum = snapshot.histogram.sum;
+    metric.min = snapshot.histogram.min;
+    metric.max = snapshot.histogram.max;
+    metric.p50 = snapshot.histogram.p50;
+    metric.p90 = snapshot.histogram.p90;
+    metric.p99 = snapshot.histogram.p99;
+    metrics.push_back(metric);
+  }
+
+  callback(metrics.data(), metrics.size(), user_data);
+  return kSuccess;
+}
+
 FlutterEngineResult FlutterEngineGetProcAddresses(
     FlutterEngineProcTable* table) {
   if (!table) {
@@ -2975,6 +3072,7 @@ FlutterEngineResult FlutterEngineGetProcAddresses(
   SET_PROC(NotifyDisplayUpdate, FlutterEngineNotifyDisplayUpdate);
   SET_PROC(ScheduleFrame, FlutterEngineScheduleFrame);
   SET_PROC(SetNextFrameCallback, FlutterEngineSetNextFrameCallback);
+  SET_PROC(GetMetrics, FlutterEngineGetMetrics);
 #undef SET_PROC
 
   return kSuccess;
@@ -489,6 +489,15 @@ typedef bool (*BoolPresentInfoCallback)(
     void* /* user data */,
     const FlutterPresentInfo* /* present info */);
 
+/// Callback for when a software surface is presented along with the areas of
+/// the surface that changed since the previous present.
+typedef bool (*SoftwareSurfacePresentWithDamageCallback)(
+    void* /* user data */,
+    const void* /* allocation */,
+    size_t /* row bytes */,
+    size_t /* height */,
+    const FlutterDamage* /* damage */);
+
 typedef struct {
   /// The size of this struct. Must be sizeof(FlutterOpenGLRendererConfig).
   size_t struct_size;
@@ -569,6 +578,18 @@ typedef struct {
   /// ID. Not specifying populate_existing_damage will result in full
   /// repaint (i.e. rendering all the pixels on the screen at every frame).
   FlutterFrameBufferWithDamageCallback populate_existing_damage;
+  /// The maximum number of rectangles the engine may use to describe the
+  /// frame and buffer damage passed to `present_with_info`. The engine keeps
+  /// disjoint damaged areas (for example two small animations in opposite
+  /// corners of the screen) apart instead of repainting and presenting their
+  /// bounding rectangle, merging them until no more than this many
+  /// rectangles remain. Embedders that are able to present multiple damage
+  /// rectangles (for example using `eglSwapBuffersWithDamageKHR`) can set this
+  /// to a value greater than 1. Not specifying this value, or specifying 0 or
+  /// 1, results in damage always being a single rectangle. The existing damage
+  /// returned by `populate_existing_damage` may contain multiple rectangles
+  /// regardless of this value.
+  size_t max_damage_rects;
 } FlutterOpenGLRendererConfig;
 
 /// Alias for id<MTLDevice>.
@@ -784,7 +805,20 @@ typedef struct {
   /// to the user. The pixel format of the buffer is the native 32-bit RGBA
   /// format. The buffer is owned by the Flutter engine and must be copied in
   /// this callback if needed.
+  ///
+  /// Specifying one (and only one) of `surface_present_callback` or
+  /// `surface_present_with_damage_callback` is required.
   SoftwareSurfacePresentCallback surface_present_callback;
+  /// A variant of `surface_present_callback` that enables partial repaint.
+  /// When this callback is used, the engine renders every frame into the same
+  /// buffer (until the size of the surface changes), only repaints the areas
+  /// of the buffer that changed since the previous present and passes those
+  /// areas as a list of disjoint rectangles to the callback. An embedder that
+  /// keeps a copy of the previously presented buffer only needs to copy the
+  /// damaged rectangles. The whole buffer is reported as damaged whenever its
+  /// previous contents cannot be reused. The damage may contain no rectangles
+  /// if nothing changed.
+  SoftwareSurfacePresentWithDamageCallback surface_present_with_damage_callback;
 } FlutterSoftwareRendererConfig;
 
 typedef struct {
@@ -1209,6 +1243,29 @@ typedef struct {
   size_t identifier;
 } FlutterTaskRunnerDescription;
 
+/// Scheduling controls for a thread created by the engine. Unsupported
+/// controls are ignored on the current platform.
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterThreadConfig).
+  size_t struct_size;
+  /// The CPUs the thread may run on. May be null to run on any CPU. Only
+  /// supported on Linux and Android.
+  const size_t* cpu_affinity;
+  /// The number of CPUs in `cpu_affinity`.
+  size_t cpu_affinity_count;
+  /// The stack size of the thread in bytes, or 0 for the platform default.
+  /// Not supported on Windows.
+  size_t stack_size;
+  /// When not 0, runs the thread with the `SCHED_FIFO` real time policy at
+  /// this priority, from 1 to 99. Only supported on Linux and Android.
+  int32_t realtime_priority;
+  /// Whether `nice_value` should be applied to the thread.
+  bool has_nice_value;
+  /// The nice value of the thread, from -20 to 19. Only supported on Linux and
+  /// Android.
+  int32_t nice_value;
+} FlutterThreadConfig;
+
 typedef struct {
   /// The size of this struct. Must be sizeof(FlutterCustomTaskRunners).
   size_t struct_size;
@@ -1225,6 +1282,14 @@ typedef struct {
   /// Specify a callback that is used to set the thread priority for embedder
   /// task runners.
   void (*thread_priority_setter)(FlutterThreadPriority);
+  /// Optional scheduling controls for the UI thread.
+  const FlutterThreadConfig* ui_thread_config;
+  /// Optional scheduling controls for the raster thread. Only used if the
+  /// engine creates the raster thread, that is, if no `render_task_runner` is
+  /// specified.
+  const FlutterThreadConfig* raster_thread_config;
+  /// Optional scheduling controls for the IO thread.
+  const FlutterThreadConfig* io_thread_config;
 } FlutterCustomTaskRunners;
 
 typedef struct {
@@ -1643,6 +1708,52 @@ typedef enum {
 typedef void (*FlutterNativeThreadCallback)(FlutterNativeThreadType type,
                                             void* user_data);
 
+/// The kind of value held by a `FlutterMetric`.
+typedef enum {
+  /// A count that only goes up, in `value`.
+  kFlutterMetricTypeCounter,
+  /// A value that goes up and down, in `value`.
+  kFlutterMetricTypeGauge,
+  /// A distribution of values, summarized by `count` through `p99`.
+  kFlutterMetricTypeHistogram,
+} FlutterMetricType;
+
+/// The value of one of the metrics the engine collects, such as the depth of
+/// its task queues or the sizes of platform messages, when
+/// `FlutterEngineGetMetrics` was called. Metrics are shared by all the engines
+/// in the process.
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterMetric).
+  size_t struct_size;
+  /// The name of the metric, such as "flutter.RasterCache.Bytes". The string
+  /// is only valid for the duration of the `FlutterMetricsCallback`.
+  const char* name;
+  FlutterMetricType type;
+  /// The value of a counter or a gauge.
+  int64_t value;
+  /// The number of values recorded by a histogram.
+  uint64_t count;
+  /// The sum of the values recorded by a histogram.
+  int64_t sum;
+  /// The smallest value recorded by a histogram.
+  int64_t min;
+  /// The largest value recorded by a histogram.
+  int64_t max;
+  /// The median of the values recorded by a histogram.
+  int64_t p50;
+  /// The 90th percentile of the values recorded by a histogram.
+  int64_t p90;
+  /// The 99th percentile of the values recorded by a histogram.
+  int64_t p99;
+} FlutterMetric;
+
+/// A callback made by the engine in response to `FlutterEngineGetMetrics`
+/// with all the metrics it collects. The metrics are only valid for the
+/// duration of the callback.
+typedef void (*FlutterMetricsCallback)(const FlutterMetric* metrics,
+                                       size_t metrics_count,
+                                       void* user_data);
+
 /// AOT data source type.
 typedef enum {
   kFlutterEngineAOTDataSourceTypeElfPath
@@ -2629,6 +2740,27 @@ FlutterEngineResult FlutterEngineSetNextFrameCallback(
     VoidCallback callback,
     void* user_data);
 
+//------------------------------------------------------------------------------
+/// @brief      Reports the metrics the engine always collects, such as the
+///             depth of its task queues, the bytes in its raster caches, the
+///             latency of image decodes and the sizes of platform messages,
+///             without tracing. This may be called on any thread. The
+///             callback is made synchronously on the calling thread, before
+///             this call returns.
+///
+/// @param[in]  engine     A running engine instance.
+/// @param[in]  callback   The callback to execute with the metrics.
+/// @param[in]  user_data  A baton passed by the engine to the callback. This
+///                        baton is not interpreted by the engine in any way.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineGetMetrics(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterMetricsCallback callback,
+    void* user_data);
+
 #endif  // !FLUTTER_ENGINE_NO_PROTOTYPES
 
 // Typedefs for the function pointers in FlutterEngineProcTable.
@@ -2751,6 +2883,10 @@ typedef FlutterEngineResult (*FlutterEngineSetNextFrameCallbackFnPtr)(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     VoidCallback callback,
     void* user_data);
+typedef FlutterEngineResult (*FlutterEngineGetMetricsFnPtr)(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterMetricsCallback callback,
+    void* user_data);
 
 /// Function-pointer-based versions of the APIs above.
 typedef struct {
@@ -2797,6 +2933,7 @@ typedef struct {
   FlutterEngineNotifyDisplayUpdateFnPtr NotifyDisplayUpdate;
   FlutterEngineScheduleFrameFnPtr ScheduleFrame;
   FlutterEngineSetNextFrameCallbackFnPtr SetNextFrameCallback;
+  FlutterEngineGetMetricsFnPtr GetMetrics;
 } FlutterEngineProcTable;
 
 //------------------------------------------------------------------------------
@@ -18,7 +18,8 @@ EmbedderSurfaceSoftware::EmbedderSurfaceSoftware(
     std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder)
     : software_dispatch_table_(std::move(software_dispatch_table)),
       external_view_embedder_(std::move(external_view_embedder)) {
-  if (!software_dispatch_table_.software_present_backing_store) {
+  if (!software_dispatch_table_.software_present_backing_store &&
+      !software_dispatch_table_.software_present_backing_store_with_damage) {
     return;
   }
   valid_ = true;
@@ -79,29 +80,48 @@ sk_sp<SkSurface> EmbedderSurfaceSoftware::AcquireBackingStore(
   return sk_surface_;
 }
 
-// |GPUSurfaceSoftwareDelegate|
-bool EmbedderSurfaceSoftware::PresentBackingStore(
-    sk_sp<SkSurface> backing_store) {
+bool EmbedderSurfaceSoftware::PeekPresentablePixels(
+    const sk_sp<SkSurface>& backing_store,
+    SkPixmap* pixmap) const {
   if (!IsValid()) {
     FML_LOG(ERROR) << "Tried to present an invalid software surface.";
     return false;
   }
 
-  SkPixmap pixmap;
-  if (!backing_store->peekPixels(&pixmap)) {
+  if (!backing_store->peekPixels(pixmap)) {
     FML_LOG(ERROR) << "Could not peek the pixels of the backing store.";
     return false;
   }
 
   // Some basic sanity checking.
-  uint64_t expected_pixmap_data_size = pixmap.width() * pixmap.height() * 4;
+  uint64_t expected_pixmap_data_size = pixmap->width() * pixmap->height() * 4;
 
-  const size_t pixmap_size = pixmap.computeByteSize();
+  const size_t pixmap_size = pixmap->computeByteSize();
 
   if (expected_pixmap_data_size != pixmap_size) {
     FML_LOG(ERROR) << "Software backing store had unexpected size.";
     return false;
   }
+  return true;
+}
+
+// |GPUSurfaceSoftwareDelegate|
+bool EmbedderSurfaceSoftware::PresentBackingStore(
+    sk_sp<SkSurface> backing_store) {
+  SkPixmap pixmap;
+  if (!PeekPresentablePixels(backing_store, &pixmap)) {
+    return false;
+  }
+
+  if (software_dispatch_table_.software_present_backing_store_with_damage) {
+    // The whole backing store is new to the embedder.
+    return software_dispatch_table_.software_present_backing_store_with_damage(
+        pixmap.addr(),                                       //
+        pixmap.rowBytes(),                                   //
+        pixmap.height(),                                     //
+        {SkIRect::MakeWH(pixmap.width(), pixmap.height())}  //
+    );
+  }
 
   return software_dispatch_table_.software_present_backing_store(
       pixmap.addr(),      //
@@ -110,4 +130,33 @@ bool EmbedderSurfaceSoftware::PresentBackingStore(
   );
 }
 
+// |GPUSurfaceSoftwareDelegate|
+bool EmbedderSurfaceSoftware::BackingStoreRetainsContents() const {
+  // The backing store is only replaced when the size of the surface changes
+  // and the embedder is only given read access to it.
+  return software_dispatch_table_.software_present_backing_store_with_damage !=
+         nullptr;
+}
+
+// |GPUSurfaceSoftwareDelegate|
+bool EmbedderSurfaceSoftware::PresentDamagedBackingStore(
+    sk_sp<SkSurface> backing_store,
+    const std::vector<SkIRect>& damage) {
+  if (!software_dispatch_table_.software_present_backing_store_with_damage) {
+    return PresentBackingStore(std::move(backing_store));
+  }
+
+  SkPixmap pixmap;
+  if (!PeekPresentablePixels(backing_store, &pixmap)) {
+    return false;
+  }
+
+  return software_dispatch_table_.software_present_backing_store_with_damage(
+      pixmap.addr(),      //
+      pixmap.rowBytes(),  //
+      pixmap.height(),    //
+      damage              //
+  );
+}
+
 }  // namespace flutter
@@ -5,19 +5,31 @@
 #ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
 #define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
 
+#include <vector>
+
 #include "flutter/fml/macros.h"
 #include "flutter/shell/gpu/gpu_surface_software.h"
 #include "flutter/shell/platform/embedder/embedder_external_view_embedder.h"
 #include "flutter/shell/platform/embedder/embedder_surface.h"
+#include "third_party/skia/include/core/SkPixmap.h"
 
 namespace flutter {
 
 class EmbedderSurfaceSoftware final : public EmbedderSurface,
                                       public GPUSurfaceSoftwareDelegate {
  public:
+  // One of the present callbacks is required. When
+  // software_present_backing_store_with_damage is set, the backing store is
+  // reused between frames, only damaged areas are repainted and the damage is
+  // passed to the embedder.
   struct SoftwareDispatchTable {
     std::function<bool(const void* allocation, size_t row_bytes, size_t height)>
-        software_present_backing_store;  // required
+        software_present_backing_store;
+    std::function<bool(const void* allocation,
+                       size_t row_bytes,
+                       size_t height,
+                       const std::vector<SkIRect>& damage)>
+        software_present_backing_store_with_damage;
   };
 
   EmbedderSurfaceSoftware(
@@ -47,6 +59,17 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
   // |GPUSurfaceSoftwareDelegate|
   bool PresentBackingStore(sk_sp<SkSurface> backing_store) override;
 
+  // |GPUSurfaceSoftwareDelegate|
+  bool BackingStoreRetainsContents() const override;
+
+  // |GPUSurfaceSoftwareDelegate|
+  bool PresentDamagedBackingStore(sk_sp<SkSurface> backing_store,
+                                  const std::vector<SkIRect>& damage) override;
+
+  // Checks the backing store about to be presented and returns its pixels.
+  bool PeekPresentablePixels(const sk_sp<SkSurface>& backing_store,
+                             SkPixmap* pixmap) const;
+
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderSurfaceSoftware);
 };
 
@@ -53,6 +53,11 @@ void EmbedderTaskRunner::PostDelayedTask(const fml::closure& task,
   PostTaskForTime(task, fml::TimePoint::Now() + delay);
 }
 
+void EmbedderTaskRunner::PostIdleTask(const fml::closure& task) {
+  // Tasks are run by the embedder, which doesn't know about frame deadlines.
+  PostTask(task);
+}
+
 bool EmbedderTaskRunner::RunsTasksOnCurrentThread() {
   return dispatch_table_.runs_task_on_current_thread_callback();
 }
@@ -89,6 +89,9 @@ class EmbedderTaskRunner final : public fml::TaskRunner {
   // |fml::TaskRunner|
   void PostDelayedTask(const fml::closure& task, fml::TimeDelta delay) override;
 
+  // |fml::TaskRunner|
+  void PostIdleTask(const fml::closure& task) override;
+
   // |fml::TaskRunner|
   bool RunsTasksOnCurrentThread() override;
 
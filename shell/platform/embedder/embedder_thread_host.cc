@@ -121,6 +121,34 @@ fml::Thread::ThreadConfig MakeThreadConfig(
       priority);
 }
 
+fml::Thread::ThreadConfig MakeThreadConfig(
+    flutter::ThreadHost::Type type,
+    fml::Thread::ThreadPriority priority,
+    const FlutterThreadConfig* embedder_config) {
+  auto config = MakeThreadConfig(type, priority);
+  if (embedder_config == nullptr) {
+    return config;
+  }
+  const size_t* cpu_affinity =
+      SAFE_ACCESS(embedder_config, cpu_affinity, nullptr);
+  if (cpu_affinity != nullptr) {
+    config.cpu_affinity.assign(
+        cpu_affinity,
+        cpu_affinity +
+            SAFE_ACCESS(embedder_config, cpu_affinity_count, 0u));
+  }
+  config.stack_size = SAFE_ACCESS(embedder_config, stack_size, 0u);
+  const int32_t realtime_priority =
+      SAFE_ACCESS(embedder_config, realtime_priority, 0);
+  if (realtime_priority != 0) {
+    config.realtime_priority = realtime_priority;
+  }
+  if (SAFE_ACCESS(embedder_config, has_nice_value, false)) {
+    config.nice_value = SAFE_ACCESS(embedder_config, nice_value, 0);
+  }
+  return config;
+}
+
 // static
 std::unique_ptr<EmbedderThreadHost>
 EmbedderThreadHost::CreateEmbedderManagedThreadHost(
@@ -137,9 +165,11 @@ EmbedderThreadHost::CreateEmbedderManagedThreadHost(
   //
   // If/when more task runners are exposed, this mask will need to be updated.
   thread_host_config.SetUIConfig(MakeThreadConfig(
-      ThreadHost::Type::UI, fml::Thread::ThreadPriority::DISPLAY));
+      ThreadHost::Type::UI, fml::Thread::ThreadPriority::DISPLAY,
+      SAFE_ACCESS(custom_task_runners, ui_thread_config, nullptr)));
   thread_host_config.SetIOConfig(MakeThreadConfig(
-      ThreadHost::Type::IO, fml::Thread::ThreadPriority::BACKGROUND));
+      ThreadHost::Type::IO, fml::Thread::ThreadPriority::BACKGROUND,
+      SAFE_ACCESS(custom_task_runners, io_thread_config, nullptr)));
 
   auto platform_task_runner_pair = CreateEmbedderTaskRunner(
       SAFE_ACCESS(custom_task_runners, platform_task_runner, nullptr));
@@ -157,7 +187,8 @@ EmbedderThreadHost::CreateEmbedderManagedThreadHost(
   // created.
   if (!render_task_runner_pair.second) {
     thread_host_config.SetRasterConfig(MakeThreadConfig(
-        ThreadHost::Type::RASTER, fml::Thread::ThreadPriority::RASTER));
+        ThreadHost::Type::RASTER, fml::Thread::ThreadPriority::RASTER,
+        SAFE_ACCESS(custom_task_runners, raster_thread_config, nullptr)));
   }
 
   // If both the platform task runner and the raster task runner are specified
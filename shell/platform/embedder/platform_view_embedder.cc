@@ -68,6 +68,7 @@ PlatformViewEmbedder::PlatformViewEmbedder(
     const flutter::TaskRunners& task_runners,
     const EmbedderSurfaceGL::GLDispatchTable& gl_dispatch_table,
     bool fbo_reset_after_present,
+    size_t max_damage_rects,
     PlatformDispatchTable platform_dispatch_table,
     std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder)
     : PlatformView(delegate, task_runners),
@@ -75,6 +76,7 @@ PlatformViewEmbedder::PlatformViewEmbedder(
       embedder_surface_(
           std::make_unique<EmbedderSurfaceGL>(gl_dispatch_table,
                                               fbo_reset_after_present,
+                                              max_damage_rects,
                                               external_view_embedder_)),
       platform_message_handler_(new EmbedderPlatformMessageHandler(
           GetWeakPtr(),
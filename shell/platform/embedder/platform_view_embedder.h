@@ -67,6 +67,7 @@ class PlatformViewEmbedder final : public PlatformView {
       const flutter::TaskRunners& task_runners,
       const EmbedderSurfaceGL::GLDispatchTable& gl_dispatch_table,
       bool fbo_reset_after_present,
+      size_t max_damage_rects,
       PlatformDispatchTable platform_dispatch_table,
       std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder);
 #endif
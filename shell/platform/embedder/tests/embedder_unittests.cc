@@ -75,6 +75,64 @@ TEST_F(EmbedderTest, CanLaunchAndShutdownWithValidProjectArgs) {
   engine.reset();
 }
 
+TEST_F(EmbedderTest, SoftwareRendererWithBothPresentCallbacksIsInvalid) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  builder.GetRendererConfig().software.surface_present_with_damage_callback =
+      [](void* context, const void* allocation, size_t row_bytes,
+         size_t height, const FlutterDamage* damage) { return true; };
+  auto engine = builder.LaunchEngine();
+  ASSERT_FALSE(engine.is_valid());
+}
+
+TEST_F(EmbedderTest, SoftwarePresentWithDamageReceivesDamage) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig(SkISize::Make(800, 600));
+  builder.SetDartEntrypoint("render_gradient");
+
+  static fml::AutoResetWaitableEvent present_latch;
+  static std::vector<std::vector<FlutterRect>> presented_damage;
+  presented_damage.clear();
+  FlutterSoftwareRendererConfig& software =
+      builder.GetRendererConfig().software;
+  software.surface_present_callback = nullptr;
+  software.surface_present_with_damage_callback =
+      [](void* context, const void* allocation, size_t row_bytes,
+         size_t height, const FlutterDamage* damage) {
+        presented_damage.emplace_back(damage->damage,
+                                      damage->damage + damage->num_rects);
+        present_latch.Signal();
+        return true;
+      };
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  // The first frame repaints the entire buffer, the second frame is identical
+  // and repaints nothing.
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+  present_latch.Wait();
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+  present_latch.Wait();
+
+  ASSERT_EQ(presented_damage.size(), 2u);
+  ASSERT_EQ(presented_damage[0].size(), 1u);
+  EXPECT_EQ(presented_damage[0][0].left, 0);
+  EXPECT_EQ(presented_damage[0][0].top, 0);
+  EXPECT_EQ(presented_damage[0][0].right, 800);
+  EXPECT_EQ(presented_damage[0][0].bottom, 600);
+  EXPECT_TRUE(presented_damage[1].empty());
+}
+
 // TODO(41999): Disabled because flaky.
 TEST_F(EmbedderTest, DISABLED_CanLaunchAndShutdownMultipleTimes) {
   EmbedderConfigBuilder builder(
@@ -2180,6 +2238,37 @@ TEST_F(EmbedderTest, CanSetNextFrameCallback) {
   callback_latch.Wait();
 }
 
+TEST_F(EmbedderTest, CanGetMetrics) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  ASSERT_EQ(FlutterEngineGetMetrics(engine.get(), nullptr, nullptr),
+            kInvalidArguments);
+
+  // Launching the engine ran tasks on the UI thread, so its queue has been
+  // measured.
+  bool found_task_queue_depth = false;
+  auto result = FlutterEngineGetMetrics(
+      engine.get(),
+      [](const FlutterMetric* metrics, size_t metrics_count, void* user_data) {
+        for (size_t i = 0; i < metrics_count; i++) {
+          ASSERT_EQ(metrics[i].struct_size, sizeof(FlutterMetric));
+          if (std::string(metrics[i].name) ==
+              "fml.MessageLoop.ui.TaskQueueDepth") {
+            ASSERT_EQ(metrics[i].type, kFlutterMetricTypeHistogram);
+            ASSERT_GT(metrics[i].count, 0u);
+            *static_cast<bool*>(user_data) = true;
+          }
+        }
+      },
+      &found_task_queue_depth);
+  ASSERT_EQ(result, kSuccess);
+  ASSERT_TRUE(found_task_queue_depth);
+}
+
 #if defined(FML_OS_MACOSX)
 
 static void MockThreadConfigSetter(const fml::Thread::ThreadConfig& config) {
@@ -36,6 +36,10 @@ class CompatTaskRunner : public fml::TaskRunner {
                            zx::duration(delay.ToNanoseconds()));
   }
 
+  void PostIdleTask(const fml::closure& task) override {
+    async::PostTask(forwarding_target_, task);
+  }
+
   bool RunsTasksOnCurrentThread() override {
     return forwarding_target_ == async_get_default_dispatcher();
   }
@@ -103,6 +103,31 @@ void main() {
       await vmService?.dispose();
     }
   });
+
+  test('Can get the engine metrics', () async {
+    vms.VmService? vmService;
+    try {
+      final developer.ServiceProtocolInfo info = await developer.Service.getInfo();
+      if (info.serverUri == null) {
+        fail('This test must not be run with --disable-observatory.');
+      }
+
+      vmService = await vmServiceConnectUri(
+        'ws://localhost:${info.serverUri!.port}${info.serverUri!.path}ws',
+      );
+
+      final vms.Response response = await vmService.callMethod('_flutter.getMetrics');
+      expect(response.type, 'FlutterMetrics');
+      final List<Object?> metrics = response.json!['metrics']! as List<Object?>;
+      final Map<String, Object?> taskQueueDepth = metrics
+          .cast<Map<String, Object?>>()
+          .firstWhere((Map<String, Object?> metric) => metric['name'] == 'fml.MessageLoop.TaskQueueDepth');
+      expect(taskQueueDepth['type'], 'histogram');
+      expect((taskQueueDepth['count']! as int) > 0, true);
+    } finally {
+      await vmService?.dispose();
+    }
+  });
 }
 
 Future<String> getViewId(vms.VmService vmService) async {